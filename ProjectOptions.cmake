@@ -9,12 +9,18 @@ macro(renderer_setup_options)
     option(renderer_ENABLE_PCH "Enable precompiled headers" OFF)
     option(renderer_ENABLE_CACHE "Enable ccache" OFF)
     option(renderer_ENABLE_TESTS "Enable renderer tests" ON)
+    option(renderer_ENABLE_STREAM_JSON "Use streaming json backend for assets" OFF)
+    option(renderer_ENABLE_BINARY_JSON "Use binary backend for assets" OFF)
+    option(renderer_ENABLE_IO_URING "Read asset files through io_uring on Linux" ON)
   else()
     option(renderer_WARNINGS_AS_ERRORS "Treat Warnings As Errors" ON)
     option(renderer_ENABLE_UNITY_BUILD "Enable unity builds" OFF)
     option(renderer_ENABLE_PCH "Enable precompiled headers" OFF)
     option(renderer_ENABLE_CACHE "Enable ccache" OFF)
     option(renderer_ENABLE_TESTS "Enable renderer tests" ON)
+    option(renderer_ENABLE_STREAM_JSON "Use streaming json backend for assets" OFF)
+    option(renderer_ENABLE_BINARY_JSON "Use binary backend for assets" OFF)
+    option(renderer_ENABLE_IO_URING "Read asset files through io_uring on Linux" ON)
   endif()
 
   if(NOT PROJECT_IS_TOP_LEVEL)
@@ -11,3 +11,9 @@
 
 for %%f in (shaders\*.vert) do %VULKAN_SDK%/Bin/glslc.exe %%f -o SPRV/%%~nfvert.spv
 for %%v in (shaders\*.frag) do %VULKAN_SDK%/Bin/glslc.exe %%v -o SPRV/%%~nvfrag.spv
+
+:: Model vertex shaders also get packed vertex variants, see shaders/vertex_input.glsl
+for %%m in (shader shaderLight shaderLightBlend) do (
+    %VULKAN_SDK%/Bin/glslc.exe -DPACKED_VERTEX shaders\%%m.vert -o SPRV/%%mpackedvert.spv
+    %VULKAN_SDK%/Bin/glslc.exe -DPACKED_VERTEX -DVERTEX_COLOR shaders\%%m.vert -o SPRV/%%mpackedcolorvert.spv
+)
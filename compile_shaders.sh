@@ -24,4 +24,12 @@ do
 	echo ../$dir/${v%.*}frag.spv
 done
 
+# Model vertex shaders also get packed vertex variants, see vertex_input.glsl
+for m in shader shaderLight shaderLightBlend
+do
+	glslc -DPACKED_VERTEX $m.vert -o ../$dir/${m}packedvert.spv
+	glslc -DPACKED_VERTEX -DVERTEX_COLOR $m.vert -o ../$dir/${m}packedcolorvert.spv
+	echo ../$dir/${m}packedvert.spv ../$dir/${m}packedcolorvert.spv
+done
+
 cd ..
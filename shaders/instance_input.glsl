@@ -0,0 +1,16 @@
+// Per instance data Renderer writes every frame, instances of one draw are consecutive from its first instance
+struct InstanceData
+{
+    mat4 model;
+
+    vec4 ambient;
+    vec4 diffusive;
+    vec4 specular;
+
+    int id;
+};
+
+layout(std430, set = 0, binding = 4) readonly buffer InstanceBuffer
+{
+    InstanceData instances[];
+};
@@ -15,17 +15,8 @@ layout(set = 0, binding = 1) uniform LightBufferObject
     float spec_str;
 } light;
 
-//push constants block
-layout( push_constant ) uniform constants
-{
-    mat4 model;
-
-    vec4 pushAmbient;
-    vec4 pushDiffusive;
-    vec4 pushSpecular;
-
-    int id;
-} pushModel;
+// Instance id passed on by the vertex shader
+layout(location = 5) flat in int inId;
 
 layout(set = 1, binding = 0) uniform sampler2D texSampler;
 layout(set = 1, binding = 1) uniform sampler2D diffMap;
@@ -37,5 +28,5 @@ layout(location = 1) out int outId;
 void main()
 {
     outColor = texture(texSampler, fragTexCoord) * vec4(fragColor, 1.0f);
-    outId = pushModel.id;
+    outId = inId;
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #version 450
+#extension GL_GOOGLE_include_directive : require
 
 layout(set = 0, binding = 0) uniform UniformBufferObject
 {
@@ -7,29 +8,18 @@ layout(set = 0, binding = 0) uniform UniformBufferObject
     vec3 viewPosition;
 } ubo;
 
-//push constants block
-layout( push_constant ) uniform constants
-{
-    mat4 model;
-
-    vec4 pushAmbient;
-    vec4 pushDiffusive;
-    vec4 pushSpecular;
-
-    int id;
-} pushModel;
-
-layout(location = 0) in vec3 inPosition;
-layout(location = 1) in vec3 inColor;
-layout(location = 2) in vec2 inTexCoord;
-layout(location = 3) in vec3 inNormal;
+#include "instance_input.glsl"
+#include "vertex_input.glsl"
 
 layout(location = 0) out vec3 fragColor;
 layout(location = 1) out vec2 fragTexCoord;
+layout(location = 5) flat out int outId;
 
 void main()
 {
-    gl_Position = ubo.proj * ubo.view * pushModel.model * vec4(inPosition, 1.0);
+    InstanceData instance = instances[gl_InstanceIndex];
+    gl_Position = ubo.proj * ubo.view * instance.model * vec4(inPosition, 1.0);
     fragColor = inColor;
     fragTexCoord = inTexCoord;
+    outId = instance.id;
 }
\ No newline at end of file
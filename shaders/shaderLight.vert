@@ -1,4 +1,5 @@
 #version 450
+#extension GL_GOOGLE_include_directive : require
 
 layout(set = 0, binding = 0) uniform UniformBufferObject
 {
@@ -11,35 +12,30 @@ layout(set = 0, binding = 0) uniform UniformBufferObject
     int spot_size;
 } ubo;
 
-//push constants block
-layout( push_constant ) uniform constants
-{
-    mat4 model;
-
-    vec4 pushAmbient;
-    vec4 pushDiffusive;
-    vec4 pushSpecular;
-
-    int id;
-} pushModel;
-
-layout(location = 0) in vec3 inPosition;
-layout(location = 1) in vec3 inColor;
-layout(location = 2) in vec2 inTexCoord;
-layout(location = 3) in vec3 inNormal;
+#include "instance_input.glsl"
+#include "vertex_input.glsl"
 
 layout(location = 0) out vec3 fragColor;
 layout(location = 1) out vec2 fragTexCoord;
 layout(location = 2) out vec3 outNormal;
 layout(location = 3) out vec3 outPosition;
 layout(location = 4) out vec3 outViewPosition;
+layout(location = 5) flat out int outId;
+layout(location = 6) flat out vec4 outAmbient;
+layout(location = 7) flat out vec4 outDiffusive;
+layout(location = 8) flat out vec4 outSpecular;
 
 void main()
 {
-    gl_Position = ubo.proj * ubo.view * pushModel.model * vec4(inPosition, 1.0);
+    InstanceData instance = instances[gl_InstanceIndex];
+    gl_Position = ubo.proj * ubo.view * instance.model * vec4(inPosition, 1.0);
     fragColor = inColor;
     fragTexCoord = inTexCoord;
-    outNormal = inNormal;
-    outPosition = vec3(pushModel.model * vec4(inPosition, 1.0));
+    outNormal = vertexNormal();
+    outPosition = vec3(instance.model * vec4(inPosition, 1.0));
     outViewPosition = ubo.viewPosition;
+    outId = instance.id;
+    outAmbient = instance.ambient;
+    outDiffusive = instance.diffusive;
+    outSpecular = instance.specular;
 }
\ No newline at end of file
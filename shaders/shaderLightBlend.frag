@@ -84,17 +84,11 @@ layout(set = 1, binding = 0) uniform sampler2D texSampler;
 layout(set = 1, binding = 1) uniform sampler2D diffMap;
 layout(set = 1, binding = 2) uniform sampler2D specMap;
 
-//push constants block
-layout( push_constant ) uniform constants
-{
-    mat4 model;
-
-    vec4 pushAmbient;
-    vec4 pushDiffusive;
-    vec4 pushSpecular;
-
-    int id;
-} pushModel;
+// Instance values passed on by the vertex shader
+layout(location = 5) flat in int inId;
+layout(location = 6) flat in vec4 inAmbient;
+layout(location = 7) flat in vec4 inDiffusive;
+layout(location = 8) flat in vec4 inSpecular;
 
 layout(location = 0) out vec4 outColor;
 layout(location = 1) out int outId;
@@ -130,7 +124,7 @@ void main()
 
     //result *= fragColor;
     outColor = vec4(new_res, result.a);
-    outId = pushModel.id;
+    outId = inId;
 }
 
 vec3 calcDirLight(LightBufferObject light, vec3 normal, vec3 viewDir)
@@ -140,9 +134,9 @@ vec3 calcDirLight(LightBufferObject light, vec3 normal, vec3 viewDir)
     vec3 reflectDir = reflect(-LightDir, normal);
     float spec = pow(max(dot(viewDir, reflectDir), 0.0), 64.0);
 
-    vec3 ambient = light.ambient * pushModel.pushAmbient.xyz * vec3(texture(texSampler, fragTexCoord));
-    vec3 diffuse = light.diffusive * diff * pushModel.pushDiffusive.xyz * vec3(texture(diffMap, fragTexCoord));
-    vec3 specular = light.specular * spec * pushModel.pushSpecular.xyz * vec3(texture(specMap, fragTexCoord));
+    vec3 ambient = light.ambient * inAmbient.xyz * vec3(texture(texSampler, fragTexCoord));
+    vec3 diffuse = light.diffusive * diff * inDiffusive.xyz * vec3(texture(diffMap, fragTexCoord));
+    vec3 specular = light.specular * spec * inSpecular.xyz * vec3(texture(specMap, fragTexCoord));
 
     return ambient + diffuse + specular;
 }
@@ -157,9 +151,9 @@ vec3 calcPointLight(PointLightBuffer light, vec3 normal, vec3 fragPos, vec3 view
     float distance = length(light.position - fragPos);
     float attenuation = 1.0f / (light.constant + light.linear * distance + light.quadratic * (distance * distance));
 
-    vec3 ambient = light.ambient * pushModel.pushAmbient.xyz * vec3(texture(texSampler, fragTexCoord));
-    vec3 diffuse = light.diffusive * diff * pushModel.pushDiffusive.xyz * vec3(texture(diffMap, fragTexCoord));
-    vec3 specular = light.specular * spec * pushModel.pushSpecular.xyz * vec3(texture(specMap, fragTexCoord));
+    vec3 ambient = light.ambient * inAmbient.xyz * vec3(texture(texSampler, fragTexCoord));
+    vec3 diffuse = light.diffusive * diff * inDiffusive.xyz * vec3(texture(diffMap, fragTexCoord));
+    vec3 specular = light.specular * spec * inSpecular.xyz * vec3(texture(specMap, fragTexCoord));
 
     ambient *= attenuation;
     diffuse *= attenuation;
@@ -182,9 +176,9 @@ vec3 calcSpotLight(SpotLightBuffer light, vec3 normal, vec3 fragPos, vec3 viewDi
     float epsilon = light.cut_off - light.outer_cutoff;
     float intensity = clamp((theta - light.outer_cutoff) / epsilon, 0.0, 1.0);
 
-    vec3 ambient = light.ambient * pushModel.pushAmbient.xyz * vec3(texture(texSampler, fragTexCoord));
-    vec3 diffuse = light.diffusive * diff * pushModel.pushDiffusive.xyz * vec3(texture(diffMap, fragTexCoord));
-    vec3 specular = light.specular * spec * pushModel.pushSpecular.xyz * vec3(texture(specMap, fragTexCoord));
+    vec3 ambient = light.ambient * inAmbient.xyz * vec3(texture(texSampler, fragTexCoord));
+    vec3 diffuse = light.diffusive * diff * inDiffusive.xyz * vec3(texture(diffMap, fragTexCoord));
+    vec3 specular = light.specular * spec * inSpecular.xyz * vec3(texture(specMap, fragTexCoord));
 
     ambient *= attenuation * intensity;
     diffuse *= attenuation * intensity;
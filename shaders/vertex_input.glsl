@@ -0,0 +1,36 @@
+// Model vertex attributes for every vertex layout, PACKED_VERTEX and VERTEX_COLOR select the packed ones
+#ifdef PACKED_VERTEX
+
+// Unsigned normalized position in the mesh bounds, model matrix maps it back
+layout(location = 0) in vec3 inPosition;
+#ifdef VERTEX_COLOR
+layout(location = 1) in vec3 inColor;
+#else
+const vec3 inColor = vec3(1.0);
+#endif
+layout(location = 2) in vec2 inTexCoord;
+// Octahedral encoded normal
+layout(location = 3) in vec2 inPackedNormal;
+
+vec3 vertexNormal()
+{
+    vec3 normal = vec3(inPackedNormal, 1.0 - abs(inPackedNormal.x) - abs(inPackedNormal.y));
+    float fold = max(-normal.z, 0.0);
+    normal.x += normal.x >= 0.0 ? -fold : fold;
+    normal.y += normal.y >= 0.0 ? -fold : fold;
+    return normalize(normal);
+}
+
+#else
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inColor;
+layout(location = 2) in vec2 inTexCoord;
+layout(location = 3) in vec3 inNormal;
+
+vec3 vertexNormal()
+{
+    return inNormal;
+}
+
+#endif
@@ -100,7 +100,7 @@ bool omp::Asset::saveAsset()
                 WARN(LogAssetManager, "Metadata saving error");
             };
 
-            return m_Parser.writeToFile(m_Metadata.path_on_disk);
+            return m_Parser.writeToFile(m_Metadata.path_on_disk, m_FileFormat);
         }
         else
         {
@@ -147,6 +147,29 @@ void omp::Asset::specifyMetaData(omp::MetaData&& metadata)
     m_Metadata = metadata;
 }
 
+void omp::Asset::setFileFormat(EJsonFormat inFormat)
+{
+    std::lock_guard<std::mutex> lock(m_Access);
+    m_FileFormat = inFormat;
+}
+
+void omp::Asset::setThreadPool(omp::ThreadPool* inThreadPool)
+{
+    std::lock_guard<std::mutex> lock(m_Access);
+    m_ThreadPool = inThreadPool;
+}
+
+void omp::Asset::appendSourceFiles(std::vector<std::string>& outPaths) const
+{
+    std::lock_guard<std::mutex> lock(m_Access);
+    if (!m_Metadata || m_IsLoaded || !m_Parser.contains(MAIN_DATA_KEY))
+    {
+        return;
+    }
+    JsonParser<> main_parser = m_Parser.readObject(MAIN_DATA_KEY);
+    omp::ObjectFactory::appendSourceFiles(m_Metadata.class_id, main_parser, outPaths);
+}
+
 void omp::Asset::addChild(const std::shared_ptr<omp::Asset>& asset)
 {
     if (asset.get())
@@ -8,6 +8,8 @@
 
 namespace omp
 {
+    class ThreadPool;
+
     struct AssetHandle
     {
         using handle_type = omp::SerializableObject::SerializationId;
@@ -106,6 +108,10 @@ namespace omp
         mutable std::mutex m_Access;
 
         bool m_IsLoaded = false;
+        // Format used when asset is saved, project wide setting
+        EJsonFormat m_FileFormat = EJsonFormat::Text;
+        // Pool available to the object while it deserializes, set by manager before load
+        omp::ThreadPool* m_ThreadPool = nullptr;
 
     // Methods //
     // ======= //
@@ -119,6 +125,10 @@ namespace omp
         bool saveAsset();
         void specifyFileData(JsonParser<>&& fileData);
         void specifyMetaData(omp::MetaData&& metadata);
+        void setFileFormat(EJsonFormat inFormat);
+        void setThreadPool(omp::ThreadPool* inThreadPool);
+        // Files object reads while loading, so they can be read ahead in one batch
+        void appendSourceFiles(std::vector<std::string>& outPaths) const;
 
         /*
          * @brief Additionally add self as parent
@@ -134,6 +144,7 @@ namespace omp
         void resetHierarchy();
 
         std::shared_ptr<SerializableObject> getObject() const;
+        omp::ThreadPool* getThreadPool() const { return m_ThreadPool; }
         template< typename T >
         std::shared_ptr<T> getObjectAs() const
         {
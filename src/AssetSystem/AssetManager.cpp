@@ -11,12 +11,15 @@
 #include "SceneEntityFactory.h"
 #include "LightSystem.h"
 #include "Rendering/Model.h"
+#include "AssetSystem/ContentCache.h"
+#include "IO/JsonConverter.h"
 
 using namespace std::filesystem;
 
 omp::AssetManager::AssetManager(omp::ThreadPool* threadPool)
     : m_AssetRegistry()
     , m_ThreadPool(threadPool)
+    , m_FileReader(std::make_unique<omp::AsyncFileReader>(threadPool))
 {
     omp::ObjectFactory::registerClass<omp::TextureSrc>("TextureSrc");
     omp::ObjectFactory::registerClass<omp::Model>("Model");
@@ -41,6 +44,9 @@ omp::AssetManager::~AssetManager()
 
 void omp::AssetManager::loadProject(const std::string& inPath)
 {
+    m_ProjectPath = inPath;
+    omp::ContentCache::resetStatistics();
+    loadProjectSettings();
     loadAssetsFromDrive(inPath);
 }
 
@@ -165,6 +171,8 @@ omp::AssetHandle omp::AssetManager::createAsset(const std::string& inName, const
     if (new_asset)
     {
         m_PathRegistry.emplace(inPath, id);
+        new_asset->setFileFormat(m_AssetFormat);
+        new_asset->setThreadPool(m_ThreadPool);
         new_asset->specifyMetaData(std::move(init_metadata));
         new_asset->createObject();
     }
@@ -200,41 +208,85 @@ void omp::AssetManager::loadAssetsFromDrive(const std::string& path)
 {
     OMP_STAT_SCOPE("LoadAssetsFromDrive");
 
+    std::vector<std::string> paths;
+    collectAssetPaths(path, paths);
+
+    // All asset files are read in one batch, parsed on the pool as reads complete
+    std::vector<std::shared_ptr<omp::Asset>> assets(paths.size());
+    std::future<void> reads = m_FileReader->readFiles(paths, [this, &paths, &assets](size_t inIndex, std::string&& inData, bool inSuccess)
+    {
+        if (!inSuccess)
+        {
+            ERROR(LogAssetManager, "Cannot read asset file: {}", paths[inIndex]);
+            return;
+        }
+        assets[inIndex] = createAssetFromData(paths[inIndex], std::move(inData));
+    });
+    waitForReads(reads);
+
+    // Registries are not thread safe, fill them in directory order
+    for (size_t i = 0; i < paths.size(); i++)
+    {
+        if (assets[i])
+        {
+            registerLoadedAsset(paths[i], assets[i]);
+        }
+    }
+}
+
+void omp::AssetManager::collectAssetPaths(const std::string& path, std::vector<std::string>& outPaths) const
+{
     directory_iterator directory{std::filesystem::path(path)};
     for (auto iter: directory)
     {
         if (iter.is_directory())
         {
             std::string temp_path = iter.path().generic_string();
-            loadAssetsFromDrive(temp_path);
+            collectAssetPaths(temp_path, outPaths);
         }
         if (iter.path().extension().string() == ASSET_FORMAT)
         {
-            loadAssetFromFileSystem_internal(iter.path().string());
+            outPaths.push_back(iter.path().string());
         }
     }
 }
 
-void omp::AssetManager::loadAssetFromFileSystem_internal(const std::string& inPath)
+std::shared_ptr<omp::Asset> omp::AssetManager::createAssetFromData(const std::string& inPath, std::string&& inData) const
 {
     JsonParser<> file_data{};
-    if (file_data.populateFromFile(inPath))
+    if (!file_data.populateFromData(std::move(inData), inPath))
     {
-        std::shared_ptr<omp::Asset> asset = std::make_shared<omp::Asset>((std::move(file_data)));
-        if (asset->loadMetadata())
-        {
-            omp::MetaData meta = asset->getMetaData();
-            m_AssetRegistry.add_or_update_mapping(meta.asset_id, asset);
-            m_PathRegistry.emplace(meta.path_on_disk, meta.asset_id);
-            INFO(LogAssetManager, "Asset loaded successfully: {0}", inPath);
-        }
-        else
-        {
-            ERROR(LogAssetManager, "Cannot load asset metadata: {}", inPath);
-            // should not be possible
-            // TODO: assert
-        }
+        return nullptr;
+    }
+
+    std::shared_ptr<omp::Asset> asset = std::make_shared<omp::Asset>((std::move(file_data)));
+    asset->setFileFormat(m_AssetFormat);
+    asset->setThreadPool(m_ThreadPool);
+    if (!asset->loadMetadata())
+    {
+        ERROR(LogAssetManager, "Cannot load asset metadata: {}", inPath);
+        // should not be possible
+        // TODO: assert
+        return nullptr;
     }
+    return asset;
+}
+
+void omp::AssetManager::registerLoadedAsset(const std::string& inPath, const std::shared_ptr<omp::Asset>& asset)
+{
+    omp::MetaData meta = asset->getMetaData();
+    m_AssetRegistry.add_or_update_mapping(meta.asset_id, asset);
+    m_PathRegistry.emplace(meta.path_on_disk, meta.asset_id);
+    INFO(LogAssetManager, "Asset loaded successfully: {0}", inPath);
+}
+
+void omp::AssetManager::waitForReads(std::future<void>& reads) const
+{
+    if (m_ThreadPool)
+    {
+        m_ThreadPool->wait(reads);
+    }
+    reads.get();
 }
 
 std::future<std::weak_ptr<omp::Asset>> omp::AssetManager::loadAssetAsync(AssetHandle assetHandle)
@@ -245,16 +297,16 @@ std::future<std::weak_ptr<omp::Asset>> omp::AssetManager::loadAssetAsync(AssetHa
     {
         if (m_ThreadPool)
         {
-            result = m_ThreadPool->submit([found_asset, this]()
+            result = m_ThreadPool->submit([assetHandle, this]()
             {
-                return loadAssetInternal(found_asset);
+                return loadAsset(assetHandle);
             });
         }
         else
         {
             std::promise<std::weak_ptr<Asset>> prom;
             result = prom.get_future();
-            prom.set_value(loadAssetInternal(found_asset));
+            prom.set_value(loadAsset(assetHandle));
             return result;
         }
     }
@@ -306,7 +358,11 @@ std::weak_ptr<omp::Asset> omp::AssetManager::loadAsset(AssetHandle assetHandle)
     std::weak_ptr<Asset> result;
     if (found_asset)
     {
+        // Loads may run in parallel, each drops only leftovers of its own batch
+        std::vector<std::string> prefetched_paths;
+        prefetchSourceFiles(found_asset, prefetched_paths);
         result = loadAssetInternal(found_asset);
+        omp::ContentCache::clearPrefetched(prefetched_paths);
     }
     else
     {
@@ -332,14 +388,60 @@ std::weak_ptr<omp::Asset> omp::AssetManager::loadAssetInternal(const std::shared
     {
         INFO(LogAssetManager, "Start loading dependency for asset {}, dependency: {}", metadata.asset_id, dependency_id);
 
-        std::weak_ptr<omp::Asset> child = loadAsset(dependency_id);
-        asset->addChild(child.lock());
+        std::shared_ptr<omp::Asset> child = m_AssetRegistry.value_for(dependency_id, nullptr);
+        if (!child)
+        {
+            ERROR(LogAssetManager, "Cant find asset with id {0}", dependency_id);
+            continue;
+        }
+        loadAssetInternal(child);
+        asset->addChild(child);
     }
 
     asset->tryLoadObject();
     return std::weak_ptr<omp::Asset>(asset);
 }
 
+void omp::AssetManager::prefetchSourceFiles(const std::shared_ptr<omp::Asset>& asset, std::vector<std::string>& outPaths)
+{
+    OMP_STAT_SCOPE("PrefetchSourceFiles");
+
+    std::unordered_set<AssetHandle::handle_type> visited;
+    collectSourceFiles(asset, visited, outPaths);
+    if (outPaths.empty())
+    {
+        return;
+    }
+
+    std::future<void> reads = m_FileReader->readFiles(outPaths, [&outPaths](size_t inIndex, std::string&& inData, bool inSuccess)
+    {
+        if (inSuccess)
+        {
+            omp::ContentCache::prefetchFile(outPaths[inIndex], std::move(inData));
+        }
+    });
+    waitForReads(reads);
+}
+
+void omp::AssetManager::collectSourceFiles(const std::shared_ptr<omp::Asset>& asset, std::unordered_set<AssetHandle::handle_type>& visited, std::vector<std::string>& outPaths) const
+{
+    omp::MetaData metadata = asset->getMetaData();
+    if (!visited.insert(metadata.asset_id).second)
+    {
+        return;
+    }
+
+    asset->appendSourceFiles(outPaths);
+    for (auto dependency_id : metadata.dependencies)
+    {
+        std::shared_ptr<omp::Asset> child = m_AssetRegistry.value_for(dependency_id, nullptr);
+        if (child)
+        {
+            collectSourceFiles(child, visited, outPaths);
+        }
+    }
+}
+
 std::weak_ptr<omp::Asset> omp::AssetManager::getAsset(AssetHandle assetHandle) const
 {
     std::shared_ptr<Asset> found_asset = m_AssetRegistry.value_for(assetHandle, nullptr);
@@ -360,3 +462,67 @@ std::weak_ptr<omp::Asset> omp::AssetManager::getAsset(const std::string& inPath)
     return std::weak_ptr<omp::Asset>();
 }
 
+
+void omp::AssetManager::reportContentStatistics() const
+{
+    omp::ContentCache::logStatistics(m_ProjectPath);
+}
+
+void omp::AssetManager::setAssetFormat(EJsonFormat inFormat)
+{
+    m_AssetFormat = inFormat;
+    m_AssetRegistry.foreach([inFormat](std::pair<AssetHandle, std::shared_ptr<omp::Asset>>& asset)
+    {
+        asset.second->setFileFormat(inFormat);
+    });
+
+    if (!saveProjectSettings())
+    {
+        WARN(LogAssetManager, "Cant save project settings for project {}", m_ProjectPath);
+    }
+}
+
+bool omp::AssetManager::convertProject(EJsonFormat inFormat)
+{
+    OMP_STAT_SCOPE("ConvertProject");
+
+    setAssetFormat(inFormat);
+
+    bool success = true;
+    for (const auto& [path, id] : m_PathRegistry)
+    {
+        if (!omp::JsonConverter::convertFile(path, path, inFormat))
+        {
+            ERROR(LogAssetManager, "Cant convert asset {} to {}", path, omp::JsonConverter::formatName(inFormat));
+            success = false;
+        }
+    }
+
+    INFO(LogAssetManager, "Project {} converted to {} format", m_ProjectPath, omp::JsonConverter::formatName(inFormat));
+    return success;
+}
+
+void omp::AssetManager::loadProjectSettings()
+{
+    m_AssetFormat = EJsonFormat::Text;
+
+    std::string settings_path = (std::filesystem::path(m_ProjectPath) / PROJECT_SETTINGS_FILE).string();
+    if (!std::filesystem::exists(settings_path))
+    {
+        return;
+    }
+
+    JsonParser<> settings;
+    if (settings.populateFromFile(settings_path))
+    {
+        std::string format_name = settings.readValue<std::string>(ASSET_FORMAT_KEY).value_or("Text");
+        m_AssetFormat = omp::JsonConverter::formatFromName(format_name).value_or(EJsonFormat::Text);
+    }
+}
+
+bool omp::AssetManager::saveProjectSettings() const
+{
+    JsonParser<> settings;
+    settings.writeValue(ASSET_FORMAT_KEY, std::string(omp::JsonConverter::formatName(m_AssetFormat)));
+    return settings.writeToFile((std::filesystem::path(m_ProjectPath) / PROJECT_SETTINGS_FILE).string());
+}
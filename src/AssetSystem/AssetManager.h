@@ -7,6 +7,7 @@
 #include "AssetSystem/Asset.h"
 #include "AssetSystem/ObjectFactory.h"
 #include "Async/ThreadPool.h"
+#include "IO/AsyncFileReader.h"
 
 namespace omp
 {
@@ -15,8 +16,11 @@ namespace omp
     private:
         omp::threadsafe_map<AssetHandle, std::shared_ptr<Asset>> m_AssetRegistry;
         std::unordered_map<std::string, omp::AssetHandle::handle_type> m_PathRegistry;
+        std::string m_ProjectPath;
+        EJsonFormat m_AssetFormat = EJsonFormat::Text;
 
         omp::ThreadPool* m_ThreadPool = nullptr;
+        std::unique_ptr<omp::AsyncFileReader> m_FileReader;
     public:
 
         AssetManager(omp::ThreadPool* threadPool);
@@ -44,16 +48,45 @@ namespace omp
         [[nodiscard]] std::weak_ptr<Asset> getAsset(AssetHandle assetId) const;
         [[nodiscard]] std::weak_ptr<Asset> getAsset(const std::string& inPath) const;
 
+        /*
+         * Log CPU and GPU memory saved by content deduplication since project was loaded
+         * */
+        void reportContentStatistics() const;
+
+        /*
+         * Format used for saving assets of loaded project, stored in project settings file
+         * */
+        void setAssetFormat(EJsonFormat inFormat);
+        EJsonFormat getAssetFormat() const { return m_AssetFormat; }
+        /*
+         * Rewrite all asset files of the project in specified format and use it for next saves
+         * */
+        bool convertProject(EJsonFormat inFormat);
+
     private:
         void saveAssetsToDrive();
         void loadAssetsFromDrive(const std::string& pathDirectory = ASSET_FOLDER);
-        void loadAssetFromFileSystem_internal(const std::string& inPath);
+        void collectAssetPaths(const std::string& pathDirectory, std::vector<std::string>& outPaths) const;
+        std::shared_ptr<omp::Asset> createAssetFromData(const std::string& inPath, std::string&& inData) const;
+        void registerLoadedAsset(const std::string& inPath, const std::shared_ptr<omp::Asset>& asset);
+        /*
+         * @brief Read source files of asset and its unloaded dependencies in one batch before they are deserialized,
+         * outPaths receives the batch so its leftovers can be dropped
+         * */
+        void prefetchSourceFiles(const std::shared_ptr<omp::Asset>& asset, std::vector<std::string>& outPaths);
+        void collectSourceFiles(const std::shared_ptr<omp::Asset>& asset, std::unordered_set<AssetHandle::handle_type>& visited, std::vector<std::string>& outPaths) const;
+        void waitForReads(std::future<void>& reads) const;
+        void loadProjectSettings();
+        bool saveProjectSettings() const;
         std::weak_ptr<Asset> loadAssetInternal(const std::shared_ptr<omp::Asset>& asset);
 
         // This is the only places to store data
         inline static const std::string ASSET_FOLDER = "../assets/";
 
         inline static const std::string ASSET_FORMAT = ".json";
+        // Not an asset, so not matching ASSET_FORMAT
+        inline static const std::string PROJECT_SETTINGS_FILE = "project.settings";
+        inline static const std::string ASSET_FORMAT_KEY = "AssetFormat";
 
         inline static const std::string NAME_MEMBER = "Name";
         inline static const std::string CLASS_MEMBER = "Class";
@@ -0,0 +1,97 @@
+#include "AssetSystem/ContentCache.h"
+#include "IO/JsonConverter.h"
+#include "Logs.h"
+
+omp::Hash128 omp::ContentCache::hashFile(const std::string& inPath, std::string& outData)
+{
+    if (!takePrefetched(inPath, outData) && !omp::JsonConverter::readFile(inPath, outData))
+    {
+        WARN(LogIO, "Cant read file to hash: {}", inPath);
+        outData.clear();
+        return omp::Hash128{};
+    }
+
+    return omp::HashLib::hash128(outData.data(), outData.size());
+}
+
+void omp::ContentCache::prefetchFile(const std::string& inPath, std::string&& inData)
+{
+    std::lock_guard<std::mutex> lock(s_Access);
+    s_Prefetched.insert_or_assign(inPath, std::move(inData));
+}
+
+bool omp::ContentCache::takePrefetched(const std::string& inPath, std::string& outData)
+{
+    std::lock_guard<std::mutex> lock(s_Access);
+    auto iter = s_Prefetched.find(inPath);
+    if (iter == s_Prefetched.end())
+    {
+        return false;
+    }
+    outData = std::move(iter->second);
+    s_Prefetched.erase(iter);
+    return true;
+}
+
+void omp::ContentCache::clearPrefetched(const std::vector<std::string>& inPaths)
+{
+    std::lock_guard<std::mutex> lock(s_Access);
+    for (const std::string& path : inPaths)
+    {
+        s_Prefetched.erase(path);
+    }
+}
+
+omp::ContentCacheStatistics omp::ContentCache::getStatistics()
+{
+    std::lock_guard<std::mutex> lock(s_Access);
+    return s_Statistics;
+}
+
+void omp::ContentCache::resetStatistics()
+{
+    std::lock_guard<std::mutex> lock(s_Access);
+    s_Statistics = ContentCacheStatistics{};
+    for (EntryTable& table : s_CpuEntries)
+    {
+        pruneExpired(table);
+    }
+    for (EntryTable& table : s_GpuEntries)
+    {
+        pruneExpired(table);
+    }
+}
+
+size_t omp::ContentCache::getEntryCount()
+{
+    std::lock_guard<std::mutex> lock(s_Access);
+    size_t count = 0;
+    for (const EntryTable& table : s_CpuEntries)
+    {
+        count += table.entries.size();
+    }
+    for (const EntryTable& table : s_GpuEntries)
+    {
+        count += table.entries.size();
+    }
+    return count;
+}
+
+void omp::ContentCache::pruneExpired(EntryTable& table)
+{
+    std::erase_if(table.entries, [](const std::pair<const omp::Hash128, Entry>& inEntry)
+    {
+        return inEntry.second.data.expired();
+    });
+    // Next sweep once live entries double, so sweeping stays linear in insertions
+    table.prune_size = table.entries.size() * 2;
+}
+
+void omp::ContentCache::logStatistics(const std::string& inProjectPath)
+{
+    ContentCacheStatistics stats = getStatistics();
+    INFO(LogAssetManager, "Content cache for project {}: CPU {} unique, {} reused, {} bytes saved; GPU {} unique, {} reused, {} bytes saved",
+         inProjectPath,
+         stats.cpu_entries, stats.cpu_hits, stats.cpu_bytes_saved,
+         stats.gpu_entries, stats.gpu_hits, stats.gpu_bytes_saved);
+}
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Math/Hash.h"
+
+namespace omp
+{
+    enum class EContentType
+    {
+        Texture = 0,
+        Mesh,
+        Max
+    };
+
+    struct ContentCacheStatistics
+    {
+        size_t cpu_entries = 0;
+        size_t cpu_hits = 0;
+        size_t cpu_bytes_saved = 0;
+        size_t gpu_entries = 0;
+        size_t gpu_hits = 0;
+        size_t gpu_bytes_saved = 0;
+    };
+
+    /**
+     * @brief Content addressed storage for decoded source files and their GPU resources.
+     * Entries are keyed by hash of the source bytes, so same file imported by different assets
+     * or byte identical files with different names are decoded and uploaded once.
+     * Cache holds weak references, entry lives while at least one object uses it. Expired entries are erased
+     * when their hash is looked up, and swept whenever a table doubles or statistics are reset.
+     * Cached type must provide getByteSize().
+     */
+    class ContentCache final
+    {
+    private:
+        struct Entry
+        {
+            std::weak_ptr<void> data;
+            size_t byte_size = 0;
+        };
+        using EntryMap = std::unordered_map<omp::Hash128, Entry>;
+
+        static constexpr size_t MIN_PRUNE_SIZE = 64;
+
+        struct EntryTable
+        {
+            EntryMap entries;
+            // Size at which expired entries are swept next, never below MIN_PRUNE_SIZE.
+            // No initializer, tables are value initialized as static members of the enclosing class
+            size_t prune_size;
+        };
+
+        inline static std::mutex s_Access{};
+        inline static std::array<EntryTable, static_cast<size_t>(EContentType::Max)> s_CpuEntries{};
+        inline static std::array<EntryTable, static_cast<size_t>(EContentType::Max)> s_GpuEntries{};
+        inline static ContentCacheStatistics s_Statistics{};
+        // Source files read ahead in batches, consumed by hashFile and takePrefetched
+        inline static std::unordered_map<std::string, std::string> s_Prefetched{};
+
+        template< typename T, typename Creator >
+        static std::shared_ptr<T> acquireInternal(EntryTable& table, const omp::Hash128& hash, Creator&& creator, bool isGpu);
+        // Erase entries nobody uses anymore, s_Access must be held
+        static void pruneExpired(EntryTable& table);
+
+    public:
+        /*
+         * @brief Return decoded data for hash, creator called only when nothing alive is cached
+         */
+        template< typename T, typename Creator >
+        static std::shared_ptr<T> acquireCpu(EContentType type, const omp::Hash128& hash, Creator&& creator);
+
+        /*
+         * @brief Same as acquireCpu, but for resources already uploaded to GPU
+         */
+        template< typename T, typename Creator >
+        static std::shared_ptr<T> acquireGpu(EContentType type, const omp::Hash128& hash, Creator&& creator);
+
+        /*
+         * @brief Read file, or take its prefetched contents, and hash them
+         */
+        static omp::Hash128 hashFile(const std::string& inPath, std::string& outData);
+        static void prefetchFile(const std::string& inPath, std::string&& inData);
+        // Move prefetched contents out, false if file was not prefetched
+        static bool takePrefetched(const std::string& inPath, std::string& outData);
+        // Drop prefetched files of a batch nobody asked for, other batches keep theirs
+        static void clearPrefetched(const std::vector<std::string>& inPaths);
+
+        static ContentCacheStatistics getStatistics();
+        // Also sweeps expired entries of every table
+        static void resetStatistics();
+        // Entries held by the cache, expired ones included until they are erased
+        static size_t getEntryCount();
+        static void logStatistics(const std::string& inProjectPath);
+
+        ContentCache() = delete;
+        ~ContentCache() = delete;
+        ContentCache(const ContentCache&) = delete;
+        ContentCache(ContentCache&&) = delete;
+        ContentCache& operator=(const ContentCache&) = delete;
+        ContentCache& operator=(ContentCache&&) = delete;
+    };
+}
+
+template< typename T, typename Creator >
+std::shared_ptr<T> omp::ContentCache::acquireInternal(EntryTable& table, const omp::Hash128& hash, Creator&& creator, bool isGpu)
+{
+    if (!hash.isValid())
+    {
+        return creator();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(s_Access);
+        auto iter = table.entries.find(hash);
+        if (iter != table.entries.end())
+        {
+            std::shared_ptr<void> alive = iter->second.data.lock();
+            if (alive)
+            {
+                size_t& hits = isGpu ? s_Statistics.gpu_hits : s_Statistics.cpu_hits;
+                size_t& saved = isGpu ? s_Statistics.gpu_bytes_saved : s_Statistics.cpu_bytes_saved;
+                hits++;
+                saved += iter->second.byte_size;
+                return std::static_pointer_cast<T>(alive);
+            }
+            table.entries.erase(iter);
+        }
+    }
+
+    // Creation is expensive, do not block other imports
+    std::shared_ptr<T> created = creator();
+    if (!created)
+    {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(s_Access);
+    if (table.entries.size() >= std::max(table.prune_size, MIN_PRUNE_SIZE))
+    {
+        pruneExpired(table);
+    }
+    Entry& entry = table.entries[hash];
+    std::shared_ptr<void> alive = entry.data.lock();
+    if (alive)
+    {
+        // Someone created same content while we were decoding, keep single copy
+        return std::static_pointer_cast<T>(alive);
+    }
+    size_t& entries = isGpu ? s_Statistics.gpu_entries : s_Statistics.cpu_entries;
+    entries++;
+    entry.data = created;
+    entry.byte_size = created->getByteSize();
+    return created;
+}
+
+template< typename T, typename Creator >
+std::shared_ptr<T> omp::ContentCache::acquireCpu(EContentType type, const omp::Hash128& hash, Creator&& creator)
+{
+    return acquireInternal<T>(s_CpuEntries[static_cast<size_t>(type)], hash, std::forward<Creator>(creator), false);
+}
+
+template< typename T, typename Creator >
+std::shared_ptr<T> omp::ContentCache::acquireGpu(EContentType type, const omp::Hash128& hash, Creator&& creator)
+{
+    return acquireInternal<T>(s_GpuEntries[static_cast<size_t>(type)], hash, std::forward<Creator>(creator), true);
+}
@@ -4,6 +4,7 @@
 #include <string>
 #include <unordered_map>
 #include <functional>
+#include <vector>
 
 // DEPRECATED
 //#define ADD_CLASS(ClassName) { typeid(std::decay_t<ClassName>).name(), new omp::ClassType<ClassName>() }
@@ -13,13 +14,33 @@ namespace omp
     class ObjectFactory final
     {
     private:
+        using SourceFilesCollector = std::function<void(const JsonParser<>&, std::vector<std::string>&)>;
+
         inline static std::unordered_map<std::string, std::function<std::shared_ptr<SerializableObject>()>> m_CreationMap{};
+        // Classes loading content from other files, like textures and meshes
+        inline static std::unordered_map<std::string, SourceFilesCollector> m_SourceFilesMap{};
     public:
 
         template< typename T >
         inline static void registerClass(const std::string& inClassName)
         {
             m_CreationMap.insert( {inClassName, []{ return std::make_shared<T>(); }} );
+            if constexpr (requires(const JsonParser<>& parser, std::vector<std::string>& paths) { T::appendSourceFiles(parser, paths); })
+            {
+                m_SourceFilesMap.insert( {inClassName, &T::appendSourceFiles} );
+            }
+        }
+
+        /*
+         * @brief Add files object of inClassName will read while deserializing from parser
+         * */
+        inline static void appendSourceFiles(const std::string& inClassName, const JsonParser<>& parser, std::vector<std::string>& outPaths)
+        {
+            auto iter = m_SourceFilesMap.find(inClassName);
+            if (iter != m_SourceFilesMap.end())
+            {
+                iter->second(parser, outPaths);
+            }
         }
 
         [[nodiscard]] inline static std::shared_ptr<SerializableObject> createSerializableObject(const std::string& inClassName)
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace omp
+{
+    /**
+     * @brief Where asset data stays once loaded. GPU only drops decoded CPU copies as soon as upload completes,
+     * they are read from the source file again when something needs them. CPU only is never uploaded
+     */
+    enum class EResidency : uint8_t
+    {
+        GpuOnly = 0,
+        CpuAndGpu,
+        CpuOnly
+    };
+
+    inline bool keepsCpuCopy(EResidency inResidency)
+    {
+        return inResidency != EResidency::GpuOnly;
+    }
+
+    inline bool uploadsToGpu(EResidency inResidency)
+    {
+        return inResidency != EResidency::CpuOnly;
+    }
+
+    inline std::string residencyToString(EResidency inResidency)
+    {
+        switch (inResidency)
+        {
+            case EResidency::CpuAndGpu:
+                return "CpuAndGpu";
+            case EResidency::CpuOnly:
+                return "CpuOnly";
+            case EResidency::GpuOnly:
+                break;
+        }
+        return "GpuOnly";
+    }
+
+    // Unknown names fall back to GPU only
+    inline EResidency residencyFromString(const std::string& inName)
+    {
+        if (inName == "CpuAndGpu")
+        {
+            return EResidency::CpuAndGpu;
+        }
+        if (inName == "CpuOnly")
+        {
+            return EResidency::CpuOnly;
+        }
+        return EResidency::GpuOnly;
+    }
+}
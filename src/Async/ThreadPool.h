@@ -4,6 +4,8 @@
 #include <functional>
 #include <deque>
 #include <future>
+#include <algorithm>
+#include <chrono>
 #include "Core/Profiling.h"
 #include "threadsafe_queue.h"
 
@@ -382,6 +384,53 @@ namespace omp
             return result;
         }
 
+        /*
+         * @brief Block until inFuture is ready, running pending tasks meanwhile, so workers can wait on each other
+         */
+        template< typename T >
+        void wait(const std::future<T>& inFuture)
+        {
+            while (inFuture.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            {
+                runPendingTask();
+            }
+        }
+
+        /*
+         * @brief Split [0, inCount) into chunks of inChunkSize and call f(begin, end) for each chunk on the pool.
+         * Blocks until every chunk is done, waiting thread runs pending tasks so it is safe to call from a worker.
+         * First exception thrown by a chunk is rethrown after all chunks finished.
+         */
+        template< typename FunctionType >
+        void parallelFor(size_t inCount, size_t inChunkSize, FunctionType&& f)
+        {
+            if (inChunkSize == 0 || inCount <= inChunkSize)
+            {
+                f(size_t{0}, inCount);
+                return;
+            }
+
+            std::vector<std::future<void>> chunks;
+            chunks.reserve((inCount + inChunkSize - 1) / inChunkSize);
+            for (size_t begin = 0; begin < inCount; begin += inChunkSize)
+            {
+                const size_t end = std::min(begin + inChunkSize, inCount);
+                chunks.push_back(submit([&f, begin, end]()
+                {
+                    f(begin, end);
+                }));
+            }
+
+            for (std::future<void>& chunk : chunks)
+            {
+                wait(chunk);
+            }
+            for (std::future<void>& chunk : chunks)
+            {
+                chunk.get();
+            }
+        }
+
         void runPendingTask()
         {
             TaskType task;
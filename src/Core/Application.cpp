@@ -80,7 +80,7 @@ void omp::Application::preInit()
 
     m_Renderer = std::make_unique<omp::Renderer>();
     m_Renderer->initVulkan(m_Window, m_Width, m_Height);
-    m_Renderer->initResources();
+    m_Renderer->initResources(m_ThreadPool.get());
 
     wait_assets.wait();
 }
@@ -92,6 +92,7 @@ void omp::Application::init()
     //m_CurrentScene->setCurrentCamera(0);
 
     m_Renderer->loadScene(m_CurrentScene.get());
+    m_AssetManager->reportContentStatistics();
 }
 
 void omp::Application::preDestroy()
@@ -4,5 +4,6 @@
 
 #define OMP_FRAME() FrameMark
 #define OMP_STAT_SCOPE(Name) ZoneScopedN(Name)
+#define OMP_STAT_VALUE(Name, Value) TracyPlot(Name, static_cast<int64_t>(Value))
 #define OMP_STAT_THREAD_BEGIN(Name) FrameMarkStart(Name)
 #define OMP_STAT_THREAD_END(Name) FrameMarkEnd(Name)
@@ -0,0 +1,126 @@
+#include "Core/RangeAllocator.h"
+#include <algorithm>
+#include <iterator>
+#include "Logs.h"
+
+omp::RangeAllocator::RangeAllocator(size_t inCapacity)
+    : m_Capacity(inCapacity)
+{
+    if (inCapacity > 0)
+    {
+        m_FreeBlocks.emplace(0, inCapacity);
+    }
+}
+
+size_t omp::RangeAllocator::allocate(size_t inSize, size_t inAlignment)
+{
+    if (inSize == 0 || inAlignment == 0)
+    {
+        return INVALID_OFFSET;
+    }
+
+    auto best = m_FreeBlocks.end();
+    size_t best_waste = SIZE_MAX;
+    for (auto block = m_FreeBlocks.begin(); block != m_FreeBlocks.end(); ++block)
+    {
+        const size_t aligned = (block->first + inAlignment - 1) / inAlignment * inAlignment;
+        const size_t padding = aligned - block->first;
+        if (block->second < padding || block->second - padding < inSize)
+        {
+            continue;
+        }
+        const size_t waste = block->second - inSize;
+        if (waste < best_waste)
+        {
+            best_waste = waste;
+            best = block;
+            if (waste == padding)
+            {
+                break;
+            }
+        }
+    }
+    if (best == m_FreeBlocks.end())
+    {
+        return INVALID_OFFSET;
+    }
+
+    const size_t block_offset = best->first;
+    const size_t block_size = best->second;
+    const size_t offset = (block_offset + inAlignment - 1) / inAlignment * inAlignment;
+    m_FreeBlocks.erase(best);
+
+    // Padding in front and the tail stay free
+    if (offset > block_offset)
+    {
+        m_FreeBlocks.emplace(block_offset, offset - block_offset);
+    }
+    const size_t tail = block_offset + block_size - (offset + inSize);
+    if (tail > 0)
+    {
+        m_FreeBlocks.emplace(offset + inSize, tail);
+    }
+
+    m_Allocations.emplace(offset, inSize);
+    m_UsedSize += inSize;
+    return offset;
+}
+
+void omp::RangeAllocator::free(size_t inOffset)
+{
+    const auto allocation = m_Allocations.find(inOffset);
+    if (allocation == m_Allocations.end())
+    {
+        WARN(LogCore, "RangeAllocator free of unknown offset {}", inOffset);
+        return;
+    }
+
+    const size_t size = allocation->second;
+    m_Allocations.erase(allocation);
+    m_UsedSize -= size;
+    insertFreeBlock(inOffset, size);
+}
+
+void omp::RangeAllocator::grow(size_t inCapacity)
+{
+    if (inCapacity <= m_Capacity)
+    {
+        return;
+    }
+    const size_t old_capacity = m_Capacity;
+    m_Capacity = inCapacity;
+    insertFreeBlock(old_capacity, inCapacity - old_capacity);
+}
+
+size_t omp::RangeAllocator::getLargestFreeBlock() const
+{
+    size_t largest = 0;
+    for (const auto& [offset, size] : m_FreeBlocks)
+    {
+        largest = std::max(largest, size);
+    }
+    return largest;
+}
+
+void omp::RangeAllocator::insertFreeBlock(size_t inOffset, size_t inSize)
+{
+    size_t offset = inOffset;
+    size_t size = inSize;
+
+    auto next = m_FreeBlocks.lower_bound(offset);
+    if (next != m_FreeBlocks.end() && offset + size == next->first)
+    {
+        size += next->second;
+        next = m_FreeBlocks.erase(next);
+    }
+    if (next != m_FreeBlocks.begin())
+    {
+        auto previous = std::prev(next);
+        if (previous->first + previous->second == offset)
+        {
+            previous->second += size;
+            return;
+        }
+    }
+    m_FreeBlocks.emplace_hint(next, offset, size);
+}
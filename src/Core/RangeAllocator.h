@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+
+namespace omp
+{
+    /*
+     * @brief Sub-allocator of offsets inside one range of inCapacity units, owns no memory itself.
+     * Free blocks are kept sorted by offset, a freed range is merged with free neighbours right away,
+     * so the list never holds two adjacent blocks and fragmentation stays at what live ranges force
+     */
+    class RangeAllocator
+    {
+    public:
+        static constexpr size_t INVALID_OFFSET = SIZE_MAX;
+
+        RangeAllocator() = default;
+        explicit RangeAllocator(size_t inCapacity);
+
+        /*
+         * @brief Best fitting free block, offset is a multiple of inAlignment, which doesn't need to be a power of two
+         * so vertex strides can be used. Returns INVALID_OFFSET when no block fits
+         */
+        size_t allocate(size_t inSize, size_t inAlignment = 1);
+
+        // Range must come from allocate, alignment padding in front of it was returned to the free list already
+        void free(size_t inOffset);
+
+        // Extends capacity, new space joins the last free block when it ends at the old capacity
+        void grow(size_t inCapacity);
+
+        size_t getCapacity() const { return m_Capacity; }
+        size_t getUsedSize() const { return m_UsedSize; }
+        size_t getAllocationCount() const { return m_Allocations.size(); }
+        size_t getFreeBlockCount() const { return m_FreeBlocks.size(); }
+        size_t getLargestFreeBlock() const;
+
+    private:
+        void insertFreeBlock(size_t inOffset, size_t inSize);
+
+        size_t m_Capacity = 0;
+        size_t m_UsedSize = 0;
+        // Offset to size
+        std::map<size_t, size_t> m_FreeBlocks;
+        std::unordered_map<size_t, size_t> m_Allocations;
+    };
+}
@@ -0,0 +1,437 @@
+#include "IO/AsyncFileReader.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include "Async/ThreadPool.h"
+#include "IO/JsonConverter.h"
+#include "Core/Profiling.h"
+#include "Logs.h"
+
+#if defined(OMP_IO_URING)
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+struct omp::AsyncFileReader::Batch
+{
+    ReadCallback callback;
+    std::atomic<size_t> remaining{0};
+    std::promise<void> done;
+    std::mutex error_access;
+    std::exception_ptr error;
+
+    void finish(size_t inIndex, std::string&& inData, bool inSuccess)
+    {
+        try
+        {
+            callback(inIndex, std::move(inData), inSuccess);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(error_access);
+            if (!error)
+            {
+                error = std::current_exception();
+            }
+        }
+
+        if (remaining.fetch_sub(1) == 1)
+        {
+            if (error)
+            {
+                done.set_exception(error);
+            }
+            else
+            {
+                done.set_value();
+            }
+        }
+    }
+};
+
+struct omp::AsyncFileReader::PendingRead
+{
+    int file = -1;
+    size_t offset = 0;
+    std::string data;
+    bool done = false;
+};
+
+#if defined(OMP_IO_URING)
+/*
+ * @brief Minimal io_uring over raw syscalls, only what batched reads need.
+ * Rings are mapped once, requires IORING_FEAT_SINGLE_MMAP (Linux 5.4+)
+ */
+struct omp::AsyncFileReader::IoUring
+{
+    int fd = -1;
+    uint32_t entries = 0;
+
+    void* rings = MAP_FAILED;
+    size_t rings_size = 0;
+    io_uring_sqe* sqes = nullptr;
+    size_t sqes_size = 0;
+
+    uint32_t* sq_head = nullptr;
+    uint32_t* sq_tail = nullptr;
+    uint32_t sq_mask = 0;
+    uint32_t* sq_array = nullptr;
+    uint32_t* cq_head = nullptr;
+    uint32_t* cq_tail = nullptr;
+    uint32_t cq_mask = 0;
+    io_uring_cqe* cqes = nullptr;
+
+    bool init(uint32_t inDepth)
+    {
+        io_uring_params params{};
+        fd = static_cast<int>(syscall(__NR_io_uring_setup, inDepth, &params));
+        if (fd < 0 || !(params.features & IORING_FEAT_SINGLE_MMAP))
+        {
+            return false;
+        }
+
+        size_t sq_size = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+        size_t cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        rings_size = std::max(sq_size, cq_size);
+        rings = mmap(nullptr, rings_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, static_cast<off_t>(IORING_OFF_SQ_RING));
+        if (rings == MAP_FAILED)
+        {
+            return false;
+        }
+
+        sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqes_memory = mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, static_cast<off_t>(IORING_OFF_SQES));
+        if (sqes_memory == MAP_FAILED)
+        {
+            return false;
+        }
+        sqes = static_cast<io_uring_sqe*>(sqes_memory);
+
+        char* base = static_cast<char*>(rings);
+        sq_head = reinterpret_cast<uint32_t*>(base + params.sq_off.head);
+        sq_tail = reinterpret_cast<uint32_t*>(base + params.sq_off.tail);
+        sq_mask = *reinterpret_cast<uint32_t*>(base + params.sq_off.ring_mask);
+        sq_array = reinterpret_cast<uint32_t*>(base + params.sq_off.array);
+        cq_head = reinterpret_cast<uint32_t*>(base + params.cq_off.head);
+        cq_tail = reinterpret_cast<uint32_t*>(base + params.cq_off.tail);
+        cq_mask = *reinterpret_cast<uint32_t*>(base + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(base + params.cq_off.cqes);
+        entries = params.sq_entries;
+        return true;
+    }
+
+    ~IoUring()
+    {
+        if (sqes)
+        {
+            munmap(sqes, sqes_size);
+        }
+        if (rings != MAP_FAILED)
+        {
+            munmap(rings, rings_size);
+        }
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+    }
+
+    // Queue read of inLength bytes, visible to kernel on next enter
+    bool pushRead(int inFile, char* outBuffer, uint32_t inLength, uint64_t inOffset, uint64_t inUserData)
+    {
+        uint32_t tail = *sq_tail;
+        uint32_t head = std::atomic_ref<uint32_t>(*sq_head).load(std::memory_order_acquire);
+        if (tail - head >= entries)
+        {
+            return false;
+        }
+
+        uint32_t index = tail & sq_mask;
+        io_uring_sqe* sqe = &sqes[index];
+        std::memset(sqe, 0, sizeof(io_uring_sqe));
+        sqe->opcode = IORING_OP_READ;
+        sqe->fd = inFile;
+        sqe->addr = reinterpret_cast<uint64_t>(outBuffer);
+        sqe->len = inLength;
+        sqe->off = inOffset;
+        sqe->user_data = inUserData;
+        sq_array[index] = index;
+
+        std::atomic_ref<uint32_t>(*sq_tail).store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    int enter(uint32_t inSubmit, uint32_t inWaitCount)
+    {
+        return static_cast<int>(syscall(__NR_io_uring_enter, fd, inSubmit, inWaitCount, IORING_ENTER_GETEVENTS, nullptr, 0));
+    }
+
+    template< typename Handler >
+    void reap(Handler&& handler)
+    {
+        uint32_t head = *cq_head;
+        uint32_t tail = std::atomic_ref<uint32_t>(*cq_tail).load(std::memory_order_acquire);
+        while (head != tail)
+        {
+            const io_uring_cqe& cqe = cqes[head & cq_mask];
+            handler(cqe.user_data, cqe.res);
+            head++;
+        }
+        std::atomic_ref<uint32_t>(*cq_head).store(head, std::memory_order_release);
+    }
+};
+#else
+struct omp::AsyncFileReader::IoUring
+{
+    bool init(uint32_t)
+    {
+        return false;
+    }
+};
+#endif
+
+omp::AsyncFileReader::AsyncFileReader(omp::ThreadPool* inThreadPool, uint32_t inQueueDepth)
+    : m_ThreadPool(inThreadPool)
+    , m_Ring(std::make_unique<IoUring>())
+{
+    if (m_Ring->init(inQueueDepth))
+    {
+        INFO(LogIO, "File reads use io_uring, queue depth {}", inQueueDepth);
+    }
+    else
+    {
+        m_Ring.reset();
+        INFO(LogIO, "io_uring is not available, file reads use thread pool");
+    }
+}
+
+omp::AsyncFileReader::~AsyncFileReader()
+{
+#if defined(OMP_IO_URING)
+    // Closing ring waits for reads kernel still owns, only then descriptors of abandoned reads can go
+    m_Ring.reset();
+    for (std::vector<PendingRead>& reads : m_AbandonedReads)
+    {
+        for (PendingRead& read : reads)
+        {
+            if (read.file >= 0)
+            {
+                close(read.file);
+                read.file = -1;
+            }
+        }
+    }
+#endif
+}
+
+std::future<void> omp::AsyncFileReader::readFiles(const std::vector<std::string>& inPaths, ReadCallback inCallback)
+{
+    OMP_STAT_SCOPE("ReadFiles");
+
+    std::shared_ptr<Batch> batch = std::make_shared<Batch>();
+    batch->callback = std::move(inCallback);
+    batch->remaining = inPaths.size();
+    std::future<void> result = batch->done.get_future();
+
+    if (inPaths.empty())
+    {
+        batch->done.set_value();
+        return result;
+    }
+
+    if (m_Ring)
+    {
+        readWithRing(inPaths, batch);
+    }
+    else
+    {
+        readWithPool(inPaths, batch);
+    }
+    return result;
+}
+
+void omp::AsyncFileReader::readWithPool(const std::vector<std::string>& inPaths, const std::shared_ptr<Batch>& inBatch)
+{
+    for (size_t i = 0; i < inPaths.size(); i++)
+    {
+        auto read = [inBatch, path = inPaths[i], i]()
+        {
+            std::string data;
+            bool success = omp::JsonConverter::readFile(path, data);
+            inBatch->finish(i, std::move(data), success);
+        };
+
+        if (m_ThreadPool)
+        {
+            m_ThreadPool->submit(std::move(read));
+        }
+        else
+        {
+            read();
+        }
+    }
+}
+
+void omp::AsyncFileReader::complete(const std::shared_ptr<Batch>& inBatch, size_t inIndex, std::string&& inData, bool inSuccess)
+{
+    if (m_ThreadPool)
+    {
+        m_ThreadPool->submit([inBatch, inIndex, data = std::move(inData), inSuccess]() mutable
+        {
+            inBatch->finish(inIndex, std::move(data), inSuccess);
+        });
+    }
+    else
+    {
+        inBatch->finish(inIndex, std::move(inData), inSuccess);
+    }
+}
+
+#if defined(OMP_IO_URING)
+void omp::AsyncFileReader::readWithRing(const std::vector<std::string>& inPaths, const std::shared_ptr<Batch>& inBatch)
+{
+    std::unique_lock<std::mutex> lock(m_RingAccess);
+    if (m_RingFailed)
+    {
+        lock.unlock();
+        readWithPool(inPaths, inBatch);
+        return;
+    }
+
+    std::vector<PendingRead> reads(inPaths.size());
+    size_t next_path = 0;
+    uint32_t in_flight = 0;
+    uint32_t queued = 0;
+
+    auto push = [this, &reads, &queued, &in_flight](size_t inIndex) -> bool
+    {
+        PendingRead& read = reads[inIndex];
+        uint32_t length = static_cast<uint32_t>(std::min(read.data.size() - read.offset, MAX_READ_SIZE));
+        if (!m_Ring->pushRead(read.file, read.data.data() + read.offset, length, read.offset, inIndex))
+        {
+            return false;
+        }
+        queued++;
+        in_flight++;
+        return true;
+    };
+
+    auto finish = [this, &reads, &inBatch, &inPaths](size_t inIndex, bool inSuccess)
+    {
+        PendingRead& read = reads[inIndex];
+        if (read.file >= 0)
+        {
+            close(read.file);
+            read.file = -1;
+        }
+        if (!inSuccess)
+        {
+            // Kernel without IORING_OP_READ and other io errors, read this file the usual way
+            inSuccess = omp::JsonConverter::readFile(inPaths[inIndex], read.data);
+        }
+        read.done = true;
+        complete(inBatch, inIndex, std::move(read.data), inSuccess);
+    };
+
+    while (next_path < inPaths.size() || in_flight > 0)
+    {
+        // Files are opened only when ring has room, so open descriptors never exceed queue depth
+        while (next_path < inPaths.size() && in_flight < m_Ring->entries)
+        {
+            size_t index = next_path++;
+            PendingRead& read = reads[index];
+            read.file = open(inPaths[index].c_str(), O_RDONLY | O_CLOEXEC);
+            struct stat file_stat{};
+            if (read.file < 0 || fstat(read.file, &file_stat) != 0)
+            {
+                finish(index, false);
+                continue;
+            }
+            read.data.resize(static_cast<size_t>(file_stat.st_size));
+            if (read.data.empty() || !push(index))
+            {
+                finish(index, read.data.empty());
+            }
+        }
+
+        if (in_flight == 0)
+        {
+            continue;
+        }
+
+        int entered = m_Ring->enter(queued, 1);
+        if (entered < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY)
+        {
+            ERROR(LogIO, "io_uring_enter failed: {}, next reads use thread pool", std::strerror(errno));
+            m_RingFailed = true;
+            for (size_t index = 0; index < inPaths.size(); index++)
+            {
+                PendingRead& read = reads[index];
+                if (!read.done)
+                {
+                    std::string data;
+                    bool success = omp::JsonConverter::readFile(inPaths[index], data);
+                    complete(inBatch, index, std::move(data), success);
+                }
+            }
+            // Kernel can still write to buffers of submitted reads, keep them until ring is closed
+            m_AbandonedReads.push_back(std::move(reads));
+            return;
+        }
+        if (entered > 0)
+        {
+            queued -= std::min(queued, static_cast<uint32_t>(entered));
+        }
+
+        m_Ring->reap([&reads, &in_flight, &push, &finish](uint64_t inUserData, int32_t inResult)
+        {
+            size_t index = inUserData;
+            PendingRead& read = reads[index];
+            in_flight--;
+
+            if (inResult == -EINTR || inResult == -EAGAIN)
+            {
+                if (!push(index))
+                {
+                    finish(index, false);
+                }
+                return;
+            }
+            if (inResult < 0)
+            {
+                finish(index, false);
+                return;
+            }
+            if (inResult == 0)
+            {
+                // File got shorter after stat
+                read.data.resize(read.offset);
+                finish(index, true);
+                return;
+            }
+
+            read.offset += static_cast<size_t>(inResult);
+            if (read.offset < read.data.size())
+            {
+                if (!push(index))
+                {
+                    finish(index, false);
+                }
+                return;
+            }
+            finish(index, true);
+        });
+    }
+}
+#else
+void omp::AsyncFileReader::readWithRing(const std::vector<std::string>& inPaths, const std::shared_ptr<Batch>& inBatch)
+{
+    readWithPool(inPaths, inBatch);
+}
+#endif
@@ -0,0 +1,66 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace omp
+{
+    class ThreadPool;
+
+    /*
+     * @brief Batched file reads for asset loading.
+     * With OMP_IO_URING on Linux the whole batch is kept in flight through one io_uring, so deep device queues are used.
+     * When io_uring is not compiled in or kernel refuses it, every file is read by a separate pool task.
+     * Completion callbacks always run on the pool, or inline without pool.
+     */
+    class AsyncFileReader
+    {
+    public:
+        // Index of the path in the batch, file contents, false if file can't be read
+        using ReadCallback = std::function<void(size_t inIndex, std::string&& inData, bool inSuccess)>;
+
+        explicit AsyncFileReader(omp::ThreadPool* inThreadPool, uint32_t inQueueDepth = DEFAULT_QUEUE_DEPTH);
+        ~AsyncFileReader();
+
+        AsyncFileReader(const AsyncFileReader&) = delete;
+        AsyncFileReader& operator=(const AsyncFileReader&) = delete;
+        AsyncFileReader(AsyncFileReader&&) = delete;
+        AsyncFileReader& operator=(AsyncFileReader&&) = delete;
+
+        /*
+         * @brief Submit reads of all files at once, inCallback is called once per path.
+         * Returned future is ready when every callback finished.
+         * With io_uring the calling thread drives submissions until the last read completes
+         */
+        std::future<void> readFiles(const std::vector<std::string>& inPaths, ReadCallback inCallback);
+
+        bool isUsingIoUring() const { return m_Ring != nullptr && !m_RingFailed; }
+
+        static constexpr uint32_t DEFAULT_QUEUE_DEPTH = 64;
+
+    private:
+        struct Batch;
+        struct IoUring;
+        struct PendingRead;
+
+        void readWithRing(const std::vector<std::string>& inPaths, const std::shared_ptr<Batch>& inBatch);
+        void readWithPool(const std::vector<std::string>& inPaths, const std::shared_ptr<Batch>& inBatch);
+        void complete(const std::shared_ptr<Batch>& inBatch, size_t inIndex, std::string&& inData, bool inSuccess);
+
+        // Larger reads are split, io_uring read length is 32 bit
+        static constexpr size_t MAX_READ_SIZE = size_t{1} << 30;
+
+        omp::ThreadPool* m_ThreadPool = nullptr;
+        // Destroyed after the ring, kernel may still write to them until ring is closed
+        std::vector<std::vector<PendingRead>> m_AbandonedReads;
+        std::unique_ptr<IoUring> m_Ring;
+        std::atomic<bool> m_RingFailed = false;
+        // Single ring, batches from different threads are driven one by one
+        std::mutex m_RingAccess;
+    };
+}
@@ -0,0 +1,648 @@
+#include "IO/BinaryJson.h"
+#include <bit>
+#include <stdexcept>
+#include "Logs.h"
+
+namespace
+{
+    uint64_t readBigEndian(const std::string& inBuffer, size_t inOffset, size_t inSize)
+    {
+        uint64_t value = 0;
+        for (size_t i = 0; i < inSize; i++)
+        {
+            value = (value << 8) | static_cast<uint8_t>(inBuffer[inOffset + i]);
+        }
+        return value;
+    }
+
+    void appendBigEndian(std::string& outBytes, uint64_t inValue, size_t inSize)
+    {
+        for (size_t i = inSize; i > 0; i--)
+        {
+            outBytes += static_cast<char>((inValue >> ((i - 1) * 8)) & 0xff);
+        }
+    }
+
+    void appendTag(std::string& outBytes, uint8_t inTag)
+    {
+        outBytes += static_cast<char>(inTag);
+    }
+
+    class BinaryJsonReader
+    {
+    public:
+        BinaryJsonReader(const std::string& inBuffer, std::vector<omp::StreamJsonNode>& outNodes, size_t inStart)
+            : m_Buffer(inBuffer)
+            , m_Nodes(outNodes)
+            , m_Position(inStart)
+        {
+        }
+
+        bool parseDocument()
+        {
+            return parseValue(0) && m_Position == m_Buffer.size();
+        }
+
+    private:
+        static constexpr size_t s_MaxDepth = 512;
+
+        const std::string& m_Buffer;
+        std::vector<omp::StreamJsonNode>& m_Nodes;
+        size_t m_Position = 0;
+
+        bool available(size_t inSize) const
+        {
+            return m_Buffer.size() - m_Position >= inSize;
+        }
+
+        bool scalar(omp::EStreamJsonType inType, size_t inSize)
+        {
+            if (!available(inSize))
+            {
+                return false;
+            }
+            m_Nodes.push_back({inType, m_Position, m_Position + inSize, m_Nodes.size() + 1});
+            m_Position += inSize;
+            return true;
+        }
+
+        bool string(size_t inHeader, size_t inLengthSize)
+        {
+            if (!available(inHeader))
+            {
+                return false;
+            }
+            size_t length = inLengthSize == 0
+                    ? static_cast<size_t>(static_cast<uint8_t>(m_Buffer[m_Position]) & 0x1f)
+                    : readBigEndian(m_Buffer, m_Position + 1, inLengthSize);
+            return scalar(omp::EStreamJsonType::String, inHeader + length);
+        }
+
+        bool container(omp::EStreamJsonType inType, size_t inHeader, size_t inCount, size_t inDepth)
+        {
+            if (!available(inHeader))
+            {
+                return false;
+            }
+            size_t node = m_Nodes.size();
+            m_Nodes.push_back({inType, m_Position, m_Position, 0});
+            m_Position += inHeader;
+
+            size_t values = inType == omp::EStreamJsonType::Object ? inCount * 2 : inCount;
+            for (size_t i = 0; i < values; i++)
+            {
+                // Object keys must be strings
+                bool is_key = inType == omp::EStreamJsonType::Object && i % 2 == 0;
+                if (!parseValue(inDepth + 1) || (is_key && m_Nodes.back().type != omp::EStreamJsonType::String))
+                {
+                    return false;
+                }
+            }
+
+            m_Nodes[node].end = m_Position;
+            m_Nodes[node].next = m_Nodes.size();
+            return true;
+        }
+
+        bool parseValue(size_t inDepth)
+        {
+            if (!available(1) || inDepth > s_MaxDepth)
+            {
+                return false;
+            }
+
+            uint8_t tag = static_cast<uint8_t>(m_Buffer[m_Position]);
+            if (tag <= 0x7f || tag >= 0xe0)
+            {
+                return scalar(omp::EStreamJsonType::Number, 1);
+            }
+            if (tag <= 0x8f)
+            {
+                return container(omp::EStreamJsonType::Object, 1, tag & 0x0f, inDepth);
+            }
+            if (tag <= 0x9f)
+            {
+                return container(omp::EStreamJsonType::Array, 1, tag & 0x0f, inDepth);
+            }
+            if (tag <= 0xbf)
+            {
+                return string(1, 0);
+            }
+
+            switch (tag)
+            {
+                case 0xc0: return scalar(omp::EStreamJsonType::Null, 1);
+                case 0xc2:
+                case 0xc3: return scalar(omp::EStreamJsonType::Bool, 1);
+                case 0xc4:
+                case 0xd9: return string(2, 1);
+                case 0xc5:
+                case 0xda: return string(3, 2);
+                case 0xc6:
+                case 0xdb: return string(5, 4);
+                case 0xca: return scalar(omp::EStreamJsonType::Number, 5);
+                case 0xcb: return scalar(omp::EStreamJsonType::Number, 9);
+                case 0xcc:
+                case 0xd0: return scalar(omp::EStreamJsonType::Number, 2);
+                case 0xcd:
+                case 0xd1: return scalar(omp::EStreamJsonType::Number, 3);
+                case 0xce:
+                case 0xd2: return scalar(omp::EStreamJsonType::Number, 5);
+                case 0xcf:
+                case 0xd3: return scalar(omp::EStreamJsonType::Number, 9);
+                case 0xdc:
+                case 0xde:
+                {
+                    if (!available(3))
+                    {
+                        return false;
+                    }
+                    size_t count = readBigEndian(m_Buffer, m_Position + 1, 2);
+                    auto type = tag == 0xdc ? omp::EStreamJsonType::Array : omp::EStreamJsonType::Object;
+                    return container(type, 3, count, inDepth);
+                }
+                case 0xdd:
+                case 0xdf:
+                {
+                    if (!available(5))
+                    {
+                        return false;
+                    }
+                    size_t count = readBigEndian(m_Buffer, m_Position + 1, 4);
+                    auto type = tag == 0xdd ? omp::EStreamJsonType::Array : omp::EStreamJsonType::Object;
+                    return container(type, 5, count, inDepth);
+                }
+                default:
+                    // Extension types are not used by assets
+                    return false;
+            }
+        }
+    };
+}
+
+bool omp::BinaryJsonDocument::parse()
+{
+    nodes.clear();
+    if (JsonConverter::detectFormat(buffer) != EJsonFormat::Binary)
+    {
+        return false;
+    }
+
+    member_index.clear();
+    BinaryJsonReader reader(buffer, nodes, JsonConverter::BINARY_MAGIC.size());
+    if (!reader.parseDocument())
+    {
+        nodes.clear();
+        return false;
+    }
+
+    for (size_t object = 0; object < nodes.size(); object++)
+    {
+        if (nodes[object].type != EStreamJsonType::Object)
+        {
+            continue;
+        }
+
+        std::unordered_map<std::string_view, size_t> members;
+        for (size_t key = object + 1; key < nodes[object].next; key = nodes[key + 1].next)
+        {
+            members.emplace(stringView(key), key + 1);
+        }
+
+        if (members.size() >= StreamJsonDocument::INDEX_MEMBER_COUNT)
+        {
+            member_index.emplace(object, std::move(members));
+        }
+    }
+    return true;
+}
+
+std::string_view omp::BinaryJsonDocument::raw(size_t inNode) const
+{
+    const StreamJsonNode& node = nodes[inNode];
+    return std::string_view(buffer).substr(node.begin, node.end - node.begin);
+}
+
+std::string_view omp::BinaryJsonDocument::stringView(size_t inNode) const
+{
+    const StreamJsonNode& node = nodes[inNode];
+    uint8_t tag = static_cast<uint8_t>(buffer[node.begin]);
+
+    size_t header = 1;
+    if (tag == 0xc4 || tag == 0xd9)
+    {
+        header = 2;
+    }
+    else if (tag == 0xc5 || tag == 0xda)
+    {
+        header = 3;
+    }
+    else if (tag == 0xc6 || tag == 0xdb)
+    {
+        header = 5;
+    }
+    return std::string_view(buffer).substr(node.begin + header, node.end - node.begin - header);
+}
+
+std::optional<size_t> omp::BinaryJsonDocument::findMember(size_t inObject, std::string_view inKey) const
+{
+    const StreamJsonNode& object = nodes[inObject];
+    if (object.type != EStreamJsonType::Object)
+    {
+        return std::nullopt;
+    }
+
+    auto index = member_index.find(inObject);
+    if (index != member_index.end())
+    {
+        auto member = index->second.find(inKey);
+        if (member == index->second.end())
+        {
+            return std::nullopt;
+        }
+        return member->second;
+    }
+
+    for (size_t key = inObject + 1; key < object.next; key = nodes[key + 1].next)
+    {
+        if (stringView(key) == inKey)
+        {
+            return key + 1;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<int64_t> omp::BinaryJsonDocument::toSigned(size_t inNode) const
+{
+    const StreamJsonNode& node = nodes[inNode];
+    if (node.type != EStreamJsonType::Number)
+    {
+        return std::nullopt;
+    }
+
+    uint8_t tag = static_cast<uint8_t>(buffer[node.begin]);
+    if (tag <= 0x7f)
+    {
+        return static_cast<int64_t>(tag);
+    }
+    if (tag >= 0xe0)
+    {
+        return static_cast<int64_t>(static_cast<int8_t>(tag));
+    }
+
+    size_t size = node.end - node.begin - 1;
+    uint64_t bits = readBigEndian(buffer, node.begin + 1, size);
+    switch (tag)
+    {
+        case 0xca:
+        case 0xcb:
+            return static_cast<int64_t>(toDouble(inNode).value());
+        case 0xd0: return static_cast<int64_t>(static_cast<int8_t>(bits));
+        case 0xd1: return static_cast<int64_t>(static_cast<int16_t>(bits));
+        case 0xd2: return static_cast<int64_t>(static_cast<int32_t>(bits));
+        default: return static_cast<int64_t>(bits);
+    }
+}
+
+std::optional<uint64_t> omp::BinaryJsonDocument::toUnsigned(size_t inNode) const
+{
+    const StreamJsonNode& node = nodes[inNode];
+    if (node.type != EStreamJsonType::Number)
+    {
+        return std::nullopt;
+    }
+
+    uint8_t tag = static_cast<uint8_t>(buffer[node.begin]);
+    if (tag >= 0xcc && tag <= 0xcf)
+    {
+        return readBigEndian(buffer, node.begin + 1, node.end - node.begin - 1);
+    }
+
+    std::optional<int64_t> value = toSigned(inNode);
+    if (!value.has_value())
+    {
+        return std::nullopt;
+    }
+    return static_cast<uint64_t>(value.value());
+}
+
+std::optional<double> omp::BinaryJsonDocument::toDouble(size_t inNode) const
+{
+    const StreamJsonNode& node = nodes[inNode];
+    if (node.type != EStreamJsonType::Number)
+    {
+        return std::nullopt;
+    }
+
+    uint8_t tag = static_cast<uint8_t>(buffer[node.begin]);
+    if (tag == 0xca)
+    {
+        uint32_t bits = static_cast<uint32_t>(readBigEndian(buffer, node.begin + 1, 4));
+        return static_cast<double>(std::bit_cast<float>(bits));
+    }
+    if (tag == 0xcb)
+    {
+        return std::bit_cast<double>(readBigEndian(buffer, node.begin + 1, 8));
+    }
+    if (tag >= 0xcc && tag <= 0xcf)
+    {
+        return static_cast<double>(toUnsigned(inNode).value());
+    }
+    return static_cast<double>(toSigned(inNode).value());
+}
+
+omp::binaryjson::binaryjson(std::shared_ptr<const BinaryJsonDocument> inDocument, size_t inNode)
+    : m_Document(std::move(inDocument))
+    , m_Node(inNode)
+{
+}
+
+bool omp::binaryjson::readJsonFromFile(const std::string& inFilePath)
+{
+    std::string data;
+    if (!JsonConverter::readFile(inFilePath, data))
+    {
+        VWARN(LogIO, "Cant read json file {1}", inFilePath);
+        return false;
+    }
+    return readJsonFromData(std::move(data), inFilePath);
+}
+
+bool omp::binaryjson::readJsonFromData(std::string&& inData, const std::string& inSourceName)
+{
+    auto document = std::make_shared<BinaryJsonDocument>();
+    document->buffer = std::move(inData);
+
+    if (JsonConverter::detectFormat(document->buffer) == EJsonFormat::Text)
+    {
+        std::string text = std::move(document->buffer);
+        if (!JsonConverter::textToBinary(text, document->buffer))
+        {
+            VWARN(LogIO, "Cant parse json file {1}", inSourceName);
+            return false;
+        }
+    }
+
+    if (!document->parse() || document->nodes[0].type != EStreamJsonType::Object)
+    {
+        VWARN(LogIO, "Cant parse binary file {1}", inSourceName);
+        return false;
+    }
+
+    m_Document = std::move(document);
+    m_Node = 0;
+    m_Written.clear();
+    m_WrittenIndex.clear();
+    return true;
+}
+
+bool omp::binaryjson::writeJsonToFile(const std::string& inFilePath, EJsonFormat inFormat) const
+{
+    bool success = inFormat == EJsonFormat::Binary
+            ? JsonConverter::writeFile(inFilePath, to_binary())
+            : JsonConverter::writeFile(inFilePath, to_string());
+    if (!success)
+    {
+        VWARN(LogIO, "Cant write json to file: {1}", inFilePath);
+    }
+    return success;
+}
+
+omp::binaryjson omp::binaryjson::readObject(const std::string& inKey) const
+{
+    auto written = m_WrittenIndex.find(inKey);
+    if (written != m_WrittenIndex.end())
+    {
+        auto document = std::make_shared<BinaryJsonDocument>();
+        document->buffer = std::string(JsonConverter::BINARY_MAGIC) + m_Written[written->second].second;
+        if (document->parse() && document->nodes[0].type == EStreamJsonType::Object)
+        {
+            return binaryjson(std::move(document), 0);
+        }
+    }
+    else if (m_Document)
+    {
+        std::optional<size_t> node = m_Document->findMember(m_Node, inKey);
+        if (node.has_value() && m_Document->nodes[node.value()].type == EStreamJsonType::Object)
+        {
+            return binaryjson(m_Document, node.value());
+        }
+    }
+
+    throw std::out_of_range("binaryjson: no object with key " + inKey);
+}
+
+void omp::binaryjson::writeObject(const std::string& inKey, binaryjson&& inObject)
+{
+    std::string bytes;
+    inObject.appendEncoded(bytes);
+    setWritten(inKey, std::move(bytes));
+}
+
+bool omp::binaryjson::contains(const std::string& inKey) const
+{
+    if (m_WrittenIndex.contains(inKey))
+    {
+        return true;
+    }
+    return m_Document && m_Document->findMember(m_Node, inKey).has_value();
+}
+
+std::string omp::binaryjson::to_string() const
+{
+    std::string text;
+    JsonConverter::binaryToText(to_binary(), text);
+    return text;
+}
+
+std::string omp::binaryjson::to_binary() const
+{
+    std::string bytes(JsonConverter::BINARY_MAGIC);
+    appendEncoded(bytes);
+    return bytes;
+}
+
+void omp::binaryjson::setWritten(const std::string& inKey, std::string&& inBytes)
+{
+    auto written = m_WrittenIndex.find(inKey);
+    if (written != m_WrittenIndex.end())
+    {
+        m_Written[written->second].second = std::move(inBytes);
+        return;
+    }
+
+    m_WrittenIndex.emplace(inKey, m_Written.size());
+    m_Written.emplace_back(inKey, std::move(inBytes));
+}
+
+void omp::binaryjson::appendEncoded(std::string& outBytes) const
+{
+    std::vector<size_t> kept_members;
+    if (m_Document)
+    {
+        const std::vector<StreamJsonNode>& nodes = m_Document->nodes;
+        for (size_t key = m_Node + 1; key < nodes[m_Node].next; key = nodes[key + 1].next)
+        {
+            if (!m_WrittenIndex.contains(std::string(m_Document->stringView(key))))
+            {
+                kept_members.push_back(key);
+            }
+        }
+    }
+
+    appendMapHeader(outBytes, kept_members.size() + m_Written.size());
+    for (size_t key : kept_members)
+    {
+        outBytes.append(m_Document->raw(key));
+        outBytes.append(m_Document->raw(key + 1));
+    }
+    for (const auto& [key, value] : m_Written)
+    {
+        appendString(outBytes, key);
+        outBytes.append(value);
+    }
+}
+
+void omp::binaryjson::appendNil(std::string& outBytes)
+{
+    appendTag(outBytes, 0xc0);
+}
+
+void omp::binaryjson::appendBool(std::string& outBytes, bool inValue)
+{
+    appendTag(outBytes, inValue ? 0xc3 : 0xc2);
+}
+
+void omp::binaryjson::appendSigned(std::string& outBytes, int64_t inValue)
+{
+    if (inValue >= 0)
+    {
+        appendUnsigned(outBytes, static_cast<uint64_t>(inValue));
+    }
+    else if (inValue >= -32)
+    {
+        appendTag(outBytes, static_cast<uint8_t>(inValue));
+    }
+    else if (inValue >= INT8_MIN)
+    {
+        appendTag(outBytes, 0xd0);
+        appendBigEndian(outBytes, static_cast<uint64_t>(inValue), 1);
+    }
+    else if (inValue >= INT16_MIN)
+    {
+        appendTag(outBytes, 0xd1);
+        appendBigEndian(outBytes, static_cast<uint64_t>(inValue), 2);
+    }
+    else if (inValue >= INT32_MIN)
+    {
+        appendTag(outBytes, 0xd2);
+        appendBigEndian(outBytes, static_cast<uint64_t>(inValue), 4);
+    }
+    else
+    {
+        appendTag(outBytes, 0xd3);
+        appendBigEndian(outBytes, static_cast<uint64_t>(inValue), 8);
+    }
+}
+
+void omp::binaryjson::appendUnsigned(std::string& outBytes, uint64_t inValue)
+{
+    if (inValue <= 0x7f)
+    {
+        appendTag(outBytes, static_cast<uint8_t>(inValue));
+    }
+    else if (inValue <= UINT8_MAX)
+    {
+        appendTag(outBytes, 0xcc);
+        appendBigEndian(outBytes, inValue, 1);
+    }
+    else if (inValue <= UINT16_MAX)
+    {
+        appendTag(outBytes, 0xcd);
+        appendBigEndian(outBytes, inValue, 2);
+    }
+    else if (inValue <= UINT32_MAX)
+    {
+        appendTag(outBytes, 0xce);
+        appendBigEndian(outBytes, inValue, 4);
+    }
+    else
+    {
+        appendTag(outBytes, 0xcf);
+        appendBigEndian(outBytes, inValue, 8);
+    }
+}
+
+void omp::binaryjson::appendFloat(std::string& outBytes, float inValue)
+{
+    appendTag(outBytes, 0xca);
+    appendBigEndian(outBytes, std::bit_cast<uint32_t>(inValue), 4);
+}
+
+void omp::binaryjson::appendDouble(std::string& outBytes, double inValue)
+{
+    appendTag(outBytes, 0xcb);
+    appendBigEndian(outBytes, std::bit_cast<uint64_t>(inValue), 8);
+}
+
+void omp::binaryjson::appendString(std::string& outBytes, std::string_view inValue)
+{
+    size_t length = inValue.size();
+    if (length <= 31)
+    {
+        appendTag(outBytes, static_cast<uint8_t>(0xa0 | length));
+    }
+    else if (length <= UINT8_MAX)
+    {
+        appendTag(outBytes, 0xd9);
+        appendBigEndian(outBytes, length, 1);
+    }
+    else if (length <= UINT16_MAX)
+    {
+        appendTag(outBytes, 0xda);
+        appendBigEndian(outBytes, length, 2);
+    }
+    else
+    {
+        appendTag(outBytes, 0xdb);
+        appendBigEndian(outBytes, length, 4);
+    }
+    outBytes.append(inValue);
+}
+
+void omp::binaryjson::appendArrayHeader(std::string& outBytes, size_t inCount)
+{
+    if (inCount <= 15)
+    {
+        appendTag(outBytes, static_cast<uint8_t>(0x90 | inCount));
+    }
+    else if (inCount <= UINT16_MAX)
+    {
+        appendTag(outBytes, 0xdc);
+        appendBigEndian(outBytes, inCount, 2);
+    }
+    else
+    {
+        appendTag(outBytes, 0xdd);
+        appendBigEndian(outBytes, inCount, 4);
+    }
+}
+
+void omp::binaryjson::appendMapHeader(std::string& outBytes, size_t inCount)
+{
+    if (inCount <= 15)
+    {
+        appendTag(outBytes, static_cast<uint8_t>(0x80 | inCount));
+    }
+    else if (inCount <= UINT16_MAX)
+    {
+        appendTag(outBytes, 0xde);
+        appendBigEndian(outBytes, inCount, 2);
+    }
+    else
+    {
+        appendTag(outBytes, 0xdf);
+        appendBigEndian(outBytes, inCount, 4);
+    }
+}
@@ -0,0 +1,249 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <optional>
+#include <vector>
+#include <memory>
+#include <ranges>
+#include <type_traits>
+#include <unordered_map>
+#include "IO/StreamJson.h"
+#include "IO/JsonConverter.h"
+
+namespace omp
+{
+    /*
+     * @brief Parsed binary asset file, MessagePack encoded after JsonConverter::BINARY_MAGIC.
+     * Uses the same node tape layout as StreamJsonDocument, begin/end cover encoded bytes of a value.
+     */
+    struct BinaryJsonDocument
+    {
+        std::string buffer;
+        std::vector<StreamJsonNode> nodes;
+        std::unordered_map<size_t, std::unordered_map<std::string_view, size_t>> member_index;
+
+        bool parse();
+
+        std::string_view raw(size_t inNode) const;
+        std::string_view stringView(size_t inNode) const;
+        std::optional<size_t> findMember(size_t inObject, std::string_view inKey) const;
+
+        std::optional<int64_t> toSigned(size_t inNode) const;
+        std::optional<uint64_t> toUnsigned(size_t inNode) const;
+        std::optional<double> toDouble(size_t inNode) const;
+    };
+
+    /*
+     * @brief Compact binary backend for JsonParser.
+     * Same read/write/contains interface as nlohmannjson, nested objects are views into a single file buffer,
+     * written values are kept encoded and streamed to the file.
+     */
+    class binaryjson
+    {
+    private:
+        std::shared_ptr<const BinaryJsonDocument> m_Document;
+        size_t m_Node = 0;
+
+        std::vector<std::pair<std::string, std::string>> m_Written;
+        std::unordered_map<std::string, size_t> m_WrittenIndex;
+
+    public:
+        binaryjson() = default;
+        binaryjson(std::shared_ptr<const BinaryJsonDocument> inDocument, size_t inNode);
+        binaryjson(binaryjson&& other) = default;
+        binaryjson& operator=(binaryjson&& other) = default;
+
+        binaryjson(const binaryjson& other) = delete;
+        binaryjson& operator=(const binaryjson& other) = delete;
+
+        bool readJsonFromFile(const std::string& inFilePath);
+        // Parse file contents read elsewhere, inSourceName is used for logs
+        bool readJsonFromData(std::string&& inData, const std::string& inSourceName);
+        bool writeJsonToFile(const std::string& inFilePath, EJsonFormat inFormat = EJsonFormat::Binary) const;
+
+        template< typename T >
+        std::optional<T> read(const std::string& inKey) const;
+
+        template< typename T >
+        void write(const std::string& inKey, T&& inValue);
+
+        binaryjson readObject(const std::string& inKey) const;
+        void writeObject(const std::string& inKey, binaryjson&& inObject);
+
+        bool contains(const std::string& inKey) const;
+
+        // Text json representation
+        std::string to_string() const;
+        // Encoded file contents, with header
+        std::string to_binary() const;
+
+        friend class JsonConverter;
+
+    private:
+        void setWritten(const std::string& inKey, std::string&& inBytes);
+        void appendEncoded(std::string& outBytes) const;
+
+        template< typename T >
+        static std::optional<T> convert(const BinaryJsonDocument& inDocument, size_t inNode);
+        template< typename T >
+        static void append(std::string& outBytes, const T& inValue);
+
+        static void appendNil(std::string& outBytes);
+        static void appendBool(std::string& outBytes, bool inValue);
+        static void appendSigned(std::string& outBytes, int64_t inValue);
+        static void appendUnsigned(std::string& outBytes, uint64_t inValue);
+        static void appendFloat(std::string& outBytes, float inValue);
+        static void appendDouble(std::string& outBytes, double inValue);
+        static void appendString(std::string& outBytes, std::string_view inValue);
+        static void appendArrayHeader(std::string& outBytes, size_t inCount);
+        static void appendMapHeader(std::string& outBytes, size_t inCount);
+    };
+
+    template< typename T >
+    std::optional<T> binaryjson::read(const std::string& inKey) const
+    {
+        auto written = m_WrittenIndex.find(inKey);
+        if (written != m_WrittenIndex.end())
+        {
+            BinaryJsonDocument document;
+            document.buffer = std::string(JsonConverter::BINARY_MAGIC) + m_Written[written->second].second;
+            if (!document.parse())
+            {
+                return std::nullopt;
+            }
+            return convert<T>(document, 0);
+        }
+
+        if (!m_Document)
+        {
+            return std::nullopt;
+        }
+
+        std::optional<size_t> node = m_Document->findMember(m_Node, inKey);
+        if (!node.has_value())
+        {
+            return std::nullopt;
+        }
+        return convert<T>(*m_Document, node.value());
+    }
+
+    template< typename T >
+    void binaryjson::write(const std::string& inKey, T&& inValue)
+    {
+        std::string bytes;
+        append(bytes, inValue);
+        setWritten(inKey, std::move(bytes));
+    }
+
+    template< typename T >
+    std::optional<T> binaryjson::convert(const BinaryJsonDocument& inDocument, size_t inNode)
+    {
+        using Type = std::remove_cvref_t<T>;
+        const StreamJsonNode& node = inDocument.nodes[inNode];
+        if constexpr (std::is_same_v<Type, bool>)
+        {
+            if (node.type != EStreamJsonType::Bool)
+            {
+                return std::nullopt;
+            }
+            return static_cast<uint8_t>(inDocument.buffer[node.begin]) == 0xc3;
+        }
+        else if constexpr (std::is_floating_point_v<Type>)
+        {
+            std::optional<double> value = inDocument.toDouble(inNode);
+            if (!value.has_value())
+            {
+                return std::nullopt;
+            }
+            return static_cast<Type>(value.value());
+        }
+        else if constexpr (std::is_integral_v<Type> && std::is_signed_v<Type>)
+        {
+            std::optional<int64_t> value = inDocument.toSigned(inNode);
+            if (!value.has_value())
+            {
+                return std::nullopt;
+            }
+            return static_cast<Type>(value.value());
+        }
+        else if constexpr (std::is_integral_v<Type>)
+        {
+            std::optional<uint64_t> value = inDocument.toUnsigned(inNode);
+            if (!value.has_value())
+            {
+                return std::nullopt;
+            }
+            return static_cast<Type>(value.value());
+        }
+        else if constexpr (std::is_same_v<Type, std::string>)
+        {
+            if (node.type != EStreamJsonType::String)
+            {
+                return std::nullopt;
+            }
+            return std::string(inDocument.stringView(inNode));
+        }
+        else
+        {
+            static_assert(std::ranges::range<Type>, "binaryjson can't read this type");
+
+            if (node.type != EStreamJsonType::Array)
+            {
+                return std::nullopt;
+            }
+
+            Type result;
+            for (size_t child = inNode + 1; child < node.next; child = inDocument.nodes[child].next)
+            {
+                auto element = convert<std::ranges::range_value_t<Type>>(inDocument, child);
+                if (!element.has_value())
+                {
+                    return std::nullopt;
+                }
+                result.insert(result.end(), std::move(element.value()));
+            }
+            return result;
+        }
+    }
+
+    template< typename T >
+    void binaryjson::append(std::string& outBytes, const T& inValue)
+    {
+        using Type = std::remove_cvref_t<T>;
+        if constexpr (std::is_same_v<Type, bool>)
+        {
+            appendBool(outBytes, inValue);
+        }
+        else if constexpr (std::is_same_v<Type, float>)
+        {
+            appendFloat(outBytes, inValue);
+        }
+        else if constexpr (std::is_floating_point_v<Type>)
+        {
+            appendDouble(outBytes, inValue);
+        }
+        else if constexpr (std::is_integral_v<Type> && std::is_signed_v<Type>)
+        {
+            appendSigned(outBytes, inValue);
+        }
+        else if constexpr (std::is_integral_v<Type>)
+        {
+            appendUnsigned(outBytes, inValue);
+        }
+        else if constexpr (std::is_convertible_v<const Type&, std::string_view>)
+        {
+            appendString(outBytes, inValue);
+        }
+        else
+        {
+            static_assert(std::ranges::sized_range<Type>, "binaryjson can't write this type");
+
+            appendArrayHeader(outBytes, std::ranges::size(inValue));
+            for (const auto& element : inValue)
+            {
+                append(outBytes, element);
+            }
+        }
+    }
+}
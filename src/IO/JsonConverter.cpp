@@ -0,0 +1,270 @@
+#include "IO/JsonConverter.h"
+#include <charconv>
+#include <fstream>
+#include "IO/StreamJson.h"
+#include "IO/BinaryJson.h"
+#include "Logs.h"
+
+omp::EJsonFormat omp::JsonConverter::detectFormat(std::string_view inData)
+{
+    return inData.starts_with(BINARY_MAGIC) ? EJsonFormat::Binary : EJsonFormat::Text;
+}
+
+bool omp::JsonConverter::textToBinary(std::string_view inText, std::string& outBinary)
+{
+    StreamJsonDocument document;
+    document.buffer = std::string(inText);
+    if (!document.parse())
+    {
+        return false;
+    }
+
+    outBinary.assign(BINARY_MAGIC);
+    outBinary.reserve(inText.size() / 2);
+    textNodeToBinary(document, 0, outBinary);
+    return true;
+}
+
+bool omp::JsonConverter::binaryToText(std::string_view inBinary, std::string& outText)
+{
+    BinaryJsonDocument document;
+    document.buffer = std::string(inBinary);
+    if (!document.parse())
+    {
+        return false;
+    }
+
+    outText.clear();
+    outText.reserve(inBinary.size() * 2);
+    binaryNodeToText(document, 0, outText);
+    return true;
+}
+
+bool omp::JsonConverter::convertFile(const std::string& inSource, const std::string& inDestination, EJsonFormat inFormat)
+{
+    std::string source;
+    if (!readFile(inSource, source))
+    {
+        WARN(LogIO, "Cant read file to convert: {}", inSource);
+        return false;
+    }
+
+    if (detectFormat(source) == inFormat)
+    {
+        return inSource == inDestination || writeFile(inDestination, source);
+    }
+
+    std::string converted;
+    bool success = inFormat == EJsonFormat::Binary
+            ? textToBinary(source, converted)
+            : binaryToText(source, converted);
+    if (!success)
+    {
+        WARN(LogIO, "Cant convert file {} to {}", inSource, formatName(inFormat));
+        return false;
+    }
+    return writeFile(inDestination, converted);
+}
+
+bool omp::JsonConverter::readFile(const std::string& inPath, std::string& outData)
+{
+    std::ifstream file(inPath, std::ios::ate | std::ios::binary);
+    if (!file.is_open())
+    {
+        return false;
+    }
+
+    std::streamsize file_size = file.tellg();
+    outData.resize(static_cast<size_t>(file_size));
+    file.seekg(0);
+    file.read(outData.data(), file_size);
+    return true;
+}
+
+bool omp::JsonConverter::writeFile(const std::string& inPath, std::string_view inData)
+{
+    std::ofstream file(inPath, std::ios::binary);
+    if (!file.is_open())
+    {
+        return false;
+    }
+
+    file.write(inData.data(), static_cast<std::streamsize>(inData.size()));
+    return file.good();
+}
+
+std::string_view omp::JsonConverter::formatName(EJsonFormat inFormat)
+{
+    return inFormat == EJsonFormat::Binary ? "Binary" : "Text";
+}
+
+std::optional<omp::EJsonFormat> omp::JsonConverter::formatFromName(std::string_view inName)
+{
+    if (inName == "Binary")
+    {
+        return EJsonFormat::Binary;
+    }
+    if (inName == "Text")
+    {
+        return EJsonFormat::Text;
+    }
+    return std::nullopt;
+}
+
+void omp::JsonConverter::numberToBinary(std::string_view inText, std::string& outBinary)
+{
+    const char* end = inText.data() + inText.size();
+
+    uint64_t unsigned_value = 0;
+    auto unsigned_result = std::from_chars(inText.data(), end, unsigned_value);
+    if (unsigned_result.ec == std::errc() && unsigned_result.ptr == end)
+    {
+        omp::binaryjson::appendUnsigned(outBinary, unsigned_value);
+        return;
+    }
+
+    int64_t signed_value = 0;
+    auto signed_result = std::from_chars(inText.data(), end, signed_value);
+    if (signed_result.ec == std::errc() && signed_result.ptr == end)
+    {
+        omp::binaryjson::appendSigned(outBinary, signed_value);
+        return;
+    }
+
+    double value = 0;
+    std::from_chars(inText.data(), end, value);
+
+    // Keep 4 bytes when the float closest to the text prints back to the same number
+    float float_value = 0;
+    std::from_chars(inText.data(), end, float_value);
+    char buffer[64];
+    auto float_text = std::to_chars(buffer, buffer + sizeof(buffer), float_value);
+    double float_round_trip = 0;
+    std::from_chars(buffer, float_text.ptr, float_round_trip);
+
+    if (float_round_trip == value)
+    {
+        omp::binaryjson::appendFloat(outBinary, float_value);
+    }
+    else
+    {
+        omp::binaryjson::appendDouble(outBinary, value);
+    }
+}
+
+void omp::JsonConverter::textNodeToBinary(const omp::StreamJsonDocument& inDocument, size_t inNode, std::string& outBinary)
+{
+    const omp::StreamJsonNode& node = inDocument.nodes[inNode];
+    switch (node.type)
+    {
+        case omp::EStreamJsonType::Null:
+            omp::binaryjson::appendNil(outBinary);
+            break;
+        case omp::EStreamJsonType::Bool:
+            omp::binaryjson::appendBool(outBinary, inDocument.buffer[node.begin] == 't');
+            break;
+        case omp::EStreamJsonType::Number:
+            numberToBinary(inDocument.raw(inNode), outBinary);
+            break;
+        case omp::EStreamJsonType::String:
+            omp::binaryjson::appendString(outBinary, inDocument.decodeString(inNode));
+            break;
+        case omp::EStreamJsonType::Array:
+        {
+            size_t count = 0;
+            for (size_t child = inNode + 1; child < node.next; child = inDocument.nodes[child].next)
+            {
+                count++;
+            }
+            omp::binaryjson::appendArrayHeader(outBinary, count);
+            for (size_t child = inNode + 1; child < node.next; child = inDocument.nodes[child].next)
+            {
+                textNodeToBinary(inDocument, child, outBinary);
+            }
+            break;
+        }
+        case omp::EStreamJsonType::Object:
+        {
+            size_t count = 0;
+            for (size_t key = inNode + 1; key < node.next; key = inDocument.nodes[key + 1].next)
+            {
+                count++;
+            }
+            omp::binaryjson::appendMapHeader(outBinary, count);
+            for (size_t key = inNode + 1; key < node.next; key = inDocument.nodes[key + 1].next)
+            {
+                omp::binaryjson::appendString(outBinary, inDocument.decodeString(key));
+                textNodeToBinary(inDocument, key + 1, outBinary);
+            }
+            break;
+        }
+    }
+}
+
+void omp::JsonConverter::binaryNodeToText(const omp::BinaryJsonDocument& inDocument, size_t inNode, std::string& outText)
+{
+    const omp::StreamJsonNode& node = inDocument.nodes[inNode];
+    switch (node.type)
+    {
+        case omp::EStreamJsonType::Null:
+            outText += "null";
+            break;
+        case omp::EStreamJsonType::Bool:
+            omp::streamjson::appendBool(outText, static_cast<uint8_t>(inDocument.buffer[node.begin]) == 0xc3);
+            break;
+        case omp::EStreamJsonType::Number:
+        {
+            uint8_t tag = static_cast<uint8_t>(inDocument.buffer[node.begin]);
+            if (tag == 0xca)
+            {
+                omp::streamjson::appendFloat(outText, static_cast<float>(inDocument.toDouble(inNode).value()));
+            }
+            else if (tag == 0xcb)
+            {
+                omp::streamjson::appendDouble(outText, inDocument.toDouble(inNode).value());
+            }
+            else if ((tag >= 0xd0 && tag <= 0xd3) || tag >= 0xe0)
+            {
+                omp::streamjson::appendSigned(outText, inDocument.toSigned(inNode).value());
+            }
+            else
+            {
+                omp::streamjson::appendUnsigned(outText, inDocument.toUnsigned(inNode).value());
+            }
+            break;
+        }
+        case omp::EStreamJsonType::String:
+            omp::streamjson::appendString(outText, inDocument.stringView(inNode));
+            break;
+        case omp::EStreamJsonType::Array:
+        {
+            outText += '[';
+            for (size_t child = inNode + 1; child < node.next; child = inDocument.nodes[child].next)
+            {
+                if (child != inNode + 1)
+                {
+                    outText += ',';
+                }
+                binaryNodeToText(inDocument, child, outText);
+            }
+            outText += ']';
+            break;
+        }
+        case omp::EStreamJsonType::Object:
+        {
+            outText += '{';
+            for (size_t key = inNode + 1; key < node.next; key = inDocument.nodes[key + 1].next)
+            {
+                if (key != inNode + 1)
+                {
+                    outText += ',';
+                }
+                omp::streamjson::appendString(outText, inDocument.stringView(key));
+                outText += ':';
+                binaryNodeToText(inDocument, key + 1, outText);
+            }
+            outText += '}';
+            break;
+        }
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace omp
+{
+    struct StreamJsonDocument;
+    struct BinaryJsonDocument;
+
+    enum class EJsonFormat : uint8_t
+    {
+        Text = 0,
+        Binary
+    };
+
+    /*
+     * @brief Converts asset files between text json and the binary (MessagePack based) format.
+     * Conversion walks parsed tapes of the source and writes the target directly, no DOM is built.
+     */
+    class JsonConverter
+    {
+    public:
+        JsonConverter() = delete;
+
+        // Binary files start with this header followed by a MessagePack map
+        inline static constexpr std::string_view BINARY_MAGIC = std::string_view("OMPB\x01", 5);
+
+        static EJsonFormat detectFormat(std::string_view inData);
+
+        static bool textToBinary(std::string_view inText, std::string& outBinary);
+        static bool binaryToText(std::string_view inBinary, std::string& outText);
+
+        /*
+         * @brief Read file in any format and write it to inDestination in inFormat. Source and destination can match
+         * */
+        static bool convertFile(const std::string& inSource, const std::string& inDestination, EJsonFormat inFormat);
+
+        static bool readFile(const std::string& inPath, std::string& outData);
+        static bool writeFile(const std::string& inPath, std::string_view inData);
+
+        static std::string_view formatName(EJsonFormat inFormat);
+        static std::optional<EJsonFormat> formatFromName(std::string_view inName);
+
+    private:
+        static void numberToBinary(std::string_view inText, std::string& outBinary);
+        static void textNodeToBinary(const StreamJsonDocument& inDocument, size_t inNode, std::string& outBinary);
+        static void binaryNodeToText(const BinaryJsonDocument& inDocument, size_t inNode, std::string& outText);
+    };
+}
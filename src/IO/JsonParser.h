@@ -4,6 +4,9 @@
 #include <fstream>
 #include "Logs.h"
 #include "nlohmann/json.hpp"
+#include "IO/StreamJson.h"
+#include "IO/BinaryJson.h"
+#include "IO/JsonConverter.h"
 
 namespace omp
 {
@@ -15,8 +18,8 @@ namespace omp
         using ImplementationType = nlohmann::json;
         nlohmannjson() = default;
         nlohmannjson(nlohmann::json&& value)
+            : m_Data(std::move(value))
         {
-            m_Data = value;
         }
         nlohmannjson(nlohmannjson&& other)
         {
@@ -33,21 +36,42 @@ namespace omp
 
         bool readJsonFromFile(const std::string& inFilePath)
         {
-            std::ifstream f(inFilePath);
-            if (f.is_open())
+            std::string data;
+            if (!JsonConverter::readFile(inFilePath, data))
             {
-                m_Data = nlohmann::json::parse(f);
-                return true;
+                VWARN(LogIO, "Cant read json file {1}", inFilePath);
+                return false;
+            }
+            return readJsonFromData(std::move(data), inFilePath);
+        }
+
+        bool readJsonFromData(std::string&& inData, const std::string&)
+        {
+            if (JsonConverter::detectFormat(inData) == EJsonFormat::Binary)
+            {
+                m_Data = nlohmann::json::from_msgpack(inData.begin() + static_cast<std::ptrdiff_t>(JsonConverter::BINARY_MAGIC.size()), inData.end());
             }
             else
             {
-                VWARN(LogIO, "Cant read json file {1}", inFilePath);
-                return false;
+                m_Data = nlohmann::json::parse(inData);
             }
+            return true;
         }
 
-        bool writeJsonToFile(const std::string& inFilePath)
+        bool writeJsonToFile(const std::string& inFilePath, EJsonFormat inFormat = EJsonFormat::Text)
         {
+            if (inFormat == EJsonFormat::Binary)
+            {
+                std::string data(JsonConverter::BINARY_MAGIC);
+                nlohmann::json::to_msgpack(m_Data, nlohmann::detail::output_adapter<char>(data));
+                if (!JsonConverter::writeFile(inFilePath, data))
+                {
+                    VWARN(LogIO, "Cant write binary to file: {1}", inFilePath);
+                    return false;
+                }
+                return true;
+            }
+
             std::ofstream f(inFilePath);
             if (f.is_open())
             {
@@ -78,6 +102,16 @@ namespace omp
             m_Data[inKey] = std::forward<T>(inValue);
         }
 
+        nlohmannjson readObject(const std::string& inKey) const
+        {
+            return nlohmannjson(nlohmann::json(m_Data.at(inKey)));
+        }
+
+        void writeObject(const std::string& inKey, nlohmannjson&& inObject)
+        {
+            m_Data[inKey] = std::move(inObject.m_Data);
+        }
+
         bool contains(const std::string& inKey) const
         {
             return m_Data.contains(inKey);
@@ -95,7 +129,15 @@ namespace omp
     };
 
 
-    template<typename ParserType = nlohmannjson>
+#if defined(OMP_BINARY_JSON)
+    using DefaultParserType = binaryjson;
+#elif defined(OMP_STREAM_JSON)
+    using DefaultParserType = streamjson;
+#else
+    using DefaultParserType = nlohmannjson;
+#endif
+
+    template<typename ParserType = DefaultParserType>
     class JsonParser
     {
     private:
@@ -125,7 +167,9 @@ namespace omp
         // Usage //
         // ===== //
         bool populateFromFile(const std::string& filePath);
-        bool writeToFile(const std::string& filePath);
+        // Same as populateFromFile for file contents already in memory
+        bool populateFromData(std::string&& inData, const std::string& inSourceName);
+        bool writeToFile(const std::string& filePath, EJsonFormat inFormat = EJsonFormat::Text);
 
         template<typename T>
         std::optional<T> readValue(const std::string& inKey) const;
@@ -150,9 +194,15 @@ namespace omp
     }
 
     template< typename ParserType >
-    bool JsonParser<ParserType>::writeToFile(const std::string& filePath)
+    bool JsonParser<ParserType>::populateFromData(std::string&& inData, const std::string& inSourceName)
+    {
+        return m_Parser.readJsonFromData(std::move(inData), inSourceName);
+    }
+
+    template< typename ParserType >
+    bool JsonParser<ParserType>::writeToFile(const std::string& filePath, EJsonFormat inFormat)
     {
-        return m_Parser.writeJsonToFile(filePath);
+        return m_Parser.writeJsonToFile(filePath, inFormat);
     }
 
     template< typename ParserType >
@@ -165,7 +215,7 @@ namespace omp
     template< typename ParserType >
     JsonParser<ParserType> JsonParser<ParserType>::readObject(const std::string& inKey) const
     {
-        return JsonParser(ParserType(m_Parser.template read<typename ParserType::ImplementationType>(inKey).value()));
+        return JsonParser(m_Parser.readObject(inKey));
     }
 
     template< typename ParserType >
@@ -178,7 +228,7 @@ namespace omp
     template< typename ParserType >
     void JsonParser<ParserType>::writeObject(const std::string& inKey, JsonParser&& parser)
     {
-        m_Parser.template write<typename ParserType::ImplementationType>(inKey, parser.m_Parser.getImplementation());
+        m_Parser.writeObject(inKey, std::move(parser.m_Parser));
     }
 
     template< typename ParserType >
@@ -0,0 +1,76 @@
+#include "IO/MappedFile.h"
+#include "IO/JsonConverter.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define OMP_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+omp::MappedFile::~MappedFile()
+{
+    close();
+}
+
+bool omp::MappedFile::open(const std::string& inPath)
+{
+    close();
+
+#if defined(OMP_MMAP)
+    const int file = ::open(inPath.c_str(), O_RDONLY);
+    if (file >= 0)
+    {
+        struct stat file_stat{};
+        if (fstat(file, &file_stat) == 0 && S_ISREG(file_stat.st_mode))
+        {
+            const size_t size = static_cast<size_t>(file_stat.st_size);
+            if (size == 0)
+            {
+                ::close(file);
+                m_Opened = true;
+                return true;
+            }
+
+            void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+            if (data != MAP_FAILED)
+            {
+                ::close(file);
+                madvise(data, size, MADV_SEQUENTIAL);
+                m_Data = static_cast<const char*>(data);
+                m_Size = size;
+                m_Mapped = true;
+                m_Opened = true;
+                return true;
+            }
+        }
+        ::close(file);
+    }
+#endif
+
+    if (!omp::JsonConverter::readFile(inPath, m_Buffer))
+    {
+        m_Buffer.clear();
+        return false;
+    }
+    m_Data = m_Buffer.data();
+    m_Size = m_Buffer.size();
+    m_Opened = true;
+    return true;
+}
+
+void omp::MappedFile::close()
+{
+#if defined(OMP_MMAP)
+    if (m_Mapped)
+    {
+        munmap(const_cast<char*>(m_Data), m_Size);
+    }
+#endif
+    m_Data = nullptr;
+    m_Size = 0;
+    m_Mapped = false;
+    m_Opened = false;
+    m_Buffer.clear();
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace omp
+{
+    /*
+     * @brief Read only view of a whole file.
+     * Mapped with mmap on POSIX systems, elsewhere contents are read into an owned buffer.
+     */
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&& other) = delete;
+        MappedFile& operator=(MappedFile&& other) = delete;
+
+        bool open(const std::string& inPath);
+        void close();
+
+        std::string_view view() const { return std::string_view(m_Data, m_Size); }
+        bool isOpen() const { return m_Opened; }
+
+    private:
+        const char* m_Data = nullptr;
+        size_t m_Size = 0;
+        bool m_Mapped = false;
+        bool m_Opened = false;
+        // Used when file can't be mapped
+        std::string m_Buffer;
+    };
+}
@@ -0,0 +1,726 @@
+#include "IO/ObjParser.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include "Async/ThreadPool.h"
+#include "Core/Profiling.h"
+#include "Math/Hash.h"
+
+struct omp::ObjParser::Chunk
+{
+    std::vector<float> positions;
+    std::vector<float> colors;
+    std::vector<float> texcoords;
+    std::vector<float> normals;
+    // Position, texcoord and normal index of every face corner, zero based
+    std::vector<uint32_t> corners;
+    std::vector<uint8_t> face_sizes;
+    size_t triangle_count = 0;
+    bool supported = true;
+};
+
+namespace
+{
+    bool isSpace(char inChar)
+    {
+        return inChar == ' ' || inChar == '\t';
+    }
+
+    bool isDigit(char inChar)
+    {
+        return inChar >= '0' && inChar <= '9';
+    }
+
+    const char* skipSpaces(const char* inBegin, const char* inEnd)
+    {
+        while (inBegin < inEnd && isSpace(*inBegin))
+        {
+            inBegin++;
+        }
+        return inBegin;
+    }
+
+    const char* tokenEnd(const char* inBegin, const char* inEnd)
+    {
+        while (inBegin < inEnd && !isSpace(*inBegin))
+        {
+            inBegin++;
+        }
+        return inBegin;
+    }
+
+    /*
+     * Same digit accumulation as tinyobj tryParseDouble, std::from_chars rounds correctly
+     * and would differ from the tinyobj path in the last bit for some inputs.
+     * Returns end of the parsed number, nullptr when there is no number.
+     */
+    const char* parseDouble(const char* inBegin, const char* inEnd, double& outValue)
+    {
+        static constexpr std::array<double, 8> pow_lut = {1.0, 0.1, 0.01, 0.001, 0.0001, 0.00001, 0.000001, 0.0000001};
+
+        if (inBegin >= inEnd)
+        {
+            return nullptr;
+        }
+
+        double mantissa = 0.0;
+        int exponent = 0;
+        bool negative = false;
+        bool leading_dot = false;
+        const char* current = inBegin;
+
+        if (*current == '+' || *current == '-')
+        {
+            negative = *current == '-';
+            current++;
+            leading_dot = current != inEnd && *current == '.';
+        }
+        else if (*current == '.')
+        {
+            leading_dot = true;
+        }
+        else if (!isDigit(*current))
+        {
+            return nullptr;
+        }
+
+        if (!leading_dot)
+        {
+            int read = 0;
+            while (current != inEnd && isDigit(*current))
+            {
+                mantissa *= 10;
+                mantissa += (*current - '0');
+                current++;
+                read++;
+            }
+            if (read == 0)
+            {
+                return nullptr;
+            }
+        }
+
+        if (current != inEnd && *current == '.')
+        {
+            current++;
+            int read = 1;
+            while (current != inEnd && isDigit(*current))
+            {
+                const double scale = read < static_cast<int>(pow_lut.size())
+                        ? pow_lut[static_cast<size_t>(read)]
+                        : std::pow(10.0, -read);
+                mantissa += (*current - '0') * scale;
+                read++;
+                current++;
+            }
+        }
+
+        if (current != inEnd && (*current == 'e' || *current == 'E'))
+        {
+            current++;
+            bool negative_exponent = false;
+            if (current != inEnd && (*current == '+' || *current == '-'))
+            {
+                negative_exponent = *current == '-';
+                current++;
+            }
+            else if (current == inEnd || !isDigit(*current))
+            {
+                return nullptr;
+            }
+
+            int read = 0;
+            while (current != inEnd && isDigit(*current))
+            {
+                if (exponent > 2147483647 / 10)
+                {
+                    return nullptr;
+                }
+                exponent *= 10;
+                exponent += (*current - '0');
+                current++;
+                read++;
+            }
+            if (read == 0)
+            {
+                return nullptr;
+            }
+            exponent *= negative_exponent ? -1 : 1;
+        }
+
+        outValue = (negative ? -1 : 1) * (exponent ? std::ldexp(mantissa * std::pow(5.0, exponent), exponent) : mantissa);
+        return current;
+    }
+
+    /*
+     * Reads whitespace separated reals until the end of line, false if a token is not a number
+     */
+    template< size_t MaxCount >
+    bool parseReals(const char* inBegin, const char* inEnd, std::array<float, MaxCount>& outValues, size_t& outCount)
+    {
+        outCount = 0;
+        const char* current = skipSpaces(inBegin, inEnd);
+        while (current < inEnd)
+        {
+            const char* end = tokenEnd(current, inEnd);
+            double value = 0.0;
+            if (outCount == MaxCount || parseDouble(current, end, value) != end || std::isnan(value))
+            {
+                return false;
+            }
+            outValues[outCount++] = static_cast<float>(value);
+            current = skipSpaces(end, inEnd);
+        }
+        return true;
+    }
+
+    bool parseIndex(const char* inBegin, const char* inEnd, uint32_t& outIndex)
+    {
+        uint32_t value = 0;
+        std::from_chars_result result = std::from_chars(inBegin, inEnd, value);
+        // Relative and zero indices are left to tinyobj
+        if (result.ec != std::errc() || result.ptr != inEnd || value == 0 || value > 2147483647U)
+        {
+            return false;
+        }
+        outIndex = value - 1;
+        return true;
+    }
+
+    bool parseCorner(const char* inBegin, const char* inEnd, std::vector<uint32_t>& outCorners)
+    {
+        const char* first_slash = std::find(inBegin, inEnd, '/');
+        if (first_slash == inEnd)
+        {
+            return false;
+        }
+        const char* second_slash = std::find(first_slash + 1, inEnd, '/');
+        if (second_slash == inEnd)
+        {
+            return false;
+        }
+
+        uint32_t position = 0;
+        uint32_t texcoord = 0;
+        uint32_t normal = 0;
+        if (!parseIndex(inBegin, first_slash, position)
+            || !parseIndex(first_slash + 1, second_slash, texcoord)
+            || !parseIndex(second_slash + 1, inEnd, normal))
+        {
+            return false;
+        }
+
+        outCorners.push_back(position);
+        outCorners.push_back(texcoord);
+        outCorners.push_back(normal);
+        return true;
+    }
+
+    uint64_t mix(uint64_t inKey)
+    {
+        inKey ^= inKey >> 33;
+        inKey *= 0xff51afd7ed558ccdULL;
+        inKey ^= inKey >> 33;
+        inKey *= 0xc4ceb9fe1a85ec53ULL;
+        inKey ^= inKey >> 33;
+        return inKey;
+    }
+
+    size_t tableCapacity(size_t inCount)
+    {
+        return std::bit_ceil(std::max<size_t>(inCount * 2, 64));
+    }
+
+    constexpr uint32_t EMPTY = UINT32_MAX;
+
+    // Corners are deduplicated in hash partitions, counted and scattered in blocks
+    constexpr int PARTITION_BITS = 6;
+    constexpr size_t PARTITION_COUNT = size_t{1} << PARTITION_BITS;
+    constexpr size_t PARTITION_BLOCK = size_t{1} << 16;
+
+    uint64_t cornerHash(const uint32_t* inCorner)
+    {
+        return mix((uint64_t{inCorner[0]} << 32 | inCorner[1]) ^ mix(inCorner[2]));
+    }
+
+    // Top bits pick the partition, table slots use the low ones
+    size_t partition(const uint32_t* inCorner)
+    {
+        return cornerHash(inCorner) >> (64 - PARTITION_BITS);
+    }
+
+    struct CornerSlot
+    {
+        uint32_t position = 0;
+        uint32_t texcoord = 0;
+        uint32_t normal = 0;
+        uint32_t corner = EMPTY;
+    };
+
+    /*
+     * Writes the first corner with the same index triple for every corner returned by inCornerAt, corners come in file order
+     */
+    template< typename CornerAt >
+    void findFirstCorners(const std::vector<uint32_t>& inCorners, size_t inCount, CornerAt&& inCornerAt, std::vector<uint32_t>& outFirstCorners)
+    {
+        // Closed meshes share every vertex between several triangles
+        std::vector<CornerSlot> slots(tableCapacity(inCount / 4));
+        size_t used = 0;
+        for (size_t index = 0; index < inCount; index++)
+        {
+            const uint32_t corner = inCornerAt(index);
+            const uint32_t* key = inCorners.data() + size_t{corner} * 3;
+            const size_t mask = slots.size() - 1;
+            size_t slot = cornerHash(key) & mask;
+            while (slots[slot].corner != EMPTY
+                   && (slots[slot].position != key[0] || slots[slot].texcoord != key[1] || slots[slot].normal != key[2]))
+            {
+                slot = (slot + 1) & mask;
+            }
+
+            if (slots[slot].corner != EMPTY)
+            {
+                outFirstCorners[corner] = slots[slot].corner;
+                continue;
+            }
+            slots[slot] = CornerSlot{key[0], key[1], key[2], corner};
+            outFirstCorners[corner] = corner;
+
+            if (++used * 2 > slots.size())
+            {
+                std::vector<CornerSlot> old_slots = std::move(slots);
+                slots.assign(old_slots.size() * 2, CornerSlot{});
+                const size_t new_mask = slots.size() - 1;
+                for (const CornerSlot& old_slot : old_slots)
+                {
+                    if (old_slot.corner == EMPTY)
+                    {
+                        continue;
+                    }
+                    const uint32_t old_key[3] = {old_slot.position, old_slot.texcoord, old_slot.normal};
+                    size_t new_slot = cornerHash(old_key) & new_mask;
+                    while (slots[new_slot].corner != EMPTY)
+                    {
+                        new_slot = (new_slot + 1) & new_mask;
+                    }
+                    slots[new_slot] = old_slot;
+                }
+            }
+        }
+    }
+}
+
+bool omp::ObjParser::parse(std::string_view inData, omp::ThreadPool* inThreadPool,
+                           std::vector<float>& outVertices, std::vector<uint32_t>& outIndices)
+{
+    OMP_STAT_SCOPE("ParseObj");
+
+    std::vector<std::string_view> ranges;
+    size_t begin = 0;
+    while (begin < inData.size())
+    {
+        size_t end = std::min(begin + CHUNK_SIZE, inData.size());
+        if (end < inData.size())
+        {
+            const size_t line_end = inData.find('\n', end);
+            end = line_end == std::string_view::npos ? inData.size() : line_end + 1;
+        }
+        ranges.push_back(inData.substr(begin, end - begin));
+        begin = end;
+    }
+
+    std::vector<Chunk> chunks(ranges.size());
+    auto parse_chunks = [&ranges, &chunks](size_t inBegin, size_t inEnd)
+    {
+        for (size_t index = inBegin; index < inEnd; index++)
+        {
+            parseChunk(ranges[index], chunks[index]);
+        }
+    };
+    if (inThreadPool)
+    {
+        inThreadPool->parallelFor(chunks.size(), 1, parse_chunks);
+    }
+    else
+    {
+        parse_chunks(0, chunks.size());
+    }
+
+    size_t position_floats = 0;
+    size_t texcoord_floats = 0;
+    size_t normal_floats = 0;
+    size_t corner_count = 0;
+    std::vector<size_t> corner_offsets(chunks.size());
+    for (size_t index = 0; index < chunks.size(); index++)
+    {
+        if (!chunks[index].supported)
+        {
+            return false;
+        }
+        corner_offsets[index] = corner_count;
+        position_floats += chunks[index].positions.size();
+        texcoord_floats += chunks[index].texcoords.size();
+        normal_floats += chunks[index].normals.size();
+        corner_count += chunks[index].triangle_count * 3;
+    }
+
+    std::vector<float> positions;
+    std::vector<float> colors;
+    std::vector<float> texcoords;
+    std::vector<float> normals;
+    positions.reserve(position_floats);
+    colors.reserve(position_floats);
+    texcoords.reserve(texcoord_floats);
+    normals.reserve(normal_floats);
+    for (Chunk& chunk : chunks)
+    {
+        positions.insert(positions.end(), chunk.positions.begin(), chunk.positions.end());
+        colors.insert(colors.end(), chunk.colors.begin(), chunk.colors.end());
+        texcoords.insert(texcoords.end(), chunk.texcoords.begin(), chunk.texcoords.end());
+        normals.insert(normals.end(), chunk.normals.begin(), chunk.normals.end());
+        chunk.positions = {};
+        chunk.colors = {};
+        chunk.texcoords = {};
+        chunk.normals = {};
+    }
+
+    // Quads are split by their positions, so corners are resolved after every position is known
+    std::vector<uint32_t> corners(corner_count * 3);
+    std::vector<uint8_t> valid(chunks.size(), 0);
+    auto triangulate_chunks = [&](size_t inBegin, size_t inEnd)
+    {
+        for (size_t index = inBegin; index < inEnd; index++)
+        {
+            valid[index] = triangulate(chunks[index], positions, texcoords.size() / 2, normals.size() / 3,
+                                       corners.data() + corner_offsets[index] * 3) ? 1 : 0;
+        }
+    };
+    if (inThreadPool)
+    {
+        inThreadPool->parallelFor(chunks.size(), 1, triangulate_chunks);
+    }
+    else
+    {
+        triangulate_chunks(0, chunks.size());
+    }
+    if (std::find(valid.begin(), valid.end(), 0) != valid.end())
+    {
+        return false;
+    }
+    chunks.clear();
+
+    return deduplicate(corners, positions, colors, texcoords, normals, inThreadPool, outVertices, outIndices);
+}
+
+void omp::ObjParser::parseChunk(std::string_view inData, Chunk& outChunk)
+{
+    const char* current = inData.data();
+    const char* end = inData.data() + inData.size();
+    while (current < end)
+    {
+        const char* line_end = static_cast<const char*>(std::memchr(current, '\n', static_cast<size_t>(end - current)));
+        if (!line_end)
+        {
+            line_end = end;
+        }
+
+        const char* content_end = line_end;
+        if (content_end > current && *(content_end - 1) == '\r')
+        {
+            content_end--;
+        }
+
+        // Lone carriage returns are line breaks for tinyobj
+        if (std::memchr(current, '\r', static_cast<size_t>(content_end - current)) || !parseLine(current, content_end, outChunk))
+        {
+            outChunk.supported = false;
+            return;
+        }
+        current = line_end + 1;
+    }
+}
+
+bool omp::ObjParser::parseLine(const char* inBegin, const char* inEnd, Chunk& outChunk)
+{
+    const char* token = skipSpaces(inBegin, inEnd);
+    const size_t length = static_cast<size_t>(inEnd - token);
+    if (length < 2)
+    {
+        return true;
+    }
+
+    if (token[0] == 'v' && isSpace(token[1]))
+    {
+        std::array<float, 6> values{};
+        size_t count = 0;
+        // x y z w lines are read differently between tinyobj versions
+        if (!parseReals(token + 2, inEnd, values, count) || (count != 3 && count != 6))
+        {
+            return false;
+        }
+        outChunk.positions.insert(outChunk.positions.end(), values.begin(), values.begin() + 3);
+        if (count == 6)
+        {
+            outChunk.colors.insert(outChunk.colors.end(), values.begin() + 3, values.end());
+        }
+        else
+        {
+            outChunk.colors.insert(outChunk.colors.end(), {1.0f, 1.0f, 1.0f});
+        }
+        return true;
+    }
+
+    if (length > 2 && token[0] == 'v' && token[1] == 't' && isSpace(token[2]))
+    {
+        std::array<float, 3> values{};
+        size_t count = 0;
+        if (!parseReals(token + 3, inEnd, values, count) || count < 2)
+        {
+            return false;
+        }
+        outChunk.texcoords.insert(outChunk.texcoords.end(), values.begin(), values.begin() + 2);
+        return true;
+    }
+
+    if (length > 2 && token[0] == 'v' && token[1] == 'n' && isSpace(token[2]))
+    {
+        std::array<float, 3> values{};
+        size_t count = 0;
+        if (!parseReals(token + 3, inEnd, values, count) || count != 3)
+        {
+            return false;
+        }
+        outChunk.normals.insert(outChunk.normals.end(), values.begin(), values.end());
+        return true;
+    }
+
+    if (token[0] == 'f' && isSpace(token[1]))
+    {
+        size_t count = 0;
+        const char* current = skipSpaces(token + 2, inEnd);
+        while (current < inEnd)
+        {
+            const char* end = tokenEnd(current, inEnd);
+            if (count == 4 || !parseCorner(current, end, outChunk.corners))
+            {
+                return false;
+            }
+            count++;
+            current = skipSpaces(end, inEnd);
+        }
+
+        // Larger polygons go through tinyobj triangulation
+        if (count < 3)
+        {
+            return false;
+        }
+        outChunk.face_sizes.push_back(static_cast<uint8_t>(count));
+        outChunk.triangle_count += count - 2;
+        return true;
+    }
+
+    // Groups, materials, smoothing and comments don't change the mesh
+    return true;
+}
+
+bool omp::ObjParser::triangulate(const Chunk& inChunk, const std::vector<float>& inPositions,
+                                 size_t inTexcoordCount, size_t inNormalCount, uint32_t* outCorners)
+{
+    const size_t position_count = inPositions.size() / 3;
+    const uint32_t* corner = inChunk.corners.data();
+    for (uint8_t face_size : inChunk.face_sizes)
+    {
+        for (size_t index = 0; index < face_size; index++)
+        {
+            if (corner[index * 3] >= position_count
+                || corner[index * 3 + 1] >= inTexcoordCount
+                || corner[index * 3 + 2] >= inNormalCount)
+            {
+                return false;
+            }
+        }
+
+        std::array<size_t, 6> order = {0, 1, 2, 0, 0, 0};
+        if (face_size == 4)
+        {
+            // Shorter diagonal is the split edge, same as tinyobj
+            auto position = [&inPositions, corner](size_t inCorner, size_t inAxis)
+            {
+                return inPositions[size_t{corner[inCorner * 3]} * 3 + inAxis];
+            };
+            const float e02x = position(2, 0) - position(0, 0);
+            const float e02y = position(2, 1) - position(0, 1);
+            const float e02z = position(2, 2) - position(0, 2);
+            const float e13x = position(3, 0) - position(1, 0);
+            const float e13y = position(3, 1) - position(1, 1);
+            const float e13z = position(3, 2) - position(1, 2);
+            const float sqr02 = e02x * e02x + e02y * e02y + e02z * e02z;
+            const float sqr13 = e13x * e13x + e13y * e13y + e13z * e13z;
+
+            order = sqr02 < sqr13
+                    ? std::array<size_t, 6>{0, 1, 2, 0, 2, 3}
+                    : std::array<size_t, 6>{0, 1, 3, 1, 2, 3};
+        }
+
+        const size_t corner_count = face_size == 4 ? 6 : 3;
+        for (size_t index = 0; index < corner_count; index++)
+        {
+            std::memcpy(outCorners, corner + order[index] * 3, 3 * sizeof(uint32_t));
+            outCorners += 3;
+        }
+        corner += size_t{face_size} * 3;
+    }
+    return true;
+}
+
+bool omp::ObjParser::deduplicate(const std::vector<uint32_t>& inCorners, const std::vector<float>& inPositions,
+                                 const std::vector<float>& inColors, const std::vector<float>& inTexcoords,
+                                 const std::vector<float>& inNormals, omp::ThreadPool* inThreadPool,
+                                 std::vector<float>& outVertices, std::vector<uint32_t>& outIndices)
+{
+    OMP_STAT_SCOPE("DeduplicateObj");
+
+    const size_t corner_count = inCorners.size() / 3;
+    if (corner_count >= EMPTY)
+    {
+        return false;
+    }
+
+    // Equal index triples always give equal vertices, first corner of every triple is found per hash partition
+    std::vector<uint32_t> first_corners(corner_count);
+    if (!inThreadPool)
+    {
+        findFirstCorners(inCorners, corner_count, [](size_t inIndex) { return static_cast<uint32_t>(inIndex); }, first_corners);
+    }
+    else
+    {
+        // Stable scatter of corners by partition, so every partition sees its corners in file order
+        const size_t block_count = (corner_count + PARTITION_BLOCK - 1) / PARTITION_BLOCK;
+        std::vector<size_t> offsets(block_count * PARTITION_COUNT, 0);
+        inThreadPool->parallelFor(block_count, 1, [&inCorners, &offsets, corner_count](size_t inBegin, size_t inEnd)
+        {
+            for (size_t block = inBegin; block < inEnd; block++)
+            {
+                const size_t end = std::min((block + 1) * PARTITION_BLOCK, corner_count);
+                for (size_t corner = block * PARTITION_BLOCK; corner < end; corner++)
+                {
+                    offsets[block * PARTITION_COUNT + partition(inCorners.data() + corner * 3)]++;
+                }
+            }
+        });
+
+        std::vector<size_t> partition_begins(PARTITION_COUNT + 1, 0);
+        size_t running = 0;
+        for (size_t part = 0; part < PARTITION_COUNT; part++)
+        {
+            partition_begins[part] = running;
+            for (size_t block = 0; block < block_count; block++)
+            {
+                const size_t count = offsets[block * PARTITION_COUNT + part];
+                offsets[block * PARTITION_COUNT + part] = running;
+                running += count;
+            }
+        }
+        partition_begins[PARTITION_COUNT] = running;
+
+        std::vector<uint32_t> order(corner_count);
+        inThreadPool->parallelFor(block_count, 1, [&inCorners, &offsets, &order, corner_count](size_t inBegin, size_t inEnd)
+        {
+            for (size_t block = inBegin; block < inEnd; block++)
+            {
+                const size_t end = std::min((block + 1) * PARTITION_BLOCK, corner_count);
+                for (size_t corner = block * PARTITION_BLOCK; corner < end; corner++)
+                {
+                    order[offsets[block * PARTITION_COUNT + partition(inCorners.data() + corner * 3)]++] = static_cast<uint32_t>(corner);
+                }
+            }
+        });
+
+        inThreadPool->parallelFor(PARTITION_COUNT, 1, [&inCorners, &partition_begins, &order, &first_corners](size_t inBegin, size_t inEnd)
+        {
+            for (size_t part = inBegin; part < inEnd; part++)
+            {
+                const uint32_t* part_order = order.data() + partition_begins[part];
+                findFirstCorners(inCorners, partition_begins[part + 1] - partition_begins[part],
+                                 [part_order](size_t inIndex) { return part_order[inIndex]; }, first_corners);
+            }
+        });
+    }
+
+    // Different triples can still hold equal values, tinyobj path merges them by value in order of first use
+    outVertices.clear();
+    outIndices.resize(corner_count);
+    std::vector<uint32_t> vertex_slots(tableCapacity(inPositions.size() / 3), EMPTY);
+    size_t vertex_count = 0;
+
+    auto vertex_hash = [&outVertices](size_t inVertex)
+    {
+        return omp::HashLib::hashFloats(outVertices.data() + inVertex * VERTEX_FLOATS, VERTEX_FLOATS);
+    };
+    auto vertex_equal = [&outVertices](size_t inFirst, size_t inSecond)
+    {
+        for (size_t index = 0; index < VERTEX_FLOATS; index++)
+        {
+            if (outVertices[inFirst * VERTEX_FLOATS + index] != outVertices[inSecond * VERTEX_FLOATS + index])
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    for (size_t corner = 0; corner < corner_count; corner++)
+    {
+        if (first_corners[corner] != corner)
+        {
+            outIndices[corner] = outIndices[first_corners[corner]];
+            continue;
+        }
+
+        const size_t p = size_t{inCorners[corner * 3]} * 3;
+        const size_t t = size_t{inCorners[corner * 3 + 1]} * 2;
+        const size_t n = size_t{inCorners[corner * 3 + 2]} * 3;
+        outVertices.insert(outVertices.end(), {
+                inPositions[p], inPositions[p + 1], inPositions[p + 2],
+                inColors[p], inColors[p + 1], inColors[p + 2],
+                inTexcoords[t], 1 - inTexcoords[t + 1],
+                inNormals[n], inNormals[n + 1], inNormals[n + 2]});
+
+        const size_t mask = vertex_slots.size() - 1;
+        size_t slot = vertex_hash(vertex_count) & mask;
+        while (vertex_slots[slot] != EMPTY && !vertex_equal(vertex_slots[slot], vertex_count))
+        {
+            slot = (slot + 1) & mask;
+        }
+
+        if (vertex_slots[slot] != EMPTY)
+        {
+            outIndices[corner] = vertex_slots[slot];
+            outVertices.resize(outVertices.size() - VERTEX_FLOATS);
+            continue;
+        }
+
+        vertex_slots[slot] = static_cast<uint32_t>(vertex_count);
+        outIndices[corner] = static_cast<uint32_t>(vertex_count);
+        vertex_count++;
+
+        if (vertex_count * 2 > vertex_slots.size())
+        {
+            vertex_slots.assign(vertex_slots.size() * 2, EMPTY);
+            const size_t new_mask = vertex_slots.size() - 1;
+            for (size_t vertex = 0; vertex < vertex_count; vertex++)
+            {
+                size_t new_slot = vertex_hash(vertex) & new_mask;
+                while (vertex_slots[new_slot] != EMPTY)
+                {
+                    new_slot = (new_slot + 1) & new_mask;
+                }
+                vertex_slots[new_slot] = static_cast<uint32_t>(vertex);
+            }
+        }
+    }
+    return true;
+}
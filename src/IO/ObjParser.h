@@ -0,0 +1,41 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace omp
+{
+    class ThreadPool;
+
+    /*
+     * @brief Multithreaded parser for OBJ files as written by common exporters: v, vt, vn and triangle or quad faces with v/vt/vn corners.
+     * File is split into line aligned chunks parsed in parallel, faces are triangulated and vertices deduplicated
+     * in file order, so the result is identical to the tinyobj path of ModelImporter.
+     * Returns false for anything outside of that subset, caller falls back to tinyobj.
+     */
+    class ObjParser
+    {
+    public:
+        // pos, color, tex_coord, normal, same layout as omp::Vertex
+        static constexpr size_t VERTEX_FLOATS = 11;
+
+        [[nodiscard]] static bool parse(std::string_view inData, omp::ThreadPool* inThreadPool,
+                                        std::vector<float>& outVertices, std::vector<uint32_t>& outIndices);
+
+    private:
+        struct Chunk;
+
+        static void parseChunk(std::string_view inData, Chunk& outChunk);
+        static bool parseLine(const char* inBegin, const char* inEnd, Chunk& outChunk);
+        static bool triangulate(const Chunk& inChunk, const std::vector<float>& inPositions,
+                                size_t inTexcoordCount, size_t inNormalCount, uint32_t* outCorners);
+        static bool deduplicate(const std::vector<uint32_t>& inCorners, const std::vector<float>& inPositions,
+                                const std::vector<float>& inColors, const std::vector<float>& inTexcoords,
+                                const std::vector<float>& inNormals, omp::ThreadPool* inThreadPool,
+                                std::vector<float>& outVertices, std::vector<uint32_t>& outIndices);
+
+        // Big enough to amortize task overhead, small enough to balance a few MB files
+        static constexpr size_t CHUNK_SIZE = size_t{1} << 20;
+    };
+}
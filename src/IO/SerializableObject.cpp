@@ -32,3 +32,7 @@ std::shared_ptr<omp::SerializableObject> omp::SerializableObject::getDependency(
     return nullptr;
 }
 
+omp::ThreadPool* omp::SerializableObject::getThreadPool() const
+{
+    return m_Asset ? m_Asset->getThreadPool() : nullptr;
+}
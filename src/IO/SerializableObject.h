@@ -5,6 +5,7 @@
 namespace omp {
 
 class Asset;
+class ThreadPool;
 
 class SerializableObject {
 public:
@@ -23,6 +24,8 @@ public:
 
   SerializationId serializeDependency(SerializableObject* object);
   std::shared_ptr<SerializableObject> getDependency(SerializationId);
+  // Pool of the owning asset, nullptr when loaded without asset manager threads
+  omp::ThreadPool* getThreadPool() const;
 
   friend class Asset;
 };
@@ -0,0 +1,729 @@
+#include "IO/StreamJson.h"
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include "Logs.h"
+
+namespace
+{
+    class StreamJsonReader
+    {
+    public:
+        StreamJsonReader(const std::string& inBuffer, std::vector<omp::StreamJsonNode>& outNodes)
+            : m_Buffer(inBuffer)
+            , m_Nodes(outNodes)
+        {
+        }
+
+        bool parseDocument()
+        {
+            skipWhitespace();
+            if (!parseValue(0))
+            {
+                return false;
+            }
+            skipWhitespace();
+            return m_Position == m_Buffer.size();
+        }
+
+    private:
+        // Deeper nesting is treated as malformed input instead of overflowing the stack
+        static constexpr size_t s_MaxDepth = 512;
+
+        const std::string& m_Buffer;
+        std::vector<omp::StreamJsonNode>& m_Nodes;
+        size_t m_Position = 0;
+
+        void skipWhitespace()
+        {
+            while (m_Position < m_Buffer.size())
+            {
+                char symbol = m_Buffer[m_Position];
+                if (symbol != ' ' && symbol != '\n' && symbol != '\r' && symbol != '\t')
+                {
+                    break;
+                }
+                m_Position++;
+            }
+        }
+
+        size_t addNode(omp::EStreamJsonType inType)
+        {
+            m_Nodes.push_back({inType, m_Position, m_Position, 0});
+            return m_Nodes.size() - 1;
+        }
+
+        void closeNode(size_t inNode)
+        {
+            m_Nodes[inNode].end = m_Position;
+            m_Nodes[inNode].next = m_Nodes.size();
+        }
+
+        bool parseValue(size_t inDepth)
+        {
+            if (m_Position >= m_Buffer.size() || inDepth > s_MaxDepth)
+            {
+                return false;
+            }
+
+            switch (m_Buffer[m_Position])
+            {
+                case '{':
+                    return parseObject(inDepth);
+                case '[':
+                    return parseArray(inDepth);
+                case '"':
+                    return parseString();
+                case 't':
+                    return parseLiteral("true", omp::EStreamJsonType::Bool);
+                case 'f':
+                    return parseLiteral("false", omp::EStreamJsonType::Bool);
+                case 'n':
+                    return parseLiteral("null", omp::EStreamJsonType::Null);
+                default:
+                    return parseNumber();
+            }
+        }
+
+        bool parseObject(size_t inDepth)
+        {
+            size_t node = addNode(omp::EStreamJsonType::Object);
+            m_Position++;
+            skipWhitespace();
+
+            if (m_Position < m_Buffer.size() && m_Buffer[m_Position] == '}')
+            {
+                m_Position++;
+                closeNode(node);
+                return true;
+            }
+
+            while (m_Position < m_Buffer.size())
+            {
+                if (m_Buffer[m_Position] != '"' || !parseString())
+                {
+                    return false;
+                }
+                skipWhitespace();
+                if (m_Position >= m_Buffer.size() || m_Buffer[m_Position] != ':')
+                {
+                    return false;
+                }
+                m_Position++;
+                skipWhitespace();
+                if (!parseValue(inDepth + 1))
+                {
+                    return false;
+                }
+                skipWhitespace();
+
+                if (m_Position < m_Buffer.size() && m_Buffer[m_Position] == ',')
+                {
+                    m_Position++;
+                    skipWhitespace();
+                }
+                else if (m_Position < m_Buffer.size() && m_Buffer[m_Position] == '}')
+                {
+                    m_Position++;
+                    closeNode(node);
+                    return true;
+                }
+                else
+                {
+                    return false;
+                }
+            }
+            return false;
+        }
+
+        bool parseArray(size_t inDepth)
+        {
+            size_t node = addNode(omp::EStreamJsonType::Array);
+            m_Position++;
+            skipWhitespace();
+
+            if (m_Position < m_Buffer.size() && m_Buffer[m_Position] == ']')
+            {
+                m_Position++;
+                closeNode(node);
+                return true;
+            }
+
+            while (m_Position < m_Buffer.size())
+            {
+                if (!parseValue(inDepth + 1))
+                {
+                    return false;
+                }
+                skipWhitespace();
+
+                if (m_Position < m_Buffer.size() && m_Buffer[m_Position] == ',')
+                {
+                    m_Position++;
+                    skipWhitespace();
+                }
+                else if (m_Position < m_Buffer.size() && m_Buffer[m_Position] == ']')
+                {
+                    m_Position++;
+                    closeNode(node);
+                    return true;
+                }
+                else
+                {
+                    return false;
+                }
+            }
+            return false;
+        }
+
+        bool parseString()
+        {
+            size_t node = addNode(omp::EStreamJsonType::String);
+            m_Position++;
+            while (m_Position < m_Buffer.size())
+            {
+                char symbol = m_Buffer[m_Position];
+                if (symbol == '\\')
+                {
+                    m_Position += 2;
+                    continue;
+                }
+                m_Position++;
+                if (symbol == '"')
+                {
+                    closeNode(node);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool parseLiteral(std::string_view inLiteral, omp::EStreamJsonType inType)
+        {
+            if (std::string_view(m_Buffer).substr(m_Position, inLiteral.size()) != inLiteral)
+            {
+                return false;
+            }
+            size_t node = addNode(inType);
+            m_Position += inLiteral.size();
+            closeNode(node);
+            return true;
+        }
+
+        bool parseNumber()
+        {
+            size_t node = addNode(omp::EStreamJsonType::Number);
+            while (m_Position < m_Buffer.size())
+            {
+                char symbol = m_Buffer[m_Position];
+                bool number_symbol = (symbol >= '0' && symbol <= '9')
+                        || symbol == '-' || symbol == '+' || symbol == '.' || symbol == 'e' || symbol == 'E';
+                if (!number_symbol)
+                {
+                    break;
+                }
+                m_Position++;
+            }
+            closeNode(node);
+            return m_Nodes[node].end > m_Nodes[node].begin;
+        }
+    };
+
+    uint32_t readHex(std::string_view inText, size_t inPosition)
+    {
+        uint32_t value = 0;
+        if (inPosition + 4 > inText.size())
+        {
+            return 0;
+        }
+        std::from_chars(inText.data() + inPosition, inText.data() + inPosition + 4, value, 16);
+        return value;
+    }
+
+    void appendUtf8(std::string& outText, uint32_t inCodepoint)
+    {
+        if (inCodepoint < 0x80)
+        {
+            outText += static_cast<char>(inCodepoint);
+        }
+        else if (inCodepoint < 0x800)
+        {
+            outText += static_cast<char>(0xC0 | (inCodepoint >> 6));
+            outText += static_cast<char>(0x80 | (inCodepoint & 0x3F));
+        }
+        else if (inCodepoint < 0x10000)
+        {
+            outText += static_cast<char>(0xE0 | (inCodepoint >> 12));
+            outText += static_cast<char>(0x80 | ((inCodepoint >> 6) & 0x3F));
+            outText += static_cast<char>(0x80 | (inCodepoint & 0x3F));
+        }
+        else
+        {
+            outText += static_cast<char>(0xF0 | (inCodepoint >> 18));
+            outText += static_cast<char>(0x80 | ((inCodepoint >> 12) & 0x3F));
+            outText += static_cast<char>(0x80 | ((inCodepoint >> 6) & 0x3F));
+            outText += static_cast<char>(0x80 | (inCodepoint & 0x3F));
+        }
+    }
+}
+
+bool omp::StreamJsonDocument::parse()
+{
+    nodes.clear();
+    member_index.clear();
+    StreamJsonReader reader(buffer, nodes);
+    if (!reader.parseDocument())
+    {
+        nodes.clear();
+        return false;
+    }
+
+    for (size_t object = 0; object < nodes.size(); object++)
+    {
+        if (nodes[object].type != EStreamJsonType::Object)
+        {
+            continue;
+        }
+
+        std::unordered_map<std::string_view, size_t> members;
+        bool escaped = false;
+        for (size_t key = object + 1; key < nodes[object].next && !escaped; key = nodes[key + 1].next)
+        {
+            std::string_view key_text = raw(key);
+            key_text = key_text.substr(1, key_text.size() - 2);
+            escaped = key_text.find('\\') != std::string_view::npos;
+            members.emplace(key_text, key + 1);
+        }
+
+        // Escaped keys can only be compared decoded, leave such objects to linear search
+        if (!escaped && members.size() >= INDEX_MEMBER_COUNT)
+        {
+            member_index.emplace(object, std::move(members));
+        }
+    }
+    return true;
+}
+
+std::string_view omp::StreamJsonDocument::raw(size_t inNode) const
+{
+    const StreamJsonNode& node = nodes[inNode];
+    return std::string_view(buffer).substr(node.begin, node.end - node.begin);
+}
+
+std::string omp::StreamJsonDocument::decodeString(size_t inNode) const
+{
+    std::string_view text = raw(inNode);
+    text = text.substr(1, text.size() - 2);
+
+    if (text.find('\\') == std::string_view::npos)
+    {
+        return std::string(text);
+    }
+
+    std::string result;
+    result.reserve(text.size());
+    for (size_t i = 0; i < text.size(); i++)
+    {
+        if (text[i] != '\\' || i + 1 >= text.size())
+        {
+            result += text[i];
+            continue;
+        }
+
+        i++;
+        switch (text[i])
+        {
+            case 'b': result += '\b'; break;
+            case 'f': result += '\f'; break;
+            case 'n': result += '\n'; break;
+            case 'r': result += '\r'; break;
+            case 't': result += '\t'; break;
+            case 'u':
+            {
+                uint32_t codepoint = readHex(text, i + 1);
+                i += 4;
+                // Surrogate pair
+                if (codepoint >= 0xD800 && codepoint < 0xDC00 && i + 6 < text.size() && text[i + 1] == '\\' && text[i + 2] == 'u')
+                {
+                    uint32_t low = readHex(text, i + 3);
+                    codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+                    i += 6;
+                }
+                appendUtf8(result, codepoint);
+                break;
+            }
+            default: result += text[i]; break;
+        }
+    }
+    return result;
+}
+
+std::optional<size_t> omp::StreamJsonDocument::findMember(size_t inObject, std::string_view inKey) const
+{
+    const StreamJsonNode& object = nodes[inObject];
+    if (object.type != EStreamJsonType::Object)
+    {
+        return std::nullopt;
+    }
+
+    auto index = member_index.find(inObject);
+    if (index != member_index.end())
+    {
+        auto member = index->second.find(inKey);
+        if (member == index->second.end())
+        {
+            return std::nullopt;
+        }
+        return member->second;
+    }
+
+    for (size_t key = inObject + 1; key < object.next; key = nodes[key + 1].next)
+    {
+        std::string_view key_text = raw(key);
+        key_text = key_text.substr(1, key_text.size() - 2);
+        bool equal = key_text.find('\\') == std::string_view::npos
+                ? key_text == inKey
+                : decodeString(key) == inKey;
+        if (equal)
+        {
+            return key + 1;
+        }
+    }
+    return std::nullopt;
+}
+
+omp::streamjson::streamjson(std::shared_ptr<const StreamJsonDocument> inDocument, size_t inNode)
+    : m_Document(std::move(inDocument))
+    , m_Node(inNode)
+{
+}
+
+template<typename Sink>
+void omp::streamjson::stream(Sink&& sink) const
+{
+    sink("{");
+    bool first = true;
+
+    if (m_Document)
+    {
+        const std::vector<StreamJsonNode>& nodes = m_Document->nodes;
+        for (size_t key = m_Node + 1; key < nodes[m_Node].next; key = nodes[key + 1].next)
+        {
+            if (m_WrittenIndex.contains(m_Document->decodeString(key)))
+            {
+                continue;
+            }
+            if (!first)
+            {
+                sink(",");
+            }
+            first = false;
+
+            sink(m_Document->raw(key));
+            sink(":");
+            sink(m_Document->raw(key + 1));
+        }
+    }
+
+    std::string key_text;
+    for (const auto& [key, value] : m_Written)
+    {
+        key_text.clear();
+        if (!first)
+        {
+            key_text += ',';
+        }
+        first = false;
+
+        appendString(key_text, key);
+        key_text += ':';
+        sink(std::string_view(key_text));
+        sink(std::string_view(value));
+    }
+    sink("}");
+}
+
+bool omp::streamjson::readJsonFromFile(const std::string& inFilePath)
+{
+    std::string data;
+    if (!JsonConverter::readFile(inFilePath, data))
+    {
+        VWARN(LogIO, "Cant read json file {1}", inFilePath);
+        return false;
+    }
+    return readJsonFromData(std::move(data), inFilePath);
+}
+
+bool omp::streamjson::readJsonFromData(std::string&& inData, const std::string& inSourceName)
+{
+    auto document = std::make_shared<StreamJsonDocument>();
+    document->buffer = std::move(inData);
+
+    if (JsonConverter::detectFormat(document->buffer) == EJsonFormat::Binary)
+    {
+        std::string binary = std::move(document->buffer);
+        if (!JsonConverter::binaryToText(binary, document->buffer))
+        {
+            VWARN(LogIO, "Cant parse binary file {1}", inSourceName);
+            return false;
+        }
+    }
+
+    if (!document->parse() || document->nodes[0].type != EStreamJsonType::Object)
+    {
+        VWARN(LogIO, "Cant parse json file {1}", inSourceName);
+        return false;
+    }
+
+    m_Document = std::move(document);
+    m_Node = 0;
+    m_Written.clear();
+    m_WrittenIndex.clear();
+    return true;
+}
+
+bool omp::streamjson::writeJsonToFile(const std::string& inFilePath, EJsonFormat inFormat) const
+{
+    if (inFormat == EJsonFormat::Binary)
+    {
+        std::string binary;
+        if (!JsonConverter::textToBinary(to_string(), binary) || !JsonConverter::writeFile(inFilePath, binary))
+        {
+            VWARN(LogIO, "Cant write binary to file: {1}", inFilePath);
+            return false;
+        }
+        return true;
+    }
+
+    std::ofstream file(inFilePath, std::ios::binary);
+    if (!file.is_open())
+    {
+        VWARN(LogIO, "Cant write json to file: {1}", inFilePath);
+        return false;
+    }
+
+    stream([&file](std::string_view inText)
+           {
+               file.write(inText.data(), static_cast<std::streamsize>(inText.size()));
+           });
+    file << '\n';
+    return true;
+}
+
+omp::streamjson omp::streamjson::readObject(const std::string& inKey) const
+{
+    auto written = m_WrittenIndex.find(inKey);
+    if (written != m_WrittenIndex.end())
+    {
+        auto document = std::make_shared<StreamJsonDocument>();
+        document->buffer = m_Written[written->second].second;
+        if (document->parse() && document->nodes[0].type == EStreamJsonType::Object)
+        {
+            return streamjson(std::move(document), 0);
+        }
+    }
+    else if (m_Document)
+    {
+        std::optional<size_t> node = m_Document->findMember(m_Node, inKey);
+        if (node.has_value() && m_Document->nodes[node.value()].type == EStreamJsonType::Object)
+        {
+            return streamjson(m_Document, node.value());
+        }
+    }
+
+    throw std::out_of_range("streamjson: no object with key " + inKey);
+}
+
+void omp::streamjson::writeObject(const std::string& inKey, streamjson&& inObject)
+{
+    std::string text;
+    inObject.stream([&text](std::string_view inText)
+                    {
+                        text.append(inText);
+                    });
+    setWritten(inKey, std::move(text));
+}
+
+bool omp::streamjson::contains(const std::string& inKey) const
+{
+    if (m_WrittenIndex.contains(inKey))
+    {
+        return true;
+    }
+    return m_Document && m_Document->findMember(m_Node, inKey).has_value();
+}
+
+std::string omp::streamjson::to_string() const
+{
+    std::string text;
+    stream([&text](std::string_view inText)
+           {
+               text.append(inText);
+           });
+    return text;
+}
+
+void omp::streamjson::setWritten(const std::string& inKey, std::string&& inText)
+{
+    auto written = m_WrittenIndex.find(inKey);
+    if (written != m_WrittenIndex.end())
+    {
+        m_Written[written->second].second = std::move(inText);
+        return;
+    }
+
+    m_WrittenIndex.emplace(inKey, m_Written.size());
+    m_Written.emplace_back(inKey, std::move(inText));
+}
+
+std::optional<bool> omp::streamjson::toBool(const StreamJsonDocument& inDocument, size_t inNode)
+{
+    const StreamJsonNode& node = inDocument.nodes[inNode];
+    if (node.type != EStreamJsonType::Bool)
+    {
+        return std::nullopt;
+    }
+    return inDocument.buffer[node.begin] == 't';
+}
+
+std::optional<int64_t> omp::streamjson::toSigned(const StreamJsonDocument& inDocument, size_t inNode)
+{
+    if (inDocument.nodes[inNode].type != EStreamJsonType::Number)
+    {
+        return std::nullopt;
+    }
+
+    std::string_view text = inDocument.raw(inNode);
+    int64_t value = 0;
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (error != std::errc() || end != text.data() + text.size())
+    {
+        // Written as floating point
+        std::optional<double> real = toDouble(inDocument, inNode);
+        if (!real.has_value())
+        {
+            return std::nullopt;
+        }
+        return static_cast<int64_t>(real.value());
+    }
+    return value;
+}
+
+std::optional<uint64_t> omp::streamjson::toUnsigned(const StreamJsonDocument& inDocument, size_t inNode)
+{
+    if (inDocument.nodes[inNode].type != EStreamJsonType::Number)
+    {
+        return std::nullopt;
+    }
+
+    std::string_view text = inDocument.raw(inNode);
+    uint64_t value = 0;
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (error != std::errc() || end != text.data() + text.size())
+    {
+        std::optional<int64_t> signed_value = toSigned(inDocument, inNode);
+        if (!signed_value.has_value())
+        {
+            return std::nullopt;
+        }
+        return static_cast<uint64_t>(signed_value.value());
+    }
+    return value;
+}
+
+std::optional<double> omp::streamjson::toDouble(const StreamJsonDocument& inDocument, size_t inNode)
+{
+    if (inDocument.nodes[inNode].type != EStreamJsonType::Number)
+    {
+        return std::nullopt;
+    }
+
+    std::string_view text = inDocument.raw(inNode);
+    double value = 0;
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (error != std::errc())
+    {
+        return std::nullopt;
+    }
+    return value;
+}
+
+void omp::streamjson::appendBool(std::string& outText, bool inValue)
+{
+    outText += inValue ? "true" : "false";
+}
+
+void omp::streamjson::appendSigned(std::string& outText, int64_t inValue)
+{
+    char buffer[32];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), inValue);
+    outText.append(buffer, result.ptr);
+}
+
+void omp::streamjson::appendUnsigned(std::string& outText, uint64_t inValue)
+{
+    char buffer[32];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), inValue);
+    outText.append(buffer, result.ptr);
+}
+
+void omp::streamjson::appendFloat(std::string& outText, float inValue)
+{
+    // JSON has no nan or inf, written as null the way nlohmann does
+    if (!std::isfinite(inValue))
+    {
+        outText += "null";
+        return;
+    }
+
+    // Shortest representation that reads back to the same float
+    char buffer[64];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), inValue);
+    outText.append(buffer, result.ptr);
+}
+
+void omp::streamjson::appendDouble(std::string& outText, double inValue)
+{
+    if (!std::isfinite(inValue))
+    {
+        outText += "null";
+        return;
+    }
+
+    char buffer[64];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), inValue);
+    outText.append(buffer, result.ptr);
+}
+
+void omp::streamjson::appendString(std::string& outText, std::string_view inValue)
+{
+    outText += '"';
+    for (char symbol : inValue)
+    {
+        switch (symbol)
+        {
+            case '"': outText += "\\\""; break;
+            case '\\': outText += "\\\\"; break;
+            case '\b': outText += "\\b"; break;
+            case '\f': outText += "\\f"; break;
+            case '\n': outText += "\\n"; break;
+            case '\r': outText += "\\r"; break;
+            case '\t': outText += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(symbol) < 0x20)
+                {
+                    char buffer[8];
+                    std::snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned int>(symbol));
+                    outText += buffer;
+                }
+                else
+                {
+                    outText += symbol;
+                }
+                break;
+        }
+    }
+    outText += '"';
+}
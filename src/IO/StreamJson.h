@@ -0,0 +1,277 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <optional>
+#include <vector>
+#include <memory>
+#include <ranges>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include "IO/JsonConverter.h"
+
+namespace omp
+{
+    enum class EStreamJsonType : uint8_t
+    {
+        Null = 0,
+        Bool,
+        Number,
+        String,
+        Array,
+        Object
+    };
+
+    /*
+     * @brief One parsed json value. Nodes are stored in document order,
+     * children of arrays and objects follow their parent, object members are key/value node pairs.
+     * begin/end is the raw text range in the document buffer, next is the index after the whole subtree.
+     */
+    struct StreamJsonNode
+    {
+        EStreamJsonType type = EStreamJsonType::Null;
+        size_t begin = 0;
+        size_t end = 0;
+        size_t next = 0;
+    };
+
+    /*
+     * @brief Immutable parsed json text, shared by every view created from it.
+     */
+    struct StreamJsonDocument
+    {
+        std::string buffer;
+        std::vector<StreamJsonNode> nodes;
+        // Key lookup for objects with many members, built on parse, keyed by object node
+        std::unordered_map<size_t, std::unordered_map<std::string_view, size_t>> member_index;
+
+        bool parse();
+
+        std::string_view raw(size_t inNode) const;
+        // String contents without quotes and with escapes resolved
+        std::string decodeString(size_t inNode) const;
+        std::optional<size_t> findMember(size_t inObject, std::string_view inKey) const;
+
+        // Objects with less members are searched linearly
+        static constexpr size_t INDEX_MEMBER_COUNT = 32;
+    };
+
+    /*
+     * @brief Pull parser backend for JsonParser.
+     * File is read once into a single buffer, nested objects are views into it, nothing is copied into a DOM.
+     * Written values are kept as serialized text and streamed to the output file as is.
+     */
+    class streamjson
+    {
+    private:
+        std::shared_ptr<const StreamJsonDocument> m_Document;
+        size_t m_Node = 0;
+
+        // Serialized values written through this parser, override document members with the same key
+        std::vector<std::pair<std::string, std::string>> m_Written;
+        std::unordered_map<std::string, size_t> m_WrittenIndex;
+
+    public:
+        streamjson() = default;
+        streamjson(std::shared_ptr<const StreamJsonDocument> inDocument, size_t inNode);
+        streamjson(streamjson&& other) = default;
+        streamjson& operator=(streamjson&& other) = default;
+
+        streamjson(const streamjson& other) = delete;
+        streamjson& operator=(const streamjson& other) = delete;
+
+        bool readJsonFromFile(const std::string& inFilePath);
+        // Parse file contents read elsewhere, inSourceName is used for logs
+        bool readJsonFromData(std::string&& inData, const std::string& inSourceName);
+        bool writeJsonToFile(const std::string& inFilePath, EJsonFormat inFormat = EJsonFormat::Text) const;
+
+        template< typename T >
+        std::optional<T> read(const std::string& inKey) const;
+
+        template< typename T >
+        void write(const std::string& inKey, T&& inValue);
+
+        streamjson readObject(const std::string& inKey) const;
+        void writeObject(const std::string& inKey, streamjson&& inObject);
+
+        bool contains(const std::string& inKey) const;
+
+        std::string to_string() const;
+
+        friend class JsonConverter;
+
+    private:
+        void setWritten(const std::string& inKey, std::string&& inText);
+        template<typename Sink>
+        void stream(Sink&& sink) const;
+
+        template< typename T >
+        static std::optional<T> convert(const StreamJsonDocument& inDocument, size_t inNode);
+        template< typename T >
+        static void append(std::string& outText, const T& inValue);
+
+        static std::optional<bool> toBool(const StreamJsonDocument& inDocument, size_t inNode);
+        static std::optional<int64_t> toSigned(const StreamJsonDocument& inDocument, size_t inNode);
+        static std::optional<uint64_t> toUnsigned(const StreamJsonDocument& inDocument, size_t inNode);
+        static std::optional<double> toDouble(const StreamJsonDocument& inDocument, size_t inNode);
+
+        static void appendBool(std::string& outText, bool inValue);
+        static void appendSigned(std::string& outText, int64_t inValue);
+        static void appendUnsigned(std::string& outText, uint64_t inValue);
+        static void appendFloat(std::string& outText, float inValue);
+        static void appendDouble(std::string& outText, double inValue);
+        static void appendString(std::string& outText, std::string_view inValue);
+    };
+
+    template< typename T >
+    std::optional<T> streamjson::read(const std::string& inKey) const
+    {
+        auto written = m_WrittenIndex.find(inKey);
+        if (written != m_WrittenIndex.end())
+        {
+            // Rare path, values are usually read from files and written to files
+            StreamJsonDocument document;
+            document.buffer = m_Written[written->second].second;
+            if (!document.parse())
+            {
+                return std::nullopt;
+            }
+            return convert<T>(document, 0);
+        }
+
+        if (!m_Document)
+        {
+            return std::nullopt;
+        }
+
+        std::optional<size_t> node = m_Document->findMember(m_Node, inKey);
+        if (!node.has_value())
+        {
+            return std::nullopt;
+        }
+        return convert<T>(*m_Document, node.value());
+    }
+
+    template< typename T >
+    void streamjson::write(const std::string& inKey, T&& inValue)
+    {
+        std::string text;
+        append(text, inValue);
+        setWritten(inKey, std::move(text));
+    }
+
+    template< typename T >
+    std::optional<T> streamjson::convert(const StreamJsonDocument& inDocument, size_t inNode)
+    {
+        using Type = std::remove_cvref_t<T>;
+        if constexpr (std::is_same_v<Type, bool>)
+        {
+            return toBool(inDocument, inNode);
+        }
+        else if constexpr (std::is_floating_point_v<Type>)
+        {
+            std::optional<double> value = toDouble(inDocument, inNode);
+            if (!value.has_value())
+            {
+                return std::nullopt;
+            }
+            return static_cast<Type>(value.value());
+        }
+        else if constexpr (std::is_integral_v<Type> && std::is_signed_v<Type>)
+        {
+            std::optional<int64_t> value = toSigned(inDocument, inNode);
+            if (!value.has_value())
+            {
+                return std::nullopt;
+            }
+            return static_cast<Type>(value.value());
+        }
+        else if constexpr (std::is_integral_v<Type>)
+        {
+            std::optional<uint64_t> value = toUnsigned(inDocument, inNode);
+            if (!value.has_value())
+            {
+                return std::nullopt;
+            }
+            return static_cast<Type>(value.value());
+        }
+        else if constexpr (std::is_same_v<Type, std::string>)
+        {
+            if (inDocument.nodes[inNode].type != EStreamJsonType::String)
+            {
+                return std::nullopt;
+            }
+            return inDocument.decodeString(inNode);
+        }
+        else
+        {
+            static_assert(std::ranges::range<Type>, "streamjson can't read this type");
+
+            const StreamJsonNode& array = inDocument.nodes[inNode];
+            if (array.type != EStreamJsonType::Array)
+            {
+                return std::nullopt;
+            }
+
+            Type result;
+            for (size_t child = inNode + 1; child < array.next; child = inDocument.nodes[child].next)
+            {
+                auto element = convert<std::ranges::range_value_t<Type>>(inDocument, child);
+                if (!element.has_value())
+                {
+                    return std::nullopt;
+                }
+                result.insert(result.end(), std::move(element.value()));
+            }
+            return result;
+        }
+    }
+
+    template< typename T >
+    void streamjson::append(std::string& outText, const T& inValue)
+    {
+        using Type = std::remove_cvref_t<T>;
+        if constexpr (std::is_same_v<Type, bool>)
+        {
+            appendBool(outText, inValue);
+        }
+        else if constexpr (std::is_same_v<Type, float>)
+        {
+            appendFloat(outText, inValue);
+        }
+        else if constexpr (std::is_floating_point_v<Type>)
+        {
+            appendDouble(outText, inValue);
+        }
+        else if constexpr (std::is_integral_v<Type> && std::is_signed_v<Type>)
+        {
+            appendSigned(outText, inValue);
+        }
+        else if constexpr (std::is_integral_v<Type>)
+        {
+            appendUnsigned(outText, inValue);
+        }
+        else if constexpr (std::is_convertible_v<const Type&, std::string_view>)
+        {
+            appendString(outText, inValue);
+        }
+        else
+        {
+            static_assert(std::ranges::range<Type>, "streamjson can't write this type");
+
+            outText += '[';
+            bool first = true;
+            for (const auto& element : inValue)
+            {
+                if (!first)
+                {
+                    outText += ',';
+                }
+                first = false;
+                append(outText, element);
+            }
+            outText += ']';
+        }
+    }
+}
@@ -96,30 +96,38 @@ void omp::LightSystem::onSceneChanged(omp::Scene* scene)
     }
 }
 
-VkBuffer omp::LightSystem::getGlobalLightBuffer(uint32_t khr)
+VkBuffer omp::LightSystem::getGlobalLightBuffer()
 {
     if (m_GlobalBuffer)
     {
-        return m_GlobalBuffer->getBuffer(khr);
+        return m_GlobalBuffer->getBuffer();
     }
     return 0;
 }
 
-VkBuffer omp::LightSystem::getPointLightBuffer(uint32_t khr)
+VkBuffer omp::LightSystem::getPointLightBuffer()
 {
     if (m_PointBuffer)
     {
-        return m_PointBuffer->getBuffer(khr);
+        return m_PointBuffer->getBuffer();
     }
     return 0;
 }
 
-VkBuffer omp::LightSystem::getSpotLightBuffer(uint32_t khr)
+VkBuffer omp::LightSystem::getSpotLightBuffer()
 {
     if (m_SpotBuffer)
     {
-        return m_SpotBuffer->getBuffer(khr);
+        return m_SpotBuffer->getBuffer();
     }
     return 0;
 }
 
+std::array<uint32_t, 3> omp::LightSystem::getDynamicOffsets(uint32_t khr) const
+{
+    if (!m_GlobalBuffer || !m_PointBuffer || !m_SpotBuffer)
+    {
+        return {0, 0, 0};
+    }
+    return {m_GlobalBuffer->getDynamicOffset(khr), m_PointBuffer->getDynamicOffset(khr), m_SpotBuffer->getDynamicOffset(khr)};
+}
@@ -1,4 +1,5 @@
 #pragma once
+#include <array>
 #include "LightObject.h"
 #include "Rendering/UniformBuffer.h"
 
@@ -33,9 +34,12 @@ namespace omp
         size_t getPointLightBufferSize() const { return std::max(sizeof(PointLight), sizeof(PointLight) * m_PointLightNum); }
         size_t getSpotLightBufferSize() const { return std::max(sizeof(SpotLight), sizeof(SpotLight) * m_SpotLightNum); }
 
-        VkBuffer getGlobalLightBuffer(uint32_t khr);
-        VkBuffer getPointLightBuffer(uint32_t khr);
-        VkBuffer getSpotLightBuffer(uint32_t khr);
+        VkBuffer getGlobalLightBuffer();
+        VkBuffer getPointLightBuffer();
+        VkBuffer getSpotLightBuffer();
+
+        // Dynamic offsets of global, point and spot light regions of the image, in binding order
+        std::array<uint32_t, 3> getDynamicOffsets(uint32_t khr) const;
 
         void tryRecreateBuffers();
         void update();
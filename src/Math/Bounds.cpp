@@ -0,0 +1,207 @@
+#include "Math/Bounds.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define OMP_BOUNDS_SSE 1
+#include <xmmintrin.h>
+#endif
+
+namespace
+{
+    const float* positionAt(const float* inPositions, size_t inStride, size_t inVertex)
+    {
+        return reinterpret_cast<const float*>(reinterpret_cast<const uint8_t*>(inPositions) + inVertex * inStride);
+    }
+
+    void expandBox(omp::BoundingBox& ioBox, const float* inPosition)
+    {
+        for (size_t axis = 0; axis < 3; axis++)
+        {
+            ioBox.min[axis] = std::min(ioBox.min[axis], inPosition[axis]);
+            ioBox.max[axis] = std::max(ioBox.max[axis], inPosition[axis]);
+        }
+    }
+}
+
+omp::BoundingBox omp::BoundsLib::computeBox(const float* inPositions, size_t inStride, size_t inCount)
+{
+    omp::BoundingBox box{{FLT_MAX, FLT_MAX, FLT_MAX}, {-FLT_MAX, -FLT_MAX, -FLT_MAX}};
+    if (inCount == 0)
+    {
+        return box;
+    }
+
+    size_t scalar_first = 0;
+#ifdef OMP_BOUNDS_SSE
+    // Every load takes four floats, so last vertex is left to the scalar loop to not read past the buffer.
+    // Two pairs of accumulators keep min and max latency off the critical path
+    const size_t vector_count = inCount - 1;
+    __m128 min_a = _mm_set1_ps(FLT_MAX);
+    __m128 min_b = min_a;
+    __m128 max_a = _mm_set1_ps(-FLT_MAX);
+    __m128 max_b = max_a;
+    size_t vertex = 0;
+    for (; vertex + 1 < vector_count; vertex += 2)
+    {
+        const __m128 a = _mm_loadu_ps(positionAt(inPositions, inStride, vertex));
+        const __m128 b = _mm_loadu_ps(positionAt(inPositions, inStride, vertex + 1));
+        min_a = _mm_min_ps(min_a, a);
+        max_a = _mm_max_ps(max_a, a);
+        min_b = _mm_min_ps(min_b, b);
+        max_b = _mm_max_ps(max_b, b);
+    }
+    if (vertex < vector_count)
+    {
+        const __m128 a = _mm_loadu_ps(positionAt(inPositions, inStride, vertex));
+        min_a = _mm_min_ps(min_a, a);
+        max_a = _mm_max_ps(max_a, a);
+    }
+
+    alignas(16) float min_values[4];
+    alignas(16) float max_values[4];
+    _mm_store_ps(min_values, _mm_min_ps(min_a, min_b));
+    _mm_store_ps(max_values, _mm_max_ps(max_a, max_b));
+    box.min = {min_values[0], min_values[1], min_values[2]};
+    box.max = {max_values[0], max_values[1], max_values[2]};
+    scalar_first = vector_count;
+#endif
+
+    for (size_t index = scalar_first; index < inCount; index++)
+    {
+        expandBox(box, positionAt(inPositions, inStride, index));
+    }
+    return box;
+}
+
+omp::BoundingSphere omp::BoundsLib::computeSphere(const float* inPositions, size_t inStride, size_t inCount, const omp::BoundingBox& inBox)
+{
+    if (inCount == 0 || !inBox.isValid())
+    {
+        return omp::BoundingSphere{};
+    }
+
+    omp::BoundingSphere sphere;
+    for (size_t axis = 0; axis < 3; axis++)
+    {
+        sphere.center[axis] = (inBox.min[axis] + inBox.max[axis]) * 0.5f;
+    }
+
+    float max_distance = 0.0f;
+    for (size_t index = 0; index < inCount; index++)
+    {
+        const float* position = positionAt(inPositions, inStride, index);
+        const float x = position[0] - sphere.center[0];
+        const float y = position[1] - sphere.center[1];
+        const float z = position[2] - sphere.center[2];
+        max_distance = std::max(max_distance, x * x + y * y + z * z);
+    }
+    sphere.radius = std::sqrt(max_distance);
+    return sphere;
+}
+
+omp::Bounds omp::BoundsLib::compute(const float* inPositions, size_t inStride, size_t inCount)
+{
+    omp::Bounds bounds;
+    bounds.box = computeBox(inPositions, inStride, inCount);
+    bounds.sphere = computeSphere(inPositions, inStride, inCount, bounds.box);
+    return bounds;
+}
+
+omp::Bounds omp::BoundsLib::transform(const omp::Bounds& inBounds, const float* inMatrix)
+{
+    if (!inBounds.box.isValid())
+    {
+        return inBounds;
+    }
+
+    // Transformed center plus extents projected on world axes, Arvo's method
+    std::array<float, 3> center{};
+    std::array<float, 3> extent{};
+    for (size_t axis = 0; axis < 3; axis++)
+    {
+        center[axis] = (inBounds.box.min[axis] + inBounds.box.max[axis]) * 0.5f;
+        extent[axis] = (inBounds.box.max[axis] - inBounds.box.min[axis]) * 0.5f;
+    }
+
+    omp::Bounds result;
+    float max_scale = 0.0f;
+    for (size_t row = 0; row < 3; row++)
+    {
+        float world_center = inMatrix[12 + row];
+        float world_extent = 0.0f;
+        float sphere_center = inMatrix[12 + row];
+        for (size_t column = 0; column < 3; column++)
+        {
+            const float value = inMatrix[column * 4 + row];
+            world_center += value * center[column];
+            world_extent += std::fabs(value) * extent[column];
+            sphere_center += value * inBounds.sphere.center[column];
+        }
+        result.box.min[row] = world_center - world_extent;
+        result.box.max[row] = world_center + world_extent;
+        result.sphere.center[row] = sphere_center;
+    }
+
+    // Length of a basis column is the scale along that local axis
+    for (size_t column = 0; column < 3; column++)
+    {
+        const float* basis = inMatrix + column * 4;
+        max_scale = std::max(max_scale, basis[0] * basis[0] + basis[1] * basis[1] + basis[2] * basis[2]);
+    }
+    result.sphere.radius = inBounds.sphere.radius * std::sqrt(max_scale);
+    return result;
+}
+
+omp::Frustum omp::BoundsLib::extractFrustum(const float* inViewProjection)
+{
+    // Rows of the matrix, element of row r and column c is at c * 4 + r
+    std::array<std::array<float, 4>, 4> rows{};
+    for (size_t row = 0; row < 4; row++)
+    {
+        for (size_t column = 0; column < 4; column++)
+        {
+            rows[row][column] = inViewProjection[column * 4 + row];
+        }
+    }
+
+    omp::Frustum frustum;
+    for (size_t component = 0; component < 4; component++)
+    {
+        frustum.planes[0][component] = rows[3][component] + rows[0][component];
+        frustum.planes[1][component] = rows[3][component] - rows[0][component];
+        frustum.planes[2][component] = rows[3][component] + rows[1][component];
+        frustum.planes[3][component] = rows[3][component] - rows[1][component];
+        // Depth starts at zero, so near plane is the third row alone
+        frustum.planes[4][component] = rows[2][component];
+        frustum.planes[5][component] = rows[3][component] - rows[2][component];
+    }
+
+    for (std::array<float, 4>& plane : frustum.planes)
+    {
+        const float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+        if (length > 0.0f)
+        {
+            for (float& component : plane)
+            {
+                component /= length;
+            }
+        }
+    }
+    return frustum;
+}
+
+bool omp::BoundsLib::isVisible(const omp::Frustum& inFrustum, const omp::BoundingSphere& inSphere)
+{
+    for (const std::array<float, 4>& plane : inFrustum.planes)
+    {
+        const float distance = plane[0] * inSphere.center[0] + plane[1] * inSphere.center[1] + plane[2] * inSphere.center[2] + plane[3];
+        if (distance < -inSphere.radius)
+        {
+            return false;
+        }
+    }
+    return true;
+}
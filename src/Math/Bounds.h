@@ -0,0 +1,73 @@
+#pragma once
+#include <array>
+#include <cstddef>
+
+namespace omp
+{
+    struct BoundingBox
+    {
+        std::array<float, 3> min{};
+        std::array<float, 3> max{};
+
+        bool operator==(const BoundingBox&) const = default;
+        // Box of no points has min above max
+        bool isValid() const { return min[0] <= max[0] && min[1] <= max[1] && min[2] <= max[2]; }
+    };
+
+    struct BoundingSphere
+    {
+        std::array<float, 3> center{};
+        float radius = 0.0f;
+
+        bool operator==(const BoundingSphere&) const = default;
+    };
+
+    /*
+     * @brief Both volumes of the same points, box for tight tests, sphere for cheap ones
+     */
+    struct Bounds
+    {
+        BoundingBox box;
+        BoundingSphere sphere;
+
+        bool operator==(const Bounds&) const = default;
+    };
+
+    /*
+     * @brief Six planes as a, b, c, d with unit normals facing inside, point p is inside a plane when dot(abc, p) + d >= 0.
+     * Order is left, right, bottom, top, near, far
+     */
+    struct Frustum
+    {
+        std::array<std::array<float, 4>, 6> planes{};
+    };
+
+    struct BoundsLib
+    {
+        /*
+         * @brief Box of inCount positions, inStride bytes apart. Reduced with SSE where it is available
+         */
+        static BoundingBox computeBox(const float* inPositions, size_t inStride, size_t inCount);
+
+        /*
+         * @brief Sphere around inBox center that contains every position, no larger than the box diagonal
+         */
+        static BoundingSphere computeSphere(const float* inPositions, size_t inStride, size_t inCount, const BoundingBox& inBox);
+
+        static Bounds compute(const float* inPositions, size_t inStride, size_t inCount);
+
+        /*
+         * @brief Bounds after inMatrix, column major 4x4 affine transform. Box stays axis aligned around the transformed box,
+         * sphere radius grows by the largest axis scale
+         */
+        static Bounds transform(const Bounds& inBounds, const float* inMatrix);
+
+        /*
+         * @brief Planes of column major view projection matrix with depth in [0, 1], as Vulkan clips (Gribb and Hartmann)
+         */
+        static Frustum extractFrustum(const float* inViewProjection);
+
+        // False only when sphere is entirely outside one of the planes
+        static bool isVisible(const Frustum& inFrustum, const BoundingSphere& inSphere);
+    };
+}
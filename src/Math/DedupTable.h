@@ -0,0 +1,106 @@
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace omp
+{
+    /*
+     * @brief Open addressing table for deduplication, maps values to their index in an external array.
+     * Array is cleared on construction, new values are appended to the array in order of first insertion.
+     * Slots keep only the index and upper hash bits, so lookups rarely touch the values themselves.
+     */
+    template< typename T, typename Hash = std::hash<T>, typename Equal = std::equal_to<T> >
+    class DedupTable
+    {
+    public:
+        /*
+         * @brief Table is sized for inExpectedCount insertions, e.g. index count of a mesh,
+         * and rehashes only when more than half of them are unique
+         */
+        DedupTable(std::vector<T>& outValues, size_t inExpectedCount);
+
+        // Index of an equal value in the array, inValue is appended when there is none
+        uint32_t insert(const T& inValue);
+
+        size_t size() const { return m_Values.size(); }
+        size_t capacity() const { return m_Slots.size(); }
+
+    private:
+        struct Slot
+        {
+            uint32_t index = EMPTY;
+            uint32_t tag = 0;
+        };
+
+        void grow();
+
+        static constexpr uint32_t EMPTY = UINT32_MAX;
+
+        std::vector<T>& m_Values;
+        std::vector<Slot> m_Slots;
+        Hash m_Hash;
+        Equal m_Equal;
+    };
+
+    template< typename T, typename Hash, typename Equal >
+    DedupTable<T, Hash, Equal>::DedupTable(std::vector<T>& outValues, size_t inExpectedCount)
+        : m_Values(outValues)
+        , m_Slots(std::bit_ceil(inExpectedCount < 16 ? size_t{16} : inExpectedCount))
+    {
+        m_Values.clear();
+    }
+
+    template< typename T, typename Hash, typename Equal >
+    uint32_t DedupTable<T, Hash, Equal>::insert(const T& inValue)
+    {
+        const uint64_t hash = m_Hash(inValue);
+        const uint32_t tag = static_cast<uint32_t>(hash >> 32);
+        const size_t mask = m_Slots.size() - 1;
+
+        size_t slot = hash & mask;
+        while (m_Slots[slot].index != EMPTY)
+        {
+            if (m_Slots[slot].tag == tag && m_Equal(m_Values[m_Slots[slot].index], inValue))
+            {
+                return m_Slots[slot].index;
+            }
+            slot = (slot + 1) & mask;
+        }
+
+        const uint32_t index = static_cast<uint32_t>(m_Values.size());
+        m_Values.push_back(inValue);
+        m_Slots[slot] = Slot{index, tag};
+
+        if (m_Values.size() * 2 > m_Slots.size())
+        {
+            grow();
+        }
+        return index;
+    }
+
+    template< typename T, typename Hash, typename Equal >
+    void DedupTable<T, Hash, Equal>::grow()
+    {
+        std::vector<Slot> old_slots = std::move(m_Slots);
+        m_Slots.assign(old_slots.size() * 2, Slot{});
+        const size_t mask = m_Slots.size() - 1;
+        for (const Slot& old_slot : old_slots)
+        {
+            if (old_slot.index == EMPTY)
+            {
+                continue;
+            }
+
+            // Tag has only the upper bits, hash is recomputed for the new slot
+            size_t slot = m_Hash(m_Values[old_slot.index]) & mask;
+            while (m_Slots[slot].index != EMPTY)
+            {
+                slot = (slot + 1) & mask;
+            }
+            m_Slots[slot] = old_slot;
+        }
+    }
+}
@@ -4,6 +4,7 @@
 #include "glm/glm.hpp"
 #include <functional>
 #include <unordered_map>
+#include "Math/Hash.h"
 
 namespace std
 {
@@ -12,8 +13,7 @@ namespace std
     {
         size_t operator()(glm::vec2 const& v) const
         {
-            return ((hash<glm::vec2::value_type>()(v[0]) ^
-                     (hash<glm::vec2::value_type>()(v[1]) << 1)) >> 1);
+            return omp::HashLib::hashFloats(&v.x, 2);
         }
     };
 
@@ -22,10 +22,7 @@ namespace std
     {
         size_t operator()(glm::vec3 const& v) const
         {
-
-            return ((hash<glm::vec3::value_type>()(v[0]) ^
-                     (hash<glm::vec3::value_type>()(v[1]) << 1)) >> 1) ^
-                   (hash<glm::vec3::value_type>()(v[2]) << 1);
+            return omp::HashLib::hashFloats(&v.x, 3);
         }
     };
 }
\ No newline at end of file
@@ -0,0 +1,220 @@
+#include "Math/Hash.h"
+#include <array>
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    inline uint64_t rotl64(uint64_t x, int8_t r)
+    {
+        return (x << r) | (x >> (64 - r));
+    }
+
+    inline uint64_t fmix64(uint64_t k)
+    {
+        k ^= k >> 33;
+        k *= 0xff51afd7ed558ccdULL;
+        k ^= k >> 33;
+        k *= 0xc4ceb9fe1a85ec53ULL;
+        k ^= k >> 33;
+        return k;
+    }
+
+    inline uint64_t readBlock(const uint8_t* ptr)
+    {
+        uint64_t value;
+        std::memcpy(&value, ptr, sizeof(value));
+        return value;
+    }
+
+    inline uint64_t readHalfBlock(const uint8_t* ptr)
+    {
+        uint32_t value;
+        std::memcpy(&value, ptr, sizeof(value));
+        return value;
+    }
+
+    constexpr std::array<uint64_t, 4> s_WySecret = {
+        0xa0761d6478bd642fULL, 0xe7037ed1a0b428dbULL, 0x8ebc6af09c88c6e3ULL, 0x589965cc75374cc3ULL
+    };
+
+    // Full 64x64 -> 128 bit multiply, low half in a, high half in b
+    inline void multiply128(uint64_t& a, uint64_t& b)
+    {
+#if defined(__SIZEOF_INT128__)
+        __extension__ using Uint128 = unsigned __int128;
+        const Uint128 result = static_cast<Uint128>(a) * b;
+        a = static_cast<uint64_t>(result);
+        b = static_cast<uint64_t>(result >> 64);
+#else
+        const uint64_t high_a = a >> 32;
+        const uint64_t high_b = b >> 32;
+        const uint64_t low_a = a & 0xffffffffULL;
+        const uint64_t low_b = b & 0xffffffffULL;
+
+        const uint64_t high = high_a * high_b;
+        const uint64_t middle0 = high_a * low_b;
+        const uint64_t middle1 = high_b * low_a;
+        const uint64_t low = low_a * low_b;
+
+        const uint64_t t = low + (middle0 << 32);
+        uint64_t carry = t < low ? 1 : 0;
+        const uint64_t result_low = t + (middle1 << 32);
+        carry += result_low < t ? 1 : 0;
+
+        a = result_low;
+        b = high + (middle0 >> 32) + (middle1 >> 32) + carry;
+#endif
+    }
+
+    inline uint64_t wyMix(uint64_t a, uint64_t b)
+    {
+        multiply128(a, b);
+        return a ^ b;
+    }
+}
+
+omp::Hash128 omp::HashLib::hash128(const void* data, size_t size, uint64_t seed)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    const size_t block_count = size / 16;
+
+    uint64_t h1 = seed;
+    uint64_t h2 = seed;
+
+    const uint64_t c1 = 0x87c37b91114253d5ULL;
+    const uint64_t c2 = 0x4cf5ad432745937fULL;
+
+    // Body
+    for (size_t i = 0; i < block_count; i++)
+    {
+        uint64_t k1 = readBlock(bytes + i * 16);
+        uint64_t k2 = readBlock(bytes + i * 16 + 8);
+
+        k1 *= c1; k1 = rotl64(k1, 31); k1 *= c2; h1 ^= k1;
+
+        h1 = rotl64(h1, 27); h1 += h2; h1 = h1 * 5 + 0x52dce729;
+
+        k2 *= c2; k2 = rotl64(k2, 33); k2 *= c1; h2 ^= k2;
+
+        h2 = rotl64(h2, 31); h2 += h1; h2 = h2 * 5 + 0x38495ab5;
+    }
+
+    // Tail
+    const uint8_t* tail = bytes + block_count * 16;
+
+    uint64_t k1 = 0;
+    uint64_t k2 = 0;
+
+    switch (size & 15)
+    {
+        case 15: k2 ^= static_cast<uint64_t>(tail[14]) << 48; [[fallthrough]];
+        case 14: k2 ^= static_cast<uint64_t>(tail[13]) << 40; [[fallthrough]];
+        case 13: k2 ^= static_cast<uint64_t>(tail[12]) << 32; [[fallthrough]];
+        case 12: k2 ^= static_cast<uint64_t>(tail[11]) << 24; [[fallthrough]];
+        case 11: k2 ^= static_cast<uint64_t>(tail[10]) << 16; [[fallthrough]];
+        case 10: k2 ^= static_cast<uint64_t>(tail[9]) << 8; [[fallthrough]];
+        case 9:  k2 ^= static_cast<uint64_t>(tail[8]);
+                 k2 *= c2; k2 = rotl64(k2, 33); k2 *= c1; h2 ^= k2;
+                 [[fallthrough]];
+        case 8:  k1 ^= static_cast<uint64_t>(tail[7]) << 56; [[fallthrough]];
+        case 7:  k1 ^= static_cast<uint64_t>(tail[6]) << 48; [[fallthrough]];
+        case 6:  k1 ^= static_cast<uint64_t>(tail[5]) << 40; [[fallthrough]];
+        case 5:  k1 ^= static_cast<uint64_t>(tail[4]) << 32; [[fallthrough]];
+        case 4:  k1 ^= static_cast<uint64_t>(tail[3]) << 24; [[fallthrough]];
+        case 3:  k1 ^= static_cast<uint64_t>(tail[2]) << 16; [[fallthrough]];
+        case 2:  k1 ^= static_cast<uint64_t>(tail[1]) << 8; [[fallthrough]];
+        case 1:  k1 ^= static_cast<uint64_t>(tail[0]);
+                 k1 *= c1; k1 = rotl64(k1, 31); k1 *= c2; h1 ^= k1;
+                 break;
+        default: break;
+    }
+
+    // Finalization
+    h1 ^= size;
+    h2 ^= size;
+
+    h1 += h2;
+    h2 += h1;
+
+    h1 = fmix64(h1);
+    h2 = fmix64(h2);
+
+    h1 += h2;
+    h2 += h1;
+
+    return Hash128{h1, h2};
+}
+
+uint64_t omp::HashLib::hash64(const void* data, size_t size, uint64_t seed)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    seed ^= wyMix(seed ^ s_WySecret[0], s_WySecret[1]);
+
+    uint64_t a = 0;
+    uint64_t b = 0;
+    if (size <= 16)
+    {
+        if (size >= 4)
+        {
+            const size_t offset = (size >> 3) << 2;
+            a = (readHalfBlock(bytes) << 32) | readHalfBlock(bytes + offset);
+            b = (readHalfBlock(bytes + size - 4) << 32) | readHalfBlock(bytes + size - 4 - offset);
+        }
+        else if (size > 0)
+        {
+            a = (static_cast<uint64_t>(bytes[0]) << 16) | (static_cast<uint64_t>(bytes[size >> 1]) << 8) | bytes[size - 1];
+        }
+    }
+    else
+    {
+        size_t remaining = size;
+        if (remaining > 48)
+        {
+            uint64_t seed1 = seed;
+            uint64_t seed2 = seed;
+            do
+            {
+                seed = wyMix(readBlock(bytes) ^ s_WySecret[1], readBlock(bytes + 8) ^ seed);
+                seed1 = wyMix(readBlock(bytes + 16) ^ s_WySecret[2], readBlock(bytes + 24) ^ seed1);
+                seed2 = wyMix(readBlock(bytes + 32) ^ s_WySecret[3], readBlock(bytes + 40) ^ seed2);
+                bytes += 48;
+                remaining -= 48;
+            }
+            while (remaining > 48);
+            seed ^= seed1 ^ seed2;
+        }
+        while (remaining > 16)
+        {
+            seed = wyMix(readBlock(bytes) ^ s_WySecret[1], readBlock(bytes + 8) ^ seed);
+            bytes += 16;
+            remaining -= 16;
+        }
+        a = readBlock(bytes + remaining - 16);
+        b = readBlock(bytes + remaining - 8);
+    }
+
+    a ^= s_WySecret[1];
+    b ^= seed;
+    multiply128(a, b);
+    return wyMix(a ^ s_WySecret[0] ^ size, b ^ s_WySecret[1]);
+}
+
+uint64_t omp::HashLib::hashFloats(const float* values, size_t count, uint64_t seed)
+{
+    std::array<float, 16> block{};
+    do
+    {
+        const size_t block_count = std::min(count, block.size());
+        for (size_t index = 0; index < block_count; index++)
+        {
+            // Adding +0 turns -0 into +0 and keeps every other value
+            block[index] = values[index] + 0.0f;
+        }
+        seed = hash64(block.data(), block_count * sizeof(float), seed);
+        values += block_count;
+        count -= block_count;
+    }
+    while (count > 0);
+    return seed;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace omp
+{
+    struct Hash128
+    {
+        uint64_t low = 0;
+        uint64_t high = 0;
+
+        bool operator==(const Hash128& other) const
+        {
+            return low == other.low && high == other.high;
+        }
+        bool operator!=(const Hash128& other) const
+        {
+            return !(*this == other);
+        }
+        bool isValid() const { return low != 0 || high != 0; }
+    };
+
+    struct HashLib
+    {
+        /*
+         * @brief MurmurHash3 x64 128 bit variant, used to address content by its raw bytes
+         */
+        static Hash128 hash128(const void* data, size_t size, uint64_t seed = 0);
+
+        /*
+         * @brief wyhash, fast 64 bit hash of raw bytes for hash tables
+         */
+        static uint64_t hash64(const void* data, size_t size, uint64_t seed = 0);
+
+        /*
+         * @brief hash64 of float values, -0 and 0 hash the same since they compare equal
+         */
+        static uint64_t hashFloats(const float* values, size_t count, uint64_t seed = 0);
+    };
+}
+
+template<>
+struct std::hash<omp::Hash128>
+{
+    std::size_t operator()(const omp::Hash128& value) const
+    {
+        // Already well mixed, no need to hash again
+        return static_cast<std::size_t>(value.low ^ (value.high * 0x9E3779B97F4A7C15ULL));
+    }
+};
@@ -1,6 +1,7 @@
 #include "Renderer.h"
 #include "imgui.h"
 #include <algorithm>
+#include <cmath>
 #include <optional>
 #include <set>
 #include <vector>
@@ -10,11 +11,16 @@
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
 
 #include <chrono>
 
 #include "IO/stb_image.h"
 #include "backends/imgui_impl_vulkan.h"
+#include "Rendering/GeometryArena.h"
+#include "Rendering/UploadQueue.h"
+#include "Async/ThreadPool.h"
+#include "Math/Hash.h"
 #include "Rendering/Shader.h"
 #include "Core/Profiling.h"
 #include "backends/imgui_impl_glfw.h"
@@ -55,10 +61,16 @@ void omp::Renderer::initVulkan(GLFWwindow* window, int initWidth, int initHeight
     createSwapChain();
 }
 
-void omp::Renderer::initResources()
+void omp::Renderer::initResources(omp::ThreadPool* inThreadPool)
 {
     OMP_STAT_SCOPE("InitResources");
 
+    m_ThreadPool = inThreadPool;
+    VkPhysicalDeviceProperties properties{};
+    vkGetPhysicalDeviceProperties(m_PhysDevice, &properties);
+    m_PipelineCache = std::make_unique<omp::PipelineCache>(m_LogicalDevice, properties);
+    m_PipelineCache->load();
+
     postSwapChainInitialize();
     createImageViews();
     createRenderPass();
@@ -101,6 +113,13 @@ bool omp::Renderer::prepareFrame()
     vkWaitForFences(m_LogicalDevice, 1, &m_InFlightFences[m_CurrentFrame],
                     VK_TRUE, UINT64_MAX);
 
+    // Slot fence belongs to the frame submitted MAX_FRAMES_IN_FLIGHT frames ago, it and every earlier frame are done
+    const uint64_t recorded_frames = m_VulkanContext->deferred_deletion.getFrame();
+    if (recorded_frames >= MAX_FRAMES_IN_FLIGHT)
+    {
+        m_VulkanContext->deferred_deletion.collect(recorded_frames - MAX_FRAMES_IN_FLIGHT + 1);
+    }
+
     uint32_t image_index;
     VkResult result = vkAcquireNextImageKHR(
             m_LogicalDevice, m_SwapChain, UINT64_MAX,
@@ -138,18 +157,23 @@ void omp::Renderer::requestDrawFrame(float deltaTime)
 {
     OMP_STAT_SCOPE("RequestDrawFrame");
 
+    // Uploads finished since last frame release their staging space and become drawable
+    m_VulkanContext->upload_queue->poll();
+    m_VulkanContext->geometry_arena->update();
+
     drawFrame();
     //TODO: remove
     tick(deltaTime);
-
-    vkDeviceWaitIdle(m_LogicalDevice);
 }
 
 void omp::Renderer::cleanup()
 {
     OMP_STAT_SCOPE("Cleanup");
 
-    vkFreeMemory(m_LogicalDevice, m_PixelReadMemory, nullptr);
+    vkDeviceWaitIdle(m_LogicalDevice);
+    m_VulkanContext->deferred_deletion.flush();
+
+    m_VulkanContext->freeMemory(m_PixelReadMemory);
     vkDestroyBuffer(m_LogicalDevice, m_PixelReadBuffer, nullptr);
 
     for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
@@ -166,6 +190,7 @@ void omp::Renderer::cleanup()
     m_MaterialSets.clear();
 
     destroyAllCommandBuffers();
+    destroySecondaryCommandBuffers();
     vkDestroyCommandPool(m_LogicalDevice, m_CommandPool, nullptr);
     vkDestroyCommandPool(m_LogicalDevice, m_ImguiCommandPool, nullptr);
 
@@ -177,6 +202,7 @@ void omp::Renderer::cleanup()
     m_ViewportImage.reset();
     m_UboBuffer.reset();
     m_OutlineBuffer.reset();
+    m_InstanceBuffer.reset();
     m_LightSystem.reset();
 
     vkDestroyDescriptorSetLayout(m_LogicalDevice, m_UboDescriptorSetLayout,
@@ -192,6 +218,15 @@ void omp::Renderer::cleanup()
     ImGui::DestroyContext();
     vkDestroyDescriptorPool(m_LogicalDevice, m_ImguiDescriptorPool, nullptr);
 
+    m_VulkanContext->upload_queue.reset();
+    m_VulkanContext->geometry_arena.reset();
+    m_VulkanContext->memory_allocator->logStatistics();
+    m_VulkanContext->memory_allocator.reset();
+
+    // Pipelines compiled this run start the next one from the cache
+    m_PipelineCache->save();
+    m_PipelineCache.reset();
+
     vkDestroyDevice(m_LogicalDevice, nullptr);
 
     vkDestroySurfaceKHR(m_Instance, m_Surface, nullptr);
@@ -421,6 +456,16 @@ omp::Renderer::findQueueFamilies(VkPhysicalDevice device)
         i++;
     }
 
+    for (uint32_t family = 0; family < queue_family_count; family++)
+    {
+        const VkQueueFlags flags = queue_families[family].queueFlags;
+        if ((flags & VK_QUEUE_TRANSFER_BIT) && !(flags & VK_QUEUE_GRAPHICS_BIT))
+        {
+            indices.transfer_family = family;
+            break;
+        }
+    }
+
     return indices;
 }
 
@@ -431,6 +476,10 @@ void omp::Renderer::createLogicalDevice()
     std::vector<VkDeviceQueueCreateInfo> queue_create_infos;
     std::set<uint32_t> unique_queue_families = {indices.graphics_family.value(),
                                                 indices.present_family.value()};
+    if (indices.transfer_family.has_value())
+    {
+        unique_queue_families.insert(indices.transfer_family.value());
+    }
 
     float queue_priority = 1.f;
     for (uint32_t queue_family: unique_queue_families)
@@ -478,10 +527,19 @@ void omp::Renderer::createLogicalDevice()
                      &m_GraphicsQueue);
     vkGetDeviceQueue(m_LogicalDevice, indices.present_family.value(), 0,
                      &m_PresentQueue);
+    const uint32_t transfer_family = indices.transfer_family.value_or(indices.graphics_family.value());
+    vkGetDeviceQueue(m_LogicalDevice, transfer_family, 0, &m_TransferQueue);
 
     createCommandPool();
     m_VulkanContext = std::make_shared<omp::VulkanContext>(
             m_LogicalDevice, m_PhysDevice, m_CommandPool, m_GraphicsQueue);
+    if (indices.transfer_family.has_value())
+    {
+        m_VulkanContext->queue_families = {indices.graphics_family.value(), transfer_family};
+    }
+    m_VulkanContext->upload_queue = std::make_shared<omp::UploadQueue>(
+            m_VulkanContext, m_GraphicsQueue, indices.graphics_family.value(), m_TransferQueue, transfer_family);
+    m_VulkanContext->geometry_arena = std::make_shared<omp::GeometryArena>(m_VulkanContext);
     m_ViewportImage = std::make_unique<omp::VulkanImage>(m_VulkanContext);
     m_RenderPass = std::make_shared<omp::RenderPass>(m_LogicalDevice);
     m_ImguiRenderPass = std::make_shared<omp::RenderPass>(m_LogicalDevice);
@@ -686,7 +744,7 @@ void omp::Renderer::postSwapChainInitialize()
 
     m_VulkanContext->createBuffer(sizeof(int32_t),
                                   VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                                  VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
                                   m_PixelReadBuffer, m_PixelReadMemory);
 }
 
@@ -715,6 +773,11 @@ void omp::Renderer::createImageViews()
 
 void omp::Renderer::createGraphicsPipeline()
 {
+    OMP_STAT_SCOPE("CreateGraphicsPipelines");
+
+    // Pipelines are only configured here, the costly compilation of all of them runs at the end
+    std::vector<omp::GraphicsPipeline*> pending_pipelines;
+
     VkPipelineColorBlendAttachmentState color_blend_attachment{};
     color_blend_attachment.colorWriteMask =
             VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
@@ -750,26 +813,6 @@ void omp::Renderer::createGraphicsPipeline()
     depth_stencil.front = stencil_state;
     depth_stencil.back = stencil_state;
 
-    // Light pipeline
-    std::shared_ptr<omp::Shader> light_shader = std::make_shared<omp::Shader>(
-            m_VulkanContext, "../SPRV/shaderLightvert.spv",
-            "../SPRV/shaderLightfrag.spv");
-
-    std::unique_ptr<omp::GraphicsPipeline> light_pipe =
-            std::make_unique<omp::GraphicsPipeline>(m_LogicalDevice);
-    light_pipe->startDefaultCreation();
-    light_pipe->addColorBlendingAttachment(color_blend_attachment);
-    light_pipe->addColorBlendingAttachment(color_blend_attachment);
-    light_pipe->createMultisamplingInfo(m_MSAASamples);
-    light_pipe->createViewport(m_SwapChainExtent);
-    light_pipe->definePushConstant<omp::ModelPushConstant>(
-            VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT);
-    light_pipe->addPipelineSetLayout(m_UboDescriptorSetLayout);
-    light_pipe->addPipelineSetLayout(m_TexturesDescriptorSetLayout);
-    light_pipe->createShaders(light_shader);
-    light_pipe->setDepthStencil(depth_stencil);
-    light_pipe->confirmCreation(m_RenderPass);
-
     std::shared_ptr<omp::Shader> skybox_shader = std::make_shared<omp::Shader>(
             m_VulkanContext, "../SPRV/skyboxvert.spv", "../SPRV/skyboxfrag.spv");
 
@@ -788,109 +831,159 @@ void omp::Renderer::createGraphicsPipeline()
     depth_stencil.depthTestEnable = VK_TRUE;
     skybox_pipe->setDepthStencil(depth_stencil);
     skybox_pipe->createShaders(skybox_shader);
-    skybox_pipe->confirmCreation(m_RenderPass);
-    depth_stencil.depthTestEnable = VK_FALSE;
-
-    // Simple pipeline
-    std::shared_ptr<omp::Shader> shader = std::make_shared<omp::Shader>(
-            m_VulkanContext, "../SPRV/shadervert.spv", "../SPRV/shaderfrag.spv");
+    pending_pipelines.push_back(skybox_pipe.get());
+
+    // Model pipelines exist for every vertex layout, packed ones use vertex shaders compiled with PACKED_VERTEX
+    const VkPipelineColorBlendAttachmentState default_color_blend_attachment = color_blend_attachment;
+    const VkPipelineDepthStencilStateCreateInfo default_depth_stencil = depth_stencil;
+    const VkStencilOpState default_stencil_state = stencil_state;
+    for (omp::EVertexLayout layout : {omp::EVertexLayout::Full, omp::EVertexLayout::Packed, omp::EVertexLayout::PackedColor})
+    {
+        color_blend_attachment = default_color_blend_attachment;
+        depth_stencil = default_depth_stencil;
+        stencil_state = default_stencil_state;
+
+        // Light pipeline
+        std::shared_ptr<omp::Shader> light_shader = std::make_shared<omp::Shader>(
+                m_VulkanContext, getVertexShaderPath("shaderLight", layout),
+                "../SPRV/shaderLightfrag.spv");
+
+        std::unique_ptr<omp::GraphicsPipeline> light_pipe =
+                std::make_unique<omp::GraphicsPipeline>(m_LogicalDevice);
+        light_pipe->startDefaultCreation(layout);
+        light_pipe->addColorBlendingAttachment(color_blend_attachment);
+        light_pipe->addColorBlendingAttachment(color_blend_attachment);
+        light_pipe->createMultisamplingInfo(m_MSAASamples);
+        light_pipe->createViewport(m_SwapChainExtent);
+        light_pipe->addPipelineSetLayout(m_UboDescriptorSetLayout);
+        light_pipe->addPipelineSetLayout(m_TexturesDescriptorSetLayout);
+        light_pipe->createShaders(light_shader);
+        light_pipe->setDepthStencil(depth_stencil);
+        pending_pipelines.push_back(light_pipe.get());
+
+        // Pipelines below are created without depth test
+        depth_stencil.depthTestEnable = VK_FALSE;
+
+        // Simple pipeline
+        std::shared_ptr<omp::Shader> shader = std::make_shared<omp::Shader>(
+                m_VulkanContext, getVertexShaderPath("shader", layout), "../SPRV/shaderfrag.spv");
+
+        std::unique_ptr<omp::GraphicsPipeline> pipe =
+                std::make_unique<omp::GraphicsPipeline>(m_LogicalDevice);
+        pipe->startDefaultCreation(layout);
+        pipe->addColorBlendingAttachment(color_blend_attachment);
+        pipe->addColorBlendingAttachment(color_blend_attachment);
+        pipe->createMultisamplingInfo(m_MSAASamples);
+        pipe->createViewport(m_SwapChainExtent);
+        pipe->addPipelineSetLayout(m_UboDescriptorSetLayout);
+        pipe->addPipelineSetLayout(m_TexturesDescriptorSetLayout);
+        pipe->setDepthStencil(depth_stencil);
+        pipe->createShaders(shader);
+        pending_pipelines.push_back(pipe.get());
+
+        std::shared_ptr<omp::Shader> blend_shader = std::make_shared<omp::Shader>(
+                m_VulkanContext, getVertexShaderPath("shaderLightBlend", layout),
+                "../SPRV/shaderLightBlendfrag.spv");
+        VkPipelineRasterizationStateCreateInfo rasterization_state{};
+        rasterization_state.sType =
+                VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+        rasterization_state.depthClampEnable = VK_FALSE;
+        rasterization_state.rasterizerDiscardEnable = VK_FALSE;
+        rasterization_state.polygonMode = VK_POLYGON_MODE_FILL;
+        rasterization_state.lineWidth = 1.0f;
+        rasterization_state.cullMode = VK_CULL_MODE_NONE;
+        rasterization_state.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+        rasterization_state.depthBiasEnable = VK_FALSE;
+        rasterization_state.depthBiasConstantFactor = 0.0f;
+        rasterization_state.depthBiasClamp = 0.0f;
+        rasterization_state.depthBiasSlopeFactor = 0.0f;
+        std::unique_ptr<omp::GraphicsPipeline> grass_pipe =
+                std::make_unique<omp::GraphicsPipeline>(m_LogicalDevice);
+        grass_pipe->startDefaultCreation(layout);
+        color_blend_attachment.blendEnable = VK_TRUE;
+        grass_pipe->addColorBlendingAttachment(color_blend_attachment);
+        color_blend_attachment.blendEnable = VK_FALSE;
+        grass_pipe->addColorBlendingAttachment(color_blend_attachment);
+        grass_pipe->createMultisamplingInfo(m_MSAASamples);
+        grass_pipe->createViewport(m_SwapChainExtent);
+        grass_pipe->createRasterizer(rasterization_state);
+        grass_pipe->addPipelineSetLayout(m_UboDescriptorSetLayout);
+        grass_pipe->addPipelineSetLayout(m_TexturesDescriptorSetLayout);
+        grass_pipe->setDepthStencil(depth_stencil);
+        grass_pipe->createShaders(blend_shader);
+        pending_pipelines.push_back(grass_pipe.get());
+
+        // LIGHT STENCIL
+        color_blend_attachment.blendEnable = VK_FALSE;
+        std::unique_ptr<omp::GraphicsPipeline> light_stencil =
+                std::make_unique<omp::GraphicsPipeline>(m_LogicalDevice);
+        light_stencil->startDefaultCreation(layout);
+        light_stencil->addColorBlendingAttachment(color_blend_attachment);
+        light_stencil->addColorBlendingAttachment(color_blend_attachment);
+        light_stencil->createMultisamplingInfo(m_MSAASamples);
+        light_stencil->createViewport(m_SwapChainExtent);
+        light_stencil->addPipelineSetLayout(m_UboDescriptorSetLayout);
+        light_stencil->addPipelineSetLayout(m_TexturesDescriptorSetLayout);
+        light_stencil->createShaders(light_shader);
+        depth_stencil.stencilTestEnable = VK_TRUE;
+        light_stencil->setDepthStencil(depth_stencil);
+        pending_pipelines.push_back(light_stencil.get());
+
+        // Outline pipeline
+        std::shared_ptr<omp::Shader> outline_shader = std::make_unique<omp::Shader>(
+                m_VulkanContext, "../SPRV/outlinevert.spv", "../SPRV/outlinefrag.spv");
+        std::unique_ptr<omp::GraphicsPipeline> outline_pipe =
+                std::make_unique<omp::GraphicsPipeline>(m_LogicalDevice);
+        outline_pipe->startDefaultCreation(layout);
+        outline_pipe->addColorBlendingAttachment(color_blend_attachment);
+        outline_pipe->addColorBlendingAttachment(color_blend_attachment);
+        outline_pipe->createMultisamplingInfo(m_MSAASamples);
+        outline_pipe->createViewport(m_SwapChainExtent);
+        outline_pipe->addPipelineSetLayout(m_OutlineSetLayout);
+        outline_pipe->createShaders(outline_shader);
+        stencil_state.compareOp = VK_COMPARE_OP_NOT_EQUAL;
+        stencil_state.failOp = VK_STENCIL_OP_KEEP;
+        stencil_state.depthFailOp = VK_STENCIL_OP_KEEP;
+        stencil_state.passOp = VK_STENCIL_OP_REPLACE;
+        depth_stencil.back = stencil_state;
+        depth_stencil.front = stencil_state;
+        depth_stencil.depthTestEnable = VK_FALSE;
+        depth_stencil.stencilTestEnable = VK_TRUE;
+        outline_pipe->setDepthStencil(depth_stencil);
+        pending_pipelines.push_back(outline_pipe.get());
+
+        m_Pipelines.insert({getPipelineName("Light", layout), std::move(light_pipe)});
+        m_Pipelines.insert({getPipelineName("Simple", layout), std::move(pipe)});
+        m_Pipelines.insert({getPipelineName("Outline", layout), std::move(outline_pipe)});
+        m_Pipelines.insert({getPipelineName("LightStencil", layout), std::move(light_stencil)});
+        m_Pipelines.insert({getPipelineName("Grass", layout), std::move(grass_pipe)});
+    }
 
-    std::unique_ptr<omp::GraphicsPipeline> pipe =
-            std::make_unique<omp::GraphicsPipeline>(m_LogicalDevice);
-    pipe->startDefaultCreation();
-    pipe->addColorBlendingAttachment(color_blend_attachment);
-    pipe->addColorBlendingAttachment(color_blend_attachment);
-    pipe->createMultisamplingInfo(m_MSAASamples);
-    pipe->createViewport(m_SwapChainExtent);
-    pipe->definePushConstant<omp::ModelPushConstant>(
-            VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT);
-    pipe->addPipelineSetLayout(m_UboDescriptorSetLayout);
-    pipe->addPipelineSetLayout(m_TexturesDescriptorSetLayout);
-    pipe->setDepthStencil(depth_stencil);
-    pipe->createShaders(shader);
-    pipe->confirmCreation(m_RenderPass);
-
-    std::shared_ptr<omp::Shader> blend_shader = std::make_shared<omp::Shader>(
-            m_VulkanContext, "../SPRV/shaderLightBlendvert.spv",
-            "../SPRV/shaderLightBlendfrag.spv");
-    VkPipelineRasterizationStateCreateInfo rasterization_state{};
-    rasterization_state.sType =
-            VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
-    rasterization_state.depthClampEnable = VK_FALSE;
-    rasterization_state.rasterizerDiscardEnable = VK_FALSE;
-    rasterization_state.polygonMode = VK_POLYGON_MODE_FILL;
-    rasterization_state.lineWidth = 1.0f;
-    rasterization_state.cullMode = VK_CULL_MODE_NONE;
-    rasterization_state.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
-    rasterization_state.depthBiasEnable = VK_FALSE;
-    rasterization_state.depthBiasConstantFactor = 0.0f;
-    rasterization_state.depthBiasClamp = 0.0f;
-    rasterization_state.depthBiasSlopeFactor = 0.0f;
-    std::unique_ptr<omp::GraphicsPipeline> grass_pipe =
-            std::make_unique<omp::GraphicsPipeline>(m_LogicalDevice);
-    grass_pipe->startDefaultCreation();
-    color_blend_attachment.blendEnable = VK_TRUE;
-    grass_pipe->addColorBlendingAttachment(color_blend_attachment);
-    color_blend_attachment.blendEnable = VK_FALSE;
-    grass_pipe->addColorBlendingAttachment(color_blend_attachment);
-    grass_pipe->createMultisamplingInfo(m_MSAASamples);
-    grass_pipe->createViewport(m_SwapChainExtent);
-    grass_pipe->createRasterizer(rasterization_state);
-    grass_pipe->definePushConstant<omp::ModelPushConstant>(
-            VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT);
-    grass_pipe->addPipelineSetLayout(m_UboDescriptorSetLayout);
-    grass_pipe->addPipelineSetLayout(m_TexturesDescriptorSetLayout);
-    grass_pipe->setDepthStencil(depth_stencil);
-    grass_pipe->createShaders(blend_shader);
-    grass_pipe->confirmCreation(m_RenderPass);
-
-    // LIGHT STENCIL
-    color_blend_attachment.blendEnable = VK_FALSE;
-    std::unique_ptr<omp::GraphicsPipeline> light_stencil =
-            std::make_unique<omp::GraphicsPipeline>(m_LogicalDevice);
-    light_stencil->startDefaultCreation();
-    light_stencil->addColorBlendingAttachment(color_blend_attachment);
-    light_stencil->addColorBlendingAttachment(color_blend_attachment);
-    light_stencil->createMultisamplingInfo(m_MSAASamples);
-    light_stencil->createViewport(m_SwapChainExtent);
-    light_stencil->definePushConstant<omp::ModelPushConstant>(
-            VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT);
-    light_stencil->addPipelineSetLayout(m_UboDescriptorSetLayout);
-    light_stencil->addPipelineSetLayout(m_TexturesDescriptorSetLayout);
-    light_stencil->createShaders(light_shader);
-    depth_stencil.stencilTestEnable = VK_TRUE;
-    light_stencil->setDepthStencil(depth_stencil);
-    light_stencil->confirmCreation(m_RenderPass);
-
-    // Outline pipeline
-    std::shared_ptr<omp::Shader> outline_shader = std::make_unique<omp::Shader>(
-            m_VulkanContext, "../SPRV/outlinevert.spv", "../SPRV/outlinefrag.spv");
-    std::unique_ptr<omp::GraphicsPipeline> outline_pipe =
-            std::make_unique<omp::GraphicsPipeline>(m_LogicalDevice);
-    outline_pipe->startDefaultCreation();
-    outline_pipe->addColorBlendingAttachment(color_blend_attachment);
-    outline_pipe->addColorBlendingAttachment(color_blend_attachment);
-    outline_pipe->createMultisamplingInfo(m_MSAASamples);
-    outline_pipe->createViewport(m_SwapChainExtent);
-    outline_pipe->addPipelineSetLayout(m_OutlineSetLayout);
-    outline_pipe->createShaders(outline_shader);
-    stencil_state.compareOp = VK_COMPARE_OP_NOT_EQUAL;
-    stencil_state.failOp = VK_STENCIL_OP_KEEP;
-    stencil_state.depthFailOp = VK_STENCIL_OP_KEEP;
-    stencil_state.passOp = VK_STENCIL_OP_REPLACE;
-    depth_stencil.back = stencil_state;
-    depth_stencil.front = stencil_state;
-    depth_stencil.depthTestEnable = VK_FALSE;
-    depth_stencil.stencilTestEnable = VK_TRUE;
-    outline_pipe->setDepthStencil(depth_stencil);
-    outline_pipe->confirmCreation(m_RenderPass);
-
-    m_Pipelines.insert({"Light", std::move(light_pipe)});
-    m_Pipelines.insert({"Simple", std::move(pipe)});
-    m_Pipelines.insert({"Outline", std::move(outline_pipe)});
-    m_Pipelines.insert({"LightStencil", std::move(light_stencil)});
-    m_Pipelines.insert({"Grass", std::move(grass_pipe)});
     m_Pipelines.insert({"Skybox", std::move(skybox_pipe)});
+
+    // Configured pipelines are independent, drivers compile them concurrently into the shared cache
+    const auto start = std::chrono::steady_clock::now();
+    const VkPipelineCache pipeline_cache = m_PipelineCache->getPipelineCache();
+    const auto compile = [this, &pending_pipelines, pipeline_cache](size_t inBegin, size_t inEnd)
+    {
+        for (size_t index = inBegin; index < inEnd; index++)
+        {
+            pending_pipelines[index]->setPipelineCache(pipeline_cache);
+            pending_pipelines[index]->confirmCreation(m_RenderPass);
+        }
+    };
+    if (m_ThreadPool)
+    {
+        m_ThreadPool->parallelFor(pending_pipelines.size(), 1, compile);
+    }
+    else
+    {
+        compile(0, pending_pipelines.size());
+    }
+    const double elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    INFO(LogRendering, "Created {} pipelines in {:.2f} ms", pending_pipelines.size(), elapsed_ms);
+
+    registerPipelineHandles();
 }
 
 void omp::Renderer::createRenderPass()
@@ -1079,154 +1172,41 @@ void omp::Renderer::prepareFrameForImage(size_t KHRImageIndex)
     rect.offset.y = 0;
     rect.extent.width = m_ViewportSize[0];
     rect.extent.height = m_ViewportSize[1];
-    beginRenderPass(m_RenderPass.get(), main_buffer,
-                    m_SwapChainFramebuffers[KHRImageIndex], clear_values, rect);
-    setViewport(main_buffer);
 
-    omp::SceneEntity* outline_entity = nullptr;
-    VkDeviceSize offsets[] = {0};
+    // LOD is picked per entity from its projected size, this is pixels per unit at distance one
+    const omp::Camera* camera = m_CurrentScene->getCurrentCamera();
+    const float pixels_per_unit = static_cast<float>(m_ViewportSize[1]) /
+                                  (2.0f * std::tan(glm::radians(camera->getViewAngle()) * 0.5f));
 
     std::vector<omp::SceneEntity*> scene_copy =
             m_CurrentScene->getEntitiesCopy();
-    std::sort(
-            scene_copy.begin(), scene_copy.end(),
-            [this](
-                    const omp::SceneEntity* inEnt,
-                    const omp::SceneEntity* inEnt2) -> bool
-            {
-                if (inEnt->getModelInstance()
-                            ->getMaterialInstance()
-                            ->getStaticMaterial()
-                            .lock()
-                            ->isBlendingEnabled() &&
-                    !inEnt2->getModelInstance()
-                            ->getMaterialInstance()
-                            ->getStaticMaterial()
-                            .lock()
-                            ->isBlendingEnabled())
-                {
-                    return false;
-                }
-                if (!inEnt->getModelInstance()
-                        ->getMaterialInstance()
-                        ->getStaticMaterial()
-                        .lock()
-                        ->isBlendingEnabled() &&
-                    inEnt2->getModelInstance()
-                            ->getMaterialInstance()
-                            ->getStaticMaterial()
-                            .lock()
-                            ->isBlendingEnabled())
-                {
-                    return true;
-                }
-                // TODO remove sqrt
-                return glm::distance(m_CurrentScene->getCurrentCamera()->getPosition(),
-                                     inEnt->getModelInstance()->getPosition()) >
-                       glm::distance(m_CurrentScene->getCurrentCamera()->getPosition(),
-                                     inEnt2->getModelInstance()->getPosition());
-                // return true;
-            });
-    for (size_t index = 0; index < scene_copy.size(); index++)
-    {
-        auto& scene_entity = scene_copy[index];
-        auto& material_instance = scene_entity->getModelInstance()->getMaterialInstance();
-        auto material = material_instance->getStaticMaterial().lock();
-        if (!material)
-        {
-            WARN(LogRendering, "Material is invalid in material instance");
-        }
+    cullEntities(scene_copy);
+    buildDrawGroups(scene_copy, static_cast<uint32_t>(KHRImageIndex), pixels_per_unit);
 
-        VkPipeline model_pipeline{};
-        VkPipelineLayout model_pipeline_layout{};
-        if (scene_entity->getId() == m_CurrentScene->getCurrentId())
-        {
-            // TODO check this for valid shader, because light have simple shader, and
-            // should not have lightstencil layouts
-            outline_entity = scene_entity;
-            model_pipeline =
-                    findGraphicsPipeline("LightStencil")->getGraphicsPipeline();
-            model_pipeline_layout =
-                    findGraphicsPipeline("LightStencil")->getPipelineLayout();
-        }
-        else
-        {
-            model_pipeline = findGraphicsPipeline(material->getShaderName())
-                    ->getGraphicsPipeline();
-            model_pipeline_layout =
-                    findGraphicsPipeline(material->getShaderName())->getPipelineLayout();
-        }
-        vkCmdBindPipeline(main_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                          model_pipeline);
-
-        vkCmdBindDescriptorSets(main_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                model_pipeline_layout, 0, 1,
-                                &m_UboDescriptorSets[KHRImageIndex], 0, nullptr);
-
-        vkCmdBindVertexBuffers(
-                main_buffer, 0, 1,
-                &scene_entity->getModelInstance()->getModel().lock()->getVertexBuffer(),
-                offsets);
-        vkCmdBindIndexBuffer(
-                main_buffer,
-                scene_entity->getModelInstance()->getModel().lock()->getIndexBuffer(), 0,
-                VK_INDEX_TYPE_UINT32);
-
-        omp::ModelPushConstant constant{
-                scene_entity->getModelInstance()->getTransform(),
-                material_instance->getAmbient(), material_instance->getDiffusive(),
-                material_instance->getSpecular(), scene_entity->getId()};
-        vkCmdPushConstants(main_buffer, model_pipeline_layout,
-                           VK_SHADER_STAGE_VERTEX_BIT |
-                           VK_SHADER_STAGE_FRAGMENT_BIT,
-                           0, sizeof(omp::ModelPushConstant), &constant);
+    // Long draw lists are recorded into secondary buffers on the thread pool, render pass then holds only those
+    omp::ThreadPool* thread_pool = m_CurrentScene->getThreadPool();
+    const bool record_in_parallel = thread_pool && m_DrawGroups.size() >= PARALLEL_RECORDING_THRESHOLD;
+    beginRenderPass(m_RenderPass.get(), main_buffer,
+                    m_SwapChainFramebuffers[KHRImageIndex], clear_values, rect,
+                    record_in_parallel ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE);
 
-        // TODO: MATERIALS ARE TOTAL SHIT
-        if (material)
-        {
-            retrieveMaterialRenderState(material);
-            vkCmdBindDescriptorSets(
-                    main_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, model_pipeline_layout,
-                    1, 1, &material->getDescriptorSet()[KHRImageIndex], 0, nullptr);
-        }
-        else
-        {
-            // default material
-            vkCmdBindDescriptorSets(
-                    main_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, model_pipeline_layout,
-                    1, 1, &m_DefaultMaterial->getDescriptorSet()[KHRImageIndex], 0,
-                    nullptr);
-        }
-        vkCmdDrawIndexed(
-                main_buffer,
-                static_cast<uint32_t>(
-                        scene_entity->getModelInstance()->getModel().lock()->getIndices().size()),
-                1, 0, 0, 0);
-    }
-
-    if (outline_entity)
-    {
-        auto outline_pipeline = findGraphicsPipeline("Outline");
-        vkCmdBindVertexBuffers(
-                main_buffer, 0, 1,
-                &outline_entity->getModelInstance()->getModel().lock()->getVertexBuffer(),
-                offsets);
-        vkCmdBindIndexBuffer(
-                main_buffer,
-                outline_entity->getModelInstance()->getModel().lock()->getIndexBuffer(), 0,
-                VK_INDEX_TYPE_UINT32);
-        vkCmdBindPipeline(main_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                          outline_pipeline->getGraphicsPipeline());
-        vkCmdBindDescriptorSets(main_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                outline_pipeline->getPipelineLayout(), 0, 1,
-                                &m_OutlineDescriptorSets[KHRImageIndex], 0,
-                                nullptr);
-        vkCmdDrawIndexed(
-                main_buffer,
-                static_cast<uint32_t>(
-                        outline_entity->getModelInstance()->getModel().lock()->getIndices().size()),
-                1, 0, 0, 0);
+    DrawRecordStatistics statistics;
+    if (record_in_parallel)
+    {
+        statistics = recordDrawGroupsInParallel(main_buffer, KHRImageIndex, *thread_pool);
     }
+    else
+    {
+        setViewport(main_buffer);
+        omp::BindStateCache bind_cache;
+        statistics = recordDrawGroups(main_buffer, 0, m_DrawGroups.size(), KHRImageIndex, bind_cache);
+        recordOutline(main_buffer, statistics.outline_group, KHRImageIndex, bind_cache);
+        statistics.saved_binds = bind_cache.getSavedBinds();
+    }
+    OMP_STAT_VALUE("DrawCalls", statistics.draw_calls);
+    OMP_STAT_VALUE("SavedBinds", statistics.saved_binds);
+    OMP_STAT_VALUE("DrawnTriangles", statistics.drawn_triangles);
+    OMP_STAT_VALUE("CulledMeshlets", statistics.culled_meshlets);
 
     endRenderPass(m_RenderPass.get(), main_buffer);
 
@@ -1246,6 +1226,277 @@ void omp::Renderer::prepareFrameForImage(size_t KHRImageIndex)
                   m_ImguiCommandBuffers[KHRImageIndex].buffer);
 }
 
+omp::Renderer::DrawRecordStatistics omp::Renderer::recordDrawGroups(VkCommandBuffer inCommandBuffer, size_t inBegin, size_t inEnd,
+                                                                   size_t KHRImageIndex, omp::BindStateCache& ioBindCache) const
+{
+    OMP_STAT_SCOPE("RecordDrawGroups");
+
+    DrawRecordStatistics statistics;
+    const glm::vec3& camera_position = m_CurrentScene->getCurrentCamera()->getPosition();
+    const std::array<float, 3> view_position = {camera_position.x, camera_position.y, camera_position.z};
+    const std::array<uint32_t, 5> ubo_offsets = getUboDynamicOffsets(static_cast<uint32_t>(KHRImageIndex));
+    std::vector<omp::IndexRange> draw_ranges;
+
+    // Every model lives in the arena buffers, index buffer is rebound only when index type changes
+    const omp::GeometryArena& geometry_arena = *m_VulkanContext->geometry_arena;
+    const VkBuffer vertex_buffer = geometry_arena.getVertexBuffer();
+    const VkBuffer index_buffer = geometry_arena.getIndexBuffer();
+    const VkDeviceSize offsets[] = {0};
+    if (ioBindCache.bindVertexBuffer(vertex_buffer))
+    {
+        vkCmdBindVertexBuffers(inCommandBuffer, 0, 1, &vertex_buffer, offsets);
+    }
+
+    for (size_t index = inBegin; index < inEnd; index++)
+    {
+        const DrawGroup& group = m_DrawGroups[index];
+        const std::shared_ptr<omp::Model>& model = group.model;
+        const omp::MeshLod& lod = group.lod;
+
+        // Meshlets cover LOD 0 of single instances only, coarser LODs and instanced groups are drawn whole.
+        // Meshlets of full detail draws are culled against the same projection as the uniform buffer
+        draw_ranges.clear();
+        if (group.entity && lod.first_index == 0 && !model->getMeshlets().empty())
+        {
+            const glm::mat4 transform = group.entity->getModelInstance()->getTransform();
+            const omp::MeshletCullStatistics culled = omp::MeshletBuilder::cull(model->getMeshlets(), glm::value_ptr(transform),
+                                                                                m_ViewFrustum, view_position, draw_ranges);
+            statistics.culled_meshlets += culled.frustum_culled + culled.backface_culled;
+        }
+        else
+        {
+            draw_ranges.push_back(omp::IndexRange{lod.first_index, lod.index_count});
+        }
+        if (draw_ranges.empty())
+        {
+            continue;
+        }
+
+        if (group.entity && group.entity->getId() == m_CurrentScene->getCurrentId())
+        {
+            statistics.outline_group = &group;
+        }
+
+        // Draws are sorted by pipeline and material, so most of these binds repeat the previous draw's
+        const VkPipelineLayout model_pipeline_layout = group.pipeline->getPipelineLayout();
+        const uint64_t layout_signature = group.pipeline->getLayoutSignature();
+        if (ioBindCache.bindPipeline(group.pipeline->getGraphicsPipeline()))
+        {
+            vkCmdBindPipeline(inCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                              group.pipeline->getGraphicsPipeline());
+        }
+
+        if (ioBindCache.bindDescriptorSet(layout_signature, 0, m_UboDescriptorSet,
+                                          static_cast<uint32_t>(ubo_offsets.size()), ubo_offsets.data()))
+        {
+            vkCmdBindDescriptorSets(inCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                    model_pipeline_layout, 0, 1,
+                                    &m_UboDescriptorSet, static_cast<uint32_t>(ubo_offsets.size()), ubo_offsets.data());
+        }
+
+        if (ioBindCache.bindIndexBuffer(index_buffer, model->getIndexType()))
+        {
+            vkCmdBindIndexBuffer(inCommandBuffer, index_buffer, 0, model->getIndexType());
+        }
+
+        // Material sets are created by buildDrawGroups, recording may run on workers
+        const std::shared_ptr<omp::Material>& material = group.material ? group.material : m_DefaultMaterial;
+        const VkDescriptorSet material_set = material->getDescriptorSet()[KHRImageIndex];
+        if (ioBindCache.bindDescriptorSet(layout_signature, 1, material_set, 0, nullptr))
+        {
+            vkCmdBindDescriptorSets(
+                    inCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, model_pipeline_layout,
+                    1, 1, &material_set, 0, nullptr);
+        }
+
+        for (const omp::IndexRange& range : draw_ranges)
+        {
+            vkCmdDrawIndexed(inCommandBuffer, range.index_count, group.instance_count, model->getFirstIndex() + range.first_index,
+                             model->getVertexOffset(), group.first_instance);
+            statistics.drawn_triangles += range.index_count / 3 * group.instance_count;
+            statistics.draw_calls++;
+        }
+    }
+    return statistics;
+}
+
+void omp::Renderer::recordOutline(VkCommandBuffer inCommandBuffer, const DrawGroup* inGroup, size_t KHRImageIndex,
+                                  omp::BindStateCache& ioBindCache) const
+{
+    if (!inGroup)
+    {
+        return;
+    }
+
+    const std::shared_ptr<omp::Model>& outline_model = inGroup->model;
+    const omp::MeshLod& outline_lod = inGroup->lod;
+    omp::GraphicsPipeline* outline_pipeline =
+            getGraphicsPipeline(m_OutlinePipelines[static_cast<size_t>(outline_model->getVertexLayout())]);
+    const omp::GeometryArena& geometry_arena = *m_VulkanContext->geometry_arena;
+    const VkBuffer vertex_buffer = geometry_arena.getVertexBuffer();
+    const VkBuffer index_buffer = geometry_arena.getIndexBuffer();
+    const VkDeviceSize offsets[] = {0};
+    if (ioBindCache.bindVertexBuffer(vertex_buffer))
+    {
+        vkCmdBindVertexBuffers(inCommandBuffer, 0, 1, &vertex_buffer, offsets);
+    }
+    if (ioBindCache.bindIndexBuffer(index_buffer, outline_model->getIndexType()))
+    {
+        vkCmdBindIndexBuffer(inCommandBuffer, index_buffer, 0, outline_model->getIndexType());
+    }
+    if (ioBindCache.bindPipeline(outline_pipeline->getGraphicsPipeline()))
+    {
+        vkCmdBindPipeline(inCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                          outline_pipeline->getGraphicsPipeline());
+    }
+    const uint32_t outline_offset = m_OutlineBuffer->getDynamicOffset(static_cast<uint32_t>(KHRImageIndex));
+    if (ioBindCache.bindDescriptorSet(outline_pipeline->getLayoutSignature(), 0, m_OutlineDescriptorSet, 1, &outline_offset))
+    {
+        vkCmdBindDescriptorSets(inCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                outline_pipeline->getPipelineLayout(), 0, 1,
+                                &m_OutlineDescriptorSet, 1,
+                                &outline_offset);
+    }
+    vkCmdDrawIndexed(inCommandBuffer, outline_lod.index_count, 1, outline_model->getFirstIndex() + outline_lod.first_index,
+                     outline_model->getVertexOffset(), 0);
+}
+
+omp::Renderer::DrawRecordStatistics omp::Renderer::recordDrawGroupsInParallel(VkCommandBuffer inPrimary, size_t KHRImageIndex,
+                                                                             omp::ThreadPool& inThreadPool)
+{
+    OMP_STAT_SCOPE("RecordInParallel");
+
+    SecondaryCommandBuffers& secondaries = getSecondaryCommandBuffers(KHRImageIndex);
+    // Image's last submit is done, its fence was waited for before recording
+    for (VkCommandPool pool : secondaries.pools)
+    {
+        vkResetCommandPool(m_LogicalDevice, pool, 0);
+    }
+
+    // Last buffer is for the outline, drawn after every group on this thread
+    const size_t max_chunks = secondaries.buffers.size() - 1;
+    const size_t chunk_size = std::max((m_DrawGroups.size() + max_chunks - 1) / max_chunks, MIN_GROUPS_PER_CHUNK);
+    const size_t chunk_count = (m_DrawGroups.size() + chunk_size - 1) / chunk_size;
+
+    VkCommandBufferInheritanceInfo inheritance_info{};
+    inheritance_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    inheritance_info.renderPass = m_RenderPass->getRenderPass();
+    inheritance_info.subpass = 0;
+    inheritance_info.framebuffer = m_SwapChainFramebuffers[KHRImageIndex].getVulkanFrameBuffer();
+
+    VkCommandBufferBeginInfo begin_info{};
+    begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    begin_info.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    begin_info.pInheritanceInfo = &inheritance_info;
+
+    // Chunk index picks the pool, so no two workers record into one pool at once
+    std::vector<DrawRecordStatistics> chunk_statistics(chunk_count);
+    inThreadPool.parallelFor(m_DrawGroups.size(), chunk_size,
+                             [this, &secondaries, &begin_info, &chunk_statistics, chunk_size, KHRImageIndex](size_t inBegin, size_t inEnd)
+    {
+        const size_t chunk = inBegin / chunk_size;
+        VkCommandBuffer buffer = secondaries.buffers[chunk];
+        if (vkBeginCommandBuffer(buffer, &begin_info) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to begin recording secondary command buffer!");
+        }
+        // Dynamic state is not inherited from the primary buffer
+        setViewport(buffer);
+        omp::BindStateCache bind_cache;
+        chunk_statistics[chunk] = recordDrawGroups(buffer, inBegin, inEnd, KHRImageIndex, bind_cache);
+        chunk_statistics[chunk].saved_binds = bind_cache.getSavedBinds();
+        if (vkEndCommandBuffer(buffer) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to record secondary command buffer");
+        }
+    });
+
+    DrawRecordStatistics statistics;
+    for (const DrawRecordStatistics& chunk : chunk_statistics)
+    {
+        statistics.drawn_triangles += chunk.drawn_triangles;
+        statistics.draw_calls += chunk.draw_calls;
+        statistics.culled_meshlets += chunk.culled_meshlets;
+        statistics.saved_binds += chunk.saved_binds;
+        statistics.outline_group = chunk.outline_group ? chunk.outline_group : statistics.outline_group;
+    }
+
+    size_t execute_count = chunk_count;
+    if (statistics.outline_group)
+    {
+        VkCommandBuffer outline_buffer = secondaries.buffers[chunk_count];
+        if (vkBeginCommandBuffer(outline_buffer, &begin_info) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to begin recording secondary command buffer!");
+        }
+        setViewport(outline_buffer);
+        omp::BindStateCache bind_cache;
+        recordOutline(outline_buffer, statistics.outline_group, KHRImageIndex, bind_cache);
+        if (vkEndCommandBuffer(outline_buffer) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to record secondary command buffer");
+        }
+        execute_count++;
+    }
+    vkCmdExecuteCommands(inPrimary, static_cast<uint32_t>(execute_count), secondaries.buffers.data());
+    return statistics;
+}
+
+omp::Renderer::SecondaryCommandBuffers& omp::Renderer::getSecondaryCommandBuffers(size_t KHRImageIndex)
+{
+    if (m_SecondaryCommandBuffers.size() <= KHRImageIndex)
+    {
+        m_SecondaryCommandBuffers.resize(KHRImageIndex + 1);
+    }
+    SecondaryCommandBuffers& secondaries = m_SecondaryCommandBuffers[KHRImageIndex];
+    if (!secondaries.pools.empty())
+    {
+        return secondaries;
+    }
+
+    // A chunk per worker plus one buffer for the outline
+    const size_t buffer_count = std::max<size_t>(std::thread::hardware_concurrency(), 1) + 1;
+    QueueFamilyIndices queue_family_indices = findQueueFamilies(m_PhysDevice);
+    VkCommandPoolCreateInfo pool_info{};
+    pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    pool_info.queueFamilyIndex = queue_family_indices.graphics_family.value();
+    pool_info.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+    secondaries.pools.resize(buffer_count, VK_NULL_HANDLE);
+    secondaries.buffers.resize(buffer_count, VK_NULL_HANDLE);
+    for (size_t index = 0; index < buffer_count; index++)
+    {
+        if (vkCreateCommandPool(m_LogicalDevice, &pool_info, nullptr, &secondaries.pools[index]) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create secondary command pool");
+        }
+
+        VkCommandBufferAllocateInfo buffer_info{};
+        buffer_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        buffer_info.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+        buffer_info.commandPool = secondaries.pools[index];
+        buffer_info.commandBufferCount = 1;
+        if (vkAllocateCommandBuffers(m_LogicalDevice, &buffer_info, &secondaries.buffers[index]) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to allocate secondary command buffer");
+        }
+    }
+    return secondaries;
+}
+
+void omp::Renderer::destroySecondaryCommandBuffers()
+{
+    for (SecondaryCommandBuffers& secondaries : m_SecondaryCommandBuffers)
+    {
+        // Buffers go with their pools
+        for (VkCommandPool pool : secondaries.pools)
+        {
+            vkDestroyCommandPool(m_LogicalDevice, pool, nullptr);
+        }
+    }
+    m_SecondaryCommandBuffers.clear();
+}
+
 void omp::Renderer::drawFrame()
 {
     OMP_STAT_SCOPE("DrawFrame");
@@ -1275,6 +1526,9 @@ void omp::Renderer::drawFrame()
     submit_info.signalSemaphoreCount = 1;
     submit_info.pSignalSemaphores = signal_semaphores;
 
+    // Texture uploads of this frame land on the graphics queue ahead of draws that sample them
+    m_VulkanContext->upload_queue->flush();
+
     vkResetFences(m_LogicalDevice, 1, &m_InFlightFences[m_CurrentFrame]);
 
     if (vkQueueSubmit(m_GraphicsQueue, 1, &submit_info,
@@ -1299,8 +1553,8 @@ void omp::Renderer::drawFrame()
     {
         throw std::runtime_error("Failed to present swap chain image!");
     }
-    vkQueueWaitIdle(m_PresentQueue);
 
+    m_VulkanContext->deferred_deletion.endFrame();
     m_CurrentFrame = (m_CurrentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
 }
 
@@ -1335,6 +1589,7 @@ void omp::Renderer::createSyncObjects()
 void omp::Renderer::recreateSwapChain()
 {
     vkDeviceWaitIdle(m_LogicalDevice);
+    m_VulkanContext->deferred_deletion.flush();
 
     cleanupSwapChain();
 
@@ -1395,11 +1650,9 @@ void omp::Renderer::cleanupSwapChain()
         material->clearDescriptorSets();
     } */
 
+    std::array<VkDescriptorSet, 3> frame_sets = {m_SkyboxDescriptorSet, m_OutlineDescriptorSet, m_UboDescriptorSet};
     vkFreeDescriptorSets(m_LogicalDevice, m_DescriptorPool,
-                         static_cast<uint32_t>(m_UboDescriptorSets.size()), m_UboDescriptorSets.data());
-    vkFreeDescriptorSets(m_LogicalDevice, m_DescriptorPool,
-                         static_cast<uint32_t>(m_OutlineDescriptorSets.size()),
-                         m_OutlineDescriptorSets.data());
+                         static_cast<uint32_t>(frame_sets.size()), frame_sets.data());
 
     m_ImguiRenderPass->destroyInnerState();
 }
@@ -1420,7 +1673,7 @@ void omp::Renderer::createDescriptorSetLayout()
     {
         VkDescriptorSetLayoutBinding skybox_layout_binding{};
         skybox_layout_binding.binding = 0;
-        skybox_layout_binding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        skybox_layout_binding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
         skybox_layout_binding.descriptorCount = 1;
         skybox_layout_binding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
         skybox_layout_binding.pImmutableSamplers = nullptr;
@@ -1450,7 +1703,7 @@ void omp::Renderer::createDescriptorSetLayout()
     {
         VkDescriptorSetLayoutBinding ubo_layout_binding{};
         ubo_layout_binding.binding = 0;
-        ubo_layout_binding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        ubo_layout_binding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
         ubo_layout_binding.descriptorCount = 1;
         ubo_layout_binding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
         ubo_layout_binding.pImmutableSamplers = nullptr;
@@ -1476,7 +1729,7 @@ void omp::Renderer::createDescriptorSetLayout()
     {
         VkDescriptorSetLayoutBinding ubo_layout_binding{};
         ubo_layout_binding.binding = 0;
-        ubo_layout_binding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        ubo_layout_binding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
         ubo_layout_binding.descriptorCount = 1;
         ubo_layout_binding.stageFlags =
                 VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
@@ -1485,7 +1738,7 @@ void omp::Renderer::createDescriptorSetLayout()
         VkDescriptorSetLayoutBinding global_light_layout_binding{};
         global_light_layout_binding.binding = 1;
         global_light_layout_binding.descriptorType =
-                VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+                VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
         global_light_layout_binding.descriptorCount = 1;
         global_light_layout_binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
         global_light_layout_binding.pImmutableSamplers = nullptr;
@@ -1493,7 +1746,7 @@ void omp::Renderer::createDescriptorSetLayout()
         VkDescriptorSetLayoutBinding point_light_layout_binding{};
         point_light_layout_binding.binding = 2;
         point_light_layout_binding.descriptorType =
-                VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
         point_light_layout_binding.descriptorCount = 1;
         point_light_layout_binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
         point_light_layout_binding.pImmutableSamplers = nullptr;
@@ -1501,14 +1754,23 @@ void omp::Renderer::createDescriptorSetLayout()
         VkDescriptorSetLayoutBinding spot_light_layout_binding{};
         spot_light_layout_binding.binding = 3;
         spot_light_layout_binding.descriptorType =
-                VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
         spot_light_layout_binding.descriptorCount = 1;
         spot_light_layout_binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
         spot_light_layout_binding.pImmutableSamplers = nullptr;
 
-        std::array<VkDescriptorSetLayoutBinding, 4> ubo_bindings = {
+        VkDescriptorSetLayoutBinding instance_layout_binding{};
+        instance_layout_binding.binding = 4;
+        instance_layout_binding.descriptorType =
+                VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+        instance_layout_binding.descriptorCount = 1;
+        instance_layout_binding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+        instance_layout_binding.pImmutableSamplers = nullptr;
+
+        std::array<VkDescriptorSetLayoutBinding, 5> ubo_bindings = {
                 ubo_layout_binding, global_light_layout_binding,
-                point_light_layout_binding, spot_light_layout_binding};
+                point_light_layout_binding, spot_light_layout_binding,
+                instance_layout_binding};
 
         VkDescriptorSetLayoutCreateInfo ubo_layout_info{};
         ubo_layout_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
@@ -1577,9 +1839,57 @@ void omp::Renderer::createUniformBuffers()
             m_VulkanContext, m_PresentKHRImagesNum, sizeof(OutlineUniformBuffer),
             VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT);
 
+    m_InstanceBuffer = std::make_unique<omp::UniformBuffer>(
+            m_VulkanContext, m_PresentKHRImagesNum, m_InstanceCapacity * sizeof(omp::InstanceData),
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+
     m_LightSystem->tryRecreateBuffers();
 }
 
+void omp::Renderer::cullEntities(std::vector<omp::SceneEntity*>& ioEntities)
+{
+    OMP_STAT_SCOPE("CullEntities");
+
+    // World bounds are cached per instance, so gathering them is safe to split between threads too
+    omp::ThreadPool* thread_pool = m_CurrentScene->getThreadPool();
+    m_EntityBoxes.resize(ioEntities.size());
+    auto gather_boxes = [this, &ioEntities](size_t inBegin, size_t inEnd)
+    {
+        for (size_t index = inBegin; index < inEnd; index++)
+        {
+            const omp::ModelInstance& instance = *ioEntities[index]->getModelInstance();
+            const omp::BoundingBox& box = instance.getWorldBounds().box;
+            if (box.isValid())
+            {
+                m_EntityBoxes.set(index, box);
+            }
+            else
+            {
+                // Nothing to cull without bounds, models without a mesh are skipped when recording anyway
+                m_EntityBoxes.setUnbounded(index);
+            }
+        }
+    };
+    if (thread_pool && ioEntities.size() >= omp::FrustumCuller::PARALLEL_THRESHOLD)
+    {
+        thread_pool->parallelFor(ioEntities.size(), omp::FrustumCuller::CHUNK_SIZE, gather_boxes);
+    }
+    else
+    {
+        gather_boxes(0, ioEntities.size());
+    }
+
+    omp::FrustumCuller::cull(m_ViewFrustum, m_EntityBoxes, thread_pool, m_VisibleEntities);
+    OMP_STAT_VALUE("CulledEntities", ioEntities.size() - m_VisibleEntities.size());
+
+    // Visible indices are ascending, so entities are compacted in place
+    for (size_t index = 0; index < m_VisibleEntities.size(); index++)
+    {
+        ioEntities[index] = ioEntities[m_VisibleEntities[index]];
+    }
+    ioEntities.resize(m_VisibleEntities.size());
+}
+
 void omp::Renderer::updateUniformBuffer(uint32_t currentImage)
 {
     OMP_STAT_SCOPE("UpdateUniform");
@@ -1592,6 +1902,7 @@ void omp::Renderer::updateUniformBuffer(uint32_t currentImage)
             m_CurrentScene->getCurrentCamera()->getNearClipping(),
             m_CurrentScene->getCurrentCamera()->getFarClipping());
     ubo.proj[1][1] *= -1;
+    m_ViewFrustum = omp::BoundsLib::extractFrustum(glm::value_ptr(ubo.proj * ubo.view));
     ubo.view_position = m_CurrentScene->getCurrentCamera()->getPosition();
     ubo.global_light_enabled = m_LightSystem->getGlobalLightSize() > 0;
     ubo.point_light_size = static_cast<uint32_t>(m_LightSystem->getPointLightSize());
@@ -1604,7 +1915,8 @@ void omp::Renderer::updateUniformBuffer(uint32_t currentImage)
     if (entity)
     {
         outline_buffer.model =
-                glm::scale(entity->getModelInstance()->getTransform(), glm::vec3{1.2f});
+                glm::scale(entity->getModelInstance()->getTransform(), glm::vec3{1.2f}) *
+                entity->getModelInstance()->getModel().lock()->getDequantization();
     }
     outline_buffer.view = m_CurrentScene->getCurrentCamera()->getViewMatrix();
     m_OutlineBuffer->mapMemory(outline_buffer, currentImage);
@@ -1615,7 +1927,7 @@ void omp::Renderer::updateUniformBuffer(uint32_t currentImage)
 
 void omp::Renderer::createDescriptorPool()
 {
-    std::array<VkDescriptorPoolSize, 2> pool_sizes{};
+    std::array<VkDescriptorPoolSize, 4> pool_sizes{};
     pool_sizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
     // TODO think about size
     pool_sizes[0].descriptorCount = 100;
@@ -1623,6 +1935,13 @@ void omp::Renderer::createDescriptorPool()
     pool_sizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
     pool_sizes[1].descriptorCount = 100;
 
+    // Frame uniforms, a few sets live at once whatever the swapchain image count
+    pool_sizes[2].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    pool_sizes[2].descriptorCount = 16;
+
+    pool_sizes[3].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    pool_sizes[3].descriptorCount = 16;
+
     VkDescriptorPoolCreateInfo pool_info{};
     pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
     pool_info.poolSizeCount = static_cast<uint32_t>(pool_sizes.size());
@@ -1639,159 +1958,229 @@ void omp::Renderer::createDescriptorPool()
 
 void omp::Renderer::createDescriptorSets()
 {
-    // Skybox
-    {
-        std::vector<VkDescriptorSetLayout> layouts(m_PresentKHRImagesNum,
-                                                   m_SkyboxSetLayout);
+    // One set per layout, images pick their uniform regions with dynamic offsets when binding
+    std::array<VkDescriptorSetLayout, 3> layouts = {m_SkyboxSetLayout, m_OutlineSetLayout, m_UboDescriptorSetLayout};
+    std::array<VkDescriptorSet, 3> sets{};
 
-        VkDescriptorSetAllocateInfo allocate_info{};
-        allocate_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-        allocate_info.descriptorPool = m_DescriptorPool;
-        allocate_info.descriptorSetCount = m_PresentKHRImagesNum;
-        allocate_info.pSetLayouts = layouts.data();
+    VkDescriptorSetAllocateInfo allocate_info{};
+    allocate_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocate_info.descriptorPool = m_DescriptorPool;
+    allocate_info.descriptorSetCount = static_cast<uint32_t>(layouts.size());
+    allocate_info.pSetLayouts = layouts.data();
 
-        m_SkyboxDescriptorSets.resize(m_PresentKHRImagesNum);
-        if (vkAllocateDescriptorSets(m_LogicalDevice, &allocate_info,
-                                     m_SkyboxDescriptorSets.data()) != VK_SUCCESS)
-        {
-            throw std::runtime_error("Failed to allocate descriptor sets!");
-        }
-        for (uint32_t i = 0; i < m_PresentKHRImagesNum; i++)
-        {
-            // Same ubo for outline, so use the same
-            VkDescriptorBufferInfo buffer_info{};
-            buffer_info.buffer = m_OutlineBuffer->getBuffer(i);
-            buffer_info.offset = 0;
-            buffer_info.range = sizeof(OutlineUniformBuffer);
-
-            std::array<VkWriteDescriptorSet, 1> descriptor_writes{};
-            descriptor_writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            descriptor_writes[0].dstSet = m_SkyboxDescriptorSets[i];
-            descriptor_writes[0].dstBinding = 0;
-            descriptor_writes[0].dstArrayElement = 0;
-            descriptor_writes[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-            descriptor_writes[0].descriptorCount = 1;
-            descriptor_writes[0].pBufferInfo = &buffer_info;
-            vkUpdateDescriptorSets(m_LogicalDevice,
-                                   static_cast<uint32_t>(descriptor_writes.size()),
-                                   descriptor_writes.data(), 0, nullptr);
-        }
+    if (vkAllocateDescriptorSets(m_LogicalDevice, &allocate_info, sets.data()) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to allocate descriptor sets!");
     }
+    m_SkyboxDescriptorSet = sets[0];
+    m_OutlineDescriptorSet = sets[1];
+    m_UboDescriptorSet = sets[2];
+
+    // Same ubo for outline and skybox, so use the same
+    VkDescriptorBufferInfo outline_info{};
+    outline_info.buffer = m_OutlineBuffer->getBuffer();
+    outline_info.offset = 0;
+    outline_info.range = m_OutlineBuffer->getRange();
+
+    VkDescriptorBufferInfo buffer_info{};
+    buffer_info.buffer = m_UboBuffer->getBuffer();
+    buffer_info.offset = 0;
+    buffer_info.range = m_UboBuffer->getRange();
+
+    VkDescriptorBufferInfo global_light_info{};
+    global_light_info.buffer = m_LightSystem->getGlobalLightBuffer();
+    global_light_info.offset = 0;
+    global_light_info.range = m_LightSystem->getGlobalLightBufferSize();
+
+    VkDescriptorBufferInfo point_light_info{};
+    point_light_info.buffer = m_LightSystem->getPointLightBuffer();
+    point_light_info.offset = 0;
+    point_light_info.range = m_LightSystem->getPointLightBufferSize();
 
-    // OUTLINE
+    VkDescriptorBufferInfo spot_light_info{};
+    spot_light_info.buffer = m_LightSystem->getSpotLightBuffer();
+    spot_light_info.offset = 0;
+    spot_light_info.range = m_LightSystem->getSpotLightBufferSize();
+
+    VkDescriptorBufferInfo instance_info{};
+    instance_info.buffer = m_InstanceBuffer->getBuffer();
+    instance_info.offset = 0;
+    instance_info.range = m_InstanceBuffer->getRange();
+
+    std::array<VkWriteDescriptorSet, 7> descriptor_writes{};
+    auto write_buffer = [&descriptor_writes](size_t inIndex, VkDescriptorSet inSet, uint32_t inBinding,
+                                             VkDescriptorType inType, const VkDescriptorBufferInfo* inInfo)
     {
-        std::vector<VkDescriptorSetLayout> layouts(m_PresentKHRImagesNum,
-                                                   m_OutlineSetLayout);
+        descriptor_writes[inIndex].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptor_writes[inIndex].dstSet = inSet;
+        descriptor_writes[inIndex].dstBinding = inBinding;
+        descriptor_writes[inIndex].dstArrayElement = 0;
+        descriptor_writes[inIndex].descriptorType = inType;
+        descriptor_writes[inIndex].descriptorCount = 1;
+        descriptor_writes[inIndex].pBufferInfo = inInfo;
+    };
+    write_buffer(0, m_SkyboxDescriptorSet, 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, &outline_info);
+    write_buffer(1, m_OutlineDescriptorSet, 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, &outline_info);
+    write_buffer(2, m_UboDescriptorSet, 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, &buffer_info);
+    write_buffer(3, m_UboDescriptorSet, 1, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, &global_light_info);
+    write_buffer(4, m_UboDescriptorSet, 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, &point_light_info);
+    write_buffer(5, m_UboDescriptorSet, 3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, &spot_light_info);
+    write_buffer(6, m_UboDescriptorSet, 4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, &instance_info);
+
+    vkUpdateDescriptorSets(m_LogicalDevice,
+                           static_cast<uint32_t>(descriptor_writes.size()),
+                           descriptor_writes.data(), 0, nullptr);
+}
+
+std::array<uint32_t, 5> omp::Renderer::getUboDynamicOffsets(uint32_t inImage) const
+{
+    const std::array<uint32_t, 3> light_offsets = m_LightSystem->getDynamicOffsets(inImage);
+    return {m_UboBuffer->getDynamicOffset(inImage), light_offsets[0], light_offsets[1], light_offsets[2],
+            m_InstanceBuffer->getDynamicOffset(inImage)};
+}
 
-        VkDescriptorSetAllocateInfo allocate_info{};
-        allocate_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-        allocate_info.descriptorPool = m_DescriptorPool;
-        allocate_info.descriptorSetCount = m_PresentKHRImagesNum;
-        allocate_info.pSetLayouts = layouts.data();
+size_t omp::Renderer::DrawGroupKeyHash::operator()(const DrawGroupKey& inKey) const
+{
+    static_assert(sizeof(DrawGroupKey) == 3 * sizeof(void*) + 2 * sizeof(uint32_t), "Key bytes are hashed, it can't have padding");
+    return omp::HashLib::hash64(&inKey, sizeof(DrawGroupKey));
+}
 
-        m_OutlineDescriptorSets.resize(m_PresentKHRImagesNum);
-        if (vkAllocateDescriptorSets(m_LogicalDevice, &allocate_info,
-                                     m_OutlineDescriptorSets.data()) !=
-            VK_SUCCESS)
+void omp::Renderer::buildDrawGroups(const std::vector<omp::SceneEntity*>& inEntities, uint32_t inImage, float inPixelsPerUnit)
+{
+    OMP_STAT_SCOPE("BuildDrawGroups");
+
+    m_DrawItems.clear();
+    m_DrawSortEntries.clear();
+    m_DrawGroups.clear();
+    m_DrawGroupLookup.clear();
+    const glm::vec3 view_position = m_CurrentScene->getCurrentCamera()->getPosition();
+
+    // State is resolved and the sort key built once per entity, sorting then only compares integers
+    for (omp::SceneEntity* scene_entity : inEntities)
+    {
+        const omp::ModelInstance& model_instance = *scene_entity->getModelInstance();
+        std::shared_ptr<omp::Model> model = model_instance.getModel().lock();
+        // CPU only models have nothing to draw
+        if (!model || !model->isUploaded())
         {
-            throw std::runtime_error("Failed to allocate descriptor sets!");
+            continue;
         }
-        for (uint32_t i = 0; i < m_PresentKHRImagesNum; i++)
+        std::shared_ptr<omp::Material> material = scene_entity->getModelInstance()->getMaterialInstance()->getStaticMaterial().lock();
+        if (!material)
         {
-            VkDescriptorBufferInfo buffer_info{};
-            buffer_info.buffer = m_OutlineBuffer->getBuffer(i);
-            buffer_info.offset = 0;
-            buffer_info.range = sizeof(OutlineUniformBuffer);
-
-            std::array<VkWriteDescriptorSet, 1> descriptor_writes{};
-            descriptor_writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            descriptor_writes[0].dstSet = m_OutlineDescriptorSets[i];
-            descriptor_writes[0].dstBinding = 0;
-            descriptor_writes[0].dstArrayElement = 0;
-            descriptor_writes[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-            descriptor_writes[0].descriptorCount = 1;
-            descriptor_writes[0].pBufferInfo = &buffer_info;
-            vkUpdateDescriptorSets(m_LogicalDevice,
-                                   static_cast<uint32_t>(descriptor_writes.size()),
-                                   descriptor_writes.data(), 0, nullptr);
+            WARN(LogRendering, "Material is invalid in material instance");
+        }
+        // Loads the material once, descriptor sets are allocated on the render thread before recording may go to workers
+        retrieveMaterialRenderState(material);
+
+        // TODO check this for valid shader, because light have simple shader, and
+        // should not have lightstencil layouts
+        const omp::EVertexLayout vertex_layout = model->getVertexLayout();
+        const uint32_t pipeline_handle = scene_entity->getId() == m_CurrentScene->getCurrentId()
+                                         ? m_LightStencilPipelines[static_cast<size_t>(vertex_layout)]
+                                         : material->getPipelineHandle(vertex_layout);
+        omp::GraphicsPipeline* pipeline = getGraphicsPipeline(pipeline_handle);
+
+        // Squared distance orders the same as distance
+        const glm::vec3 to_entity = model_instance.getPosition() - view_position;
+        const uint64_t key = omp::DrawSort::makeKey(material->isBlendingEnabled(), pipeline_handle, material->getSortId(),
+                                                    glm::dot(to_entity, to_entity));
+        m_DrawSortEntries.push_back(omp::DrawSortEntry{key, static_cast<uint32_t>(m_DrawItems.size())});
+
+        DrawItem& item = m_DrawItems.emplace_back();
+        item.lod = model_instance.selectLod(view_position, inPixelsPerUnit);
+        item.model = std::move(model);
+        item.material = std::move(material);
+        item.pipeline = pipeline;
+        item.entity = scene_entity;
+    }
+    omp::DrawSort::sort(m_DrawSortEntries, m_DrawSortScratch, m_CurrentScene->getThreadPool());
+
+    // Groups are made in sorted order, so groups of the first entities of a state run come first
+    std::vector<uint32_t> entry_groups(m_DrawSortEntries.size());
+    for (size_t entry = 0; entry < m_DrawSortEntries.size(); entry++)
+    {
+        DrawItem& item = m_DrawItems[m_DrawSortEntries[entry].index];
+        const DrawGroupKey key{item.model.get(), item.material.get(), item.pipeline, item.lod.first_index, item.lod.index_count};
+        const bool can_merge = !item.material->isBlendingEnabled();
+        const auto found = can_merge ? m_DrawGroupLookup.find(key) : m_DrawGroupLookup.end();
+        if (found != m_DrawGroupLookup.end())
+        {
+            DrawGroup& group = m_DrawGroups[found->second];
+            group.instance_count++;
+            group.entity = nullptr;
+            entry_groups[entry] = static_cast<uint32_t>(found->second);
+            continue;
         }
-    }
-    // UBO
-    std::vector<VkDescriptorSetLayout> layouts(m_PresentKHRImagesNum,
-                                               m_UboDescriptorSetLayout);
 
-    VkDescriptorSetAllocateInfo allocate_info{};
-    allocate_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-    allocate_info.descriptorPool = m_DescriptorPool;
-    allocate_info.descriptorSetCount = m_PresentKHRImagesNum;
-    allocate_info.pSetLayouts = layouts.data();
+        if (can_merge)
+        {
+            m_DrawGroupLookup.emplace(key, m_DrawGroups.size());
+        }
+        entry_groups[entry] = static_cast<uint32_t>(m_DrawGroups.size());
+        DrawGroup& group = m_DrawGroups.emplace_back();
+        group.model = std::move(item.model);
+        group.material = std::move(item.material);
+        group.pipeline = item.pipeline;
+        group.lod = item.lod;
+        group.entity = item.entity;
+        group.instance_count = 1;
+    }
+
+    // Groups take consecutive instances in order of their first entity, counts are rebuilt while writing
+    uint32_t instance_count = 0;
+    for (DrawGroup& group : m_DrawGroups)
+    {
+        group.first_instance = instance_count;
+        instance_count += group.instance_count;
+        group.instance_count = 0;
+    }
+    reserveInstances(instance_count);
+
+    omp::InstanceData* instances = static_cast<omp::InstanceData*>(m_InstanceBuffer->getMappedRegion(inImage));
+    for (size_t entry = 0; entry < m_DrawSortEntries.size(); entry++)
+    {
+        DrawGroup& group = m_DrawGroups[entry_groups[entry]];
+        const omp::SceneEntity* scene_entity = m_DrawItems[m_DrawSortEntries[entry].index].entity;
+        const std::shared_ptr<omp::MaterialInstance>& material_instance = scene_entity->getModelInstance()->getMaterialInstance();
+        // Packed positions are dequantized by the model matrix
+        instances[group.first_instance + group.instance_count] = omp::InstanceData{
+                scene_entity->getModelInstance()->getTransform() * group.model->getDequantization(),
+                material_instance->getAmbient(), material_instance->getDiffusive(),
+                material_instance->getSpecular(), scene_entity->getId()};
+        group.instance_count++;
+    }
+    OMP_STAT_VALUE("Instances", instance_count);
+}
 
-    m_UboDescriptorSets.resize(m_PresentKHRImagesNum);
-    if (vkAllocateDescriptorSets(m_LogicalDevice, &allocate_info,
-                                 m_UboDescriptorSets.data()) != VK_SUCCESS)
+void omp::Renderer::reserveInstances(size_t inCount)
+{
+    if (inCount <= m_InstanceCapacity)
     {
-        throw std::runtime_error("Failed to allocate descriptor sets!");
+        return;
     }
 
-    for (uint32_t i = 0; i < m_PresentKHRImagesNum; i++)
-    {
-        VkDescriptorBufferInfo buffer_info{};
-        buffer_info.buffer = m_UboBuffer->getBuffer(i);
-        buffer_info.offset = 0;
-        buffer_info.range = sizeof(UniformBufferObject);
-
-        VkDescriptorBufferInfo global_light_info{};
-        global_light_info.buffer = m_LightSystem->getGlobalLightBuffer(i);
-        global_light_info.offset = 0;
-        global_light_info.range = m_LightSystem->getGlobalLightBufferSize();
-
-        VkDescriptorBufferInfo point_light_info{};
-        point_light_info.buffer = m_LightSystem->getPointLightBuffer(i);
-        point_light_info.offset = 0;
-        point_light_info.range = m_LightSystem->getPointLightBufferSize();
-
-        VkDescriptorBufferInfo spot_light_info{};
-        spot_light_info.buffer = m_LightSystem->getSpotLightBuffer(i);
-        spot_light_info.offset = 0;
-        spot_light_info.range = m_LightSystem->getSpotLightBufferSize();
-
-        std::array<VkWriteDescriptorSet, 4> descriptor_writes{};
-        descriptor_writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        descriptor_writes[0].dstSet = m_UboDescriptorSets[i];
-        descriptor_writes[0].dstBinding = 0;
-        descriptor_writes[0].dstArrayElement = 0;
-        descriptor_writes[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        descriptor_writes[0].descriptorCount = 1;
-        descriptor_writes[0].pBufferInfo = &buffer_info;
-
-        descriptor_writes[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        descriptor_writes[1].dstSet = m_UboDescriptorSets[i];
-        descriptor_writes[1].dstBinding = 1;
-        descriptor_writes[1].dstArrayElement = 0;
-        descriptor_writes[1].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        descriptor_writes[1].descriptorCount = 1;
-        descriptor_writes[1].pBufferInfo = &global_light_info;
-
-        descriptor_writes[2].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        descriptor_writes[2].dstSet = m_UboDescriptorSets[i];
-        descriptor_writes[2].dstBinding = 2;
-        descriptor_writes[2].dstArrayElement = 0;
-        descriptor_writes[2].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-        descriptor_writes[2].descriptorCount = 1;
-        descriptor_writes[2].pBufferInfo = &point_light_info;
-
-        descriptor_writes[3].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        descriptor_writes[3].dstSet = m_UboDescriptorSets[i];
-        descriptor_writes[3].dstBinding = 3;
-        descriptor_writes[3].dstArrayElement = 0;
-        descriptor_writes[3].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-        descriptor_writes[3].descriptorCount = 1;
-        descriptor_writes[3].pBufferInfo = &spot_light_info;
-
-        vkUpdateDescriptorSets(m_LogicalDevice,
-                               static_cast<uint32_t>(descriptor_writes.size()),
-                               descriptor_writes.data(), 0, nullptr);
-    }
+    // Frames in flight still read the old buffer, growing is rare enough to wait for them
+    vkDeviceWaitIdle(m_LogicalDevice);
+    m_InstanceCapacity = std::max(inCount, m_InstanceCapacity * 2);
+    m_InstanceBuffer = std::make_unique<omp::UniformBuffer>(
+            m_VulkanContext, m_PresentKHRImagesNum, m_InstanceCapacity * sizeof(omp::InstanceData),
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+
+    VkDescriptorBufferInfo instance_info{};
+    instance_info.buffer = m_InstanceBuffer->getBuffer();
+    instance_info.offset = 0;
+    instance_info.range = m_InstanceBuffer->getRange();
+
+    VkWriteDescriptorSet descriptor_write{};
+    descriptor_write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descriptor_write.dstSet = m_UboDescriptorSet;
+    descriptor_write.dstBinding = 4;
+    descriptor_write.dstArrayElement = 0;
+    descriptor_write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    descriptor_write.descriptorCount = 1;
+    descriptor_write.pBufferInfo = &instance_info;
+    vkUpdateDescriptorSets(m_LogicalDevice, 1, &descriptor_write, 0, nullptr);
 }
 
 void omp::Renderer::retrieveMaterialRenderState(
@@ -1802,6 +2191,16 @@ void omp::Renderer::retrieveMaterialRenderState(
         VWARN(LogRendering, "Material is invalid");
         return;
     }
+    if (!material->hasPipelineHandles())
+    {
+        omp::Material::PipelineHandles handles;
+        handles.fill(omp::Material::INVALID_PIPELINE);
+        for (omp::EVertexLayout layout : {omp::EVertexLayout::Full, omp::EVertexLayout::Packed, omp::EVertexLayout::PackedColor})
+        {
+            handles[static_cast<size_t>(layout)] = findPipelineHandle(getPipelineName(material->getShaderName(), layout));
+        }
+        material->setPipelineHandles(handles);
+    }
     if (material->isPotentiallyReadyForRendering())
     {
         return;
@@ -2193,20 +2592,20 @@ void omp::Renderer::destroyMainRenderPassResources()
 {
     vkDestroyImageView(m_LogicalDevice, m_DepthImageView, nullptr);
     vkDestroyImage(m_LogicalDevice, m_DepthImage, nullptr);
-    vkFreeMemory(m_LogicalDevice, m_DepthImageMemory, nullptr);
+    m_VulkanContext->freeMemory(m_DepthImageMemory);
 
     vkDestroyImageView(m_LogicalDevice, m_ColorImageView, nullptr);
     vkDestroyImage(m_LogicalDevice, m_ColorImage, nullptr);
-    vkFreeMemory(m_LogicalDevice, m_ColorImageMemory, nullptr);
+    m_VulkanContext->freeMemory(m_ColorImageMemory);
 
     m_ViewportImage->destroyAll();
 
     vkDestroyImageView(m_LogicalDevice, m_PickingImageView, nullptr);
     vkDestroyImage(m_LogicalDevice, m_PickingImage, nullptr);
-    vkFreeMemory(m_LogicalDevice, m_PickingMemory, nullptr);
+    m_VulkanContext->freeMemory(m_PickingMemory);
     vkDestroyImageView(m_LogicalDevice, m_PickingResolveView, nullptr);
     vkDestroyImage(m_LogicalDevice, m_PickingResolve, nullptr);
-    vkFreeMemory(m_LogicalDevice, m_PickingResolveMemory, nullptr);
+    m_VulkanContext->freeMemory(m_PickingResolveMemory);
 
     for (auto& frame_buffer: m_SwapChainFramebuffers)
     {
@@ -2237,6 +2636,8 @@ void omp::Renderer::resizeInternal()
         return;
     }
 
+    // Attachments are shared by every frame in flight, resizing is rare enough to wait for all of them
+    vkDeviceWaitIdle(m_LogicalDevice);
     destroyMainRenderPassResources();
 
     createColorResources();
@@ -2287,11 +2688,7 @@ void omp::Renderer::setClickedEntity(uint32_t x, uint32_t y)
         endSingleTimeCommands(buffer);
 
         uint32_t pixel_value = 1;
-        void* data;
-        vkMapMemory(m_VulkanContext->logical_device, m_PixelReadMemory, 0,
-                    sizeof(uint32_t), 0, &data);
-        memcpy(&pixel_value, data, sizeof(uint32_t));
-        vkUnmapMemory(m_VulkanContext->logical_device, m_PixelReadMemory);
+        memcpy(&pixel_value, m_PixelReadMemory.mapped, sizeof(uint32_t));
 
         m_CurrentScene->setCurrentId(pixel_value);
         INFO(LogRendering, "value {}", pixel_value);
@@ -2307,12 +2704,77 @@ omp::GraphicsPipeline* omp::Renderer::findGraphicsPipeline(const std::string& na
     throw "No shader with such name";
 }
 
+void omp::Renderer::registerPipelineHandles()
+{
+    for (const auto& [name, pipeline] : m_Pipelines)
+    {
+        const auto [found, inserted] = m_PipelineHandles.try_emplace(name, static_cast<uint32_t>(m_PipelineHandles.size()));
+        if (m_PipelinesByHandle.size() <= found->second)
+        {
+            m_PipelinesByHandle.resize(found->second + 1, nullptr);
+        }
+        m_PipelinesByHandle[found->second] = pipeline.get();
+    }
+
+    for (omp::EVertexLayout layout : {omp::EVertexLayout::Full, omp::EVertexLayout::Packed, omp::EVertexLayout::PackedColor})
+    {
+        m_LightStencilPipelines[static_cast<size_t>(layout)] = findPipelineHandle(getPipelineName("LightStencil", layout));
+        m_OutlinePipelines[static_cast<size_t>(layout)] = findPipelineHandle(getPipelineName("Outline", layout));
+    }
+}
+
+uint32_t omp::Renderer::findPipelineHandle(const std::string& inName) const
+{
+    const auto found = m_PipelineHandles.find(inName);
+    return found != m_PipelineHandles.end() ? found->second : omp::Material::INVALID_PIPELINE;
+}
+
+omp::GraphicsPipeline* omp::Renderer::getGraphicsPipeline(uint32_t inHandle) const
+{
+    if (inHandle >= m_PipelinesByHandle.size() || !m_PipelinesByHandle[inHandle])
+    {
+        throw "No shader with such name";
+    }
+    return m_PipelinesByHandle[inHandle];
+}
+
+std::string omp::Renderer::getPipelineName(const std::string& inName, omp::EVertexLayout inLayout)
+{
+    switch (inLayout)
+    {
+        case omp::EVertexLayout::Packed:
+            return inName + "Packed";
+        case omp::EVertexLayout::PackedColor:
+            return inName + "PackedColor";
+        case omp::EVertexLayout::Full:
+        case omp::EVertexLayout::Max:
+            break;
+    }
+    return inName;
+}
+
+std::string omp::Renderer::getVertexShaderPath(const std::string& inName, omp::EVertexLayout inLayout)
+{
+    switch (inLayout)
+    {
+        case omp::EVertexLayout::Packed:
+            return "../SPRV/" + inName + "packedvert.spv";
+        case omp::EVertexLayout::PackedColor:
+            return "../SPRV/" + inName + "packedcolorvert.spv";
+        case omp::EVertexLayout::Full:
+        case omp::EVertexLayout::Max:
+            break;
+    }
+    return "../SPRV/" + inName + "vert.spv";
+}
+
 void omp::Renderer::beginRenderPass(
         omp::RenderPass* inRenderPass,
         VkCommandBuffer inCommandBuffer,
         omp::FrameBuffer& inFrameBuffer,
         const std::vector<VkClearValue>& clearValues,
-        VkRect2D rect)
+        VkRect2D rect,
+        VkSubpassContents inContents)
 {
     VkRenderPassBeginInfo render_pass_begin_info{};
     render_pass_begin_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
@@ -2324,8 +2786,7 @@ void omp::Renderer::beginRenderPass(
             static_cast<uint32_t>(clearValues.size());
     render_pass_begin_info.pClearValues = clearValues.data();
 
-    vkCmdBeginRenderPass(inCommandBuffer, &render_pass_begin_info,
-                         VK_SUBPASS_CONTENTS_INLINE);
+    vkCmdBeginRenderPass(inCommandBuffer, &render_pass_begin_info, inContents);
 }
 
 void omp::Renderer::endRenderPass(
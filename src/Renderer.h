@@ -22,10 +22,15 @@
 
 #include "Scene.h"
 #include "Rendering/GraphicsPipeline.h"
+#include "Rendering/Material.h"
 #include "Rendering/RenderPass.h"
 #include "Rendering/FrameBuffer.h"
 #include "Logs.h"
 #include "LightSystem.h"
+#include "Rendering/FrustumCuller.h"
+#include "Rendering/DrawSort.h"
+#include "Rendering/BindStateCache.h"
+#include "Rendering/PipelineCache.h"
 
 namespace
 {
@@ -118,6 +123,8 @@ namespace omp
         {
             std::optional<uint32_t> graphics_family;
             std::optional<uint32_t> present_family;
+            // Family with transfer and without graphics, uploads run there beside rendering
+            std::optional<uint32_t> transfer_family;
 
             bool IsComplete() const
             {
@@ -132,13 +139,73 @@ namespace omp
             std::vector<VkPresentModeKHR> present_modes;
         };
 
+        // Visible entity with its draw state resolved once per frame, before sorting
+        struct DrawItem
+        {
+            std::shared_ptr<omp::Model> model;
+            std::shared_ptr<omp::Material> material;
+            omp::GraphicsPipeline* pipeline = nullptr;
+            omp::MeshLod lod{};
+            omp::SceneEntity* entity = nullptr;
+        };
+
+        /*
+         * @brief Visible entities drawn by one instanced call, their instances are consecutive in the instance buffer
+         */
+        struct DrawGroup
+        {
+            std::shared_ptr<omp::Model> model;
+            std::shared_ptr<omp::Material> material;
+            omp::GraphicsPipeline* pipeline = nullptr;
+            omp::MeshLod lod{};
+            // Meshlets are culled with one transform, so groups of a single instance keep it for that
+            omp::SceneEntity* entity = nullptr;
+            uint32_t first_instance = 0;
+            uint32_t instance_count = 0;
+        };
+
+        // Entities with equal keys draw the same ranges with the same state
+        struct DrawGroupKey
+        {
+            const omp::Model* model = nullptr;
+            const omp::Material* material = nullptr;
+            const omp::GraphicsPipeline* pipeline = nullptr;
+            uint32_t first_index = 0;
+            uint32_t index_count = 0;
+
+            bool operator==(const DrawGroupKey&) const = default;
+        };
+
+        struct DrawGroupKeyHash
+        {
+            size_t operator()(const DrawGroupKey& inKey) const;
+        };
+
+        struct DrawRecordStatistics
+        {
+            size_t draw_calls = 0;
+            size_t drawn_triangles = 0;
+            size_t culled_meshlets = 0;
+            size_t saved_binds = 0;
+            // Group of the selected entity when it was drawn
+            const DrawGroup* outline_group = nullptr;
+        };
+
+        // Pool and secondary buffer per recording chunk of one image, only one worker records a chunk
+        struct SecondaryCommandBuffers
+        {
+            std::vector<VkCommandPool> pools;
+            std::vector<VkCommandBuffer> buffers;
+        };
+
         // Methods //
         // ======= //
     public:
         Renderer();
 
         void initVulkan(GLFWwindow* window, int initWidth, int initHeight);
-        void initResources();
+        // Pipelines are compiled on inThreadPool when it is given
+        void initResources(omp::ThreadPool* inThreadPool = nullptr);
         void loadScene(omp::Scene* scene);
         // TODO: void initNewScene(omp::Scene* scene);
 
@@ -191,14 +258,40 @@ namespace omp
                 VkCommandBuffer inCommandBuffer,
                 omp::FrameBuffer& inFrameBuffer,
                 const std::vector<VkClearValue>& clearValues,
-                VkRect2D rect = VkRect2D());
+                VkRect2D rect = VkRect2D(),
+                VkSubpassContents inContents = VK_SUBPASS_CONTENTS_INLINE);
         void endRenderPass(omp::RenderPass* inRenderPass, VkCommandBuffer inCommandBuffer);
 
         void createUniformBuffers();
 
         void updateUniformBuffer(uint32_t currentImage);
+        // Camera, global, point and spot light and instance regions of the image, in binding order of the UBO set
+        std::array<uint32_t, 5> getUboDynamicOffsets(uint32_t inImage) const;
 
         void prepareFrameForImage(size_t KHRImageIndex);
+        // Drop entities whose world box is outside m_ViewFrustum, order of the rest is kept
+        void cullEntities(std::vector<omp::SceneEntity*>& ioEntities);
+        /*
+         * @brief Sort visible entities by omp::DrawSort keys, fill m_DrawGroups in that order and write their instances for inImage.
+         * Opaque entities sharing model, LOD, material and pipeline are merged into the group of the first one,
+         * blended ones keep their own groups to stay in back to front order
+         */
+        void buildDrawGroups(const std::vector<omp::SceneEntity*>& inEntities, uint32_t inImage, float inPixelsPerUnit);
+        // Grow instance buffer to at least inCount instances per image, waits for the device when it grows
+        void reserveInstances(size_t inCount);
+        // Record draws of m_DrawGroups in [inBegin, inEnd), safe to run for separate buffers on several threads
+        // ioBindCache holds what is bound in inCommandBuffer, binds of the same state are skipped
+        DrawRecordStatistics recordDrawGroups(VkCommandBuffer inCommandBuffer, size_t inBegin, size_t inEnd, size_t KHRImageIndex,
+                                              omp::BindStateCache& ioBindCache) const;
+        void recordOutline(VkCommandBuffer inCommandBuffer, const DrawGroup* inGroup, size_t KHRImageIndex,
+                           omp::BindStateCache& ioBindCache) const;
+        /*
+         * @brief Record draw groups in chunks into secondary buffers on inThreadPool and execute them from inPrimary,
+         * inPrimary must be in a render pass begun with secondary command buffer contents
+         */
+        DrawRecordStatistics recordDrawGroupsInParallel(VkCommandBuffer inPrimary, size_t KHRImageIndex, omp::ThreadPool& inThreadPool);
+        SecondaryCommandBuffers& getSecondaryCommandBuffers(size_t KHRImageIndex);
+        void destroySecondaryCommandBuffers();
 
         void createCommandPool();
 
@@ -262,6 +355,15 @@ namespace omp
         VkSampleCountFlagBits getMaxUsableSampleCount();
 
         omp::GraphicsPipeline* findGraphicsPipeline(const std::string& name);
+        // Give every created pipeline a handle, handles of a name stay the same through swap chain recreation
+        void registerPipelineHandles();
+        // Material::INVALID_PIPELINE when no pipeline has this name
+        uint32_t findPipelineHandle(const std::string& inName) const;
+        omp::GraphicsPipeline* getGraphicsPipeline(uint32_t inHandle) const;
+        // Pipeline of material shader for models uploaded with inLayout
+        static std::string getPipelineName(const std::string& inName, omp::EVertexLayout inLayout);
+        // Compiled vertex shader, packed layouts have variants built with PACKED_VERTEX and VERTEX_COLOR
+        static std::string getVertexShaderPath(const std::string& inName, omp::EVertexLayout inLayout);
 
         static VKAPI_ATTR VkBool32 VKAPI_CALL debugCallback(
                 VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity,
@@ -322,6 +424,7 @@ namespace omp
         VkQueue m_GraphicsQueue;
 
         VkQueue m_PresentQueue;
+        VkQueue m_TransferQueue = VK_NULL_HANDLE;
 
         uint32_t m_PresentKHRImagesNum;
 
@@ -333,36 +436,67 @@ namespace omp
         std::shared_ptr<omp::RenderPass> m_RenderPass;
 
         std::unordered_map<std::string, std::unique_ptr<omp::GraphicsPipeline>> m_Pipelines;
+        std::unique_ptr<omp::PipelineCache> m_PipelineCache;
+        // Not owned, used to compile pipelines at startup and swap chain recreation
+        omp::ThreadPool* m_ThreadPool = nullptr;
+        // Draws reach pipelines by handle, names are looked up once per material
+        std::unordered_map<std::string, uint32_t> m_PipelineHandles;
+        std::vector<omp::GraphicsPipeline*> m_PipelinesByHandle;
+        omp::Material::PipelineHandles m_LightStencilPipelines{};
+        omp::Material::PipelineHandles m_OutlinePipelines{};
 
         VkCommandPool m_CommandPool;
         VkDescriptorPool m_DescriptorPool;
-        std::vector<VkDescriptorSet> m_UboDescriptorSets;
+        // Shared by every image, uniform regions are picked with dynamic offsets
+        VkDescriptorSet m_UboDescriptorSet = VK_NULL_HANDLE;
         // TODO: reconsider approach of materials
         std::vector<VkDescriptorSet> m_MaterialSets;
-        std::vector<VkDescriptorSet> m_OutlineDescriptorSets;
-        std::vector<VkDescriptorSet> m_SkyboxDescriptorSets;
+        VkDescriptorSet m_OutlineDescriptorSet = VK_NULL_HANDLE;
+        VkDescriptorSet m_SkyboxDescriptorSet = VK_NULL_HANDLE;
 
         std::shared_ptr<omp::Material> m_DefaultMaterial;
 
         VkImage m_ColorImage;
-        VkDeviceMemory m_ColorImageMemory;
+        omp::MemoryAllocation m_ColorImageMemory;
         VkImageView m_ColorImageView;
 
         std::unique_ptr<omp::VulkanImage> m_ViewportImage = nullptr;
 
         VkImage m_PickingImage;
         VkImageView m_PickingImageView;
-        VkDeviceMemory m_PickingMemory;
+        omp::MemoryAllocation m_PickingMemory;
         VkImage m_PickingResolve;
         VkImageView m_PickingResolveView;
-        VkDeviceMemory m_PickingResolveMemory;
+        omp::MemoryAllocation m_PickingResolveMemory;
 
         VkBuffer m_PixelReadBuffer;
-        VkDeviceMemory m_PixelReadMemory;
+        omp::MemoryAllocation m_PixelReadMemory;
 
         std::unique_ptr<omp::UniformBuffer> m_UboBuffer;
         std::unique_ptr<omp::UniformBuffer> m_OutlineBuffer;
 
+        // Planes of the view and projection written to the uniform buffer this frame
+        omp::Frustum m_ViewFrustum;
+        // Kept between frames to not reallocate for every cull
+        omp::BoundingBoxArray m_EntityBoxes;
+        std::vector<uint32_t> m_VisibleEntities;
+
+        static constexpr size_t INITIAL_INSTANCE_CAPACITY = 1024;
+        // Storage buffer of omp::InstanceData, a region per image like the uniform buffers
+        std::unique_ptr<omp::UniformBuffer> m_InstanceBuffer;
+        size_t m_InstanceCapacity = INITIAL_INSTANCE_CAPACITY;
+        // Kept between frames, the draw list is rebuilt and sorted every frame
+        std::vector<DrawItem> m_DrawItems;
+        std::vector<omp::DrawSortEntry> m_DrawSortEntries;
+        std::vector<omp::DrawSortEntry> m_DrawSortScratch;
+        std::vector<DrawGroup> m_DrawGroups;
+        std::unordered_map<DrawGroupKey, size_t, DrawGroupKeyHash> m_DrawGroupLookup;
+
+        // Fewer groups are recorded inline, secondary buffers cost more than they save there
+        static constexpr size_t PARALLEL_RECORDING_THRESHOLD = 512;
+        static constexpr size_t MIN_GROUPS_PER_CHUNK = 128;
+        std::vector<SecondaryCommandBuffers> m_SecondaryCommandBuffers;
+
         std::vector<VkImage> m_SwapChainImages;
 
         std::vector<VkImageView> m_SwapChainImageViews;
@@ -378,7 +512,7 @@ namespace omp
         std::vector<VkFence> m_ImagesInFlight;
 
         VkImage m_DepthImage;
-        VkDeviceMemory m_DepthImageMemory;
+        omp::MemoryAllocation m_DepthImageMemory;
         VkImageView m_DepthImageView;
 
         omp::Scene* m_CurrentScene = nullptr;
@@ -0,0 +1,78 @@
+#include "Rendering/BindStateCache.h"
+#include <algorithm>
+
+bool omp::BindStateCache::bindPipeline(VkPipeline inPipeline)
+{
+    if (m_Pipeline == inPipeline)
+    {
+        m_SavedBinds++;
+        return false;
+    }
+    m_Pipeline = inPipeline;
+    return true;
+}
+
+bool omp::BindStateCache::bindDescriptorSet(uint64_t inLayoutSignature, uint32_t inSet, VkDescriptorSet inDescriptorSet,
+                                            uint32_t inOffsetCount, const uint32_t* inOffsets)
+{
+    // Sets bound with an incompatible layout can be disturbed, nothing of them is trusted
+    if (m_LayoutSignature != inLayoutSignature)
+    {
+        m_LayoutSignature = inLayoutSignature;
+        m_Sets = {};
+    }
+    if (inSet >= MAX_SETS)
+    {
+        return true;
+    }
+
+    BoundSet& bound = m_Sets[inSet];
+    if (inOffsetCount > MAX_DYNAMIC_OFFSETS)
+    {
+        bound = BoundSet{};
+        return true;
+    }
+    if (bound.set == inDescriptorSet && bound.offset_count == inOffsetCount
+        && std::equal(inOffsets, inOffsets + inOffsetCount, bound.offsets.begin()))
+    {
+        m_SavedBinds++;
+        return false;
+    }
+    bound.set = inDescriptorSet;
+    bound.offset_count = inOffsetCount;
+    std::copy(inOffsets, inOffsets + inOffsetCount, bound.offsets.begin());
+    return true;
+}
+
+bool omp::BindStateCache::bindVertexBuffer(VkBuffer inBuffer)
+{
+    if (m_VertexBuffer == inBuffer)
+    {
+        m_SavedBinds++;
+        return false;
+    }
+    m_VertexBuffer = inBuffer;
+    return true;
+}
+
+bool omp::BindStateCache::bindIndexBuffer(VkBuffer inBuffer, VkIndexType inIndexType)
+{
+    if (m_IndexBuffer == inBuffer && m_IndexType == inIndexType)
+    {
+        m_SavedBinds++;
+        return false;
+    }
+    m_IndexBuffer = inBuffer;
+    m_IndexType = inIndexType;
+    return true;
+}
+
+void omp::BindStateCache::reset()
+{
+    m_Pipeline = VK_NULL_HANDLE;
+    m_LayoutSignature = 0;
+    m_Sets = {};
+    m_VertexBuffer = VK_NULL_HANDLE;
+    m_IndexBuffer = VK_NULL_HANDLE;
+    m_IndexType = VK_INDEX_TYPE_UINT16;
+}
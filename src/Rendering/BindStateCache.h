@@ -0,0 +1,49 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "vulkan/vulkan.h"
+
+namespace omp
+{
+    /*
+     * @brief Remembers state bound in one command buffer, so the recorder skips binds of state that is already there.
+     * Descriptor sets are kept while pipelines share a layout signature, Vulkan keeps sets bound for compatible layouts.
+     * Calls return true when the bind has to be recorded, skipped binds are counted
+     */
+    class BindStateCache
+    {
+    public:
+        static constexpr uint32_t MAX_SETS = 4;
+        static constexpr uint32_t MAX_DYNAMIC_OFFSETS = 8;
+
+        bool bindPipeline(VkPipeline inPipeline);
+        // Sets past MAX_SETS or with more than MAX_DYNAMIC_OFFSETS offsets are never skipped
+        bool bindDescriptorSet(uint64_t inLayoutSignature, uint32_t inSet, VkDescriptorSet inDescriptorSet,
+                               uint32_t inOffsetCount, const uint32_t* inOffsets);
+        bool bindVertexBuffer(VkBuffer inBuffer);
+        bool bindIndexBuffer(VkBuffer inBuffer, VkIndexType inIndexType);
+
+        // Forget bound state, for when the command buffer was changed past the cache
+        void reset();
+
+        size_t getSavedBinds() const { return m_SavedBinds; }
+
+    private:
+        struct BoundSet
+        {
+            VkDescriptorSet set = VK_NULL_HANDLE;
+            uint32_t offset_count = 0;
+            std::array<uint32_t, MAX_DYNAMIC_OFFSETS> offsets{};
+        };
+
+        VkPipeline m_Pipeline = VK_NULL_HANDLE;
+        uint64_t m_LayoutSignature = 0;
+        std::array<BoundSet, MAX_SETS> m_Sets{};
+        VkBuffer m_VertexBuffer = VK_NULL_HANDLE;
+        VkBuffer m_IndexBuffer = VK_NULL_HANDLE;
+        VkIndexType m_IndexType = VK_INDEX_TYPE_UINT16;
+
+        size_t m_SavedBinds = 0;
+    };
+}
@@ -1,8 +1,11 @@
 #include "Cubemap.h"
+#include <cstring>
 #include <memory>
+#include <vector>
 #include "Logs.h"
 #include "imgui_impl_vulkan.h"
 #include "IO/stb_image.h"
+#include "Rendering/UploadQueue.h"
 
 omp::Cubemap::Cubemap(const std::vector<std::shared_ptr<omp::TextureSrc>>& inTextures)
     : m_Textures(inTextures)
@@ -21,10 +24,20 @@ void omp::Cubemap::destroyVkObjects()
 {
     if (hasVulkanContext() && hasFlags(LOADED_TO_GPU))
     {
-        vkDestroySampler(m_VulkanContext.lock()->logical_device, m_TextureSampler, nullptr);
-        vkDestroyImageView(m_VulkanContext.lock()->logical_device, m_TextureImageView, nullptr);
-        vkDestroyImage(m_VulkanContext.lock()->logical_device, m_TextureImage, nullptr);
-        vkFreeMemory(m_VulkanContext.lock()->logical_device, m_TextureImageMemory, nullptr);
+        // Frames in flight may still sample it
+        m_VulkanContext.lock()->deferred_deletion.push(
+            [weak_context = m_VulkanContext, sampler = m_TextureSampler, view = m_TextureImageView, image = m_TextureImage,
+             memory = m_TextureImageMemory]() mutable
+            {
+                if (std::shared_ptr<omp::VulkanContext> context = weak_context.lock())
+                {
+                    vkDestroySampler(context->logical_device, sampler, nullptr);
+                    vkDestroyImageView(context->logical_device, view, nullptr);
+                    vkDestroyImage(context->logical_device, image, nullptr);
+                    context->freeMemory(memory);
+                }
+            });
+        m_TextureImageMemory = omp::MemoryAllocation{};
     }
 }
 
@@ -93,28 +106,24 @@ void omp::Cubemap::createSampler()
 
 void omp::Cubemap::createImage()
 {
-    VkBuffer staging_buffer;
-    VkDeviceMemory staging_buffer_memory;
+    std::shared_ptr<omp::VulkanContext> context = m_VulkanContext.lock();
     uint32_t size = getFirstTextureSize();
     uint32_t mip_level = getFirstTextureMipMap();
     uint32_t width = getFirstTextureWidth();
     uint32_t height = getFirstTextureHeight();
 
+    // Faces one after another, copied into staging ring as one upload
     size_t size_to_alloc = getFirstTextureSize() * m_LayerAmount;
-    m_VulkanContext.lock()->createBuffer(size_to_alloc, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                                         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                                         staging_buffer, staging_buffer_memory);
-
-    char* data;
-    vkMapMemory(m_VulkanContext.lock()->logical_device, staging_buffer_memory, 0, size_to_alloc, 0,
-                reinterpret_cast<void**>(&data));
+    std::vector<char> data(size_to_alloc);
     size_t offset = 0;
     for (auto& texture : m_Textures)
     {
-        memcpy(data + offset, texture->getPixels(), size);
+        if (texture->ensurePixels())
+        {
+            memcpy(data.data() + offset, texture->getPixels(), size);
+        }
         offset += size;
     }
-    vkUnmapMemory(m_VulkanContext.lock()->logical_device, staging_buffer_memory);
 
     VkImageCreateFlags flags = 0;
     uint32_t array_layers = 1;
@@ -123,42 +132,44 @@ void omp::Cubemap::createImage()
     // faces of cubemap
     array_layers = static_cast<uint32_t>(m_LayerAmount);
 
-    m_VulkanContext.lock()->createImage(width, height, mip_level, VK_FORMAT_R8G8B8A8_SRGB,
-                                        VK_IMAGE_TILING_OPTIMAL,
-                                        VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT |
-                                        VK_IMAGE_USAGE_SAMPLED_BIT,
-                                        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_TextureImage, m_TextureImageMemory,
-                                        VK_SAMPLE_COUNT_1_BIT,
-                                        flags, array_layers);
-
-    m_VulkanContext.lock()->transitionImageLayout(m_TextureImage, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_UNDEFINED,
-                                                  VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, mip_level);
+    context->createImage(width, height, mip_level, VK_FORMAT_R8G8B8A8_SRGB,
+                         VK_IMAGE_TILING_OPTIMAL,
+                         VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+                         VK_IMAGE_USAGE_SAMPLED_BIT,
+                         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_TextureImage, m_TextureImageMemory,
+                         VK_SAMPLE_COUNT_1_BIT,
+                         flags, array_layers);
+
+    omp::ImageUploadInfo upload_info;
+    upload_info.format = VK_FORMAT_R8G8B8A8_SRGB;
+    upload_info.width = width;
+    upload_info.height = height;
+    upload_info.mip_levels = mip_level;
+    upload_info.layer_count = array_layers;
 
     offset = 0;
-    std::vector<VkBufferImageCopy> buffer_copy_regions{};
-    buffer_copy_regions.reserve(m_LayerAmount);
+    upload_info.regions.reserve(m_LayerAmount);
     for (size_t layer = 0; layer < m_LayerAmount; layer++)
     {
+        // Base level of every face, the rest is generated
         VkBufferImageCopy buffer_copy_region = {};
         buffer_copy_region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        buffer_copy_region.imageSubresource.mipLevel = mip_level;
+        buffer_copy_region.imageSubresource.mipLevel = 0;
         buffer_copy_region.imageSubresource.baseArrayLayer = static_cast<uint32_t>(layer);
         buffer_copy_region.imageSubresource.layerCount = 1;
         buffer_copy_region.imageExtent.width = width;
         buffer_copy_region.imageExtent.height = height;
         buffer_copy_region.imageExtent.depth = 1;
         buffer_copy_region.bufferOffset = offset;
-        buffer_copy_regions.push_back(buffer_copy_region);
+        upload_info.regions.push_back(buffer_copy_region);
         offset += size;
     }
-    m_VulkanContext.lock()->copyBufferToImage(staging_buffer, m_TextureImage, buffer_copy_regions);
+    context->upload_queue->uploadImage(m_TextureImage, upload_info, data.data(), size_to_alloc);
 
-    //transitionImageLayout(m_TextureImage, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_UNDEFINED,
-    //                      VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, m_MipLevels);
-    m_VulkanContext.lock()->generateMipmaps(m_TextureImage, VK_FORMAT_R8G8B8A8_SRGB, width, height, mip_level);
-
-    vkDestroyBuffer(m_VulkanContext.lock()->logical_device, staging_buffer, nullptr);
-    vkFreeMemory(m_VulkanContext.lock()->logical_device, staging_buffer_memory, nullptr);
+    for (auto& texture : m_Textures)
+    {
+        texture->onUploaded();
+    }
 }
 
 void omp::Cubemap::createImageView()
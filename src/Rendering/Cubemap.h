@@ -23,7 +23,7 @@ namespace omp
         // Vulkan //
         // ====== //
         VkImage m_TextureImage;
-        VkDeviceMemory m_TextureImageMemory;
+        omp::MemoryAllocation m_TextureImageMemory;
         VkImageView m_TextureImageView;
         VkSampler m_TextureSampler;
 
@@ -0,0 +1,54 @@
+#include "Rendering/DeferredDeletionQueue.h"
+#include <vector>
+
+omp::DeferredDeletionQueue::~DeferredDeletionQueue()
+{
+    flush();
+}
+
+void omp::DeferredDeletionQueue::push(std::function<void()> inDestroy)
+{
+    std::lock_guard<std::mutex> lock(m_Access);
+    m_Deletions.push_back(Deletion{m_Frame, std::move(inDestroy)});
+}
+
+void omp::DeferredDeletionQueue::endFrame()
+{
+    std::lock_guard<std::mutex> lock(m_Access);
+    m_Frame++;
+}
+
+void omp::DeferredDeletionQueue::collect(uint64_t inCompletedFrames)
+{
+    // Destructors may push again, so they run outside of the lock
+    std::vector<std::function<void()>> ready;
+    {
+        std::lock_guard<std::mutex> lock(m_Access);
+        while (!m_Deletions.empty() && m_Deletions.front().frame < inCompletedFrames)
+        {
+            ready.push_back(std::move(m_Deletions.front().destroy));
+            m_Deletions.pop_front();
+        }
+    }
+    for (std::function<void()>& destroy : ready)
+    {
+        destroy();
+    }
+}
+
+void omp::DeferredDeletionQueue::flush()
+{
+    collect(UINT64_MAX);
+}
+
+uint64_t omp::DeferredDeletionQueue::getFrame() const
+{
+    std::lock_guard<std::mutex> lock(m_Access);
+    return m_Frame;
+}
+
+size_t omp::DeferredDeletionQueue::getPendingCount() const
+{
+    std::lock_guard<std::mutex> lock(m_Access);
+    return m_Deletions.size();
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+namespace omp
+{
+    /*
+     * @brief Holds destruction of Vulkan objects until every frame that could have recorded them has finished.
+     * Objects pushed while frame N is recorded are released once N frames plus that one are known complete,
+     * Renderer reports completion after waiting for a frame slot fence
+     */
+    class DeferredDeletionQueue
+    {
+    public:
+        DeferredDeletionQueue() = default;
+        DeferredDeletionQueue(const DeferredDeletionQueue&) = delete;
+        DeferredDeletionQueue& operator=(const DeferredDeletionQueue&) = delete;
+        ~DeferredDeletionQueue();
+
+        void push(std::function<void()> inDestroy);
+
+        // Frame being recorded is done, later pushes wait for the next one
+        void endFrame();
+        // Runs deletions of frames before inCompletedFrames
+        void collect(uint64_t inCompletedFrames);
+        // Device is idle, everything goes
+        void flush();
+
+        uint64_t getFrame() const;
+        size_t getPendingCount() const;
+
+    private:
+        struct Deletion
+        {
+            uint64_t frame = 0;
+            std::function<void()> destroy;
+        };
+
+        mutable std::mutex m_Access;
+        std::deque<Deletion> m_Deletions;
+        uint64_t m_Frame = 0;
+    };
+}
@@ -0,0 +1,265 @@
+#include "Rendering/DeviceMemoryAllocator.h"
+#include <algorithm>
+#include <stdexcept>
+#include "Logs.h"
+
+omp::DeviceMemoryAllocator::DeviceMemoryAllocator(VkDevice inDevice, VkPhysicalDevice inPhysDevice)
+    : m_Device(inDevice)
+{
+    vkGetPhysicalDeviceMemoryProperties(inPhysDevice, &m_MemoryProperties);
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(inPhysDevice, &properties);
+    m_MaxAllocationCount = properties.limits.maxMemoryAllocationCount;
+
+    m_Pools.resize(static_cast<size_t>(m_MemoryProperties.memoryTypeCount) * POOLS_PER_TYPE);
+}
+
+omp::DeviceMemoryAllocator::~DeviceMemoryAllocator()
+{
+    if (m_Statistics.allocation_count > 0)
+    {
+        WARN(LogRendering, "{} device memory allocations are alive when allocator is destroyed", m_Statistics.allocation_count);
+    }
+    for (Pool& pool : m_Pools)
+    {
+        for (Block& block : pool.blocks)
+        {
+            if (block.memory != VK_NULL_HANDLE)
+            {
+                freeMemory(block.memory, block.size, block.mapped != nullptr);
+            }
+        }
+    }
+}
+
+omp::MemoryAllocation omp::DeviceMemoryAllocator::allocate(const VkMemoryRequirements& inRequirements, VkMemoryPropertyFlags inProperties,
+                                                           EMemoryStrategy inStrategy, bool inIsImage)
+{
+    const uint32_t memory_type = findMemoryType(inRequirements.memoryTypeBits, inProperties);
+
+    std::lock_guard<std::mutex> lock(m_Access);
+
+    // Linear blocks don't track which resource lies next to which, so images stay out of them
+    EMemoryStrategy strategy = inStrategy == EMemoryStrategy::Linear && inIsImage ? EMemoryStrategy::General : inStrategy;
+    const VkDeviceSize block_size = getBlockSize(memory_type, strategy);
+    if (inRequirements.size > block_size / 2)
+    {
+        strategy = EMemoryStrategy::Dedicated;
+    }
+
+    MemoryAllocation allocation;
+    allocation.size = inRequirements.size;
+    allocation.strategy = strategy;
+
+    if (strategy == EMemoryStrategy::Dedicated)
+    {
+        uint8_t* mapped = nullptr;
+        allocation.memory = allocateMemory(inRequirements.size, memory_type, mapped);
+        allocation.mapped = mapped;
+        m_Statistics.dedicated_count++;
+        m_Statistics.allocation_count++;
+        m_Statistics.used_bytes += inRequirements.size;
+        return allocation;
+    }
+
+    const size_t pool_index = memory_type * POOLS_PER_TYPE + (strategy == EMemoryStrategy::Linear ? 2U : (inIsImage ? 1U : 0U));
+    Pool& pool = m_Pools[pool_index];
+
+    VkDeviceSize offset = 0;
+    size_t block_index = 0;
+    while (block_index < pool.blocks.size())
+    {
+        Block& block = pool.blocks[block_index];
+        if (block.memory != VK_NULL_HANDLE && allocateFromBlock(block, strategy, inRequirements, offset))
+        {
+            break;
+        }
+        block_index++;
+    }
+
+    if (block_index == pool.blocks.size())
+    {
+        // Released slots are reused, so block indices in live allocations stay valid
+        block_index = 0;
+        while (block_index < pool.blocks.size() && pool.blocks[block_index].memory != VK_NULL_HANDLE)
+        {
+            block_index++;
+        }
+        if (block_index == pool.blocks.size())
+        {
+            pool.blocks.emplace_back();
+        }
+
+        Block& block = pool.blocks[block_index];
+        block = Block{};
+        block.memory = allocateMemory(block_size, memory_type, block.mapped);
+        block.size = block_size;
+        block.ranges = omp::RangeAllocator(block_size);
+        m_Statistics.block_count++;
+
+        // Request is at most half a block, an empty one always fits it
+        allocateFromBlock(block, strategy, inRequirements, offset);
+    }
+
+    const Block& block = pool.blocks[block_index];
+    allocation.memory = block.memory;
+    allocation.offset = offset;
+    allocation.mapped = block.mapped ? block.mapped + offset : nullptr;
+    allocation.pool = static_cast<uint32_t>(pool_index);
+    allocation.block = static_cast<uint32_t>(block_index);
+    m_Statistics.allocation_count++;
+    m_Statistics.used_bytes += inRequirements.size;
+    return allocation;
+}
+
+void omp::DeviceMemoryAllocator::free(MemoryAllocation& ioAllocation)
+{
+    if (!ioAllocation.isValid())
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_Access);
+    m_Statistics.allocation_count--;
+    m_Statistics.used_bytes -= ioAllocation.size;
+
+    if (ioAllocation.strategy == EMemoryStrategy::Dedicated)
+    {
+        freeMemory(ioAllocation.memory, ioAllocation.size, ioAllocation.mapped != nullptr);
+        m_Statistics.dedicated_count--;
+        ioAllocation = MemoryAllocation{};
+        return;
+    }
+
+    Pool& pool = m_Pools[ioAllocation.pool];
+    Block& block = pool.blocks[ioAllocation.block];
+    if (ioAllocation.strategy == EMemoryStrategy::Linear)
+    {
+        block.linear_count--;
+        if (block.linear_count == 0)
+        {
+            block.linear_head = 0;
+        }
+    }
+    else
+    {
+        block.ranges.free(ioAllocation.offset);
+    }
+    ioAllocation = MemoryAllocation{};
+
+    // One empty block per pool is kept for the next allocation, others go back to the driver
+    auto is_empty = [](const Block& inBlock)
+    {
+        return inBlock.memory != VK_NULL_HANDLE && inBlock.linear_count == 0 && inBlock.ranges.getAllocationCount() == 0;
+    };
+    if (is_empty(block) && std::count_if(pool.blocks.begin(), pool.blocks.end(), is_empty) > 1)
+    {
+        freeMemory(block.memory, block.size, block.mapped != nullptr);
+        block = Block{};
+        m_Statistics.block_count--;
+    }
+}
+
+omp::DeviceMemoryStatistics omp::DeviceMemoryAllocator::getStatistics() const
+{
+    std::lock_guard<std::mutex> lock(m_Access);
+    return m_Statistics;
+}
+
+void omp::DeviceMemoryAllocator::logStatistics() const
+{
+    const DeviceMemoryStatistics statistics = getStatistics();
+    INFO(LogRendering, "Device memory: {} allocations in {} blocks and {} dedicated, {} of {} bytes used, {} vkAllocateMemory calls",
+         statistics.allocation_count, statistics.block_count, statistics.dedicated_count, statistics.used_bytes,
+         statistics.reserved_bytes, statistics.vulkan_allocations_made);
+}
+
+uint32_t omp::DeviceMemoryAllocator::findMemoryType(uint32_t inTypeFilter, VkMemoryPropertyFlags inProperties) const
+{
+    for (uint32_t i = 0; i < m_MemoryProperties.memoryTypeCount; i++)
+    {
+        if ((inTypeFilter & (1U << i)) && (m_MemoryProperties.memoryTypes[i].propertyFlags & inProperties) == inProperties)
+        {
+            return i;
+        }
+    }
+    throw std::runtime_error("failed to find suitable memory type");
+}
+
+VkDeviceMemory omp::DeviceMemoryAllocator::allocateMemory(VkDeviceSize inSize, uint32_t inMemoryType, uint8_t*& outMapped)
+{
+    if (m_Statistics.block_count + m_Statistics.dedicated_count >= m_MaxAllocationCount)
+    {
+        WARN(LogRendering, "Device memory allocation count reaches maxMemoryAllocationCount {}", m_MaxAllocationCount);
+    }
+
+    VkMemoryAllocateInfo allocate_info{};
+    allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocate_info.allocationSize = inSize;
+    allocate_info.memoryTypeIndex = inMemoryType;
+
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    if (vkAllocateMemory(m_Device, &allocate_info, nullptr, &memory) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to allocate device memory");
+    }
+    m_Statistics.reserved_bytes += inSize;
+    m_Statistics.vulkan_allocations_made++;
+
+    // Memory can be mapped once only, so host visible memory is mapped for its whole life
+    outMapped = nullptr;
+    if (m_MemoryProperties.memoryTypes[inMemoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+    {
+        void* data = nullptr;
+        if (vkMapMemory(m_Device, memory, 0, VK_WHOLE_SIZE, 0, &data) != VK_SUCCESS)
+        {
+            vkFreeMemory(m_Device, memory, nullptr);
+            throw std::runtime_error("Failed to map device memory");
+        }
+        outMapped = static_cast<uint8_t*>(data);
+    }
+    return memory;
+}
+
+void omp::DeviceMemoryAllocator::freeMemory(VkDeviceMemory inMemory, VkDeviceSize inSize, bool inMapped)
+{
+    if (inMapped)
+    {
+        vkUnmapMemory(m_Device, inMemory);
+    }
+    vkFreeMemory(m_Device, inMemory, nullptr);
+    m_Statistics.reserved_bytes -= inSize;
+}
+
+VkDeviceSize omp::DeviceMemoryAllocator::getBlockSize(uint32_t inMemoryType, EMemoryStrategy inStrategy) const
+{
+    const VkDeviceSize preferred = inStrategy == EMemoryStrategy::Linear ? LINEAR_BLOCK_SIZE : GENERAL_BLOCK_SIZE;
+    // Small heaps, like the host visible window of device memory, are not filled by a few blocks
+    const VkDeviceSize heap_size = m_MemoryProperties.memoryHeaps[m_MemoryProperties.memoryTypes[inMemoryType].heapIndex].size;
+    return std::min(preferred, heap_size / 8);
+}
+
+bool omp::DeviceMemoryAllocator::allocateFromBlock(Block& ioBlock, EMemoryStrategy inStrategy, const VkMemoryRequirements& inRequirements,
+                                                   VkDeviceSize& outOffset)
+{
+    if (inStrategy == EMemoryStrategy::Linear)
+    {
+        const VkDeviceSize offset = (ioBlock.linear_head + inRequirements.alignment - 1) / inRequirements.alignment * inRequirements.alignment;
+        if (offset + inRequirements.size > ioBlock.size)
+        {
+            return false;
+        }
+        ioBlock.linear_head = offset + inRequirements.size;
+        ioBlock.linear_count++;
+        outOffset = offset;
+        return true;
+    }
+
+    const size_t offset = ioBlock.ranges.allocate(inRequirements.size, inRequirements.alignment);
+    if (offset == omp::RangeAllocator::INVALID_OFFSET)
+    {
+        return false;
+    }
+    outOffset = offset;
+    return true;
+}
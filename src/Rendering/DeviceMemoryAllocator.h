@@ -0,0 +1,108 @@
+#pragma once
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "vulkan/vulkan.h"
+#include "Core/RangeAllocator.h"
+
+namespace omp
+{
+    enum class EMemoryStrategy : uint8_t
+    {
+        // Best fit free list in shared blocks, for long lived resources
+        General = 0,
+        // Bump allocation in host visible blocks, a block is reused once everything in it is freed. Staging data
+        Linear,
+        // Own VkDeviceMemory, render targets and anything larger than half a block end up here
+        Dedicated
+    };
+
+    struct MemoryAllocation
+    {
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        VkDeviceSize offset = 0;
+        VkDeviceSize size = 0;
+        // Host visible memory stays mapped, this points at offset. Null for device local memory
+        void* mapped = nullptr;
+
+        // Owned by DeviceMemoryAllocator
+        EMemoryStrategy strategy = EMemoryStrategy::General;
+        uint32_t pool = 0;
+        uint32_t block = 0;
+
+        bool isValid() const { return memory != VK_NULL_HANDLE; }
+    };
+
+    struct DeviceMemoryStatistics
+    {
+        size_t block_count = 0;
+        size_t dedicated_count = 0;
+        size_t allocation_count = 0;
+        // Every live vkAllocateMemory, blocks and dedicated allocations
+        VkDeviceSize reserved_bytes = 0;
+        VkDeviceSize used_bytes = 0;
+        size_t vulkan_allocations_made = 0;
+    };
+
+    /*
+     * @brief Sub-allocates buffers and images from large VkDeviceMemory blocks per memory type, so a scene
+     * costs a few vkAllocateMemory calls instead of one per resource and stays far from maxMemoryAllocationCount.
+     * Buffers and images get separate blocks, so bufferImageGranularity never has to be respected between them
+     */
+    class DeviceMemoryAllocator
+    {
+    public:
+        static constexpr VkDeviceSize GENERAL_BLOCK_SIZE = 64ULL * 1024 * 1024;
+        static constexpr VkDeviceSize LINEAR_BLOCK_SIZE = 16ULL * 1024 * 1024;
+
+        DeviceMemoryAllocator(VkDevice inDevice, VkPhysicalDevice inPhysDevice);
+        DeviceMemoryAllocator(const DeviceMemoryAllocator&) = delete;
+        DeviceMemoryAllocator& operator=(const DeviceMemoryAllocator&) = delete;
+        ~DeviceMemoryAllocator();
+
+        // Throws when no memory type fits or device is out of memory, same as other Vulkan failures
+        MemoryAllocation allocate(const VkMemoryRequirements& inRequirements, VkMemoryPropertyFlags inProperties,
+                                  EMemoryStrategy inStrategy, bool inIsImage);
+        void free(MemoryAllocation& ioAllocation);
+
+        DeviceMemoryStatistics getStatistics() const;
+        void logStatistics() const;
+
+    private:
+        struct Block
+        {
+            VkDeviceMemory memory = VK_NULL_HANDLE;
+            VkDeviceSize size = 0;
+            uint8_t* mapped = nullptr;
+            // General blocks
+            omp::RangeAllocator ranges;
+            // Linear blocks
+            VkDeviceSize linear_head = 0;
+            size_t linear_count = 0;
+        };
+
+        struct Pool
+        {
+            std::vector<Block> blocks;
+        };
+
+        // General buffers, general images and linear buffers of every memory type
+        static constexpr uint32_t POOLS_PER_TYPE = 3;
+
+        uint32_t findMemoryType(uint32_t inTypeFilter, VkMemoryPropertyFlags inProperties) const;
+        VkDeviceMemory allocateMemory(VkDeviceSize inSize, uint32_t inMemoryType, uint8_t*& outMapped);
+        void freeMemory(VkDeviceMemory inMemory, VkDeviceSize inSize, bool inMapped);
+        VkDeviceSize getBlockSize(uint32_t inMemoryType, EMemoryStrategy inStrategy) const;
+
+        bool allocateFromBlock(Block& ioBlock, EMemoryStrategy inStrategy, const VkMemoryRequirements& inRequirements,
+                               VkDeviceSize& outOffset);
+
+        VkDevice m_Device;
+        VkPhysicalDeviceMemoryProperties m_MemoryProperties{};
+        uint32_t m_MaxAllocationCount = 0;
+
+        mutable std::mutex m_Access;
+        std::vector<Pool> m_Pools;
+        DeviceMemoryStatistics m_Statistics;
+    };
+}
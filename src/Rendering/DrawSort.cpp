@@ -0,0 +1,127 @@
+#include "Rendering/DrawSort.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <thread>
+#include "Async/ThreadPool.h"
+
+namespace
+{
+    constexpr size_t RADIX = 256;
+    constexpr uint32_t KEY_BITS = 64;
+    constexpr uint32_t DIGIT_BITS = 8;
+
+    using Histogram = std::array<size_t, RADIX>;
+
+    size_t digitOf(uint64_t inKey, uint32_t inShift)
+    {
+        return (inKey >> inShift) & (RADIX - 1);
+    }
+}
+
+uint32_t omp::DrawSort::quantizeDepth(float inDepth)
+{
+    // Bits of non negative floats order the same way as their values
+    if (!(inDepth > 0.0f))
+    {
+        return 0;
+    }
+    return std::bit_cast<uint32_t>(inDepth);
+}
+
+uint64_t omp::DrawSort::makeKey(bool inTranslucent, uint32_t inPipelineId, uint32_t inMaterialId, float inDepth)
+{
+    static_assert(1 + PIPELINE_BITS + MATERIAL_BITS + DEPTH_BITS == KEY_BITS, "Key fields must fill 64 bits exactly");
+
+    const uint64_t pipeline = inPipelineId & ((uint64_t{1} << PIPELINE_BITS) - 1);
+    const uint64_t material = inMaterialId & ((uint64_t{1} << MATERIAL_BITS) - 1);
+    const uint64_t depth = quantizeDepth(inDepth);
+    if (!inTranslucent)
+    {
+        return (pipeline << (MATERIAL_BITS + DEPTH_BITS)) | (material << DEPTH_BITS) | depth;
+    }
+
+    // Inverted depth puts far draws first
+    const uint64_t far_first = ~depth & ((uint64_t{1} << DEPTH_BITS) - 1);
+    return (uint64_t{1} << (KEY_BITS - 1)) | (far_first << (PIPELINE_BITS + MATERIAL_BITS)) | (pipeline << MATERIAL_BITS) | material;
+}
+
+void omp::DrawSort::sort(std::vector<DrawSortEntry>& ioEntries, std::vector<DrawSortEntry>& ioScratch, omp::ThreadPool* inThreadPool)
+{
+    const size_t count = ioEntries.size();
+    if (count < 2)
+    {
+        return;
+    }
+    ioScratch.resize(count);
+
+    size_t chunk_count = 1;
+    if (inThreadPool && count >= PARALLEL_THRESHOLD)
+    {
+        const size_t workers = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+        chunk_count = std::max<size_t>(std::min(workers, count / MIN_CHUNK_SIZE), 1);
+    }
+    const size_t chunk_size = (count + chunk_count - 1) / chunk_count;
+    chunk_count = (count + chunk_size - 1) / chunk_size;
+    std::vector<Histogram> histograms(chunk_count);
+
+    const auto for_each_chunk = [inThreadPool, count, chunk_size, chunk_count](auto&& inFunction)
+    {
+        if (chunk_count == 1)
+        {
+            inFunction(size_t{0}, count);
+            return;
+        }
+        inThreadPool->parallelFor(count, chunk_size, inFunction);
+    };
+
+    DrawSortEntry* source = ioEntries.data();
+    DrawSortEntry* destination = ioScratch.data();
+    for (uint32_t shift = 0; shift < KEY_BITS; shift += DIGIT_BITS)
+    {
+        for_each_chunk([source, shift, chunk_size, &histograms](size_t inBegin, size_t inEnd)
+        {
+            Histogram& histogram = histograms[inBegin / chunk_size];
+            histogram.fill(0);
+            for (size_t index = inBegin; index < inEnd; index++)
+            {
+                histogram[digitOf(source[index].key, shift)]++;
+            }
+        });
+
+        // A bucket of every chunk starts after the same bucket of earlier chunks, so equal digits keep their order
+        size_t offset = 0;
+        bool same_digit = false;
+        for (size_t digit = 0; digit < RADIX; digit++)
+        {
+            size_t bucket_size = 0;
+            for (Histogram& histogram : histograms)
+            {
+                const size_t chunk_bucket_size = histogram[digit];
+                histogram[digit] = offset;
+                offset += chunk_bucket_size;
+                bucket_size += chunk_bucket_size;
+            }
+            same_digit = same_digit || bucket_size == count;
+        }
+        if (same_digit)
+        {
+            continue;
+        }
+
+        for_each_chunk([source, destination, shift, chunk_size, &histograms](size_t inBegin, size_t inEnd)
+        {
+            Histogram& offsets = histograms[inBegin / chunk_size];
+            for (size_t index = inBegin; index < inEnd; index++)
+            {
+                destination[offsets[digitOf(source[index].key, shift)]++] = source[index];
+            }
+        });
+        std::swap(source, destination);
+    }
+
+    if (source != ioEntries.data())
+    {
+        std::swap(ioEntries, ioScratch);
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace omp
+{
+    class ThreadPool;
+
+    /*
+     * @brief Draw of the frame's list, key orders it and index points back to the draw
+     */
+    struct DrawSortEntry
+    {
+        uint64_t key = 0;
+        uint32_t index = 0;
+    };
+
+    /*
+     * @brief Orders draws by 64 bit keys built once per frame.
+     * Opaque draws have the translucency bit clear and come first, grouped by pipeline, then material, then front to back.
+     * Translucent draws have it set and are ordered back to front before anything else, so blending stays correct,
+     * pipeline and material only break ties
+     *
+     *  opaque:      | 0 | pipeline 15 | material 16 | depth 32          |
+     *  translucent: | 1 | ~depth 32         | pipeline 15 | material 16 |
+     */
+    class DrawSort
+    {
+    public:
+        static constexpr uint32_t PIPELINE_BITS = 15;
+        static constexpr uint32_t MATERIAL_BITS = 16;
+        static constexpr uint32_t DEPTH_BITS = 32;
+
+        // Smaller lists are sorted on the calling thread, thread pool overhead is above the work
+        static constexpr size_t PARALLEL_THRESHOLD = 16384;
+        static constexpr size_t MIN_CHUNK_SIZE = 4096;
+
+        /*
+         * @brief Ids wrap around their bit width, which can only merge state runs, never misorder depth.
+         * inDepth is any non negative value growing with distance, squared distance works without a sqrt
+         */
+        static uint64_t makeKey(bool inTranslucent, uint32_t inPipelineId, uint32_t inMaterialId, float inDepth);
+
+        // Depth as an integer of the same order, negative and NaN values go to zero
+        static uint32_t quantizeDepth(float inDepth);
+
+        /*
+         * @brief Stable LSD radix sort of ioEntries by key, a byte per pass. Passes where every key has the same byte
+         * are skipped. Large lists split histograms and scatter into chunks over inThreadPool when it is given.
+         * ioScratch is reused between frames to avoid allocations
+         */
+        static void sort(std::vector<DrawSortEntry>& ioEntries, std::vector<DrawSortEntry>& ioScratch, omp::ThreadPool* inThreadPool);
+    };
+}
@@ -0,0 +1,184 @@
+#include "Rendering/FrustumCuller.h"
+#include <bit>
+#include <cfloat>
+#include "Async/ThreadPool.h"
+
+#if defined(__AVX__)
+#define OMP_CULL_AVX 1
+#include <immintrin.h>
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define OMP_CULL_SSE 1
+#include <xmmintrin.h>
+#endif
+
+namespace
+{
+    /*
+     * @brief Per plane pointers to the box component of the corner furthest along the plane normal
+     */
+    struct PlaneCorners
+    {
+        std::array<std::array<const float*, 3>, 6> components{};
+    };
+
+    PlaneCorners selectCorners(const omp::Frustum& inFrustum, const omp::BoundingBoxArray& inBoxes)
+    {
+        PlaneCorners corners;
+        for (size_t plane = 0; plane < inFrustum.planes.size(); plane++)
+        {
+            for (size_t axis = 0; axis < 3; axis++)
+            {
+                corners.components[plane][axis] = inFrustum.planes[plane][axis] >= 0.0f ? inBoxes.max[axis].data()
+                                                                                          : inBoxes.min[axis].data();
+            }
+        }
+        return corners;
+    }
+
+#if defined(OMP_CULL_AVX) || defined(OMP_CULL_SSE)
+    void appendVisible(uint32_t inVisibleMask, size_t inFirst, std::vector<uint32_t>& outVisible)
+    {
+        while (inVisibleMask != 0)
+        {
+            outVisible.push_back(static_cast<uint32_t>(inFirst + static_cast<size_t>(std::countr_zero(inVisibleMask))));
+            inVisibleMask &= inVisibleMask - 1;
+        }
+    }
+#endif
+}
+
+void omp::BoundingBoxArray::resize(size_t inCount)
+{
+    for (size_t axis = 0; axis < 3; axis++)
+    {
+        min[axis].resize(inCount);
+        max[axis].resize(inCount);
+    }
+}
+
+void omp::BoundingBoxArray::set(size_t inIndex, const omp::BoundingBox& inBox)
+{
+    for (size_t axis = 0; axis < 3; axis++)
+    {
+        min[axis][inIndex] = inBox.min[axis];
+        max[axis][inIndex] = inBox.max[axis];
+    }
+}
+
+void omp::BoundingBoxArray::push(const omp::BoundingBox& inBox)
+{
+    resize(size() + 1);
+    set(size() - 1, inBox);
+}
+
+void omp::BoundingBoxArray::setUnbounded(size_t inIndex)
+{
+    // Corner distances stay finite or go to positive infinity, never below a plane
+    set(inIndex, omp::BoundingBox{{-FLT_MAX, -FLT_MAX, -FLT_MAX}, {FLT_MAX, FLT_MAX, FLT_MAX}});
+}
+
+void omp::FrustumCuller::cull(const omp::Frustum& inFrustum, const omp::BoundingBoxArray& inBoxes, size_t inBegin, size_t inEnd,
+                              std::vector<uint32_t>& outVisible)
+{
+    const PlaneCorners corners = selectCorners(inFrustum, inBoxes);
+    size_t index = inBegin;
+
+#if defined(OMP_CULL_AVX)
+    // Attributes of vector types are dropped in template arguments, so registers sit in a plain array
+    __m256 planes[6][4];
+    for (size_t plane = 0; plane < 6; plane++)
+    {
+        for (size_t component = 0; component < 4; component++)
+        {
+            planes[plane][component] = _mm256_set1_ps(inFrustum.planes[plane][component]);
+        }
+    }
+    const __m256 zero = _mm256_setzero_ps();
+    for (; index + 8 <= inEnd; index += 8)
+    {
+        __m256 outside = zero;
+        for (size_t plane = 0; plane < 6; plane++)
+        {
+            const std::array<const float*, 3>& corner = corners.components[plane];
+            __m256 distance = _mm256_add_ps(_mm256_mul_ps(planes[plane][0], _mm256_loadu_ps(corner[0] + index)), planes[plane][3]);
+            distance = _mm256_add_ps(distance, _mm256_mul_ps(planes[plane][1], _mm256_loadu_ps(corner[1] + index)));
+            distance = _mm256_add_ps(distance, _mm256_mul_ps(planes[plane][2], _mm256_loadu_ps(corner[2] + index)));
+            outside = _mm256_or_ps(outside, _mm256_cmp_ps(distance, zero, _CMP_LT_OQ));
+        }
+        appendVisible(~static_cast<uint32_t>(_mm256_movemask_ps(outside)) & 0xFFU, index, outVisible);
+    }
+#elif defined(OMP_CULL_SSE)
+    // Attributes of vector types are dropped in template arguments, so registers sit in a plain array
+    __m128 planes[6][4];
+    for (size_t plane = 0; plane < 6; plane++)
+    {
+        for (size_t component = 0; component < 4; component++)
+        {
+            planes[plane][component] = _mm_set1_ps(inFrustum.planes[plane][component]);
+        }
+    }
+    const __m128 zero = _mm_setzero_ps();
+    for (; index + 4 <= inEnd; index += 4)
+    {
+        __m128 outside = zero;
+        for (size_t plane = 0; plane < 6; plane++)
+        {
+            const std::array<const float*, 3>& corner = corners.components[plane];
+            __m128 distance = _mm_add_ps(_mm_mul_ps(planes[plane][0], _mm_loadu_ps(corner[0] + index)), planes[plane][3]);
+            distance = _mm_add_ps(distance, _mm_mul_ps(planes[plane][1], _mm_loadu_ps(corner[1] + index)));
+            distance = _mm_add_ps(distance, _mm_mul_ps(planes[plane][2], _mm_loadu_ps(corner[2] + index)));
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, zero));
+        }
+        appendVisible(~static_cast<uint32_t>(_mm_movemask_ps(outside)) & 0xFU, index, outVisible);
+    }
+#endif
+
+    for (; index < inEnd; index++)
+    {
+        bool visible = true;
+        for (size_t plane = 0; plane < inFrustum.planes.size() && visible; plane++)
+        {
+            const std::array<float, 4>& equation = inFrustum.planes[plane];
+            const std::array<const float*, 3>& corner = corners.components[plane];
+            const float distance = equation[0] * corner[0][index] + equation[1] * corner[1][index]
+                                   + equation[2] * corner[2][index] + equation[3];
+            visible = !(distance < 0.0f);
+        }
+        if (visible)
+        {
+            outVisible.push_back(static_cast<uint32_t>(index));
+        }
+    }
+}
+
+void omp::FrustumCuller::cull(const omp::Frustum& inFrustum, const omp::BoundingBoxArray& inBoxes, omp::ThreadPool* inThreadPool,
+                              std::vector<uint32_t>& outVisible)
+{
+    outVisible.clear();
+    const size_t count = inBoxes.size();
+    if (!inThreadPool || count < PARALLEL_THRESHOLD)
+    {
+        cull(inFrustum, inBoxes, 0, count, outVisible);
+        return;
+    }
+
+    // Chunks fill their own lists, joined in chunk order so the result matches the serial one
+    std::vector<std::vector<uint32_t>> chunk_visible((count + CHUNK_SIZE - 1) / CHUNK_SIZE);
+    inThreadPool->parallelFor(count, CHUNK_SIZE, [&inFrustum, &inBoxes, &chunk_visible](size_t inBegin, size_t inEnd)
+    {
+        std::vector<uint32_t>& visible = chunk_visible[inBegin / CHUNK_SIZE];
+        visible.reserve(inEnd - inBegin);
+        cull(inFrustum, inBoxes, inBegin, inEnd, visible);
+    });
+
+    size_t visible_count = 0;
+    for (const std::vector<uint32_t>& visible : chunk_visible)
+    {
+        visible_count += visible.size();
+    }
+    outVisible.reserve(visible_count);
+    for (const std::vector<uint32_t>& visible : chunk_visible)
+    {
+        outVisible.insert(outVisible.end(), visible.begin(), visible.end());
+    }
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "Math/Bounds.h"
+
+namespace omp
+{
+    class ThreadPool;
+
+    /*
+     * @brief World space boxes stored per component, so SIMD lanes load consecutive boxes of one component
+     */
+    struct BoundingBoxArray
+    {
+        std::array<std::vector<float>, 3> min;
+        std::array<std::vector<float>, 3> max;
+
+        size_t size() const { return min[0].size(); }
+        void resize(size_t inCount);
+        void set(size_t inIndex, const BoundingBox& inBox);
+        void push(const BoundingBox& inBox);
+        // Box that passes every plane, for entities without bounds
+        void setUnbounded(size_t inIndex);
+    };
+
+    /*
+     * @brief Tests boxes against the six frustum planes four at a time with SSE, eight with AVX when it's enabled.
+     * Each plane is tested with the box corner furthest along its normal, so a box is culled only when it is entirely
+     * behind one plane. Visible indices come out compacted and in ascending order
+     */
+    class FrustumCuller
+    {
+    public:
+        // Smaller counts are culled on the calling thread, thread pool overhead is above the work
+        static constexpr size_t PARALLEL_THRESHOLD = 16384;
+        static constexpr size_t CHUNK_SIZE = 16384;
+
+        // Append visible indices of boxes in [inBegin, inEnd)
+        static void cull(const Frustum& inFrustum, const BoundingBoxArray& inBoxes, size_t inBegin, size_t inEnd,
+                         std::vector<uint32_t>& outVisible);
+
+        /*
+         * @brief Replace outVisible with indices of every visible box. Large arrays are split in chunks over
+         * inThreadPool when it is given
+         */
+        static void cull(const Frustum& inFrustum, const BoundingBoxArray& inBoxes, omp::ThreadPool* inThreadPool,
+                         std::vector<uint32_t>& outVisible);
+    };
+}
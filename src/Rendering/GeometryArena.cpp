@@ -0,0 +1,208 @@
+#include "Rendering/GeometryArena.h"
+#include <algorithm>
+#include "Logs.h"
+#include "Rendering/VulkanContext.h"
+
+omp::GeometryArena::GeometryArena(const std::shared_ptr<omp::VulkanContext>& inContext)
+    : m_Context(inContext)
+{
+    createPool(m_Vertices, INITIAL_VERTEX_CAPACITY, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+    createPool(m_Indices, INITIAL_INDEX_CAPACITY, VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+}
+
+omp::GeometryArena::~GeometryArena()
+{
+    destroyPool(m_Vertices);
+    destroyPool(m_Indices);
+}
+
+omp::GeometryAllocation omp::GeometryArena::uploadVertices(const void* inData, VkDeviceSize inSize, VkDeviceSize inStride)
+{
+    return upload(m_Vertices, inData, inSize, inStride);
+}
+
+omp::GeometryAllocation omp::GeometryArena::uploadIndices(const void* inData, VkDeviceSize inSize, VkDeviceSize inIndexSize)
+{
+    return upload(m_Indices, inData, inSize, inIndexSize);
+}
+
+void omp::GeometryArena::freeVertices(const omp::GeometryAllocation& inAllocation)
+{
+    free(m_Vertices, inAllocation);
+}
+
+void omp::GeometryArena::freeIndices(const omp::GeometryAllocation& inAllocation)
+{
+    free(m_Indices, inAllocation);
+}
+
+void omp::GeometryArena::update()
+{
+    releaseRetired(m_Vertices);
+    releaseRetired(m_Indices);
+}
+
+VkBuffer omp::GeometryArena::selectDrawBuffer(VkBuffer inCurrent, const std::vector<RetiredBuffer>& inRetired,
+                                              const std::function<bool(omp::UploadTicket)>& inIsComplete)
+{
+    for (const RetiredBuffer& retired : inRetired)
+    {
+        if (!inIsComplete(retired.copy_ticket))
+        {
+            return retired.buffer;
+        }
+    }
+    return inCurrent;
+}
+
+VkBuffer omp::GeometryArena::getDrawBuffer(const Pool& inPool) const
+{
+    std::shared_ptr<omp::VulkanContext> context = m_Context.lock();
+    if (!context || inPool.retired.empty())
+    {
+        return inPool.buffer;
+    }
+
+    // Tickets may complete in the middle of a frame, a model seen uploaded must find its range in the buffer returned
+    const omp::UploadQueue& upload_queue = *context->upload_queue;
+    return selectDrawBuffer(inPool.buffer, inPool.retired, [&upload_queue](omp::UploadTicket inTicket)
+    {
+        return upload_queue.isComplete(inTicket);
+    });
+}
+
+void omp::GeometryArena::releaseRetired(Pool& ioPool)
+{
+    std::shared_ptr<omp::VulkanContext> context = m_Context.lock();
+    if (!context)
+    {
+        return;
+    }
+
+    // Copies complete in ticket order, so does the switch to the next buffer
+    size_t released = 0;
+    while (released < ioPool.retired.size() && context->upload_queue->isComplete(ioPool.retired[released].copy_ticket))
+    {
+        // Frames in flight may still draw from it
+        context->deferred_deletion.push([weak_context = m_Context, retired = ioPool.retired[released]]() mutable
+        {
+            if (std::shared_ptr<omp::VulkanContext> owner = weak_context.lock())
+            {
+                vkDestroyBuffer(owner->logical_device, retired.buffer, nullptr);
+                owner->freeMemory(retired.memory);
+            }
+        });
+        released++;
+    }
+    ioPool.retired.erase(ioPool.retired.begin(), ioPool.retired.begin() + static_cast<std::ptrdiff_t>(released));
+}
+
+void omp::GeometryArena::free(Pool& ioPool, const omp::GeometryAllocation& inAllocation)
+{
+    if (!inAllocation.isValid())
+    {
+        return;
+    }
+
+    std::shared_ptr<omp::VulkanContext> context = m_Context.lock();
+    if (!context)
+    {
+        ioPool.allocator.free(inAllocation.offset);
+        return;
+    }
+
+    // Pool lives as long as the arena, it's checked before the range goes back
+    context->deferred_deletion.push([arena = weak_from_this(), pool = &ioPool, offset = inAllocation.offset]()
+    {
+        if (std::shared_ptr<omp::GeometryArena> owner = arena.lock())
+        {
+            pool->allocator.free(offset);
+        }
+    });
+}
+
+void omp::GeometryArena::createPool(Pool& outPool, VkDeviceSize inCapacity, VkBufferUsageFlags inUsage)
+{
+    std::shared_ptr<omp::VulkanContext> context = m_Context.lock();
+    if (!context)
+    {
+        return;
+    }
+
+    // Transfer source as well, growing copies the old buffer into the new one
+    outPool.usage = inUsage;
+    context->createBuffer(inCapacity, VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | inUsage,
+                          VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, outPool.buffer, outPool.memory);
+    outPool.allocator = omp::RangeAllocator(inCapacity);
+}
+
+void omp::GeometryArena::destroyPool(Pool& ioPool)
+{
+    std::shared_ptr<omp::VulkanContext> context = m_Context.lock();
+    if (context)
+    {
+        vkDestroyBuffer(context->logical_device, ioPool.buffer, nullptr);
+        context->freeMemory(ioPool.memory);
+        for (RetiredBuffer& retired : ioPool.retired)
+        {
+            vkDestroyBuffer(context->logical_device, retired.buffer, nullptr);
+            context->freeMemory(retired.memory);
+        }
+    }
+    ioPool.buffer = VK_NULL_HANDLE;
+    ioPool.memory = omp::MemoryAllocation{};
+    ioPool.retired.clear();
+}
+
+bool omp::GeometryArena::grow(Pool& ioPool, VkDeviceSize inMinimumCapacity)
+{
+    std::shared_ptr<omp::VulkanContext> context = m_Context.lock();
+    if (!context)
+    {
+        return false;
+    }
+
+    const VkDeviceSize old_capacity = ioPool.allocator.getCapacity();
+    const VkDeviceSize capacity = std::max(old_capacity * 2, inMinimumCapacity);
+    INFO(LogRendering, "Geometry arena grows from {} to {} bytes", old_capacity, capacity);
+
+    // Copy is recorded with the uploads, after those into the old buffer and before those into the new one,
+    // nothing waits for the GPU. Old buffer stays drawable until update sees the copy complete
+    Pool grown;
+    createPool(grown, capacity, ioPool.usage);
+    const omp::UploadTicket copy_ticket = context->upload_queue->copyBuffer(ioPool.buffer, grown.buffer, old_capacity);
+    ioPool.retired.push_back(RetiredBuffer{ioPool.buffer, ioPool.memory, copy_ticket});
+
+    ioPool.buffer = grown.buffer;
+    ioPool.memory = grown.memory;
+    ioPool.allocator.grow(capacity);
+    return true;
+}
+
+omp::GeometryAllocation omp::GeometryArena::upload(Pool& ioPool, const void* inData, VkDeviceSize inSize, VkDeviceSize inAlignment)
+{
+    std::shared_ptr<omp::VulkanContext> context = m_Context.lock();
+    if (!context || inSize == 0)
+    {
+        return omp::GeometryAllocation{};
+    }
+
+    size_t offset = ioPool.allocator.allocate(inSize, inAlignment);
+    if (offset == omp::RangeAllocator::INVALID_OFFSET)
+    {
+        // Worst case the range lands after the last free block, behind its alignment padding
+        if (!grow(ioPool, ioPool.allocator.getCapacity() + inSize + inAlignment))
+        {
+            return omp::GeometryAllocation{};
+        }
+        offset = ioPool.allocator.allocate(inSize, inAlignment);
+        if (offset == omp::RangeAllocator::INVALID_OFFSET)
+        {
+            ERROR(LogRendering, "Geometry arena can't fit {} bytes", inSize);
+            return omp::GeometryAllocation{};
+        }
+    }
+
+    const omp::UploadTicket ticket = context->upload_queue->uploadBuffer(ioPool.buffer, offset, inData, inSize);
+    return omp::GeometryAllocation{offset, inSize, ticket};
+}
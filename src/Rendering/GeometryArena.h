@@ -0,0 +1,102 @@
+#pragma once
+#include <functional>
+#include <memory>
+#include <vector>
+#include "vulkan/vulkan.h"
+#include "Core/RangeAllocator.h"
+#include "Rendering/DeviceMemoryAllocator.h"
+#include "Rendering/UploadQueue.h"
+
+namespace omp
+{
+    class VulkanContext;
+
+    struct GeometryAllocation
+    {
+        VkDeviceSize offset = 0;
+        VkDeviceSize size = 0;
+        // Range holds its data once this is complete in UploadQueue
+        omp::UploadTicket upload_ticket = 0;
+
+        bool isValid() const { return size > 0; }
+    };
+
+    /*
+     * @brief One device local vertex buffer and one index buffer shared by every model. Models are ranges in them,
+     * so a frame binds geometry once and draws with firstIndex and vertexOffset.
+     * Vertex ranges are aligned to their own stride and index ranges to their index size, so offsets convert to
+     * vertexOffset and firstIndex exactly. A full buffer is replaced by one twice as large, ranges keep their offsets.
+     * Data goes through UploadQueue, ranges aren't drawable until their ticket completes. Growing copies the old
+     * buffer in the upload batch too, the draw buffer is picked by that copy's ticket whenever it is fetched,
+     * so it switches at the same moment ranges allocated past the old capacity become drawable
+     */
+    class GeometryArena : public std::enable_shared_from_this<GeometryArena>
+    {
+    public:
+        static constexpr VkDeviceSize INITIAL_VERTEX_CAPACITY = 64ULL * 1024 * 1024;
+        static constexpr VkDeviceSize INITIAL_INDEX_CAPACITY = 32ULL * 1024 * 1024;
+
+        explicit GeometryArena(const std::shared_ptr<omp::VulkanContext>& inContext);
+        GeometryArena(const GeometryArena&) = delete;
+        GeometryArena& operator=(const GeometryArena&) = delete;
+        ~GeometryArena();
+
+        // inStride is the vertex size, invalid allocation when buffer can't grow
+        GeometryAllocation uploadVertices(const void* inData, VkDeviceSize inSize, VkDeviceSize inStride);
+        // inIndexSize is 2 or 4
+        GeometryAllocation uploadIndices(const void* inData, VkDeviceSize inSize, VkDeviceSize inIndexSize);
+
+        // Frames in flight may still draw freed ranges, they are reused once those frames finish
+        void freeVertices(const GeometryAllocation& inAllocation);
+        void freeIndices(const GeometryAllocation& inAllocation);
+
+        // Buffer replaced by a larger one, alive until the copy out of it completes and frames stop drawing it
+        struct RetiredBuffer
+        {
+            VkBuffer buffer = VK_NULL_HANDLE;
+            omp::MemoryAllocation memory;
+            omp::UploadTicket copy_ticket = 0;
+        };
+
+        // Hands retired buffers whose copy is complete to deferred deletion, call once per frame after UploadQueue::poll
+        void update();
+
+        // Handles change when buffers grow, fetch them for every recording
+        VkBuffer getVertexBuffer() const { return getDrawBuffer(m_Vertices); }
+        VkBuffer getIndexBuffer() const { return getDrawBuffer(m_Indices); }
+
+        /*
+         * @brief Buffer holding every range whose upload is complete: the oldest retired one whose copy out is still
+         * running, the current one once every copy is done. inRetired is ordered oldest first
+         */
+        static VkBuffer selectDrawBuffer(VkBuffer inCurrent, const std::vector<RetiredBuffer>& inRetired,
+                                         const std::function<bool(omp::UploadTicket)>& inIsComplete);
+
+        VkDeviceSize getUsedSize() const { return m_Vertices.allocator.getUsedSize() + m_Indices.allocator.getUsedSize(); }
+        VkDeviceSize getCapacity() const { return m_Vertices.allocator.getCapacity() + m_Indices.allocator.getCapacity(); }
+
+    private:
+        struct Pool
+        {
+            VkBuffer buffer = VK_NULL_HANDLE;
+            omp::MemoryAllocation memory;
+            VkBufferUsageFlags usage = 0;
+            omp::RangeAllocator allocator;
+            // Oldest first
+            std::vector<RetiredBuffer> retired;
+        };
+
+        VkBuffer getDrawBuffer(const Pool& inPool) const;
+
+        void createPool(Pool& outPool, VkDeviceSize inCapacity, VkBufferUsageFlags inUsage);
+        void destroyPool(Pool& ioPool);
+        void releaseRetired(Pool& ioPool);
+        bool grow(Pool& ioPool, VkDeviceSize inMinimumCapacity);
+        GeometryAllocation upload(Pool& ioPool, const void* inData, VkDeviceSize inSize, VkDeviceSize inAlignment);
+        void free(Pool& ioPool, const GeometryAllocation& inAllocation);
+
+        std::weak_ptr<omp::VulkanContext> m_Context;
+        Pool m_Vertices;
+        Pool m_Indices;
+    };
+}
@@ -2,6 +2,7 @@
 #include "GraphicsPipeline.h"
 #include "Model.h"
 #include "Shader.h"
+#include "Math/Hash.h"
 
 omp::GraphicsPipeline::GraphicsPipeline(VkDevice inLogicalDevice)
         : m_LogicalDevice(inLogicalDevice)
@@ -21,28 +22,28 @@ void omp::GraphicsPipeline::startCreation()
 
 }
 
-void omp::GraphicsPipeline::startDefaultCreation()
+void omp::GraphicsPipeline::startDefaultCreation(EVertexLayout inLayout)
 {
     tryDestroyVulkanObjects();
     m_IsCreated = false;
 
-    createVertexInfo();
+    createVertexInfo(inLayout);
     createInputAssembly();
     createViewport(VkExtent2D());
     createRasterizer();
 }
 
-void omp::GraphicsPipeline::createVertexInfo()
+void omp::GraphicsPipeline::createVertexInfo(EVertexLayout inLayout)
 {
-    static auto binding_description = omp::Vertex::GetBindingDescription();
-    static auto attribute_descriptions = omp::Vertex::GetAttributeDescriptions();
+    m_VertexBinding = omp::Vertex::GetBindingDescription(inLayout);
+    m_VertexAttributes = omp::Vertex::GetAttributeDescriptions(inLayout);
 
     VkPipelineVertexInputStateCreateInfo vertex_input_info{};
     vertex_input_info.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
     vertex_input_info.vertexBindingDescriptionCount = 1;
-    vertex_input_info.pVertexBindingDescriptions = &binding_description;
-    vertex_input_info.vertexAttributeDescriptionCount = static_cast<uint32_t>(attribute_descriptions.size());
-    vertex_input_info.pVertexAttributeDescriptions = attribute_descriptions.data();
+    vertex_input_info.pVertexBindingDescriptions = &m_VertexBinding;
+    vertex_input_info.vertexAttributeDescriptionCount = static_cast<uint32_t>(m_VertexAttributes.size());
+    vertex_input_info.pVertexAttributeDescriptions = m_VertexAttributes.data();
 
     m_VertexInputInfo = vertex_input_info;
 }
@@ -194,6 +195,11 @@ void omp::GraphicsPipeline::confirmCreation(const std::shared_ptr<omp::RenderPas
     {
         throw std::runtime_error("Failed to create pipeline layout");
     }
+    m_LayoutSignature = omp::HashLib::hash64(m_SetLayoutsHandles.data(), m_SetLayoutsHandles.size() * sizeof(VkDescriptorSetLayout));
+    if (m_PipelineLayoutInfo.pushConstantRangeCount > 0)
+    {
+        m_LayoutSignature = omp::HashLib::hash64(&m_ConstantRange, sizeof(VkPushConstantRange), m_LayoutSignature);
+    }
 
     VkDynamicState dynamic_states[] = {
             VK_DYNAMIC_STATE_LINE_WIDTH,
@@ -225,7 +231,7 @@ void omp::GraphicsPipeline::confirmCreation(const std::shared_ptr<omp::RenderPas
     pipeline_info.basePipelineHandle = VK_NULL_HANDLE;
     pipeline_info.basePipelineIndex = -1;
 
-    if (vkCreateGraphicsPipelines(m_LogicalDevice, VK_NULL_HANDLE, 1, &pipeline_info, nullptr, &m_GraphicsPipeline)
+    if (vkCreateGraphicsPipelines(m_LogicalDevice, m_PipelineCache, 1, &pipeline_info, nullptr, &m_GraphicsPipeline)
         != VK_SUCCESS)
     {
         throw std::runtime_error("Failed to create graphics pipeline!");
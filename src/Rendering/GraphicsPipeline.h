@@ -2,7 +2,9 @@
 
 #include "vulkan/vulkan.h"
 #include "RenderPass.h"
+#include "Rendering/VertexPacking.h"
 #include <memory>
+#include <vector>
 
 
 namespace omp
@@ -14,8 +16,8 @@ namespace omp
         ~GraphicsPipeline();
 
         void startCreation();
-        void startDefaultCreation();
-        void createVertexInfo();
+        void startDefaultCreation(EVertexLayout inLayout = EVertexLayout::Full);
+        void createVertexInfo(EVertexLayout inLayout = EVertexLayout::Full);
         void createInputAssembly();
         void createViewport(VkExtent2D scissorExtent);
         void createRasterizer();
@@ -29,19 +31,27 @@ namespace omp
         void createShaders(const std::shared_ptr<class Shader>& shader);
         void setDepthStencil();
         void setDepthStencil(VkPipelineDepthStencilStateCreateInfo info);
+        // Cache is not owned, it has to outlive confirmCreation only
+        void setPipelineCache(VkPipelineCache inPipelineCache) { m_PipelineCache = inPipelineCache; }
         void confirmCreation(const std::shared_ptr<omp::RenderPass>& renderPass);
 
         VkPipeline getGraphicsPipeline() { return m_GraphicsPipeline; }
 
         VkPipelineLayout getPipelineLayout() { return m_PipelineLayout; }
 
+        // Equal for pipelines with equal set layouts and push constants, descriptor sets stay bound between them
+        uint64_t getLayoutSignature() const { return m_LayoutSignature; }
+
     private:
         bool m_IsCreated = false;
         VkDevice m_LogicalDevice;
+        uint64_t m_LayoutSignature = 0;
 
         // PIPELINE //
         // ======== //
         VkPipelineVertexInputStateCreateInfo m_VertexInputInfo{};
+        VkVertexInputBindingDescription m_VertexBinding{};
+        std::vector<VkVertexInputAttributeDescription> m_VertexAttributes;
         VkPipelineInputAssemblyStateCreateInfo m_InputAssembly{};
         VkViewport m_Viewport{};
         VkRect2D m_Scissor{};
@@ -53,7 +63,7 @@ namespace omp
         VkPushConstantRange m_ConstantRange{};
         VkPipelineDepthStencilStateCreateInfo m_DepthStencil{};
         std::shared_ptr<omp::Shader> m_Shader;
-        VkPipelineCache m_PipelineCache{};
+        VkPipelineCache m_PipelineCache = VK_NULL_HANDLE;
 
         VkPipelineLayoutCreateInfo m_PipelineLayoutInfo{};
         std::vector<VkDescriptorSetLayout> m_SetLayoutsHandles;
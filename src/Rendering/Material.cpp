@@ -1,8 +1,14 @@
 #include "Material.h"
 #include "Logs.h"
 #include "UI/MaterialRepresentation.h"
+#include <atomic>
 #include <memory>
 
+namespace
+{
+    std::atomic<uint32_t> s_NextSortId{0};
+}
+
 void omp::Material::addTextureInternal(TextureData&& data)
 {
     clearDescriptorSets();
@@ -89,6 +95,7 @@ std::vector<omp::TextureData> omp::Material::getTextureData() const
 }
 
 omp::Material::Material()
+    : m_SortId(s_NextSortId.fetch_add(1, std::memory_order_relaxed))
 {
     m_RenderInfo = std::make_unique<omp::MaterialRenderInfo>();
 }
@@ -142,6 +149,7 @@ void omp::Material::deserialize(JsonParser<> &parser)
     }
 
     m_RenderInfo->shader_name = parser.readValue<std::string>("shader_name").value();
+    m_HasPipelineHandles = false;
     m_EnableBlending = parser.readValue<bool>("enable_blending").value();
 }
 
@@ -149,3 +157,15 @@ void omp::Material::enableBlending(bool enable)
 {
     m_EnableBlending = enable;
 }
+
+void omp::Material::setShaderName(const std::string& newName)
+{
+    m_RenderInfo->shader_name = newName;
+    m_HasPipelineHandles = false;
+}
+
+void omp::Material::setPipelineHandles(const PipelineHandles& inHandles)
+{
+    m_PipelineHandles = inHandles;
+    m_HasPipelineHandles = true;
+}
@@ -2,9 +2,12 @@
 
 #include <vector>
 #include <memory>
+#include <array>
+#include <cstdint>
 #include "Texture.h"
 #include "TextureSrc.h"
 #include "IO/SerializableObject.h"
+#include "Rendering/VertexPacking.h"
 
 namespace omp
 {
@@ -42,6 +45,11 @@ namespace omp
 
     class Material : public SerializableObject
     {
+    public:
+        static constexpr uint32_t INVALID_PIPELINE = UINT32_MAX;
+        // Renderer pipeline handle of the material's shader for every vertex layout
+        using PipelineHandles = std::array<uint32_t, static_cast<size_t>(EVertexLayout::Max)>;
+
     private:
         std::unique_ptr<omp::MaterialRenderInfo> m_RenderInfo;
 
@@ -51,6 +59,11 @@ namespace omp
 
         bool m_EnableBlending = false;
 
+        uint32_t m_SortId = 0;
+
+        PipelineHandles m_PipelineHandles{};
+        bool m_HasPipelineHandles = false;
+
     public:
         Material();
         explicit Material(const std::string& name);
@@ -69,7 +82,7 @@ namespace omp
 
         std::vector<TextureData> getTextureData() const;
 
-        void setShaderName(const std::string& newName) { m_RenderInfo->shader_name = newName; };
+        void setShaderName(const std::string& newName);
 
         std::string getShaderName() const { return m_RenderInfo->shader_name; }
 
@@ -84,6 +97,14 @@ namespace omp
         void enableBlending(bool enable);
         bool isBlendingEnabled() const { return m_EnableBlending; }
 
+        // Unique per material until it wraps, draw sort keys group by it
+        uint32_t getSortId() const { return m_SortId; }
+
+        // Handles are resolved by the renderer once, when it loads the material, and dropped when the shader changes
+        void setPipelineHandles(const PipelineHandles& inHandles);
+        bool hasPipelineHandles() const { return m_HasPipelineHandles; }
+        uint32_t getPipelineHandle(EVertexLayout inLayout) const { return m_PipelineHandles[static_cast<size_t>(inLayout)]; }
+
         friend MaterialManager;
     };
 } // omp
@@ -0,0 +1,335 @@
+#include "Rendering/MeshOptimizer.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numeric>
+#include "Core/Profiling.h"
+
+namespace
+{
+    constexpr uint32_t NONE = UINT32_MAX;
+
+    // FIFO cache simulation, vertex is a hit while less than cache size misses happened since it was loaded
+    struct CacheSimulator
+    {
+        std::vector<uint32_t> timestamps;
+        uint32_t timestamp = 0;
+        uint32_t cache_size = 0;
+
+        CacheSimulator(size_t inVertexCount, uint32_t inCacheSize)
+            : timestamps(inVertexCount, 0)
+            , timestamp(inCacheSize + 1)
+            , cache_size(inCacheSize)
+        {
+        }
+
+        bool access(uint32_t inVertex)
+        {
+            if (timestamp - timestamps[inVertex] > cache_size)
+            {
+                timestamps[inVertex] = timestamp++;
+                return false;
+            }
+            return true;
+        }
+
+        uint32_t accessTriangle(const uint32_t* inTriangle)
+        {
+            uint32_t misses = 0;
+            for (size_t corner = 0; corner < 3; corner++)
+            {
+                misses += access(inTriangle[corner]) ? 0U : 1U;
+            }
+            return misses;
+        }
+
+        void flush()
+        {
+            timestamp += cache_size + 1;
+        }
+    };
+
+    using Vec3 = std::array<float, 3>;
+
+    Vec3 position(const float* inPositions, size_t inStride, uint32_t inVertex)
+    {
+        const float* value = reinterpret_cast<const float*>(reinterpret_cast<const uint8_t*>(inPositions) + inVertex * inStride);
+        return {value[0], value[1], value[2]};
+    }
+}
+
+void omp::MeshOptimizer::optimizeVertexCache(std::vector<uint32_t>& ioIndices, size_t inVertexCount, uint32_t inCacheSize)
+{
+    OMP_STAT_SCOPE("OptimizeVertexCache");
+
+    const size_t triangle_count = ioIndices.size() / 3;
+    if (triangle_count == 0)
+    {
+        return;
+    }
+
+    // Triangles around every vertex, with the number of them not emitted yet
+    std::vector<uint32_t> live_triangles(inVertexCount, 0);
+    for (uint32_t vertex : ioIndices)
+    {
+        live_triangles[vertex]++;
+    }
+    std::vector<size_t> adjacency_offsets(inVertexCount + 1, 0);
+    for (size_t vertex = 0; vertex < inVertexCount; vertex++)
+    {
+        adjacency_offsets[vertex + 1] = adjacency_offsets[vertex] + live_triangles[vertex];
+    }
+    std::vector<uint32_t> adjacency(ioIndices.size());
+    {
+        std::vector<size_t> fill = adjacency_offsets;
+        for (size_t index = 0; index < triangle_count * 3; index++)
+        {
+            adjacency[fill[ioIndices[index]]++] = static_cast<uint32_t>(index / 3);
+        }
+    }
+
+    CacheSimulator cache(inVertexCount, inCacheSize);
+    std::vector<uint8_t> emitted(triangle_count, 0);
+    std::vector<uint32_t> dead_ends;
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> result;
+    result.reserve(triangle_count * 3);
+    size_t cursor = 0;
+
+    // Most recently used vertex with live triangles, then next one in input order
+    auto skip_dead_end = [&dead_ends, &live_triangles, &cursor, inVertexCount]()
+    {
+        while (!dead_ends.empty())
+        {
+            const uint32_t vertex = dead_ends.back();
+            dead_ends.pop_back();
+            if (live_triangles[vertex] > 0)
+            {
+                return vertex;
+            }
+        }
+        while (cursor < inVertexCount)
+        {
+            if (live_triangles[cursor] > 0)
+            {
+                return static_cast<uint32_t>(cursor);
+            }
+            cursor++;
+        }
+        return NONE;
+    };
+
+    uint32_t fanning = skip_dead_end();
+    while (fanning != NONE)
+    {
+        candidates.clear();
+        for (size_t offset = adjacency_offsets[fanning]; offset < adjacency_offsets[fanning + 1]; offset++)
+        {
+            const uint32_t triangle = adjacency[offset];
+            if (emitted[triangle])
+            {
+                continue;
+            }
+            emitted[triangle] = 1;
+
+            for (size_t corner = 0; corner < 3; corner++)
+            {
+                const uint32_t vertex = ioIndices[size_t{triangle} * 3 + corner];
+                result.push_back(vertex);
+                dead_ends.push_back(vertex);
+                candidates.push_back(vertex);
+                live_triangles[vertex]--;
+                cache.access(vertex);
+            }
+        }
+
+        // Prefer vertices that stay in cache while their remaining triangles are emitted
+        uint32_t next = NONE;
+        int64_t best_priority = -1;
+        for (uint32_t vertex : candidates)
+        {
+            if (live_triangles[vertex] == 0)
+            {
+                continue;
+            }
+            const int64_t age = int64_t{cache.timestamp} - int64_t{cache.timestamps[vertex]};
+            const int64_t priority = age + 2 * int64_t{live_triangles[vertex]} <= int64_t{inCacheSize} ? age : 0;
+            if (priority > best_priority)
+            {
+                best_priority = priority;
+                next = vertex;
+            }
+        }
+
+        fanning = next != NONE ? next : skip_dead_end();
+    }
+
+    ioIndices = std::move(result);
+}
+
+void omp::MeshOptimizer::optimizeOverdraw(std::vector<uint32_t>& ioIndices, const float* inPositions, size_t inStride, size_t inVertexCount,
+                                          uint32_t inCacheSize, float inThreshold)
+{
+    OMP_STAT_SCOPE("OptimizeOverdraw");
+
+    const size_t triangle_count = ioIndices.size() / 3;
+    if (triangle_count < 2)
+    {
+        return;
+    }
+
+    // Hard boundaries are triangles missing all three vertices, there the cache starts over anyway
+    CacheSimulator cache(inVertexCount, inCacheSize);
+    std::vector<size_t> hard_boundaries;
+    std::vector<uint32_t> triangle_misses(triangle_count);
+    for (size_t triangle = 0; triangle < triangle_count; triangle++)
+    {
+        triangle_misses[triangle] = cache.accessTriangle(ioIndices.data() + triangle * 3);
+        if (triangle == 0 || triangle_misses[triangle] == 3)
+        {
+            hard_boundaries.push_back(triangle);
+        }
+    }
+    hard_boundaries.push_back(triangle_count);
+
+    // Soft boundaries split clusters where restarting the cache costs little compared to the whole cluster
+    std::vector<size_t> clusters;
+    for (size_t hard = 0; hard + 1 < hard_boundaries.size(); hard++)
+    {
+        const size_t begin = hard_boundaries[hard];
+        const size_t end = hard_boundaries[hard + 1];
+
+        size_t hard_misses = 0;
+        for (size_t triangle = begin; triangle < end; triangle++)
+        {
+            hard_misses += triangle_misses[triangle];
+        }
+        const float cluster_threshold = inThreshold * static_cast<float>(hard_misses) / static_cast<float>(end - begin);
+
+        clusters.push_back(begin);
+        cache.flush();
+        size_t cluster_misses = 0;
+        size_t cluster_size = 0;
+        for (size_t triangle = begin; triangle < end; triangle++)
+        {
+            cluster_misses += cache.accessTriangle(ioIndices.data() + triangle * 3);
+            cluster_size++;
+
+            if (triangle + 1 < end && static_cast<float>(cluster_misses) <= cluster_threshold * static_cast<float>(cluster_size))
+            {
+                clusters.push_back(triangle + 1);
+                cache.flush();
+                cluster_misses = 0;
+                cluster_size = 0;
+            }
+        }
+    }
+    const size_t cluster_count = clusters.size();
+    clusters.push_back(triangle_count);
+
+    Vec3 mesh_center{};
+    float mesh_area = 0.0f;
+    std::vector<Vec3> centers(cluster_count);
+    std::vector<Vec3> normals(cluster_count);
+    std::vector<float> areas(cluster_count, 0.0f);
+    for (size_t cluster = 0; cluster < cluster_count; cluster++)
+    {
+        for (size_t triangle = clusters[cluster]; triangle < clusters[cluster + 1]; triangle++)
+        {
+            const Vec3 a = position(inPositions, inStride, ioIndices[triangle * 3]);
+            const Vec3 b = position(inPositions, inStride, ioIndices[triangle * 3 + 1]);
+            const Vec3 c = position(inPositions, inStride, ioIndices[triangle * 3 + 2]);
+            const Vec3 ab = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+            const Vec3 ac = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+            // Cross product length is twice the area, its direction is the face normal
+            const Vec3 normal = {ab[1] * ac[2] - ab[2] * ac[1], ab[2] * ac[0] - ab[0] * ac[2], ab[0] * ac[1] - ab[1] * ac[0]};
+            const float area = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+
+            for (size_t axis = 0; axis < 3; axis++)
+            {
+                centers[cluster][axis] += (a[axis] + b[axis] + c[axis]) / 3.0f * area;
+                normals[cluster][axis] += normal[axis];
+            }
+            areas[cluster] += area;
+        }
+
+        for (size_t axis = 0; axis < 3; axis++)
+        {
+            mesh_center[axis] += centers[cluster][axis];
+        }
+        mesh_area += areas[cluster];
+    }
+
+    // Clusters facing away from the center are more likely to occlude the rest
+    std::vector<float> sort_keys(cluster_count, 0.0f);
+    for (size_t cluster = 0; cluster < cluster_count; cluster++)
+    {
+        const Vec3& normal = normals[cluster];
+        const float normal_length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+        if (areas[cluster] <= 0.0f || normal_length <= 0.0f || mesh_area <= 0.0f)
+        {
+            continue;
+        }
+        for (size_t axis = 0; axis < 3; axis++)
+        {
+            const float offset = centers[cluster][axis] / areas[cluster] - mesh_center[axis] / mesh_area;
+            sort_keys[cluster] += offset * normal[axis] / normal_length;
+        }
+    }
+
+    std::vector<uint32_t> order(cluster_count);
+    std::iota(order.begin(), order.end(), 0U);
+    std::stable_sort(order.begin(), order.end(), [&sort_keys](uint32_t inFirst, uint32_t inSecond)
+    {
+        return sort_keys[inFirst] > sort_keys[inSecond];
+    });
+
+    std::vector<uint32_t> result;
+    result.reserve(ioIndices.size());
+    for (uint32_t cluster : order)
+    {
+        result.insert(result.end(), ioIndices.begin() + static_cast<std::ptrdiff_t>(clusters[cluster] * 3),
+                      ioIndices.begin() + static_cast<std::ptrdiff_t>(clusters[cluster + 1] * 3));
+    }
+    ioIndices = std::move(result);
+}
+
+std::vector<uint32_t> omp::MeshOptimizer::optimizeVertexFetchRemap(std::vector<uint32_t>& ioIndices, size_t inVertexCount)
+{
+    std::vector<uint32_t> remap(inVertexCount, NONE);
+    uint32_t next_vertex = 0;
+    for (uint32_t& index : ioIndices)
+    {
+        if (remap[index] == NONE)
+        {
+            remap[index] = next_vertex++;
+        }
+        index = remap[index];
+    }
+    return remap;
+}
+
+omp::VertexCacheStatistics omp::MeshOptimizer::analyzeVertexCache(const std::vector<uint32_t>& inIndices, size_t inVertexCount,
+                                                                  uint32_t inCacheSize)
+{
+    VertexCacheStatistics statistics;
+    const size_t triangle_count = inIndices.size() / 3;
+    if (triangle_count == 0)
+    {
+        return statistics;
+    }
+
+    CacheSimulator cache(inVertexCount, inCacheSize);
+    std::vector<uint8_t> used(inVertexCount, 0);
+    size_t used_count = 0;
+    for (uint32_t vertex : inIndices)
+    {
+        statistics.vertices_transformed += cache.access(vertex) ? 0U : 1U;
+        used_count += used[vertex] ? 0U : 1U;
+        used[vertex] = 1;
+    }
+
+    statistics.acmr = static_cast<float>(statistics.vertices_transformed) / static_cast<float>(triangle_count);
+    statistics.atvr = static_cast<float>(statistics.vertices_transformed) / static_cast<float>(used_count);
+    return statistics;
+}
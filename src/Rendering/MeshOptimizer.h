@@ -0,0 +1,80 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace omp
+{
+    struct VertexCacheStatistics
+    {
+        size_t vertices_transformed = 0;
+        // Average cache miss ratio, transformed vertices per triangle, 0.5 is ideal on large meshes
+        float acmr = 0.0f;
+        // Average transform to vertex ratio, 1 is ideal
+        float atvr = 0.0f;
+    };
+
+    /*
+     * @brief CPU passes reordering indexed triangle lists for the GPU, run once at import.
+     * Triangles are reordered for the post transform cache with Tipsify, then cache friendly clusters
+     * are sorted outside in to reduce overdraw, and vertices are remapped in order of first use for fetch locality.
+     */
+    class MeshOptimizer
+    {
+    public:
+        static constexpr uint32_t DEFAULT_CACHE_SIZE = 16;
+        // Clusters may be this much worse in ACMR than the whole cache optimized mesh
+        static constexpr float DEFAULT_OVERDRAW_THRESHOLD = 1.05f;
+
+        /*
+         * @brief Tipsify (Sander et al. 2007), linear time triangle reordering for a cache of inCacheSize vertices
+         */
+        static void optimizeVertexCache(std::vector<uint32_t>& ioIndices, size_t inVertexCount, uint32_t inCacheSize = DEFAULT_CACHE_SIZE);
+
+        /*
+         * @brief Split cache optimized triangles into clusters and sort them by occlusion potential, so outer clusters draw first.
+         * inPositions points to x, y, z of the first vertex, inStride is the distance between vertices in bytes
+         */
+        static void optimizeOverdraw(std::vector<uint32_t>& ioIndices, const float* inPositions, size_t inStride, size_t inVertexCount,
+                                     uint32_t inCacheSize = DEFAULT_CACHE_SIZE, float inThreshold = DEFAULT_OVERDRAW_THRESHOLD);
+
+        /*
+         * @brief Renumber vertices in order of first use, returns old index to new index, UINT32_MAX for unused vertices
+         */
+        static std::vector<uint32_t> optimizeVertexFetchRemap(std::vector<uint32_t>& ioIndices, size_t inVertexCount);
+
+        /*
+         * @brief optimizeVertexFetchRemap applied to the vertex array, unused vertices are dropped
+         */
+        template< typename T >
+        static void optimizeVertexFetch(std::vector<T>& ioVertices, std::vector<uint32_t>& ioIndices);
+
+        /*
+         * @brief Simulate a FIFO post transform cache of inCacheSize vertices
+         */
+        static VertexCacheStatistics analyzeVertexCache(const std::vector<uint32_t>& inIndices, size_t inVertexCount,
+                                                        uint32_t inCacheSize = DEFAULT_CACHE_SIZE);
+    };
+
+    template< typename T >
+    void MeshOptimizer::optimizeVertexFetch(std::vector<T>& ioVertices, std::vector<uint32_t>& ioIndices)
+    {
+        const std::vector<uint32_t> remap = optimizeVertexFetchRemap(ioIndices, ioVertices.size());
+
+        size_t used_count = 0;
+        for (uint32_t new_index : remap)
+        {
+            used_count += new_index != UINT32_MAX ? 1 : 0;
+        }
+
+        std::vector<T> vertices(used_count);
+        for (size_t index = 0; index < remap.size(); index++)
+        {
+            if (remap[index] != UINT32_MAX)
+            {
+                vertices[remap[index]] = ioVertices[index];
+            }
+        }
+        ioVertices = std::move(vertices);
+    }
+}
@@ -0,0 +1,400 @@
+#include "Rendering/MeshSimplifier.h"
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cmath>
+#include <numeric>
+#include "Core/Profiling.h"
+#include "Math/DedupTable.h"
+#include "Math/Hash.h"
+
+namespace
+{
+    constexpr uint32_t NONE = UINT32_MAX;
+    // Collapses turning a triangle normal by more than about 75 degrees are rejected
+    constexpr float MIN_NORMAL_COSINE = 0.25f;
+
+    using Vec3 = std::array<float, 3>;
+
+    struct Vec3Hash
+    {
+        size_t operator()(const Vec3& inValue) const
+        {
+            return omp::HashLib::hashFloats(inValue.data(), inValue.size());
+        }
+    };
+
+    Vec3 position(const float* inPositions, size_t inStride, uint32_t inVertex)
+    {
+        const float* value = reinterpret_cast<const float*>(reinterpret_cast<const uint8_t*>(inPositions) + inVertex * inStride);
+        return {value[0], value[1], value[2]};
+    }
+
+    Vec3 subtract(const Vec3& inFirst, const Vec3& inSecond)
+    {
+        return {inFirst[0] - inSecond[0], inFirst[1] - inSecond[1], inFirst[2] - inSecond[2]};
+    }
+
+    Vec3 cross(const Vec3& inFirst, const Vec3& inSecond)
+    {
+        return {inFirst[1] * inSecond[2] - inFirst[2] * inSecond[1],
+                inFirst[2] * inSecond[0] - inFirst[0] * inSecond[2],
+                inFirst[0] * inSecond[1] - inFirst[1] * inSecond[0]};
+    }
+
+    float dot(const Vec3& inFirst, const Vec3& inSecond)
+    {
+        return inFirst[0] * inSecond[0] + inFirst[1] * inSecond[1] + inFirst[2] * inSecond[2];
+    }
+
+    Vec3 triangleNormal(const Vec3& inFirst, const Vec3& inSecond, const Vec3& inThird)
+    {
+        return cross(subtract(inSecond, inFirst), subtract(inThird, inFirst));
+    }
+
+    void computeBounds(const std::vector<uint32_t>& inIndices, const float* inPositions, size_t inStride, Vec3& outMin, Vec3& outMax)
+    {
+        outMin = {FLT_MAX, FLT_MAX, FLT_MAX};
+        outMax = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+        for (uint32_t vertex : inIndices)
+        {
+            const Vec3 value = position(inPositions, inStride, vertex);
+            for (size_t axis = 0; axis < 3; axis++)
+            {
+                outMin[axis] = std::min(outMin[axis], value[axis]);
+                outMax[axis] = std::max(outMax[axis], value[axis]);
+            }
+        }
+    }
+
+    // Area weighted sum of squared distances to triangle planes, symmetric matrix A, vector b and constant c
+    struct Quadric
+    {
+        float a00 = 0.0f, a01 = 0.0f, a02 = 0.0f, a11 = 0.0f, a12 = 0.0f, a22 = 0.0f;
+        float b0 = 0.0f, b1 = 0.0f, b2 = 0.0f;
+        float c = 0.0f;
+        float weight = 0.0f;
+
+        void addPlane(const Vec3& inNormal, float inDistance, float inWeight)
+        {
+            a00 += inWeight * inNormal[0] * inNormal[0];
+            a01 += inWeight * inNormal[0] * inNormal[1];
+            a02 += inWeight * inNormal[0] * inNormal[2];
+            a11 += inWeight * inNormal[1] * inNormal[1];
+            a12 += inWeight * inNormal[1] * inNormal[2];
+            a22 += inWeight * inNormal[2] * inNormal[2];
+            b0 += inWeight * inNormal[0] * inDistance;
+            b1 += inWeight * inNormal[1] * inDistance;
+            b2 += inWeight * inNormal[2] * inDistance;
+            c += inWeight * inDistance * inDistance;
+            weight += inWeight;
+        }
+
+        void add(const Quadric& inOther)
+        {
+            a00 += inOther.a00;
+            a01 += inOther.a01;
+            a02 += inOther.a02;
+            a11 += inOther.a11;
+            a12 += inOther.a12;
+            a22 += inOther.a22;
+            b0 += inOther.b0;
+            b1 += inOther.b1;
+            b2 += inOther.b2;
+            c += inOther.c;
+            weight += inOther.weight;
+        }
+
+        // Mean squared distance of inPoint to the planes, x^T A x + 2 b^T x + c divided by total area
+        float error(const Vec3& inPoint) const
+        {
+            const Vec3 transformed = {a00 * inPoint[0] + a01 * inPoint[1] + a02 * inPoint[2],
+                                      a01 * inPoint[0] + a11 * inPoint[1] + a12 * inPoint[2],
+                                      a02 * inPoint[0] + a12 * inPoint[1] + a22 * inPoint[2]};
+            const float value = dot(inPoint, transformed) + 2.0f * (b0 * inPoint[0] + b1 * inPoint[1] + b2 * inPoint[2]) + c;
+            return weight > 0.0f ? std::fabs(value) / weight : 0.0f;
+        }
+    };
+}
+
+std::vector<uint32_t> omp::MeshSimplifier::simplify(const std::vector<uint32_t>& inIndices, const float* inPositions, size_t inStride,
+                                                    size_t inVertexCount, size_t inTargetIndexCount, float inTargetError, float* outError)
+{
+    OMP_STAT_SCOPE("SimplifyMesh");
+
+    std::vector<uint32_t> indices = inIndices;
+    if (outError)
+    {
+        *outError = 0.0f;
+    }
+    if (indices.size() <= inTargetIndexCount)
+    {
+        return indices;
+    }
+
+    // Positions scaled to the unit box, errors come out relative to mesh extent
+    Vec3 min_bound;
+    Vec3 max_bound;
+    computeBounds(indices, inPositions, inStride, min_bound, max_bound);
+    const float scale = getScale(indices, inPositions, inStride);
+    const float inverse_scale = scale > 0.0f ? 1.0f / scale : 0.0f;
+    std::vector<Vec3> positions(inVertexCount);
+    for (uint32_t vertex = 0; vertex < inVertexCount; vertex++)
+    {
+        const Vec3 offset = subtract(position(inPositions, inStride, vertex), min_bound);
+        positions[vertex] = {offset[0] * inverse_scale, offset[1] * inverse_scale, offset[2] * inverse_scale};
+    }
+
+    // Vertices split by attributes share a position, the first of them stands for all in quadrics and locks
+    std::vector<uint32_t> position_remap(inVertexCount);
+    {
+        std::vector<Vec3> unique_positions;
+        std::vector<uint32_t> first_vertices;
+        omp::DedupTable<Vec3, Vec3Hash> unique_table(unique_positions, inVertexCount);
+        for (uint32_t vertex = 0; vertex < inVertexCount; vertex++)
+        {
+            const uint32_t unique = unique_table.insert(positions[vertex]);
+            if (unique == first_vertices.size())
+            {
+                first_vertices.push_back(vertex);
+            }
+            position_remap[vertex] = first_vertices[unique];
+        }
+    }
+
+    // Seams, where a position has more than one used vertex, are locked
+    std::vector<uint8_t> locked(inVertexCount, 0);
+    {
+        std::vector<uint32_t> first_used(inVertexCount, NONE);
+        for (uint32_t vertex : indices)
+        {
+            uint32_t& used = first_used[position_remap[vertex]];
+            if (used == NONE)
+            {
+                used = vertex;
+            }
+            else if (used != vertex)
+            {
+                locked[position_remap[vertex]] = 1;
+            }
+        }
+    }
+
+    // Borders and non manifold edges are locked, edge without its reverse is on a border
+    {
+        std::vector<uint64_t> edges;
+        edges.reserve(indices.size());
+        for (size_t corner = 0; corner < indices.size(); corner++)
+        {
+            const size_t next = corner % 3 == 2 ? corner - 2 : corner + 1;
+            edges.push_back(uint64_t{position_remap[indices[corner]]} << 32 | position_remap[indices[next]]);
+        }
+        std::sort(edges.begin(), edges.end());
+        for (size_t edge = 0; edge < edges.size(); edge++)
+        {
+            const uint64_t reverse = edges[edge] << 32 | edges[edge] >> 32;
+            const bool duplicate = (edge + 1 < edges.size() && edges[edge + 1] == edges[edge]) ||
+                                   (edge > 0 && edges[edge - 1] == edges[edge]);
+            if (duplicate || !std::binary_search(edges.begin(), edges.end(), reverse))
+            {
+                locked[static_cast<uint32_t>(edges[edge] >> 32)] = 1;
+                locked[static_cast<uint32_t>(edges[edge])] = 1;
+            }
+        }
+    }
+
+    std::vector<Quadric> quadrics(inVertexCount);
+    for (size_t triangle = 0; triangle < indices.size(); triangle += 3)
+    {
+        const Vec3& first = positions[indices[triangle]];
+        Vec3 normal = triangleNormal(first, positions[indices[triangle + 1]], positions[indices[triangle + 2]]);
+        const float length = std::sqrt(dot(normal, normal));
+        if (length == 0.0f)
+        {
+            continue;
+        }
+        normal = {normal[0] / length, normal[1] / length, normal[2] / length};
+        for (size_t corner = 0; corner < 3; corner++)
+        {
+            quadrics[position_remap[indices[triangle + corner]]].addPlane(normal, -dot(normal, first), length * 0.5f);
+        }
+    }
+
+    const size_t target_triangles = inTargetIndexCount / 3;
+    const float error_limit = inTargetError * inTargetError;
+    float max_cost = 0.0f;
+    bool error_reached = false;
+
+    std::vector<uint32_t> adjacency_offsets(inVertexCount + 1);
+    std::vector<uint32_t> adjacency;
+    std::vector<uint32_t> best_targets(inVertexCount);
+    std::vector<float> best_costs(inVertexCount);
+    std::vector<uint32_t> order;
+    std::vector<uint32_t> collapses(inVertexCount);
+    std::vector<uint8_t> touched(inVertexCount);
+
+    // Every pass collapses independent vertices in order of cost, then rewrites the indices
+    while (indices.size() / 3 > target_triangles && !error_reached)
+    {
+        std::fill(adjacency_offsets.begin(), adjacency_offsets.end(), 0);
+        for (uint32_t vertex : indices)
+        {
+            adjacency_offsets[vertex + 1]++;
+        }
+        std::partial_sum(adjacency_offsets.begin(), adjacency_offsets.end(), adjacency_offsets.begin());
+        adjacency.resize(indices.size());
+        {
+            std::vector<uint32_t> write_offsets(adjacency_offsets.begin(), adjacency_offsets.end() - 1);
+            for (size_t corner = 0; corner < indices.size(); corner++)
+            {
+                adjacency[write_offsets[indices[corner]]++] = static_cast<uint32_t>(corner / 3);
+            }
+        }
+
+        // Cheapest neighbour of every free vertex
+        std::fill(best_targets.begin(), best_targets.end(), NONE);
+        std::fill(best_costs.begin(), best_costs.end(), FLT_MAX);
+        for (size_t corner = 0; corner < indices.size(); corner++)
+        {
+            const size_t next = corner % 3 == 2 ? corner - 2 : corner + 1;
+            for (const std::array<uint32_t, 2>& edge : {std::array<uint32_t, 2>{indices[corner], indices[next]},
+                                                        std::array<uint32_t, 2>{indices[next], indices[corner]}})
+            {
+                const uint32_t source = edge[0];
+                const uint32_t target = edge[1];
+                if (locked[position_remap[source]] || position_remap[source] == position_remap[target])
+                {
+                    continue;
+                }
+                Quadric quadric = quadrics[source];
+                quadric.add(quadrics[position_remap[target]]);
+                const float cost = quadric.error(positions[target]);
+                if (cost < best_costs[source])
+                {
+                    best_costs[source] = cost;
+                    best_targets[source] = target;
+                }
+            }
+        }
+
+        order.clear();
+        for (uint32_t vertex = 0; vertex < inVertexCount; vertex++)
+        {
+            if (best_targets[vertex] != NONE)
+            {
+                order.push_back(vertex);
+            }
+        }
+        std::sort(order.begin(), order.end(), [&best_costs](uint32_t inFirst, uint32_t inSecond)
+        {
+            return best_costs[inFirst] < best_costs[inSecond];
+        });
+
+        std::iota(collapses.begin(), collapses.end(), 0);
+        std::fill(touched.begin(), touched.end(), 0);
+        size_t triangle_count = indices.size() / 3;
+        size_t collapse_count = 0;
+        for (uint32_t source : order)
+        {
+            if (triangle_count <= target_triangles)
+            {
+                break;
+            }
+            if (best_costs[source] > error_limit)
+            {
+                error_reached = true;
+                break;
+            }
+
+            const uint32_t target = best_targets[source];
+            const uint32_t target_position = position_remap[target];
+            if (touched[source] || touched[target_position])
+            {
+                continue;
+            }
+
+            // Triangles around source must keep their orientation, ones sharing the edge disappear
+            bool flipped = false;
+            size_t removed = 0;
+            for (uint32_t offset = adjacency_offsets[source]; offset < adjacency_offsets[source + 1] && !flipped; offset++)
+            {
+                const uint32_t* triangle = &indices[size_t{adjacency[offset]} * 3];
+                if (position_remap[triangle[0]] == target_position || position_remap[triangle[1]] == target_position ||
+                    position_remap[triangle[2]] == target_position)
+                {
+                    removed++;
+                    continue;
+                }
+
+                std::array<Vec3, 3> corners = {positions[triangle[0]], positions[triangle[1]], positions[triangle[2]]};
+                const Vec3 before = triangleNormal(corners[0], corners[1], corners[2]);
+                for (size_t corner = 0; corner < 3; corner++)
+                {
+                    corners[corner] = triangle[corner] == source ? positions[target] : corners[corner];
+                }
+                const Vec3 after = triangleNormal(corners[0], corners[1], corners[2]);
+                const float lengths = std::sqrt(dot(before, before) * dot(after, after));
+                flipped = lengths == 0.0f || dot(before, after) < MIN_NORMAL_COSINE * lengths;
+            }
+            if (flipped)
+            {
+                continue;
+            }
+
+            // Neighbours are frozen for this pass, so accepted collapses never see moved vertices
+            for (uint32_t offset = adjacency_offsets[source]; offset < adjacency_offsets[source + 1]; offset++)
+            {
+                for (size_t corner = 0; corner < 3; corner++)
+                {
+                    touched[position_remap[indices[size_t{adjacency[offset]} * 3 + corner]]] = 1;
+                }
+            }
+            collapses[source] = target;
+            quadrics[target_position].add(quadrics[source]);
+            max_cost = std::max(max_cost, best_costs[source]);
+            triangle_count -= removed;
+            collapse_count++;
+        }
+
+        if (collapse_count == 0)
+        {
+            break;
+        }
+
+        size_t write = 0;
+        for (size_t triangle = 0; triangle < indices.size(); triangle += 3)
+        {
+            const uint32_t first = collapses[indices[triangle]];
+            const uint32_t second = collapses[indices[triangle + 1]];
+            const uint32_t third = collapses[indices[triangle + 2]];
+            if (position_remap[first] == position_remap[second] || position_remap[second] == position_remap[third] ||
+                position_remap[first] == position_remap[third])
+            {
+                continue;
+            }
+            indices[write++] = first;
+            indices[write++] = second;
+            indices[write++] = third;
+        }
+        indices.resize(write);
+    }
+
+    if (outError)
+    {
+        *outError = std::sqrt(max_cost);
+    }
+    return indices;
+}
+
+float omp::MeshSimplifier::getScale(const std::vector<uint32_t>& inIndices, const float* inPositions, size_t inStride)
+{
+    if (inIndices.empty())
+    {
+        return 0.0f;
+    }
+
+    Vec3 min_bound;
+    Vec3 max_bound;
+    computeBounds(inIndices, inPositions, inStride, min_bound, max_bound);
+    return std::max({max_bound[0] - min_bound[0], max_bound[1] - min_bound[1], max_bound[2] - min_bound[2]});
+}
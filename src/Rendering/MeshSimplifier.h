@@ -0,0 +1,29 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace omp
+{
+    /*
+     * @brief Edge collapse simplification driven by quadric error metrics (Garland and Heckbert 1997), run at import to build LODs.
+     * Vertices collapse onto their neighbours instead of new positions, so every LOD indexes the vertex buffer of the full mesh.
+     * Border and attribute seam vertices never move, so LODs keep silhouettes of open meshes and texture seams intact.
+     */
+    class MeshSimplifier
+    {
+    public:
+        /*
+         * @brief Collapse edges in order of cost until inTargetIndexCount is reached or the next collapse would exceed inTargetError.
+         * Errors are distances relative to the mesh extent, outError receives the largest one used, may be null.
+         * inPositions points to x, y, z of the first vertex, inStride is the distance between vertices in bytes
+         */
+        static std::vector<uint32_t> simplify(const std::vector<uint32_t>& inIndices, const float* inPositions, size_t inStride,
+                                              size_t inVertexCount, size_t inTargetIndexCount, float inTargetError, float* outError);
+
+        /*
+         * @brief Largest side of the bounding box of referenced vertices, converts relative errors to mesh units
+         */
+        static float getScale(const std::vector<uint32_t>& inIndices, const float* inPositions, size_t inStride);
+    };
+}
@@ -0,0 +1,419 @@
+#include "Rendering/MeshletBuilder.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include "Rendering/MeshOptimizer.h"
+
+namespace
+{
+    using Vec3 = std::array<float, 3>;
+
+    const float* positionAt(const float* inPositions, size_t inStride, uint32_t inVertex)
+    {
+        return reinterpret_cast<const float*>(reinterpret_cast<const uint8_t*>(inPositions) + inVertex * inStride);
+    }
+
+    Vec3 load(const float* inPositions, size_t inStride, uint32_t inVertex)
+    {
+        const float* value = positionAt(inPositions, inStride, inVertex);
+        return {value[0], value[1], value[2]};
+    }
+
+    Vec3 subtract(const Vec3& inA, const Vec3& inB)
+    {
+        return {inA[0] - inB[0], inA[1] - inB[1], inA[2] - inB[2]};
+    }
+
+    float dot(const Vec3& inA, const Vec3& inB)
+    {
+        return inA[0] * inB[0] + inA[1] * inB[1] + inA[2] * inB[2];
+    }
+
+    // Unit normal of counter clockwise triangle, zero for degenerate ones
+    Vec3 triangleNormal(const Vec3& inA, const Vec3& inB, const Vec3& inC)
+    {
+        const Vec3 ab = subtract(inB, inA);
+        const Vec3 ac = subtract(inC, inA);
+        const Vec3 normal = {ab[1] * ac[2] - ab[2] * ac[1], ab[2] * ac[0] - ab[0] * ac[2], ab[0] * ac[1] - ab[1] * ac[0]};
+        const float length = std::sqrt(dot(normal, normal));
+        if (length <= FLT_MIN)
+        {
+            return {0.0f, 0.0f, 0.0f};
+        }
+        return {normal[0] / length, normal[1] / length, normal[2] / length};
+    }
+
+    /*
+     * @brief Sphere around meshlet vertices and normal cone of its triangles, apex is pushed back until
+     * every triangle plane is in front of it (meshoptimizer's cluster bounds)
+     */
+    void computeMeshletBounds(omp::Meshlet& ioMeshlet, const uint32_t* inIndices, const std::vector<uint32_t>& inVertices,
+                              const float* inPositions, size_t inStride)
+    {
+        std::vector<Vec3> normals(ioMeshlet.index_count / 3);
+        for (size_t triangle = 0; triangle < normals.size(); triangle++)
+        {
+            normals[triangle] = triangleNormal(load(inPositions, inStride, inIndices[triangle * 3]),
+                                               load(inPositions, inStride, inIndices[triangle * 3 + 1]),
+                                               load(inPositions, inStride, inIndices[triangle * 3 + 2]));
+        }
+
+        std::vector<Vec3> positions(inVertices.size());
+        for (size_t index = 0; index < inVertices.size(); index++)
+        {
+            positions[index] = load(inPositions, inStride, inVertices[index]);
+        }
+        ioMeshlet.sphere = omp::BoundsLib::compute(positions.front().data(), sizeof(Vec3), positions.size()).sphere;
+        ioMeshlet.cone_apex = ioMeshlet.sphere.center;
+
+        Vec3 axis = {0.0f, 0.0f, 0.0f};
+        for (const Vec3& normal : normals)
+        {
+            axis = {axis[0] + normal[0], axis[1] + normal[1], axis[2] + normal[2]};
+        }
+        const float axis_length = std::sqrt(dot(axis, axis));
+        if (axis_length <= FLT_MIN)
+        {
+            return;
+        }
+        axis = {axis[0] / axis_length, axis[1] / axis_length, axis[2] / axis_length};
+
+        float min_cosine = 1.0f;
+        for (const Vec3& normal : normals)
+        {
+            // Degenerate triangles draw nothing and don't bend the cone
+            if (dot(normal, normal) > 0.0f)
+            {
+                min_cosine = std::min(min_cosine, dot(normal, axis));
+            }
+        }
+        if (min_cosine <= omp::MeshletBuilder::MIN_CONE_COSINE)
+        {
+            return;
+        }
+
+        float max_distance = 0.0f;
+        for (size_t triangle = 0; triangle < normals.size(); triangle++)
+        {
+            const Vec3& normal = normals[triangle];
+            if (dot(normal, normal) > 0.0f)
+            {
+                const Vec3 corner = load(inPositions, inStride, inIndices[triangle * 3]);
+                const float distance = dot(subtract(ioMeshlet.sphere.center, corner), normal) / dot(axis, normal);
+                max_distance = std::max(max_distance, distance);
+            }
+        }
+
+        const Vec3& center = ioMeshlet.sphere.center;
+        ioMeshlet.cone_apex = {center[0] - axis[0] * max_distance, center[1] - axis[1] * max_distance, center[2] - axis[2] * max_distance};
+        ioMeshlet.cone_axis = axis;
+        ioMeshlet.cone_cutoff = std::sqrt(1.0f - min_cosine * min_cosine);
+    }
+}
+
+std::vector<omp::Meshlet> omp::MeshletBuilder::build(std::vector<uint32_t>& ioIndices, size_t inFirstIndex, size_t inIndexCount,
+                                                     const float* inPositions, size_t inStride, size_t inVertexCount)
+{
+    std::vector<omp::Meshlet> meshlets;
+    const size_t triangle_count = inIndexCount / 3;
+    if (triangle_count == 0 || inVertexCount == 0)
+    {
+        return meshlets;
+    }
+
+    const uint32_t* indices = ioIndices.data() + inFirstIndex;
+    std::vector<Vec3> normals(triangle_count);
+    std::vector<Vec3> centroids(triangle_count);
+    for (size_t triangle = 0; triangle < triangle_count; triangle++)
+    {
+        const Vec3 a = load(inPositions, inStride, indices[triangle * 3]);
+        const Vec3 b = load(inPositions, inStride, indices[triangle * 3 + 1]);
+        const Vec3 c = load(inPositions, inStride, indices[triangle * 3 + 2]);
+        normals[triangle] = triangleNormal(a, b, c);
+        centroids[triangle] = {(a[0] + b[0] + c[0]) / 3.0f, (a[1] + b[1] + c[1]) / 3.0f, (a[2] + b[2] + c[2]) / 3.0f};
+    }
+
+    // Triangles around every vertex, the first live_counts of each list are not in a meshlet yet
+    std::vector<uint32_t> offsets(inVertexCount + 1, 0);
+    for (size_t index = 0; index < triangle_count * 3; index++)
+    {
+        offsets[indices[index] + 1]++;
+    }
+    for (size_t vertex = 0; vertex < inVertexCount; vertex++)
+    {
+        offsets[vertex + 1] += offsets[vertex];
+    }
+    std::vector<uint32_t> live_counts(inVertexCount, 0);
+    std::vector<uint32_t> adjacency(triangle_count * 3);
+    for (size_t triangle = 0; triangle < triangle_count; triangle++)
+    {
+        for (size_t corner = 0; corner < 3; corner++)
+        {
+            const uint32_t vertex = indices[triangle * 3 + corner];
+            adjacency[offsets[vertex] + live_counts[vertex]++] = static_cast<uint32_t>(triangle);
+        }
+    }
+
+    std::vector<uint32_t> reordered;
+    reordered.reserve(triangle_count * 3);
+    std::vector<uint8_t> emitted(triangle_count, 0);
+    // Meshlet a vertex was last added to, so membership needs no clearing between meshlets
+    std::vector<uint32_t> vertex_meshlet(inVertexCount, UINT32_MAX);
+
+    std::vector<uint32_t> meshlet_vertices;
+    // Vertices of the last finished meshlet, next one starts on its border
+    std::vector<uint32_t> previous_vertices;
+    std::vector<uint32_t> meshlet_triangles;
+    std::vector<uint32_t> local_indices;
+    std::vector<uint32_t> local_vertex(inVertexCount, 0);
+    size_t seed_cursor = 0;
+
+    auto finishMeshlet = [&]()
+    {
+        omp::Meshlet meshlet;
+        meshlet.first_index = static_cast<uint32_t>(inFirstIndex + reordered.size());
+        meshlet.index_count = static_cast<uint32_t>(meshlet_triangles.size() * 3);
+        meshlet.vertex_count = static_cast<uint32_t>(meshlet_vertices.size());
+
+        // Meshlet is drawn as a range of the index buffer, so its triangles are ordered for the vertex cache on local indices
+        local_indices.clear();
+        for (uint32_t local = 0; local < meshlet_vertices.size(); local++)
+        {
+            local_vertex[meshlet_vertices[local]] = local;
+        }
+        for (uint32_t triangle : meshlet_triangles)
+        {
+            for (size_t corner = 0; corner < 3; corner++)
+            {
+                local_indices.push_back(local_vertex[indices[triangle * 3 + corner]]);
+            }
+        }
+        omp::MeshOptimizer::optimizeVertexCache(local_indices, meshlet_vertices.size());
+        for (uint32_t local : local_indices)
+        {
+            reordered.push_back(meshlet_vertices[local]);
+        }
+
+        computeMeshletBounds(meshlet, reordered.data() + (meshlet.first_index - inFirstIndex), meshlet_vertices, inPositions, inStride);
+        meshlets.push_back(meshlet);
+        std::swap(previous_vertices, meshlet_vertices);
+        meshlet_vertices.clear();
+        meshlet_triangles.clear();
+    };
+
+    auto emitTriangle = [&](uint32_t inTriangle)
+    {
+        const uint32_t meshlet_id = static_cast<uint32_t>(meshlets.size());
+        emitted[inTriangle] = 1;
+        meshlet_triangles.push_back(inTriangle);
+        for (size_t corner = 0; corner < 3; corner++)
+        {
+            const uint32_t vertex = indices[inTriangle * 3 + corner];
+            if (vertex_meshlet[vertex] != meshlet_id)
+            {
+                vertex_meshlet[vertex] = meshlet_id;
+                meshlet_vertices.push_back(vertex);
+            }
+
+            // Swap triangle out of the live part of the vertex list
+            uint32_t* list = adjacency.data() + offsets[vertex];
+            const uint32_t live = live_counts[vertex];
+            for (uint32_t entry = 0; entry < live; entry++)
+            {
+                if (list[entry] == inTriangle)
+                {
+                    std::swap(list[entry], list[live - 1]);
+                    live_counts[vertex]--;
+                    break;
+                }
+            }
+        }
+    };
+
+    // Sums over meshlet triangles, for its center and average normal
+    Vec3 centroid_sum = {0.0f, 0.0f, 0.0f};
+    Vec3 axis_sum = {0.0f, 0.0f, 0.0f};
+    auto accumulate = [&](uint32_t inTriangle)
+    {
+        const Vec3& normal = normals[inTriangle];
+        const Vec3& centroid = centroids[inTriangle];
+        axis_sum = {axis_sum[0] + normal[0], axis_sum[1] + normal[1], axis_sum[2] + normal[2]};
+        centroid_sum = {centroid_sum[0] + centroid[0], centroid_sum[1] + centroid[1], centroid_sum[2] + centroid[2]};
+    };
+
+    size_t triangles_left = triangle_count;
+    while (triangles_left > 0)
+    {
+        if (meshlet_triangles.empty())
+        {
+            // Triangle on the border of the previous meshlet with fewest live neighbours, so meshlets grow
+            // along each other and leave no holes to be filled by scraps. Input order is the fallback
+            uint32_t seed = UINT32_MAX;
+            uint32_t seed_live = UINT32_MAX;
+            for (uint32_t vertex : previous_vertices)
+            {
+                const uint32_t* list = adjacency.data() + offsets[vertex];
+                for (uint32_t entry = 0; entry < live_counts[vertex]; entry++)
+                {
+                    const uint32_t triangle = list[entry];
+                    const uint32_t live = live_counts[indices[triangle * 3]] + live_counts[indices[triangle * 3 + 1]] +
+                                          live_counts[indices[triangle * 3 + 2]];
+                    if (live < seed_live)
+                    {
+                        seed_live = live;
+                        seed = triangle;
+                    }
+                }
+            }
+            if (seed == UINT32_MAX)
+            {
+                while (emitted[seed_cursor])
+                {
+                    seed_cursor++;
+                }
+                seed = static_cast<uint32_t>(seed_cursor);
+            }
+
+            axis_sum = {0.0f, 0.0f, 0.0f};
+            centroid_sum = {0.0f, 0.0f, 0.0f};
+            accumulate(seed);
+            emitTriangle(seed);
+            triangles_left--;
+            continue;
+        }
+
+        // Triangle adding fewest new vertices, among equals the one closest to the meshlet center,
+        // with distance stretched for normals away from the meshlet normal. Compact meshlets have tight spheres and cones
+        const uint32_t meshlet_id = static_cast<uint32_t>(meshlets.size());
+        const float inverse_count = 1.0f / static_cast<float>(meshlet_triangles.size());
+        const Vec3 center = {centroid_sum[0] * inverse_count, centroid_sum[1] * inverse_count, centroid_sum[2] * inverse_count};
+        const float axis_length = std::max(std::sqrt(dot(axis_sum, axis_sum)), FLT_MIN);
+        uint32_t best_triangle = UINT32_MAX;
+        uint32_t best_priority = UINT32_MAX;
+        float best_score = FLT_MAX;
+        for (uint32_t vertex : meshlet_vertices)
+        {
+            const uint32_t* list = adjacency.data() + offsets[vertex];
+            for (uint32_t entry = 0; entry < live_counts[vertex]; entry++)
+            {
+                const uint32_t triangle = list[entry];
+                uint32_t extra = 0;
+                for (size_t corner = 0; corner < 3; corner++)
+                {
+                    extra += vertex_meshlet[indices[triangle * 3 + corner]] != meshlet_id ? 1U : 0U;
+                }
+                if (meshlet_vertices.size() + extra > MAX_VERTICES)
+                {
+                    continue;
+                }
+                // Triangle that is last user of a vertex would need that vertex again in another meshlet, so it goes first
+                const uint32_t* corners = indices + triangle * 3;
+                const bool dangling = live_counts[corners[0]] == 1 || live_counts[corners[1]] == 1 || live_counts[corners[2]] == 1;
+                const uint32_t priority = extra == 0 ? 0 : (dangling ? 1 : extra + 1);
+                if (priority > best_priority)
+                {
+                    continue;
+                }
+                const Vec3 offset = subtract(centroids[triangle], center);
+                const float score = dot(offset, offset) * (1.0f + CONE_WEIGHT * (1.0f - dot(normals[triangle], axis_sum) / axis_length));
+                if (priority < best_priority || score < best_score)
+                {
+                    best_priority = priority;
+                    best_score = score;
+                    best_triangle = triangle;
+                }
+            }
+        }
+
+        if (best_triangle == UINT32_MAX)
+        {
+            finishMeshlet();
+            continue;
+        }
+        accumulate(best_triangle);
+        emitTriangle(best_triangle);
+        triangles_left--;
+        if (meshlet_triangles.size() == MAX_TRIANGLES)
+        {
+            finishMeshlet();
+        }
+    }
+    if (!meshlet_triangles.empty())
+    {
+        finishMeshlet();
+    }
+
+    std::copy(reordered.begin(), reordered.end(), ioIndices.begin() + static_cast<std::ptrdiff_t>(inFirstIndex));
+    return meshlets;
+}
+
+omp::MeshletCullStatistics omp::MeshletBuilder::cull(const std::vector<omp::Meshlet>& inMeshlets, const float* inModel,
+                                                     const omp::Frustum& inFrustum, const std::array<float, 3>& inViewPosition,
+                                                     std::vector<omp::IndexRange>& outRanges)
+{
+    omp::MeshletCullStatistics statistics;
+
+    // Squared length of basis columns is squared scale along each local axis
+    std::array<float, 3> squared_scales{};
+    for (size_t column = 0; column < 3; column++)
+    {
+        const float* basis = inModel + column * 4;
+        squared_scales[column] = basis[0] * basis[0] + basis[1] * basis[1] + basis[2] * basis[2];
+    }
+    const float max_squared_scale = std::max({squared_scales[0], squared_scales[1], squared_scales[2]});
+    const float min_squared_scale = std::min({squared_scales[0], squared_scales[1], squared_scales[2]});
+    const float max_scale = std::sqrt(max_squared_scale);
+
+    // Rotation and uniform scale keep angles, so view position moves to mesh space and cones are tested as built.
+    // Mirroring flips winding and is left to the frustum test alone
+    const float determinant = inModel[0] * (inModel[5] * inModel[10] - inModel[9] * inModel[6])
+                              - inModel[4] * (inModel[1] * inModel[10] - inModel[9] * inModel[2])
+                              + inModel[8] * (inModel[1] * inModel[6] - inModel[5] * inModel[2]);
+    const bool test_cones = min_squared_scale > FLT_MIN && max_squared_scale - min_squared_scale <= max_squared_scale * 1e-4f && determinant > 0.0f;
+    Vec3 local_view{};
+    if (test_cones)
+    {
+        const Vec3 offset = {inViewPosition[0] - inModel[12], inViewPosition[1] - inModel[13], inViewPosition[2] - inModel[14]};
+        for (size_t column = 0; column < 3; column++)
+        {
+            const float* basis = inModel + column * 4;
+            local_view[column] = (basis[0] * offset[0] + basis[1] * offset[1] + basis[2] * offset[2]) / squared_scales[column];
+        }
+    }
+
+    for (const omp::Meshlet& meshlet : inMeshlets)
+    {
+        const Vec3& center = meshlet.sphere.center;
+        omp::BoundingSphere world_sphere;
+        for (size_t row = 0; row < 3; row++)
+        {
+            world_sphere.center[row] = inModel[row] * center[0] + inModel[4 + row] * center[1] + inModel[8 + row] * center[2] + inModel[12 + row];
+        }
+        world_sphere.radius = meshlet.sphere.radius * max_scale;
+        if (!omp::BoundsLib::isVisible(inFrustum, world_sphere))
+        {
+            statistics.frustum_culled++;
+            continue;
+        }
+
+        if (test_cones && meshlet.cone_cutoff < 1.0f)
+        {
+            const Vec3 direction = subtract(meshlet.cone_apex, local_view);
+            if (dot(direction, meshlet.cone_axis) >= meshlet.cone_cutoff * std::sqrt(dot(direction, direction)))
+            {
+                statistics.backface_culled++;
+                continue;
+            }
+        }
+
+        if (!outRanges.empty() && outRanges.back().first_index + outRanges.back().index_count == meshlet.first_index)
+        {
+            outRanges.back().index_count += meshlet.index_count;
+        }
+        else
+        {
+            outRanges.push_back(omp::IndexRange{meshlet.first_index, meshlet.index_count});
+        }
+    }
+    return statistics;
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Math/Bounds.h"
+
+namespace omp
+{
+    /*
+     * @brief Cluster of at most MeshletBuilder::MAX_VERTICES vertices and MAX_TRIANGLES triangles, contiguous in the index buffer
+     */
+    struct Meshlet
+    {
+        uint32_t first_index = 0;
+        uint32_t index_count = 0;
+        uint32_t vertex_count = 0;
+        BoundingSphere sphere;
+        // Every triangle faces away from a view position inside the cone of cone_axis behind cone_apex.
+        // Cutoff is sine of the widest normal angle, cutoff 1 is a meshlet too curved to cull
+        std::array<float, 3> cone_apex{};
+        std::array<float, 3> cone_axis{};
+        float cone_cutoff = 1.0f;
+    };
+
+    struct IndexRange
+    {
+        uint32_t first_index = 0;
+        uint32_t index_count = 0;
+    };
+
+    struct MeshletCullStatistics
+    {
+        size_t frustum_culled = 0;
+        size_t backface_culled = 0;
+    };
+
+    /*
+     * @brief Splits triangles into meshlets for culling below the draw level. Meshlets grow greedily over shared vertices
+     * and prefer compact patches facing along the meshlet, which keeps spheres small and normal cones narrow.
+     * Meshlets are drawn as index ranges, so triangles inside each one are reordered for the vertex cache
+     */
+    class MeshletBuilder
+    {
+    public:
+        static constexpr size_t MAX_VERTICES = 64;
+        static constexpr size_t MAX_TRIANGLES = 124;
+        // Normals further than this cosine from the axis leave no cone worth testing
+        static constexpr float MIN_CONE_COSINE = 0.1f;
+        // How much a triangle facing away from the meshlet normal counts as farther from its center
+        static constexpr float CONE_WEIGHT = 4.0f;
+
+        /*
+         * @brief Reorder triangles of inIndexCount indices at inFirstIndex so every meshlet is one range, and return the meshlets.
+         * inPositions points to x, y, z of the first vertex, inStride is the distance between vertices in bytes
+         */
+        static std::vector<Meshlet> build(std::vector<uint32_t>& ioIndices, size_t inFirstIndex, size_t inIndexCount,
+                                          const float* inPositions, size_t inStride, size_t inVertexCount);
+
+        /*
+         * @brief Append index ranges of meshlets visible from inViewPosition in inFrustum, both in world space, merging neighbours.
+         * inModel is the column major model matrix. Cones are tested only under uniform scale, other transforms bend them
+         */
+        static MeshletCullStatistics cull(const std::vector<Meshlet>& inMeshlets, const float* inModel, const Frustum& inFrustum,
+                                          const std::array<float, 3>& inViewPosition, std::vector<IndexRange>& outRanges);
+    };
+}
@@ -1,14 +1,42 @@
 #include "Model.h"
+#include <algorithm>
+#include <glm/gtc/matrix_transform.hpp>
 #include "Rendering/ModelStatics.h"
+#include "Rendering/VertexPacking.h"
+#include "Rendering/UploadQueue.h"
+#include "AssetSystem/ContentCache.h"
+
+omp::ModelBuffers::~ModelBuffers()
+{
+    // Arena is gone at shutdown, its buffers are destroyed whole
+    if (std::shared_ptr<omp::GeometryArena> geometry_arena = arena.lock())
+    {
+        geometry_arena->freeVertices(vertex_allocation);
+        geometry_arena->freeIndices(index_allocation);
+    }
+}
+
+bool omp::Model::isUploaded() const
+{
+    if (!m_Buffers)
+    {
+        return false;
+    }
+    std::shared_ptr<omp::VulkanContext> context = m_Context.lock();
+    return context && context->upload_queue->isComplete(m_Buffers->vertex_allocation.upload_ticket)
+           && context->upload_queue->isComplete(m_Buffers->index_allocation.upload_ticket);
+}
 
 omp::Model::Model()
-        : m_Name("NONE")
+        : m_Mesh(std::make_shared<omp::MeshData>())
+        , m_Name("NONE")
 {
 
 }
 
 omp::Model::Model(const std::string& path)
-        : m_Name("NONE")
+        : m_Mesh(std::make_shared<omp::MeshData>())
+        , m_Name("NONE")
 {
     m_Loaded = omp::ModelImporter::loadModel(this, path);
 }
@@ -16,119 +44,178 @@ omp::Model::Model(const std::string& path)
 void omp::Model::serialize(JsonParser<>& parser)
 {
     parser.writeValue("ContentPath", m_Path);
+    parser.writeValue("PackedVertices", m_PackVertices);
+    parser.writeValue("Residency", omp::residencyToString(m_Residency));
+    parser.writeValue("BoundsMin", std::vector<float>(m_Bounds.box.min.begin(), m_Bounds.box.min.end()));
+    parser.writeValue("BoundsMax", std::vector<float>(m_Bounds.box.max.begin(), m_Bounds.box.max.end()));
+    parser.writeValue("BoundsCenter", std::vector<float>(m_Bounds.sphere.center.begin(), m_Bounds.sphere.center.end()));
+    parser.writeValue("BoundsRadius", m_Bounds.sphere.radius);
 }
 
 void omp::Model::deserialize(JsonParser<>& parser)
 {
     m_Path = parser.readValue<std::string>("ContentPath").value_or("");
+    m_PackVertices = parser.readValue<bool>("PackedVertices").value_or(false);
+    m_Residency = omp::residencyFromString(parser.readValue<std::string>("Residency").value_or(""));
+    readBounds(parser);
 
     if (!m_Path.empty())
     {
-        m_Loaded = omp::ModelImporter::loadModel(this, m_Path);
+        m_Loaded = omp::ModelImporter::loadModel(this, m_Path, getThreadPool());
     }
 }
 
-void omp::Model::addVertex(const omp::Vertex& inVertex)
+void omp::Model::appendSourceFiles(const JsonParser<>& parser, std::vector<std::string>& outPaths)
 {
-    m_Vertices.emplace_back(std::move(inVertex));
+    std::string path = parser.readValue<std::string>("ContentPath").value_or("");
+    if (!path.empty())
+    {
+        outPaths.push_back(std::move(path));
+    }
 }
 
-void omp::Model::addVertices(const std::vector<Vertex>& inVertices)
+void omp::Model::readBounds(const JsonParser<>& parser)
 {
-    m_Vertices = std::move(inVertices);
-}
+    const std::vector<float> min = parser.readValue<std::vector<float>>("BoundsMin").value_or(std::vector<float>{});
+    const std::vector<float> max = parser.readValue<std::vector<float>>("BoundsMax").value_or(std::vector<float>{});
+    const std::vector<float> center = parser.readValue<std::vector<float>>("BoundsCenter").value_or(std::vector<float>{});
+    if (min.size() != 3 || max.size() != 3 || center.size() != 3)
+    {
+        return;
+    }
 
-void omp::Model::addIndex(uint32_t inIndex)
-{
-    m_Indices.push_back(inIndex);
+    std::copy(min.begin(), min.end(), m_Bounds.box.min.begin());
+    std::copy(max.begin(), max.end(), m_Bounds.box.max.begin());
+    std::copy(center.begin(), center.end(), m_Bounds.sphere.center.begin());
+    m_Bounds.sphere.radius = parser.readValue<float>("BoundsRadius").value_or(0.0f);
 }
 
-void omp::Model::addIndices(const std::vector<uint32_t>& inIndices)
+void omp::Model::setMeshData(const std::shared_ptr<omp::MeshData>& inMesh, const omp::Hash128& inHash)
 {
-    m_Indices = inIndices;
+    m_Mesh = inMesh;
+    m_ContentHash = inHash;
+    m_CpuReleased = false;
+    // Imported mesh is the source of truth, saved bounds may be from an older file
+    m_Bounds = inMesh->bounds;
 }
 
-void omp::Model::loadVertexToMemory()
+void omp::Model::releaseCpuData()
 {
-    VkDeviceSize buffer_size = sizeof(getVertices()[0]) * getVertices().size();
-
-    // Vertex buffer
-    VkBuffer staging_buffer;
-    VkDeviceMemory staging_memory;
-
-    if (m_Context.expired())
+    if (m_CpuReleased || !m_Mesh)
     {
         return;
     }
 
-    std::shared_ptr<omp::VulkanContext> context = m_Context.lock();
-
-    context->createBuffer(
-            buffer_size,
-            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-            staging_buffer, staging_memory);
-
-    void* data;
-    vkMapMemory(context->logical_device, staging_memory, 0, buffer_size, 0, &data);
-    memcpy(data, getVertices().data(), static_cast<size_t>(buffer_size));
-    vkUnmapMemory(context->logical_device, staging_memory);
+    // Mesh may be shared through ContentCache, this model only drops its reference
+    std::shared_ptr<omp::MeshData> resident = std::make_shared<omp::MeshData>();
+    resident->lods = m_Mesh->lods;
+    resident->meshlets = m_Mesh->meshlets;
+    resident->bounds = m_Mesh->bounds;
+    if (resident->lods.empty())
+    {
+        resident->lods.push_back(omp::MeshLod{0, static_cast<uint32_t>(m_Mesh->indices.size()), 0.0f});
+    }
+    m_Mesh = std::move(resident);
+    m_CpuReleased = true;
+}
 
-    context->createBuffer(
-            buffer_size,
-            VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-            m_VertexBuffer, m_VertexMemory);
+bool omp::Model::ensureCpuData()
+{
+    if (m_CpuReleased && !m_Path.empty())
+    {
+        m_Loaded = omp::ModelImporter::loadModel(this, m_Path, getThreadPool());
+    }
+    return hasCpuData();
+}
 
-    context->copyBuffer(staging_buffer, m_VertexBuffer, buffer_size);
+omp::MeshLod omp::Model::selectLod(float inMaxError) const
+{
+    const std::vector<omp::MeshLod>& lods = m_Mesh->lods;
+    if (lods.empty())
+    {
+        return omp::MeshLod{0, static_cast<uint32_t>(m_Mesh->indices.size()), 0.0f};
+    }
 
-    vkDestroyBuffer(context->logical_device, staging_buffer, nullptr);
-    vkFreeMemory(context->logical_device, staging_memory, nullptr);
+    size_t level = 0;
+    while (level + 1 < lods.size() && lods[level + 1].error <= inMaxError)
+    {
+        level++;
+    }
+    return lods[level];
 }
 
-void omp::Model::loadIndexToMemory()
+omp::Hash128 omp::Model::getBuffersHash() const
 {
-    // Index buffer
-    VkDeviceSize buffer_size = sizeof(getIndices()[0]) * getIndices().size();
-
-    VkBuffer staging_buffer;
-    VkDeviceMemory staging_memory;
+    if (!m_PackVertices || !m_ContentHash.isValid())
+    {
+        return m_ContentHash;
+    }
+    return omp::HashLib::hash128(&m_ContentHash, sizeof(m_ContentHash), 1);
+}
 
-    std::shared_ptr<omp::VulkanContext> context = m_Context.lock();
+void omp::Model::loadVertexToMemory(omp::ModelBuffers& outBuffers)
+{
+    // Full layout is uploaded as is, packed layouts are encoded into a temporary
+    const void* vertex_data = getVertices().data();
+    VkDeviceSize buffer_size = sizeof(getVertices()[0]) * getVertices().size();
+    std::vector<uint8_t> packed_vertices;
+    if (m_PackVertices && !getVertices().empty())
+    {
+        const float* vertices = &getVertices().front().pos.x;
+        std::array<float, 3> min_bound{};
+        std::array<float, 3> scale{};
+        omp::VertexPacking::computeQuantization(vertices, getVertices().size(), min_bound, scale);
+        outBuffers.vertex_layout = omp::VertexPacking::hasVertexColors(vertices, getVertices().size())
+                                   ? omp::EVertexLayout::PackedColor : omp::EVertexLayout::Packed;
+        outBuffers.dequantization = glm::scale(glm::translate(glm::mat4(1.0f), glm::vec3(min_bound[0], min_bound[1], min_bound[2])),
+                                               glm::vec3(scale[0], scale[1], scale[2]));
+
+        packed_vertices = omp::VertexPacking::packVertices(vertices, getVertices().size(), outBuffers.vertex_layout, min_bound, scale);
+        vertex_data = packed_vertices.data();
+        buffer_size = packed_vertices.size();
+    }
 
-    context->createBuffer(
-            buffer_size,
-            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-            staging_buffer, staging_memory);
+    // Range in the shared vertex buffer, aligned to the stride so it maps to vertexOffset
+    std::shared_ptr<omp::GeometryArena> geometry_arena = outBuffers.arena.lock();
+    if (!geometry_arena)
+    {
+        return;
+    }
+    outBuffers.vertex_stride = omp::VertexPacking::getVertexSize(outBuffers.vertex_layout);
+    outBuffers.vertex_allocation = geometry_arena->uploadVertices(vertex_data, buffer_size, outBuffers.vertex_stride);
 
-    void* data;
-    vkMapMemory(context->logical_device, staging_memory, 0, buffer_size, 0, &data);
-    memcpy(data, getIndices().data(), static_cast<size_t>(buffer_size));
-    vkUnmapMemory(context->logical_device, staging_memory);
+    outBuffers.byte_size += static_cast<size_t>(buffer_size);
+}
 
-    context->createBuffer(
-            buffer_size,
-            VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-            m_IndexBuffer, m_IndexMemory);
+void omp::Model::loadIndexToMemory(omp::ModelBuffers& outBuffers)
+{
+    // Index buffer, 16 bit when every vertex fits
+    const void* index_data = getIndices().data();
+    VkDeviceSize buffer_size = sizeof(getIndices()[0]) * getIndices().size();
+    std::vector<uint16_t> short_indices;
+    if (getVertices().size() <= omp::VertexPacking::MAX_SHORT_INDEX_VERTICES)
+    {
+        short_indices = omp::VertexPacking::packIndices(getIndices());
+        outBuffers.index_type = VK_INDEX_TYPE_UINT16;
+        index_data = short_indices.data();
+        buffer_size = sizeof(uint16_t) * short_indices.size();
+    }
 
-    context->copyBuffer(staging_buffer, m_IndexBuffer, buffer_size);
+    std::shared_ptr<omp::GeometryArena> geometry_arena = outBuffers.arena.lock();
+    if (!geometry_arena)
+    {
+        return;
+    }
+    const VkDeviceSize index_size = outBuffers.index_type == VK_INDEX_TYPE_UINT16 ? sizeof(uint16_t) : sizeof(uint32_t);
+    outBuffers.index_allocation = geometry_arena->uploadIndices(index_data, buffer_size, index_size);
 
-    vkDestroyBuffer(context->logical_device, staging_buffer, nullptr);
-    vkFreeMemory(context->logical_device, staging_memory, nullptr);
+    outBuffers.byte_size += static_cast<size_t>(buffer_size);
 }
 
 void omp::Model::tryClear()
 {
-    if (!m_Context.expired())
-    {
-        auto context = m_Context.lock();
-        vkDestroyBuffer(context->logical_device, m_IndexBuffer, nullptr);
-        vkDestroyBuffer(context->logical_device, m_VertexBuffer, nullptr);
-        vkFreeMemory(context->logical_device, m_IndexMemory, nullptr);
-        vkFreeMemory(context->logical_device, m_VertexMemory, nullptr);
-    }
+    // Buffers destroyed with last model referencing them
+    m_Buffers.reset();
     m_Context.reset();
 }
 
@@ -150,17 +237,38 @@ void omp::Model::loadToGpuMemory(const std::shared_ptr<omp::VulkanContext>& cont
 
     if (!m_Loaded)
     {
-        m_Loaded = omp::ModelImporter::loadModel(this, m_Path);
+        m_Loaded = omp::ModelImporter::loadModel(this, m_Path, getThreadPool());
+    }
+
+    if (!omp::uploadsToGpu(m_Residency))
+    {
+        return;
     }
 
     if (m_Loaded)
     {
-        loadVertexToMemory();
-        loadIndexToMemory();
+        // Released vertices are imported again only when GPU buffers are not cached
+        m_Buffers = omp::ContentCache::acquireGpu<omp::ModelBuffers>(omp::EContentType::Mesh, getBuffersHash(),
+            [this, &context]() -> std::shared_ptr<omp::ModelBuffers>
+            {
+                if (!ensureCpuData())
+                {
+                    return nullptr;
+                }
+                auto buffers = std::make_shared<omp::ModelBuffers>(context->geometry_arena);
+                loadVertexToMemory(*buffers);
+                loadIndexToMemory(*buffers);
+                return buffers;
+            });
+
+        // Vertices are in staging memory once upload is recorded, they aren't needed for the copy
+        if (m_Buffers && !omp::keepsCpuCopy(m_Residency))
+        {
+            releaseCpuData();
+        }
     }
     else
     {
         ERROR(LogIO, "Cant load Model to GPU, because 3D model file not loaded");
     }
 }
-
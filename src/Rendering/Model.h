@@ -5,7 +5,15 @@
 #include "Material.h"
 #include "MaterialInstance.h"
 #include <array>
+#include <cstring>
+#include "AssetSystem/Residency.h"
 #include "IO/SerializableObject.h"
+#include "Math/Bounds.h"
+#include "Math/Hash.h"
+#include "Rendering/GeometryArena.h"
+#include "Rendering/MeshletBuilder.h"
+#include "Rendering/VertexPacking.h"
+#include <memory>
 #include <vector>
 
 namespace omp
@@ -13,10 +21,16 @@ namespace omp
     class Model;
 
     struct Vertex;
-    struct ModelPushConstant;
+    struct MeshLod;
+    struct InstanceData;
+    struct MeshData;
+    struct ModelBuffers;
 }
 
-struct omp::ModelPushConstant
+/*
+ * @brief Per instance values of a draw, laid out as InstanceData in shaders/instance_input.glsl (std430, 128 bytes)
+ */
+struct omp::InstanceData
 {
     glm::mat4 model;
 
@@ -25,8 +39,10 @@ struct omp::ModelPushConstant
     glm::vec4 specular{3};
 
     uint32_t id = 4;
+    uint32_t unused[3]{};
 
-    ModelPushConstant(const glm::mat4& inModel, const glm::vec4& inAmbient, const glm::vec4& inDiffusive, const glm::vec4& inSpecular, uint32_t inId)
+    InstanceData() = default;
+    InstanceData(const glm::mat4& inModel, const glm::vec4& inAmbient, const glm::vec4& inDiffusive, const glm::vec4& inSpecular, uint32_t inId)
         : model(inModel)
         , ambient(inAmbient)
         , diffusive(inDiffusive)
@@ -36,6 +52,7 @@ struct omp::ModelPushConstant
 
     }
 };
+static_assert(sizeof(omp::InstanceData) == 128, "InstanceData must match the std430 stride of the shader struct");
 
 struct omp::Vertex
 {
@@ -44,18 +61,35 @@ struct omp::Vertex
     glm::vec2 tex_coord;
     glm::vec3 normal;
 
-    static VkVertexInputBindingDescription GetBindingDescription()
+    static VkVertexInputBindingDescription GetBindingDescription(EVertexLayout inLayout = EVertexLayout::Full)
     {
         VkVertexInputBindingDescription binding_description{};
         binding_description.binding = 0;
-        binding_description.stride = sizeof(Vertex);
+        binding_description.stride = static_cast<uint32_t>(VertexPacking::getVertexSize(inLayout));
         binding_description.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
         return binding_description;
     }
 
-    static std::array<VkVertexInputAttributeDescription, 4> GetAttributeDescriptions()
+    /*
+     * @brief Locations match for every layout, position 0, color 1, texture coordinates 2, normal 3.
+     * Packed layouts need shader variants, they have octahedral normals in two components and may have no color
+     */
+    static std::vector<VkVertexInputAttributeDescription> GetAttributeDescriptions(EVertexLayout inLayout = EVertexLayout::Full)
     {
-        std::array<VkVertexInputAttributeDescription, 4> attribute_descriptions{};
+        if (inLayout == EVertexLayout::Packed || inLayout == EVertexLayout::PackedColor)
+        {
+            std::vector<VkVertexInputAttributeDescription> attribute_descriptions{
+                    {0, 0, VK_FORMAT_R16G16B16A16_UNORM, static_cast<uint32_t>(offsetof(PackedVertex, pos))},
+                    {2, 0, VK_FORMAT_R16G16_SFLOAT, static_cast<uint32_t>(offsetof(PackedVertex, tex_coord))},
+                    {3, 0, VK_FORMAT_R16G16_SNORM, static_cast<uint32_t>(offsetof(PackedVertex, normal))}};
+            if (inLayout == EVertexLayout::PackedColor)
+            {
+                attribute_descriptions.push_back({1, 0, VK_FORMAT_R8G8B8A8_UNORM, static_cast<uint32_t>(offsetof(PackedColorVertex, color))});
+            }
+            return attribute_descriptions;
+        }
+
+        std::vector<VkVertexInputAttributeDescription> attribute_descriptions(4);
         attribute_descriptions[0].binding = 0;
         attribute_descriptions[0].location = 0;
         attribute_descriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
@@ -90,15 +124,74 @@ namespace std
     template<>
     struct hash<omp::Vertex>
     {
+        // Every member is hashed in one pass
         size_t operator()(omp::Vertex const& vertex) const
         {
-            return ((hash<glm::vec3>()(vertex.pos) ^
-                     (hash<glm::vec3>()(vertex.color) << 1)) >> 1) ^
-                   (hash<glm::vec2>()(vertex.tex_coord) << 1);//TODO add normal
+            static_assert(sizeof(omp::Vertex) == 11 * sizeof(float), "Vertex has padding or non float members");
+            std::array<float, 11> values;
+            std::memcpy(values.data(), &vertex, sizeof(vertex));
+            return omp::HashLib::hashFloats(values.data(), values.size());
         }
     };
 }
 
+/**
+ * @brief Range of MeshData indices drawn for one level of detail
+ */
+struct omp::MeshLod
+{
+    uint32_t first_index = 0;
+    uint32_t index_count = 0;
+    // Deviation from the full mesh in mesh units, grows with level
+    float error = 0.0f;
+};
+
+/**
+ * @brief Imported geometry, shared between models with same source content
+ */
+struct omp::MeshData
+{
+    std::vector<Vertex> vertices;
+    // Indices of every LOD one after another, all of them index the same vertices
+    std::vector<uint32_t> indices;
+    // LOD 0 is the full mesh
+    std::vector<MeshLod> lods;
+    // Local space bounds of every vertex, LODs share them
+    omp::Bounds bounds;
+    // Ranges of LOD 0 indices with their culling bounds
+    std::vector<Meshlet> meshlets;
+
+    size_t getByteSize() const
+    {
+        return vertices.size() * sizeof(Vertex) + indices.size() * sizeof(uint32_t) + meshlets.size() * sizeof(Meshlet);
+    }
+};
+
+/**
+ * @brief GPU buffers of uploaded mesh, shared between models with same source content
+ */
+struct omp::ModelBuffers
+{
+    // Ranges in the shared GeometryArena buffers
+    omp::GeometryAllocation vertex_allocation;
+    omp::GeometryAllocation index_allocation;
+    VkDeviceSize vertex_stride = sizeof(Vertex);
+    size_t byte_size = 0;
+    omp::EVertexLayout vertex_layout = omp::EVertexLayout::Full;
+    VkIndexType index_type = VK_INDEX_TYPE_UINT32;
+    // Maps packed positions back to mesh space, applied before the model transform
+    glm::mat4 dequantization{1.0f};
+    std::weak_ptr<omp::GeometryArena> arena;
+
+    explicit ModelBuffers(const std::shared_ptr<omp::GeometryArena>& inArena)
+        : arena(inArena) {}
+    ModelBuffers(const ModelBuffers&) = delete;
+    ModelBuffers& operator=(const ModelBuffers&) = delete;
+    ~ModelBuffers();
+
+    size_t getByteSize() const { return byte_size; }
+};
+
 class omp::Model : public SerializableObject
 {
 public:
@@ -112,34 +205,40 @@ public:
 
     virtual void serialize(JsonParser<>& parser) override;
     virtual void deserialize(JsonParser<>& parser) override;
+    static void appendSourceFiles(const JsonParser<>& parser, std::vector<std::string>& outPaths);
 
 private:
-    void loadVertexToMemory();
-    void loadIndexToMemory();
+    void loadVertexToMemory(omp::ModelBuffers& outBuffers);
+    void loadIndexToMemory(omp::ModelBuffers& outBuffers);
     void tryClear();
 
-    void addVertex(const omp::Vertex& inVertex);
-    void addVertices(const std::vector<Vertex>& inVertices);
-    void addIndex(uint32_t inIndex);
-    void addIndices(const std::vector<uint32_t>& inIndices);
+    void setMeshData(const std::shared_ptr<omp::MeshData>& inMesh, const omp::Hash128& inHash);
+    // Keeps only what drawing reads, LODs, meshlets and bounds, vertices and indices are dropped
+    void releaseCpuData();
+    void readBounds(const JsonParser<>& parser);
+    // Key of GPU buffers, packed and full uploads of same content are separate entries
+    omp::Hash128 getBuffersHash() const;
 
     // State //
     // ===== //
-    std::vector<Vertex> m_Vertices;
-    std::vector<uint32_t> m_Indices;
+    std::shared_ptr<omp::MeshData> m_Mesh;
+    omp::Hash128 m_ContentHash{};
+    // Saved with the asset, so they are known before the mesh is imported
+    omp::Bounds m_Bounds;
 
     std::string m_Name;
     std::string m_Path;
 
     std::weak_ptr<omp::VulkanContext> m_Context{};
 
-    VkBuffer m_IndexBuffer;
-    VkDeviceMemory m_IndexMemory;
-
-    VkBuffer m_VertexBuffer;
-    VkDeviceMemory m_VertexMemory;
+    std::shared_ptr<omp::ModelBuffers> m_Buffers;
 
     bool m_Loaded = false;
+    // Vertices and indices were dropped after upload, see EResidency
+    bool m_CpuReleased = false;
+    // Upload vertices quantized, see PackedVertex
+    bool m_PackVertices = false;
+    omp::EResidency m_Residency = omp::EResidency::GpuOnly;
 
 public:
     // Methods //
@@ -152,13 +251,47 @@ public:
     const std::string& getName() const { return m_Name; }
     const std::string& getPath() const { return m_Path; }
     bool isLoaded() const { return m_Loaded; }
+    // Buffers exist and their upload batch has finished
+    bool isUploaded() const;
+
+    /*
+     * @brief Imports mesh again when vertices and indices were released after upload,
+     * call before reading them outside of upload
+     */
+    bool ensureCpuData();
+    bool hasCpuData() const { return m_Loaded && !m_CpuReleased; }
+
+    const std::vector<Vertex>& getVertices() const { return m_Mesh->vertices; }
+
+    const std::vector<uint32_t>& getIndices() const { return m_Mesh->indices; }
 
-    const std::vector<Vertex>& getVertices() const { return m_Vertices; }
+    const std::vector<omp::Meshlet>& getMeshlets() const { return m_Mesh->meshlets; }
+
+    /*
+     * @brief Coarsest LOD with error under inMaxError mesh units, whole index buffer when mesh has no LODs
+     */
+    omp::MeshLod selectLod(float inMaxError) const;
+
+    const omp::Hash128& getContentHash() const { return m_ContentHash; }
+    const omp::Bounds& getBounds() const { return m_Bounds; }
+
+    // Offsets of this model in the arena buffers, in vertices and indices
+    int32_t getVertexOffset() const { return static_cast<int32_t>(m_Buffers->vertex_allocation.offset / m_Buffers->vertex_stride); }
+    uint32_t getFirstIndex() const
+    {
+        return static_cast<uint32_t>(m_Buffers->index_allocation.offset / (m_Buffers->index_type == VK_INDEX_TYPE_UINT16 ? 2U : 4U));
+    }
+    VkIndexType getIndexType() const { return m_Buffers->index_type; }
+    omp::EVertexLayout getVertexLayout() const { return m_Buffers->vertex_layout; }
+    const glm::mat4& getDequantization() const { return m_Buffers->dequantization; }
 
-    const std::vector<uint32_t>& getIndices() const { return m_Indices; }
+    // Takes effect on next upload
+    void setPackVertices(bool inPackVertices) { m_PackVertices = inPackVertices; }
+    bool getPackVertices() const { return m_PackVertices; }
 
-    VkBuffer& getVertexBuffer() { return m_VertexBuffer; }
-    VkBuffer& getIndexBuffer() { return m_IndexBuffer; }
+    // Takes effect on next upload
+    void setResidency(omp::EResidency inResidency) { m_Residency = inResidency; }
+    omp::EResidency getResidency() const { return m_Residency; }
 
     friend class ModelImporter;
 };
@@ -1,4 +1,7 @@
 #include "ModelInstance.h"
+#include <algorithm>
+#include <cfloat>
+#include "glm/gtc/type_ptr.hpp"
 #include "glm/gtx/quaternion.hpp"
 
 glm::vec3& omp::ModelInstance::getPosition()
@@ -25,6 +28,48 @@ glm::mat4 omp::ModelInstance::getTransform() const
            * glm::scale(glm::mat4(1.0f), m_Scale);
 }
 
+const omp::Bounds& omp::ModelInstance::getWorldBounds() const
+{
+    if (!m_Model)
+    {
+        m_WorldBounds = omp::Bounds{};
+        m_WorldBoundsValid = false;
+        return m_WorldBounds;
+    }
+
+    const omp::Bounds& local_bounds = m_Model->getBounds();
+    if (m_WorldBoundsValid && m_WorldBoundsTranslation == m_Translation && m_WorldBoundsRotation == m_Rotation
+        && m_WorldBoundsScale == m_Scale && m_WorldBoundsSource == local_bounds)
+    {
+        return m_WorldBounds;
+    }
+
+    const glm::mat4 transform = getTransform();
+    m_WorldBounds = omp::BoundsLib::transform(local_bounds, glm::value_ptr(transform));
+    m_WorldBoundsSource = local_bounds;
+    m_WorldBoundsTranslation = m_Translation;
+    m_WorldBoundsRotation = m_Rotation;
+    m_WorldBoundsScale = m_Scale;
+    m_WorldBoundsValid = true;
+    return m_WorldBounds;
+}
+
+omp::MeshLod omp::ModelInstance::selectLod(const glm::vec3& inViewPosition, float inPixelsPerUnit) const
+{
+    if (!m_Model)
+    {
+        return omp::MeshLod{};
+    }
+
+    // Mesh units covered by LOD_PIXEL_ERROR pixels at this distance, largest scale axis is the worst case.
+    // Distance is measured to bounds center, pivot of the model may be far from its geometry
+    const std::array<float, 3>& center = getWorldBounds().sphere.center;
+    const float scale = std::max({std::abs(m_Scale.x), std::abs(m_Scale.y), std::abs(m_Scale.z)});
+    const float distance = glm::distance(inViewPosition, glm::vec3(center[0], center[1], center[2]));
+    const float pixels_per_mesh_unit = inPixelsPerUnit * scale / std::max(distance, FLT_MIN);
+    return m_Model->selectLod(LOD_PIXEL_ERROR / std::max(pixels_per_mesh_unit, FLT_MIN));
+}
+
 omp::ModelInstance::ModelInstance()
 {
 
@@ -11,6 +11,10 @@ namespace omp
 {
     class ModelInstance
     {
+    public:
+        // LOD errors are allowed to shift the silhouette by this many pixels
+        static constexpr float LOD_PIXEL_ERROR = 1.0f;
+
     private:
         std::string m_Name;
 
@@ -21,6 +25,15 @@ namespace omp
 
         std::shared_ptr<MaterialInstance> m_MaterialInstance = nullptr;
         std::shared_ptr<Model> m_Model;
+
+        // World bounds and the transform and local bounds they were computed from.
+        // Transform is edited through references, so staleness is found by comparing
+        mutable omp::Bounds m_WorldBounds;
+        mutable omp::Bounds m_WorldBoundsSource;
+        mutable glm::vec3 m_WorldBoundsTranslation = glm::vec3(0.f);
+        mutable glm::vec3 m_WorldBoundsRotation = glm::vec3(0.f);
+        mutable glm::vec3 m_WorldBoundsScale = glm::vec3(0.f);
+        mutable bool m_WorldBoundsValid = false;
     public:
         ModelInstance();
         ModelInstance(const std::shared_ptr<omp::Model>& inModel);
@@ -41,6 +54,17 @@ namespace omp
 
         glm::mat4 getTransform() const;
 
+        /*
+         * @brief Model bounds in world space, recomputed when transform or model bounds changed since last call
+         */
+        const omp::Bounds& getWorldBounds() const;
+
+        /*
+         * @brief LOD of the model for the current view, inPixelsPerUnit is viewport height over 2 * tan(fov / 2),
+         * so the model projects to size / distance * inPixelsPerUnit pixels
+         */
+        omp::MeshLod selectLod(const glm::vec3& inViewPosition, float inPixelsPerUnit) const;
+
         glm::vec3& getPosition();
         glm::vec3& getRotation();
         glm::vec3& getScale();
@@ -1,25 +1,180 @@
 #include "ModelStatics.h"
+#include <cstring>
+#include <filesystem>
+#include <sstream>
 #include "tiny_obj_loader.h"
 #include "Core/Profiling.h"
+#include "AssetSystem/ContentCache.h"
+#include "IO/MappedFile.h"
+#include "IO/ObjParser.h"
+#include "Math/Bounds.h"
+#include "Math/DedupTable.h"
+#include "Rendering/MeshOptimizer.h"
+#include "Rendering/MeshletBuilder.h"
+#include "Rendering/MeshSimplifier.h"
 
-bool omp::ModelImporter::loadModel(omp::Model* model, const std::string& inPath)
+static_assert(sizeof(omp::Vertex) == omp::ObjParser::VERTEX_FLOATS * sizeof(float), "ObjParser writes vertices in omp::Vertex layout");
+
+bool omp::ModelImporter::loadModel(omp::Model* model, const std::string& inPath, omp::ThreadPool* inThreadPool)
 {
     OMP_STAT_SCOPE("LoadModel");
 
+    // Prefetched batch reads are used as is, otherwise file is mapped and parsed in place
+    std::string prefetched;
+    omp::MappedFile mapped_file;
+    std::string_view file_data;
+    if (omp::ContentCache::takePrefetched(inPath, prefetched))
+    {
+        file_data = prefetched;
+    }
+    else if (mapped_file.open(inPath))
+    {
+        file_data = mapped_file.view();
+    }
+
+    omp::Hash128 content_hash = omp::HashLib::hash128(file_data.data(), file_data.size());
+    if (!content_hash.isValid())
+    {
+        ERROR(LogIO, "Cant read model file {}", inPath);
+        return false;
+    }
+
+    std::shared_ptr<omp::MeshData> mesh = omp::ContentCache::acquireCpu<omp::MeshData>(omp::EContentType::Mesh, content_hash,
+        [&file_data, &inPath, inThreadPool]()
+        {
+            std::shared_ptr<omp::MeshData> parsed = parseObj(file_data, inPath, inThreadPool);
+            if (parsed)
+            {
+                optimizeMesh(*parsed, inPath);
+                computeBounds(*parsed);
+            }
+            return parsed;
+        });
+
+    if (!mesh)
+    {
+        return false;
+    }
+
+    model->setMeshData(mesh, content_hash);
+    return true;
+}
+
+std::shared_ptr<omp::MeshData> omp::ModelImporter::parseObj(std::string_view inFileData, const std::string& inPath, omp::ThreadPool* inThreadPool)
+{
+    std::vector<float> vertices;
+    std::vector<uint32_t> indices;
+    if (!omp::ObjParser::parse(inFileData, inThreadPool, vertices, indices))
+    {
+        INFO(LogIO, "Model {} is parsed with tinyobj", inPath);
+        return parseObjTinyobj(inFileData, inPath);
+    }
+
+    std::shared_ptr<omp::MeshData> mesh = std::make_shared<omp::MeshData>();
+    mesh->vertices.resize(vertices.size() / omp::ObjParser::VERTEX_FLOATS);
+    std::memcpy(mesh->vertices.data(), vertices.data(), vertices.size() * sizeof(float));
+    mesh->indices = std::move(indices);
+    return mesh;
+}
+
+void omp::ModelImporter::optimizeMesh(omp::MeshData& ioMesh, const std::string& inPath)
+{
+    OMP_STAT_SCOPE("OptimizeMesh");
+
+    ioMesh.lods = {omp::MeshLod{0, static_cast<uint32_t>(ioMesh.indices.size()), 0.0f}};
+    if (ioMesh.vertices.empty() || ioMesh.indices.empty())
+    {
+        return;
+    }
+
+    const omp::VertexCacheStatistics before = omp::MeshOptimizer::analyzeVertexCache(ioMesh.indices, ioMesh.vertices.size());
+
+    omp::MeshOptimizer::optimizeVertexCache(ioMesh.indices, ioMesh.vertices.size());
+    omp::MeshOptimizer::optimizeOverdraw(ioMesh.indices, &ioMesh.vertices.front().pos.x, sizeof(omp::Vertex), ioMesh.vertices.size());
+    const omp::VertexCacheStatistics after = omp::MeshOptimizer::analyzeVertexCache(ioMesh.indices, ioMesh.vertices.size());
+
+    generateLods(ioMesh, inPath);
+    // LODs are simplified from the full mesh before meshlets reorder its triangles, they don't depend on the order
+    ioMesh.meshlets = omp::MeshletBuilder::build(ioMesh.indices, 0, ioMesh.lods.front().index_count, &ioMesh.vertices.front().pos.x,
+                                                 sizeof(omp::Vertex), ioMesh.vertices.size());
+    // Full mesh comes first in indices, so vertices follow its order
+    omp::MeshOptimizer::optimizeVertexFetch(ioMesh.vertices, ioMesh.indices);
+
+    INFO(LogIO, "Optimized model {}: ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}, {} meshlets", inPath, before.acmr, after.acmr,
+         before.atvr, after.atvr, ioMesh.meshlets.size());
+}
+
+void omp::ModelImporter::computeBounds(omp::MeshData& ioMesh)
+{
+    OMP_STAT_SCOPE("ComputeBounds");
+
+    if (ioMesh.vertices.empty())
+    {
+        ioMesh.bounds = omp::Bounds{};
+        return;
+    }
+    ioMesh.bounds = omp::BoundsLib::compute(&ioMesh.vertices.front().pos.x, sizeof(omp::Vertex), ioMesh.vertices.size());
+}
+
+void omp::ModelImporter::generateLods(omp::MeshData& ioMesh, const std::string& inPath)
+{
+    OMP_STAT_SCOPE("GenerateLods");
+
+    const float* positions = &ioMesh.vertices.front().pos.x;
+    const float scale = omp::MeshSimplifier::getScale(ioMesh.indices, positions, sizeof(omp::Vertex));
+
+    // Every level is simplified from the previous one, so errors of the steps add up
+    std::vector<uint32_t> previous = ioMesh.indices;
+    float error = 0.0f;
+    while (ioMesh.lods.size() < MAX_LOD_COUNT && previous.size() >= MIN_LOD_INDEX_COUNT)
+    {
+        float step_error = 0.0f;
+        std::vector<uint32_t> lod = omp::MeshSimplifier::simplify(previous, positions, sizeof(omp::Vertex), ioMesh.vertices.size(),
+                                                                  previous.size() / 6 * 3, MAX_LOD_ERROR, &step_error);
+        // Locked borders and seams stall simplification, a level this close to the previous one is not worth its memory
+        if (lod.empty() || lod.size() * 4 > previous.size() * 3)
+        {
+            break;
+        }
+
+        error += step_error;
+        omp::MeshOptimizer::optimizeVertexCache(lod, ioMesh.vertices.size());
+        ioMesh.lods.push_back(omp::MeshLod{static_cast<uint32_t>(ioMesh.indices.size()), static_cast<uint32_t>(lod.size()), error * scale});
+        ioMesh.indices.insert(ioMesh.indices.end(), lod.begin(), lod.end());
+        previous = std::move(lod);
+    }
+
+    for (size_t level = 1; level < ioMesh.lods.size(); level++)
+    {
+        INFO(LogIO, "Model {} LOD {}: {} triangles, error {:.5f}", inPath, level, ioMesh.lods[level].index_count / 3, ioMesh.lods[level].error);
+    }
+}
+
+std::shared_ptr<omp::MeshData> omp::ModelImporter::parseObjTinyobj(std::string_view inFileData, const std::string& inPath)
+{
     tinyobj::attrib_t attrib;
     std::vector<tinyobj::shape_t> shapes;
     std::vector<tinyobj::material_t> materials;
     std::string warn, err;
 
-    if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, inPath.c_str()))
+    std::istringstream obj_stream{std::string(inFileData)};
+    tinyobj::MaterialFileReader material_reader(std::filesystem::path(inPath).parent_path().string() + "/");
+
+    if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, &obj_stream, &material_reader))
     {
         ERROR(LogIO, "tinyobj::LoadObj Failed with output {} {}", warn, err);
-        return false;
+        return nullptr;
     }
 
-    std::unordered_map<omp::Vertex, uint32_t> unique_vertices;
+    size_t index_count = 0;
+    for (const auto& shape: shapes)
+    {
+        index_count += shape.mesh.indices.size();
+    }
 
-    unique_vertices.clear();
+    std::shared_ptr<omp::MeshData> mesh = std::make_shared<omp::MeshData>();
+    mesh->indices.reserve(index_count);
+    omp::DedupTable<omp::Vertex> unique_vertices(mesh->vertices, index_count);
 
     for (const auto& shape: shapes)
     {
@@ -50,16 +205,9 @@ bool omp::ModelImporter::loadModel(omp::Model* model, const std::string& inPath)
                     attrib.normals[3U * normal_index + 1U],
                     attrib.normals[3U * normal_index + 2U]
             };
-            // TODO incorrect amount
 
-            if (unique_vertices.count(vertex) == 0)
-            {
-                unique_vertices[vertex] = static_cast<uint32_t>(model->getVertices().size());
-                model->addVertex(vertex);
-            }
-
-            model->addIndex(unique_vertices[vertex]);
+            mesh->indices.push_back(unique_vertices.insert(vertex));
         }
     }
-    return true;
+    return mesh;
 }
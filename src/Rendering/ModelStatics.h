@@ -1,10 +1,39 @@
 #pragma once
+#include <string_view>
 #include "Model.h"
 
 namespace omp{
+    class ThreadPool;
+
     class ModelImporter
     {
     public:
-        [[nodiscard]] static bool loadModel(omp::Model* model, const std::string& path);
+        [[nodiscard]] static bool loadModel(omp::Model* model, const std::string& path, omp::ThreadPool* inThreadPool = nullptr);
+
+        /*
+         * @brief Parse OBJ contents with ObjParser, on the pool when it is given.
+         * Files ObjParser doesn't handle go through tinyobj
+         */
+        [[nodiscard]] static std::shared_ptr<omp::MeshData> parseObj(std::string_view inFileData, const std::string& inPath, omp::ThreadPool* inThreadPool);
+
+        // Reference importer, public to compare against in tests and benchmarks
+        [[nodiscard]] static std::shared_ptr<omp::MeshData> parseObjTinyobj(std::string_view inFileData, const std::string& inPath);
+
+    private:
+        // LOD chain ends at this many levels, including the full mesh
+        static constexpr size_t MAX_LOD_COUNT = 5;
+        // Meshes and levels smaller than this are not simplified further
+        static constexpr size_t MIN_LOD_INDEX_COUNT = 64 * 3;
+        // Largest error a single level may add, relative to mesh extent
+        static constexpr float MAX_LOD_ERROR = 0.05f;
+
+        // Reorders triangles and vertices for the GPU caches, builds LODs and meshlets, logs ACMR and ATVR
+        static void optimizeMesh(omp::MeshData& ioMesh, const std::string& inPath);
+
+        // Box and sphere around all vertices, stored with the cached mesh
+        static void computeBounds(omp::MeshData& ioMesh);
+
+        // Appends LODs with half the triangles of the previous one while simplification keeps up
+        static void generateLods(omp::MeshData& ioMesh, const std::string& inPath);
     };
 }
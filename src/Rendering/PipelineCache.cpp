@@ -0,0 +1,135 @@
+#include "Rendering/PipelineCache.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include "Logs.h"
+
+omp::PipelineCache::PipelineCache(VkDevice inLogicalDevice, const VkPhysicalDeviceProperties& inProperties)
+    : m_LogicalDevice(inLogicalDevice)
+    , m_Properties(inProperties)
+    , m_FilePath((std::filesystem::path(CACHE_DIRECTORY) / getCacheFileName(inProperties.pipelineCacheUUID)).string())
+{
+}
+
+omp::PipelineCache::~PipelineCache()
+{
+    destroy();
+}
+
+void omp::PipelineCache::load()
+{
+    destroy();
+
+    std::vector<char> data;
+    std::ifstream file(m_FilePath, std::ios::binary | std::ios::ate);
+    if (file.is_open())
+    {
+        data.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(data.data(), static_cast<std::streamsize>(data.size()));
+        if (!file || !isCompatible(data, m_Properties))
+        {
+            WARN(LogRendering, "Pipeline cache {} does not match the device, pipelines are compiled from scratch", m_FilePath);
+            data.clear();
+        }
+    }
+
+    VkPipelineCacheCreateInfo create_info{};
+    create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    create_info.initialDataSize = data.size();
+    create_info.pInitialData = data.empty() ? nullptr : data.data();
+    if (vkCreatePipelineCache(m_LogicalDevice, &create_info, nullptr, &m_PipelineCache) == VK_SUCCESS)
+    {
+        INFO(LogRendering, "Pipeline cache created with {} bytes from {}", data.size(), m_FilePath);
+        return;
+    }
+
+    // Driver may still refuse data it wrote itself, the cache then starts empty
+    WARN(LogRendering, "Driver rejected pipeline cache {}", m_FilePath);
+    create_info.initialDataSize = 0;
+    create_info.pInitialData = nullptr;
+    if (vkCreatePipelineCache(m_LogicalDevice, &create_info, nullptr, &m_PipelineCache) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create pipeline cache");
+    }
+}
+
+void omp::PipelineCache::save() const
+{
+    if (m_PipelineCache == VK_NULL_HANDLE)
+    {
+        return;
+    }
+
+    size_t size = 0;
+    if (vkGetPipelineCacheData(m_LogicalDevice, m_PipelineCache, &size, nullptr) != VK_SUCCESS)
+    {
+        WARN(LogRendering, "Can't read pipeline cache data");
+        return;
+    }
+    std::vector<char> data(size);
+    if (vkGetPipelineCacheData(m_LogicalDevice, m_PipelineCache, &size, data.data()) != VK_SUCCESS)
+    {
+        WARN(LogRendering, "Can't read pipeline cache data");
+        return;
+    }
+    data.resize(size);
+
+    // Written next to the old file and renamed over it, so an interrupted save never leaves half a cache
+    std::error_code error;
+    std::filesystem::create_directories(CACHE_DIRECTORY, error);
+    const std::string temporary_path = m_FilePath + ".tmp";
+    {
+        std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+        file.write(data.data(), static_cast<std::streamsize>(data.size()));
+        if (!file)
+        {
+            WARN(LogRendering, "Can't write pipeline cache {}", temporary_path);
+            return;
+        }
+    }
+    std::filesystem::rename(temporary_path, m_FilePath, error);
+    if (error)
+    {
+        WARN(LogRendering, "Can't write pipeline cache {}: {}", m_FilePath, error.message());
+        return;
+    }
+    INFO(LogRendering, "Pipeline cache saved with {} bytes to {}", data.size(), m_FilePath);
+}
+
+void omp::PipelineCache::destroy()
+{
+    if (m_PipelineCache != VK_NULL_HANDLE)
+    {
+        vkDestroyPipelineCache(m_LogicalDevice, m_PipelineCache, nullptr);
+        m_PipelineCache = VK_NULL_HANDLE;
+    }
+}
+
+std::string omp::PipelineCache::getCacheFileName(const uint8_t* inPipelineCacheUuid)
+{
+    static constexpr char digits[] = "0123456789abcdef";
+    std::string name = "pipeline_cache_";
+    for (size_t index = 0; index < VK_UUID_SIZE; index++)
+    {
+        name += digits[inPipelineCacheUuid[index] >> 4];
+        name += digits[inPipelineCacheUuid[index] & 0xF];
+    }
+    return name + ".bin";
+}
+
+bool omp::PipelineCache::isCompatible(const std::vector<char>& inData, const VkPhysicalDeviceProperties& inProperties)
+{
+    VkPipelineCacheHeaderVersionOne header{};
+    if (inData.size() < sizeof(header))
+    {
+        return false;
+    }
+    std::memcpy(&header, inData.data(), sizeof(header));
+    return header.headerSize >= sizeof(header) && header.headerSize <= inData.size()
+           && header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+           && header.vendorID == inProperties.vendorID
+           && header.deviceID == inProperties.deviceID
+           && std::memcmp(header.pipelineCacheUUID, inProperties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
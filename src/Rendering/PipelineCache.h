@@ -0,0 +1,42 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "vulkan/vulkan.h"
+
+namespace omp
+{
+    /*
+     * @brief VkPipelineCache shared by every pipeline of the renderer and kept on disk between runs.
+     * There is a file per pipeline cache UUID of the device, data from another device or driver is dropped
+     * before it reaches the driver. The cache is internally synchronized, pipelines may be created into it concurrently
+     */
+    class PipelineCache
+    {
+    public:
+        inline static const std::string CACHE_DIRECTORY = "../cache";
+
+        PipelineCache(VkDevice inLogicalDevice, const VkPhysicalDeviceProperties& inProperties);
+        ~PipelineCache();
+        PipelineCache(const PipelineCache&) = delete;
+        PipelineCache& operator=(const PipelineCache&) = delete;
+
+        // Create the cache from the device's file, empty when there is no file or it does not match the device
+        void load();
+        // Write cache data to the device's file, failures are logged since the cache only saves time
+        void save() const;
+        void destroy();
+
+        VkPipelineCache getPipelineCache() const { return m_PipelineCache; }
+
+        static std::string getCacheFileName(const uint8_t* inPipelineCacheUuid);
+        // Header version one as the specification lays it out, matched against vendor, device and cache UUID
+        static bool isCompatible(const std::vector<char>& inData, const VkPhysicalDeviceProperties& inProperties);
+
+    private:
+        VkDevice m_LogicalDevice;
+        VkPhysicalDeviceProperties m_Properties;
+        VkPipelineCache m_PipelineCache = VK_NULL_HANDLE;
+        std::string m_FilePath;
+    };
+}
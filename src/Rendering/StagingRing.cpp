@@ -0,0 +1,53 @@
+#include "Rendering/StagingRing.h"
+
+omp::StagingRing::StagingRing(uint64_t inSize, uint64_t inAlignment)
+    : m_Size(inSize)
+    , m_Alignment(inAlignment)
+{
+}
+
+bool omp::StagingRing::allocate(uint64_t inSize, uint64_t inTicket, uint64_t& outOffset)
+{
+    uint64_t offset = (m_Head + m_Alignment - 1) / m_Alignment * m_Alignment;
+    uint64_t consumed = offset - m_Head + inSize;
+    if (offset + inSize > m_Size)
+    {
+        // Tail of the ring is skipped, range starts over at the beginning
+        offset = 0;
+        consumed = m_Size - m_Head + inSize;
+    }
+    if (m_Used + consumed > m_Size)
+    {
+        return false;
+    }
+
+    // Consecutive ranges of one batch share a span
+    if (!m_Spans.empty() && m_Spans.back().ticket == inTicket)
+    {
+        m_Spans.back().consumed += consumed;
+    }
+    else
+    {
+        m_Spans.push_back(Span{consumed, inTicket});
+    }
+    m_Head = offset + inSize;
+    m_Used += consumed;
+    outOffset = offset;
+    return true;
+}
+
+void omp::StagingRing::release(const std::function<bool(uint64_t)>& inIsComplete)
+{
+    while (!m_Spans.empty() && inIsComplete(m_Spans.front().ticket))
+    {
+        m_Used -= m_Spans.front().consumed;
+        m_Spans.pop_front();
+    }
+
+    // Empty ring starts over, so large uploads after idle time don't wrap
+    if (m_Spans.empty())
+    {
+        m_Head = 0;
+        m_Used = 0;
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <functional>
+
+namespace omp
+{
+    /*
+     * @brief Space accounting of the upload staging ring, owns no memory itself.
+     * Every allocation is a span tagged with the ticket of the batch that reads it. Batches of different queues
+     * complete in any order, so space is released from the oldest span on and only while spans are complete,
+     * a finished batch never frees bytes an earlier, still running batch reads
+     */
+    class StagingRing
+    {
+    public:
+        StagingRing(uint64_t inSize, uint64_t inAlignment);
+
+        // Offset of inSize bytes read by inTicket's batch, false until older spans are released
+        bool allocate(uint64_t inSize, uint64_t inTicket, uint64_t& outOffset);
+        // Releases spans from the oldest on while inIsComplete holds for their tickets
+        void release(const std::function<bool(uint64_t)>& inIsComplete);
+
+        // Ticket of the oldest span, 0 when nothing is allocated
+        uint64_t getOldestTicket() const { return m_Spans.empty() ? 0 : m_Spans.front().ticket; }
+        uint64_t getUsedSize() const { return m_Used; }
+        uint64_t getSize() const { return m_Size; }
+
+    private:
+        struct Span
+        {
+            // Bytes including alignment and wrap padding
+            uint64_t consumed = 0;
+            uint64_t ticket = 0;
+        };
+
+        uint64_t m_Size = 0;
+        uint64_t m_Alignment = 1;
+        uint64_t m_Head = 0;
+        uint64_t m_Used = 0;
+        std::deque<Span> m_Spans;
+    };
+}
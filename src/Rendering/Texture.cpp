@@ -5,6 +5,30 @@
 #include "Logs.h"
 #include "imgui_impl_vulkan.h"
 #include "IO/stb_image.h"
+#include "AssetSystem/ContentCache.h"
+#include "Rendering/UploadQueue.h"
+
+omp::TextureImage::~TextureImage()
+{
+    std::shared_ptr<omp::VulkanContext> vulkan_context = context.lock();
+    if (!vulkan_context)
+    {
+        return;
+    }
+
+    // Frames in flight may still sample it
+    vulkan_context->deferred_deletion.push(
+        [weak_context = context, image_sampler = sampler, image_view = view, vk_image = image, image_memory = memory]() mutable
+        {
+            if (std::shared_ptr<omp::VulkanContext> owner = weak_context.lock())
+            {
+                vkDestroySampler(owner->logical_device, image_sampler, nullptr);
+                vkDestroyImageView(owner->logical_device, image_view, nullptr);
+                vkDestroyImage(owner->logical_device, vk_image, nullptr);
+                owner->freeMemory(image_memory);
+            }
+        });
+}
 
 omp::Texture::Texture(const std::shared_ptr<omp::TextureSrc>& inTexture)
     : m_TextureSource(inTexture)
@@ -24,13 +48,8 @@ omp::Texture::~Texture()
 
 void omp::Texture::destroyVkObjects()
 {
-    if (hasVulkanContext() && hasFlags(LOADED_TO_GPU))
-    {
-        vkDestroySampler(m_VulkanContext.lock()->logical_device, m_TextureSampler, nullptr);
-        vkDestroyImageView(m_VulkanContext.lock()->logical_device, m_TextureImageView, nullptr);
-        vkDestroyImage(m_VulkanContext.lock()->logical_device, m_TextureImage, nullptr);
-        vkFreeMemory(m_VulkanContext.lock()->logical_device, m_TextureImageMemory, nullptr);
-    }
+    // Vulkan objects destroyed with last texture referencing them
+    m_Image.reset();
     removeFlags(LOADED_TO_GPU | LOADED_TO_UI);
 }
 
@@ -56,15 +75,38 @@ bool omp::Texture::tryLoadToGpu()
         return false;
     }
 
-    createSampler();
-    createImage();
-    createImageView();
+    if (!omp::uploadsToGpu(m_TextureSource->getResidency()))
+    {
+        VWARN(LogRendering, "Texture is CPU only, it is not uploaded");
+        return false;
+    }
+
+    m_Image = omp::ContentCache::acquireGpu<omp::TextureImage>(omp::EContentType::Texture, m_TextureSource->getContentHash(),
+        [this]() -> std::shared_ptr<omp::TextureImage>
+        {
+            // Released pixels are decoded again only when GPU image is not cached
+            if (!m_TextureSource->ensurePixels())
+            {
+                return nullptr;
+            }
+            auto image = std::make_shared<omp::TextureImage>(m_VulkanContext.lock());
+            createSampler(*image);
+            createImage(*image);
+            createImageView(*image);
+            return image;
+        });
+    if (!m_Image)
+    {
+        return false;
+    }
 
+    // Pixels are in staging memory once upload is recorded
+    m_TextureSource->onUploaded();
     addFlags(LOADED_TO_GPU);
     return true;
 }
 
-void omp::Texture::createSampler()
+void omp::Texture::createSampler(omp::TextureImage& outImage)
 {
     VkSamplerCreateInfo sampler_info{};
     sampler_info.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
@@ -90,27 +132,18 @@ void omp::Texture::createSampler()
     sampler_info.minLod = 0;
     sampler_info.maxLod = static_cast<float>(m_TextureSource->getMipLevels());
 
-    if (vkCreateSampler(m_VulkanContext.lock()->logical_device, &sampler_info, nullptr, &m_TextureSampler) !=
+    if (vkCreateSampler(m_VulkanContext.lock()->logical_device, &sampler_info, nullptr, &outImage.sampler) !=
         VK_SUCCESS)
     {
         throw std::runtime_error("Failed to create sampler");
     }
 }
 
-void omp::Texture::createImage()
+void omp::Texture::createImage(omp::TextureImage& outImage)
 {
-    VkBuffer staging_buffer;
-    VkDeviceMemory staging_buffer_memory;
+    std::shared_ptr<omp::VulkanContext> context = m_VulkanContext.lock();
     // TODO: Layer amount 
     size_t size_to_alloc = m_TextureSource->getSize();
-    m_VulkanContext.lock()->createBuffer(size_to_alloc, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                                         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                                         staging_buffer, staging_buffer_memory);
-
-    char* data;
-    vkMapMemory(m_VulkanContext.lock()->logical_device, staging_buffer_memory, 0, size_to_alloc, 0, reinterpret_cast<void**>(&data));
-    memcpy(data, m_TextureSource->getPixels(), size_to_alloc);
-    vkUnmapMemory(m_VulkanContext.lock()->logical_device, staging_buffer_memory);
 
     VkImageCreateFlags flags = 0;
     uint32_t array_layers = 1;
@@ -121,34 +154,40 @@ void omp::Texture::createImage()
     uint32_t mip_levels = m_TextureSource->getMipLevels();
 
     //WARN(LogRendering, "Creating image with mipmaps: {}", mip_levels);
-    m_VulkanContext.lock()->createImage(width,
-                                        height,
-                                        mip_levels, VK_FORMAT_R8G8B8A8_SRGB,
-                                        VK_IMAGE_TILING_OPTIMAL,
-                                        VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT |
-                                        VK_IMAGE_USAGE_SAMPLED_BIT,
-                                        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_TextureImage, m_TextureImageMemory,
-                                        VK_SAMPLE_COUNT_1_BIT,
-                                        flags, array_layers);
-
-    m_VulkanContext.lock()->transitionImageLayout(m_TextureImage, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_UNDEFINED,
-                                                  VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, mip_levels);
-
-    m_VulkanContext.lock()->copyBufferToImage(staging_buffer,
-                                              m_TextureImage,
-                                              width,
-                                              height);
-
-    m_VulkanContext.lock()->generateMipmaps(m_TextureImage, VK_FORMAT_R8G8B8A8_SRGB, static_cast<int32_t>(width), static_cast<int32_t>(height), mip_levels);
-
-    vkDestroyBuffer(m_VulkanContext.lock()->logical_device, staging_buffer, nullptr);
-    vkFreeMemory(m_VulkanContext.lock()->logical_device, staging_buffer_memory, nullptr);
+    context->createImage(width,
+                         height,
+                         mip_levels, VK_FORMAT_R8G8B8A8_SRGB,
+                         VK_IMAGE_TILING_OPTIMAL,
+                         VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+                         VK_IMAGE_USAGE_SAMPLED_BIT,
+                         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, outImage.image, outImage.memory,
+                         VK_SAMPLE_COUNT_1_BIT,
+                         flags, array_layers);
+
+    VkBufferImageCopy region{};
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.mipLevel = 0;
+    region.imageSubresource.baseArrayLayer = 0;
+    region.imageSubresource.layerCount = 1;
+    region.imageExtent = {width, height, 1};
+
+    omp::ImageUploadInfo upload_info;
+    upload_info.format = VK_FORMAT_R8G8B8A8_SRGB;
+    upload_info.width = width;
+    upload_info.height = height;
+    upload_info.mip_levels = mip_levels;
+    upload_info.layer_count = array_layers;
+    upload_info.regions.push_back(region);
+    context->upload_queue->uploadImage(outImage.image, upload_info, m_TextureSource->getPixels(), size_to_alloc);
+
+    // Full mip chain
+    outImage.byte_size = size_to_alloc + size_to_alloc / 3;
 }
 
-void omp::Texture::createImageView()
+void omp::Texture::createImageView(omp::TextureImage& outImage)
 {
-    m_TextureImageView = m_VulkanContext.lock()->createImageView(
-                m_TextureImage, VK_FORMAT_R8G8B8A8_SRGB,
+    outImage.view = m_VulkanContext.lock()->createImageView(
+                outImage.image, VK_FORMAT_R8G8B8A8_SRGB,
                 VK_IMAGE_ASPECT_COLOR_BIT,
                 m_TextureSource->getMipLevels());
 }
@@ -179,7 +218,7 @@ void omp::Texture::loadToUi()
     {
         tryLoadToGpu();
     }
-    m_Id = ImGui_ImplVulkan_AddTexture(m_TextureSampler, m_TextureImageView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    m_Id = ImGui_ImplVulkan_AddTexture(m_Image->sampler, m_Image->view, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
     addFlags(LOADED_TO_UI);
 }
 
@@ -189,7 +228,7 @@ VkImageView omp::Texture::getImageView()
     {
         tryLoadToGpu();
     }
-    return m_TextureImageView;
+    return m_Image ? m_Image->view : VK_NULL_HANDLE;
 }
 
 VkImage omp::Texture::getImage()
@@ -198,7 +237,7 @@ VkImage omp::Texture::getImage()
     {
         tryLoadToGpu();
     }
-    return m_TextureImage;
+    return m_Image ? m_Image->image : VK_NULL_HANDLE;
 }
 
 VkSampler omp::Texture::getSampler()
@@ -207,7 +246,7 @@ VkSampler omp::Texture::getSampler()
     {
         tryLoadToGpu();
     }
-    return m_TextureSampler;
+    return m_Image ? m_Image->sampler : VK_NULL_HANDLE;
 }
 
 void omp::Texture::specifyVulkanContext(const std::shared_ptr<VulkanContext>& inHelper)
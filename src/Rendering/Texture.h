@@ -9,6 +9,27 @@
 
 namespace omp
 {
+    /**
+     * @brief Vulkan objects of uploaded texture, shared by textures with same source content
+     */
+    struct TextureImage
+    {
+        VkImage image = VK_NULL_HANDLE;
+        omp::MemoryAllocation memory;
+        VkImageView view = VK_NULL_HANDLE;
+        VkSampler sampler = VK_NULL_HANDLE;
+        size_t byte_size = 0;
+        std::weak_ptr<VulkanContext> context;
+
+        explicit TextureImage(const std::shared_ptr<VulkanContext>& inContext)
+            : context(inContext) {}
+        TextureImage(const TextureImage&) = delete;
+        TextureImage& operator=(const TextureImage&) = delete;
+        ~TextureImage();
+
+        size_t getByteSize() const { return byte_size; }
+    };
+
     /**
      * @brief Used to load images from PC, and upload directly to GPU
      */
@@ -21,10 +42,7 @@ namespace omp
         };
         // Vulkan //
         // ====== //
-        VkImage m_TextureImage;
-        VkDeviceMemory m_TextureImageMemory;
-        VkImageView m_TextureImageView;
-        VkSampler m_TextureSampler;
+        std::shared_ptr<omp::TextureImage> m_Image;
 
         VkDescriptorSet m_Id;
 
@@ -58,9 +76,9 @@ namespace omp
         bool tryLoadToGpu();
         void loadToUi();
 
-        void createSampler();
-        void createImage();
-        void createImageView();
+        void createSampler(omp::TextureImage& outImage);
+        void createImage(omp::TextureImage& outImage);
+        void createImageView(omp::TextureImage& outImage);
 
     private:
         void removeFlags(uint16_t flags);
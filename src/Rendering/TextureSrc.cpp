@@ -1,25 +1,31 @@
 #include "Rendering/TextureSrc.h"
 #include "Core/Profiling.h"
+#include "AssetSystem/ContentCache.h"
 
 void omp::TextureSrc::serialize(JsonParser<>& parser)
 {
     parser.writeValue("PathToTexture", m_Path);
+    parser.writeValue("Residency", omp::residencyToString(m_Residency));
 }
 
 void omp::TextureSrc::deserialize(JsonParser<>& parser)
 {
     m_Path = parser.readValue<std::string>("PathToTexture").value_or(""); 
+    m_Residency = omp::residencyFromString(parser.readValue<std::string>("Residency").value_or(""));
     m_IsLoaded = loadTextureFromFile();
 }
 
-omp::TextureSrc::~TextureSrc()
+void omp::TextureSrc::appendSourceFiles(const JsonParser<>& parser, std::vector<std::string>& outPaths)
 {
-    if (m_IsLoaded)
+    std::string path = parser.readValue<std::string>("PathToTexture").value_or("");
+    if (!path.empty())
     {
-        stbi_image_free(m_Pixels);
+        outPaths.push_back(std::move(path));
     }
 }
 
+omp::TextureSrc::~TextureSrc() = default;
+
 void omp::TextureSrc::setPath(const std::string& path)
 {
     m_Path = path;
@@ -27,11 +33,26 @@ void omp::TextureSrc::setPath(const std::string& path)
 
 void omp::TextureSrc::tryLoad()
 {
-    if (m_Pixels)
+    m_Pixels.reset();
+    m_IsLoaded = loadTextureFromFile();
+}
+
+bool omp::TextureSrc::ensurePixels()
+{
+    if (!m_Pixels && m_IsLoaded)
     {
-        stbi_image_free(m_Pixels);
+        m_IsLoaded = loadTextureFromFile();
+    }
+    return m_Pixels != nullptr;
+}
+
+void omp::TextureSrc::onUploaded()
+{
+    // Pixels may be shared through ContentCache, they are freed with the last reference
+    if (!omp::keepsCpuCopy(m_Residency))
+    {
+        m_Pixels.reset();
     }
-    m_IsLoaded = loadTextureFromFile();
 }
 
 bool omp::TextureSrc::loadTextureFromFile()
@@ -44,16 +65,32 @@ bool omp::TextureSrc::loadTextureFromFile()
         return false;
     }
 
-    int tex_channels;
-    m_Pixels = stbi_load(m_Path.c_str(), &m_Width, &m_Height, &tex_channels, STBI_rgb_alpha);
+    std::string file_data;
+    m_ContentHash = omp::ContentCache::hashFile(m_Path, file_data);
 
-    m_Size = m_Width * m_Height * 4;
-    m_MipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(m_Width, m_Height)))) + 1;
+    m_Pixels = omp::ContentCache::acquireCpu<omp::TexturePixels>(omp::EContentType::Texture, m_ContentHash,
+        [&file_data]() -> std::shared_ptr<omp::TexturePixels>
+        {
+            int tex_channels;
+            auto decoded = std::make_shared<omp::TexturePixels>();
+            decoded->pixels = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(file_data.data()), static_cast<int>(file_data.size()),
+                                                    &decoded->width, &decoded->height, &tex_channels, STBI_rgb_alpha);
+            if (!decoded->pixels)
+            {
+                return nullptr;
+            }
+            return decoded;
+        });
 
-    if (!m_Pixels[0])
+    if (!m_Pixels)
     {
         ERROR(LogRendering, "Failed to load texture image from path: {}", m_Path.c_str());
         return false;
     }
+
+    m_Width = m_Pixels->width;
+    m_Height = m_Pixels->height;
+    m_Size = m_Width * m_Height * 4;
+    m_MipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(m_Width, m_Height)))) + 1;
     return true;
 }
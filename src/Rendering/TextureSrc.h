@@ -1,10 +1,36 @@
 #pragma once
 
+#include <memory>
+#include "AssetSystem/Residency.h"
 #include "IO/SerializableObject.h"
 #include "IO/stb_image.h"
+#include "Math/Hash.h"
 
 namespace omp
 {
+    /**
+     * @brief Decoded RGBA pixels, shared between textures with same source content
+     */
+    struct TexturePixels
+    {
+        stbi_uc* pixels = nullptr;
+        int width = 0;
+        int height = 0;
+
+        TexturePixels() = default;
+        TexturePixels(const TexturePixels&) = delete;
+        TexturePixels& operator=(const TexturePixels&) = delete;
+        ~TexturePixels()
+        {
+            if (pixels)
+            {
+                stbi_image_free(pixels);
+            }
+        }
+
+        size_t getByteSize() const { return static_cast<size_t>(width) * static_cast<size_t>(height) * 4; }
+    };
+
     class TextureSrc : public SerializableObject
     {
     public:
@@ -23,18 +49,31 @@ namespace omp
         int getHeight() const { return m_Height; }
         uint32_t getMipLevels() const { return m_MipLevels; }
         bool isLoaded() const { return m_IsLoaded; }
-        stbi_uc* getPixels() const { return m_Pixels; }
+        // Null when pixels were released after upload, see ensurePixels
+        stbi_uc* getPixels() const { return m_Pixels ? m_Pixels->pixels : nullptr; }
+        const omp::Hash128& getContentHash() const { return m_ContentHash; }
+
+        // Decodes the file again when pixels were released after upload
+        bool ensurePixels();
+        // Called once pixels are on GPU, drops them for GPU only residency
+        void onUploaded();
+
+        void setResidency(omp::EResidency inResidency) { m_Residency = inResidency; }
+        omp::EResidency getResidency() const { return m_Residency; }
 
     private:
         std::string m_Path;
-        stbi_uc* m_Pixels = nullptr;
+        std::shared_ptr<omp::TexturePixels> m_Pixels = nullptr;
+        omp::Hash128 m_ContentHash{};
         int m_Size;
         int m_Width, m_Height;
         uint32_t m_MipLevels;
         bool m_IsLoaded = false;
+        omp::EResidency m_Residency = omp::EResidency::GpuOnly;
 
         virtual void serialize(JsonParser<>& parser) override;
         virtual void deserialize(JsonParser<>& parser) override;
+        static void appendSourceFiles(const JsonParser<>& parser, std::vector<std::string>& outPaths);
     private:
         bool loadTextureFromFile();
     };
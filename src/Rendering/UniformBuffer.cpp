@@ -2,23 +2,23 @@
 
 omp::UniformBuffer::UniformBuffer(const std::shared_ptr<omp::VulkanContext>& inVulkanContext, uint32_t khrImageCount, VkDeviceSize bufferSize, VkBufferUsageFlagBits flags)
     : m_VulkanContext(inVulkanContext)
+    , m_Range(bufferSize)
     , m_KHRNum(khrImageCount)
 {
-    m_Buffer.resize(khrImageCount);
-    m_Memory.resize(khrImageCount);
-    for (size_t i = 0; i < khrImageCount; i++)
-    {
-        m_VulkanContext->createBuffer(bufferSize, flags,
-                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                     m_Buffer[i], m_Memory[i]);
-    }
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(m_VulkanContext->phys_device, &properties);
+    const VkDeviceSize alignment = flags & VK_BUFFER_USAGE_STORAGE_BUFFER_BIT
+                                   ? properties.limits.minStorageBufferOffsetAlignment
+                                   : properties.limits.minUniformBufferOffsetAlignment;
+    m_RegionSize = (bufferSize + alignment - 1) / alignment * alignment;
+
+    m_VulkanContext->createBuffer(m_RegionSize * khrImageCount, flags,
+                                  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                  m_Buffer, m_Memory);
 }
 
 omp::UniformBuffer::~UniformBuffer()
 {
-    for (size_t i = 0; i < m_KHRNum; i++)
-    {
-        vkDestroyBuffer(m_VulkanContext->logical_device, m_Buffer[i], nullptr);
-        vkFreeMemory(m_VulkanContext->logical_device, m_Memory[i], nullptr);
-    }
+    vkDestroyBuffer(m_VulkanContext->logical_device, m_Buffer, nullptr);
+    m_VulkanContext->freeMemory(m_Memory);
 }
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstring>
 #include <vector>
 #include <vulkan/vulkan_core.h>
 #include <memory>
@@ -6,26 +7,39 @@
 
 namespace omp
 {
+    /*
+     * @brief One persistently mapped buffer cut into a region per swapchain image. Frames write straight into
+     * their region and bind the same descriptor set with the region as dynamic offset, so there is one buffer,
+     * one allocation and one descriptor set no matter how many images are in flight
+     */
     class UniformBuffer
     {
     private:
         std::shared_ptr<omp::VulkanContext> m_VulkanContext;
-        std::vector<VkBuffer> m_Buffer;
-        std::vector<VkDeviceMemory> m_Memory;
+        VkBuffer m_Buffer = VK_NULL_HANDLE;
+        omp::MemoryAllocation m_Memory;
+        // Binding range, what one frame sees
+        VkDeviceSize m_Range = 0;
+        // Range rounded up to min offset alignment of the buffer type
+        VkDeviceSize m_RegionSize = 0;
         uint32_t m_KHRNum;
 
     public:
         UniformBuffer(const std::shared_ptr<omp::VulkanContext>& inVulkanContext, uint32_t khrImageCount, VkDeviceSize bufferSize, VkBufferUsageFlagBits flags);
+        UniformBuffer(const UniformBuffer&) = delete;
+        UniformBuffer& operator=(const UniformBuffer&) = delete;
 
-        VkBuffer getBuffer(uint32_t khr) const { return m_Buffer.at(khr); }
+        VkBuffer getBuffer() const { return m_Buffer; }
+        VkDeviceSize getRange() const { return m_Range; }
+        uint32_t getDynamicOffset(uint32_t khr) const { return static_cast<uint32_t>(m_RegionSize * khr); }
+        // Region of the image, for arrays written in place
+        void* getMappedRegion(uint32_t khr) { return static_cast<uint8_t*>(m_Memory.mapped) + getDynamicOffset(khr); }
 
         template<class T>
         void mapMemory(T& memory, uint32_t imageIndex, uint32_t offset = 0)
         {
-            void* data;
-            vkMapMemory(m_VulkanContext->logical_device, m_Memory[imageIndex], offset, sizeof(T), 0, &data);
-            memcpy(data, &memory, sizeof(T));
-            vkUnmapMemory(m_VulkanContext->logical_device, m_Memory[imageIndex]);
+            // Host coherent memory stays mapped, writes need no flush
+            memcpy(static_cast<uint8_t*>(m_Memory.mapped) + getDynamicOffset(imageIndex) + offset, &memory, sizeof(T));
         }
 
         ~UniformBuffer();
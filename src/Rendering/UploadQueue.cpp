@@ -0,0 +1,361 @@
+#include "Rendering/UploadQueue.h"
+#include <cstring>
+#include <stdexcept>
+#include "Logs.h"
+#include "Rendering/VulkanContext.h"
+
+omp::UploadQueue::UploadQueue(const std::shared_ptr<omp::VulkanContext>& inContext,
+                              VkQueue inGraphicsQueue, uint32_t inGraphicsFamily,
+                              VkQueue inTransferQueue, uint32_t inTransferFamily)
+    : m_Context(inContext)
+    , m_Device(inContext->logical_device)
+{
+    m_Queues[GRAPHICS_INDEX].queue = inGraphicsQueue;
+    m_Queues[TRANSFER_INDEX].queue = inTransferQueue;
+
+    const uint32_t families[2] = {inGraphicsFamily, inTransferFamily};
+    for (size_t index = 0; index < 2; index++)
+    {
+        VkCommandPoolCreateInfo pool_info{};
+        pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        pool_info.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        pool_info.queueFamilyIndex = families[index];
+        if (vkCreateCommandPool(m_Device, &pool_info, nullptr, &m_Queues[index].command_pool) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to create upload command pool");
+        }
+    }
+
+    inContext->createBuffer(STAGING_RING_SIZE, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                            m_RingBuffer, m_RingMemory, omp::EMemoryStrategy::Dedicated);
+
+    INFO(LogRendering, "Upload queue uses {} queue for buffers", hasTransferQueue() ? "transfer" : "graphics");
+}
+
+omp::UploadQueue::~UploadQueue()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Access);
+        submitAndWaitAll();
+    }
+
+    for (QueueState& state : m_Queues)
+    {
+        for (const BatchResources& resources : state.free_resources)
+        {
+            vkDestroyFence(m_Device, resources.fence, nullptr);
+        }
+        // Command buffers go with their pools
+        vkDestroyCommandPool(m_Device, state.command_pool, nullptr);
+    }
+
+    vkDestroyBuffer(m_Device, m_RingBuffer, nullptr);
+    std::shared_ptr<omp::VulkanContext> context = m_Context.lock();
+    if (context)
+    {
+        context->freeMemory(m_RingMemory);
+    }
+}
+
+omp::UploadTicket omp::UploadQueue::uploadBuffer(VkBuffer inDestination, VkDeviceSize inDestinationOffset, const void* inData, VkDeviceSize inSize)
+{
+    if (inDestination == VK_NULL_HANDLE || inSize == 0)
+    {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(m_Access);
+    const StagingRange staging = allocateStaging(EBatchQueue::Transfer, inData, inSize);
+
+    VkBufferCopy copy_region{};
+    copy_region.srcOffset = staging.offset;
+    copy_region.dstOffset = inDestinationOffset;
+    copy_region.size = inSize;
+    vkCmdCopyBuffer(staging.state->open_batch.resources.command_buffer, staging.buffer, inDestination, 1, &copy_region);
+
+    return staging.state->open_batch.ticket;
+}
+
+omp::UploadTicket omp::UploadQueue::copyBuffer(VkBuffer inSource, VkBuffer inDestination, VkDeviceSize inSize)
+{
+    if (inSource == VK_NULL_HANDLE || inDestination == VK_NULL_HANDLE || inSize == 0)
+    {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(m_Access);
+    QueueState& state = beginBatch(EBatchQueue::Transfer);
+    VkCommandBuffer command_buffer = state.open_batch.resources.command_buffer;
+
+    // Uploads of this batch into the source land before it is read, later ones into the destination after it is written
+    recordTransferBarrier(command_buffer);
+    VkBufferCopy copy_region{};
+    copy_region.size = inSize;
+    vkCmdCopyBuffer(command_buffer, inSource, inDestination, 1, &copy_region);
+    recordTransferBarrier(command_buffer);
+
+    return state.open_batch.ticket;
+}
+
+omp::UploadTicket omp::UploadQueue::uploadImage(VkImage inImage, const omp::ImageUploadInfo& inInfo, const void* inData, VkDeviceSize inSize)
+{
+    std::shared_ptr<omp::VulkanContext> context = m_Context.lock();
+    if (!context || inImage == VK_NULL_HANDLE || inSize == 0 || inInfo.regions.empty())
+    {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(m_Access);
+    const StagingRange staging = allocateStaging(EBatchQueue::Graphics, inData, inSize);
+    VkCommandBuffer command_buffer = staging.state->open_batch.resources.command_buffer;
+
+    context->recordImageLayoutTransition(command_buffer, inImage, inInfo.format, VK_IMAGE_LAYOUT_UNDEFINED,
+                                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, inInfo.mip_levels, inInfo.layer_count);
+
+    std::vector<VkBufferImageCopy> regions = inInfo.regions;
+    for (VkBufferImageCopy& region : regions)
+    {
+        region.bufferOffset += staging.offset;
+    }
+    vkCmdCopyBufferToImage(command_buffer, staging.buffer, inImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                           static_cast<uint32_t>(regions.size()), regions.data());
+
+    context->recordMipmaps(command_buffer, inImage, inInfo.format, static_cast<int32_t>(inInfo.width),
+                           static_cast<int32_t>(inInfo.height), inInfo.mip_levels, inInfo.layer_count);
+
+    return staging.state->open_batch.ticket;
+}
+
+void omp::UploadQueue::flush()
+{
+    std::lock_guard<std::mutex> lock(m_Access);
+    for (QueueState& state : m_Queues)
+    {
+        submitBatch(state);
+    }
+}
+
+void omp::UploadQueue::poll()
+{
+    std::lock_guard<std::mutex> lock(m_Access);
+    for (QueueState& state : m_Queues)
+    {
+        while (retireOldest(state, false))
+        {
+        }
+    }
+}
+
+bool omp::UploadQueue::isComplete(UploadTicket inTicket) const
+{
+    const uint64_t completed = m_Queues[getTicketQueue(inTicket)].completed_serial.load(std::memory_order_acquire);
+    return getTicketSerial(inTicket) <= completed;
+}
+
+void omp::UploadQueue::wait(UploadTicket inTicket)
+{
+    std::lock_guard<std::mutex> lock(m_Access);
+    waitForTicket(inTicket);
+}
+
+void omp::UploadQueue::waitIdle()
+{
+    std::lock_guard<std::mutex> lock(m_Access);
+    submitAndWaitAll();
+}
+
+void omp::UploadQueue::waitForTicket(UploadTicket inTicket)
+{
+    QueueState& state = m_Queues[getTicketQueue(inTicket)];
+    if (state.is_recording && getTicketSerial(inTicket) >= getTicketSerial(state.open_batch.ticket))
+    {
+        submitBatch(state);
+    }
+    while (!isComplete(inTicket) && retireOldest(state, true))
+    {
+    }
+}
+
+void omp::UploadQueue::submitAndWaitAll()
+{
+    for (QueueState& state : m_Queues)
+    {
+        submitBatch(state);
+        while (retireOldest(state, true))
+        {
+        }
+    }
+}
+
+size_t omp::UploadQueue::getQueueIndex(EBatchQueue inQueue) const
+{
+    return inQueue == EBatchQueue::Transfer && hasTransferQueue() ? TRANSFER_INDEX : GRAPHICS_INDEX;
+}
+
+omp::UploadQueue::QueueState& omp::UploadQueue::beginBatch(EBatchQueue inQueue)
+{
+    const size_t queue_index = getQueueIndex(inQueue);
+    QueueState& state = m_Queues[queue_index];
+    if (state.is_recording)
+    {
+        return state;
+    }
+
+    BatchResources resources;
+    if (!state.free_resources.empty())
+    {
+        resources = state.free_resources.back();
+        state.free_resources.pop_back();
+    }
+    else
+    {
+        VkCommandBufferAllocateInfo alloc_info{};
+        alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        alloc_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        alloc_info.commandPool = state.command_pool;
+        alloc_info.commandBufferCount = 1;
+        if (vkAllocateCommandBuffers(m_Device, &alloc_info, &resources.command_buffer) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to allocate upload command buffer");
+        }
+
+        VkFenceCreateInfo fence_info{};
+        fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        if (vkCreateFence(m_Device, &fence_info, nullptr, &resources.fence) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to create upload fence");
+        }
+    }
+
+    state.open_batch = Batch{};
+    state.open_batch.ticket = makeTicket(queue_index, ++state.last_serial);
+    state.open_batch.resources = resources;
+
+    VkCommandBufferBeginInfo begin_info{};
+    begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkBeginCommandBuffer(resources.command_buffer, &begin_info);
+
+    // Ranges freed and reused while an earlier batch of this queue still writes them are written in submission order
+    recordTransferBarrier(resources.command_buffer);
+
+    state.is_recording = true;
+    return state;
+}
+
+void omp::UploadQueue::recordTransferBarrier(VkCommandBuffer inCommandBuffer) const
+{
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+    vkCmdPipelineBarrier(inCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         0, 1, &barrier, 0, nullptr, 0, nullptr);
+}
+
+void omp::UploadQueue::submitBatch(QueueState& ioState)
+{
+    if (!ioState.is_recording)
+    {
+        return;
+    }
+    vkEndCommandBuffer(ioState.open_batch.resources.command_buffer);
+    ioState.is_recording = false;
+
+    VkSubmitInfo submit_info{};
+    submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submit_info.commandBufferCount = 1;
+    submit_info.pCommandBuffers = &ioState.open_batch.resources.command_buffer;
+    if (vkQueueSubmit(ioState.queue, 1, &submit_info, ioState.open_batch.resources.fence) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to submit upload batch");
+    }
+
+    ioState.pending.push_back(std::move(ioState.open_batch));
+    ioState.open_batch = Batch{};
+}
+
+omp::UploadQueue::StagingRange omp::UploadQueue::allocateStaging(EBatchQueue inQueue, const void* inData, VkDeviceSize inSize)
+{
+    if (inSize > STAGING_RING_SIZE / 2)
+    {
+        std::shared_ptr<omp::VulkanContext> context = m_Context.lock();
+        if (!context)
+        {
+            throw std::runtime_error("Upload queue outlived Vulkan context");
+        }
+        StagingRange range;
+        omp::MemoryAllocation memory;
+        context->createBuffer(inSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                              VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                              range.buffer, memory, omp::EMemoryStrategy::Linear);
+        memcpy(memory.mapped, inData, inSize);
+
+        range.state = &beginBatch(inQueue);
+        range.state->open_batch.temporary_buffers.emplace_back(range.buffer, memory);
+        return range;
+    }
+
+    VkDeviceSize offset = 0;
+    QueueState* state = &beginBatch(inQueue);
+    while (!m_Ring.allocate(inSize, state->open_batch.ticket, offset))
+    {
+        // Ring is full of earlier uploads, the batch reading its oldest bytes is waited for until the range fits
+        const UploadTicket oldest = m_Ring.getOldestTicket();
+        if (oldest == 0)
+        {
+            throw std::runtime_error("Staging ring can't fit upload");
+        }
+        waitForTicket(oldest);
+        state = &beginBatch(inQueue);
+    }
+    memcpy(static_cast<uint8_t*>(m_RingMemory.mapped) + offset, inData, inSize);
+
+    return StagingRange{m_RingBuffer, offset, state};
+}
+
+bool omp::UploadQueue::retireOldest(QueueState& ioState, bool inBlock)
+{
+    if (ioState.pending.empty())
+    {
+        return false;
+    }
+
+    Batch& batch = ioState.pending.front();
+    if (inBlock)
+    {
+        if (vkGetFenceStatus(m_Device, batch.resources.fence) != VK_SUCCESS)
+        {
+            m_HostWaits.fetch_add(1, std::memory_order_relaxed);
+            vkWaitForFences(m_Device, 1, &batch.resources.fence, VK_TRUE, UINT64_MAX);
+        }
+    }
+    else if (vkGetFenceStatus(m_Device, batch.resources.fence) != VK_SUCCESS)
+    {
+        return false;
+    }
+
+    std::shared_ptr<omp::VulkanContext> context = m_Context.lock();
+    for (auto& [buffer, memory] : batch.temporary_buffers)
+    {
+        vkDestroyBuffer(m_Device, buffer, nullptr);
+        if (context)
+        {
+            context->freeMemory(memory);
+        }
+    }
+
+    vkResetFences(m_Device, 1, &batch.resources.fence);
+    vkResetCommandBuffer(batch.resources.command_buffer, 0);
+    ioState.free_resources.push_back(batch.resources);
+    ioState.completed_serial.store(getTicketSerial(batch.ticket), std::memory_order_release);
+    ioState.pending.pop_front();
+
+    // Spans of the other queue may still hold the ring tail, they are released once they complete too
+    m_Ring.release([this](uint64_t inTicket)
+    {
+        return isComplete(inTicket);
+    });
+    return true;
+}
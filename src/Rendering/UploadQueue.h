@@ -0,0 +1,143 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "vulkan/vulkan.h"
+#include "Rendering/DeviceMemoryAllocator.h"
+#include "Rendering/StagingRing.h"
+
+namespace omp
+{
+    class VulkanContext;
+
+    /*
+     * Batch an upload went into, complete once that batch's fence is signaled. 0 is always complete.
+     * Low bit is the queue of the batch, the rest counts batches of that queue, so tickets of one queue complete in order
+     */
+    using UploadTicket = uint64_t;
+
+    struct ImageUploadInfo
+    {
+        VkFormat format = VK_FORMAT_R8G8B8A8_SRGB;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t mip_levels = 1;
+        uint32_t layer_count = 1;
+        // Buffer offsets are relative to uploaded data
+        std::vector<VkBufferImageCopy> regions;
+    };
+
+    /*
+     * @brief Collects uploads into one command buffer per batch instead of a submit and queue wait per copy.
+     * Data is copied into a persistently mapped staging ring right away, so callers may free it on return.
+     * Batches are submitted on flush, which Renderer does before every frame submit, and retire by fences.
+     * Buffer only batches go to a dedicated transfer queue when the device has one. Images need blits for mips
+     * and stay on the graphics queue, where they are ready for any later submit without waiting on tickets.
+     * Each queue has its own open batch and retires in its own order, so alternating buffer and image uploads
+     * neither split batches nor wait on the GPU. Nothing on one queue reads what the other wrote, draws use
+     * geometry only after its ticket is seen complete, so the queues need no semaphores between them.
+     * Submits from the calling thread, so it's used on the render thread like the rest of Vulkan queues
+     */
+    class UploadQueue
+    {
+    public:
+        static constexpr VkDeviceSize STAGING_RING_SIZE = 32ULL * 1024 * 1024;
+        static constexpr VkDeviceSize STAGING_ALIGNMENT = 16;
+
+        UploadQueue(const std::shared_ptr<omp::VulkanContext>& inContext,
+                    VkQueue inGraphicsQueue, uint32_t inGraphicsFamily,
+                    VkQueue inTransferQueue, uint32_t inTransferFamily);
+        UploadQueue(const UploadQueue&) = delete;
+        UploadQueue& operator=(const UploadQueue&) = delete;
+        ~UploadQueue();
+
+        UploadTicket uploadBuffer(VkBuffer inDestination, VkDeviceSize inDestinationOffset, const void* inData, VkDeviceSize inSize);
+        // Device to device copy ordered after earlier uploads and before later ones, both buffers must outlive the ticket
+        UploadTicket copyBuffer(VkBuffer inSource, VkBuffer inDestination, VkDeviceSize inSize);
+        // Image is expected in UNDEFINED layout, it ends in SHADER_READ_ONLY with every mip level generated
+        UploadTicket uploadImage(VkImage inImage, const omp::ImageUploadInfo& inInfo, const void* inData, VkDeviceSize inSize);
+
+        // Submits open batches, nothing happens when they are empty
+        void flush();
+        // Retires every batch whose fence is signaled, frees their staging space
+        void poll();
+        bool isComplete(UploadTicket inTicket) const;
+        void wait(UploadTicket inTicket);
+        void waitIdle();
+
+        bool hasTransferQueue() const { return m_Queues[TRANSFER_INDEX].queue != m_Queues[GRAPHICS_INDEX].queue; }
+        // Times the CPU blocked on an upload fence, uploads only wait when the staging ring is full or on request
+        uint64_t getHostWaitCount() const { return m_HostWaits.load(std::memory_order_relaxed); }
+
+    private:
+        enum class EBatchQueue : uint8_t
+        {
+            Graphics = 0,
+            Transfer
+        };
+
+        static constexpr size_t GRAPHICS_INDEX = 0;
+        static constexpr size_t TRANSFER_INDEX = 1;
+
+        struct BatchResources
+        {
+            VkCommandBuffer command_buffer = VK_NULL_HANDLE;
+            VkFence fence = VK_NULL_HANDLE;
+        };
+
+        struct Batch
+        {
+            UploadTicket ticket = 0;
+            BatchResources resources;
+            // Uploads too large for the ring
+            std::vector<std::pair<VkBuffer, omp::MemoryAllocation>> temporary_buffers;
+        };
+
+        struct QueueState
+        {
+            VkQueue queue = VK_NULL_HANDLE;
+            VkCommandPool command_pool = VK_NULL_HANDLE;
+            std::vector<BatchResources> free_resources;
+            bool is_recording = false;
+            Batch open_batch;
+            std::deque<Batch> pending;
+            uint64_t last_serial = 0;
+            std::atomic<uint64_t> completed_serial{0};
+        };
+
+        struct StagingRange
+        {
+            VkBuffer buffer = VK_NULL_HANDLE;
+            VkDeviceSize offset = 0;
+            // Queue whose open batch reads the range
+            QueueState* state = nullptr;
+        };
+
+        QueueState& beginBatch(EBatchQueue inQueue);
+        void recordTransferBarrier(VkCommandBuffer inCommandBuffer) const;
+        void submitBatch(QueueState& ioState);
+        StagingRange allocateStaging(EBatchQueue inQueue, const void* inData, VkDeviceSize inSize);
+        bool retireOldest(QueueState& ioState, bool inBlock);
+        void waitForTicket(UploadTicket inTicket);
+        void submitAndWaitAll();
+        size_t getQueueIndex(EBatchQueue inQueue) const;
+
+        static UploadTicket makeTicket(size_t inQueueIndex, uint64_t inSerial) { return (inSerial << 1) | inQueueIndex; }
+        static size_t getTicketQueue(UploadTicket inTicket) { return inTicket & 1; }
+        static uint64_t getTicketSerial(UploadTicket inTicket) { return inTicket >> 1; }
+
+        std::weak_ptr<omp::VulkanContext> m_Context;
+        VkDevice m_Device = VK_NULL_HANDLE;
+        QueueState m_Queues[2];
+
+        VkBuffer m_RingBuffer = VK_NULL_HANDLE;
+        omp::MemoryAllocation m_RingMemory;
+        omp::StagingRing m_Ring{STAGING_RING_SIZE, STAGING_ALIGNMENT};
+
+        mutable std::mutex m_Access;
+        std::atomic<uint64_t> m_HostWaits{0};
+    };
+}
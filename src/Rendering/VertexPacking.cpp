@@ -0,0 +1,224 @@
+#include "Rendering/VertexPacking.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+static_assert(sizeof(omp::PackedVertex) == 16, "PackedVertex must stay tightly packed");
+static_assert(sizeof(omp::PackedColorVertex) == 20, "PackedColorVertex must stay tightly packed");
+
+namespace
+{
+    uint16_t quantizeUnorm16(float inValue)
+    {
+        return static_cast<uint16_t>(std::lround(std::clamp(inValue, 0.0f, 1.0f) * 65535.0f));
+    }
+
+    int16_t quantizeSnorm16(float inValue)
+    {
+        return static_cast<int16_t>(std::lround(std::clamp(inValue, -1.0f, 1.0f) * 32767.0f));
+    }
+
+    uint8_t quantizeUnorm8(float inValue)
+    {
+        return static_cast<uint8_t>(std::lround(std::clamp(inValue, 0.0f, 1.0f) * 255.0f));
+    }
+
+    float signNotZero(float inValue)
+    {
+        return inValue >= 0.0f ? 1.0f : -1.0f;
+    }
+
+    // Attributes both packed layouts have in common
+    template< typename T >
+    void packVertex(const float* inVertex, const std::array<float, 3>& inMin, const std::array<float, 3>& inInverseScale, T& outVertex)
+    {
+        for (size_t axis = 0; axis < 3; axis++)
+        {
+            outVertex.pos[axis] = quantizeUnorm16((inVertex[axis] - inMin[axis]) * inInverseScale[axis]);
+        }
+        outVertex.pos[3] = UINT16_MAX;
+
+        const float* normal = inVertex + omp::VertexPacking::NORMAL_OFFSET;
+        const std::array<float, 2> octahedral = omp::VertexPacking::encodeOctahedral(normal[0], normal[1], normal[2]);
+        outVertex.normal = {quantizeSnorm16(octahedral[0]), quantizeSnorm16(octahedral[1])};
+
+        const float* tex_coord = inVertex + omp::VertexPacking::TEX_COORD_OFFSET;
+        outVertex.tex_coord = {omp::VertexPacking::floatToHalf(tex_coord[0]), omp::VertexPacking::floatToHalf(tex_coord[1])};
+    }
+}
+
+size_t omp::VertexPacking::getVertexSize(EVertexLayout inLayout)
+{
+    switch (inLayout)
+    {
+        case EVertexLayout::Packed:
+            return sizeof(PackedVertex);
+        case EVertexLayout::PackedColor:
+            return sizeof(PackedColorVertex);
+        case EVertexLayout::Full:
+        case EVertexLayout::Max:
+            break;
+    }
+    return VERTEX_FLOATS * sizeof(float);
+}
+
+void omp::VertexPacking::computeQuantization(const float* inVertices, size_t inVertexCount, std::array<float, 3>& outMin, std::array<float, 3>& outScale)
+{
+    if (inVertexCount == 0)
+    {
+        outMin = {0.0f, 0.0f, 0.0f};
+        outScale = {0.0f, 0.0f, 0.0f};
+        return;
+    }
+
+    std::array<float, 3> max_bound = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+    outMin = {FLT_MAX, FLT_MAX, FLT_MAX};
+    for (size_t vertex = 0; vertex < inVertexCount; vertex++)
+    {
+        const float* position = inVertices + vertex * VERTEX_FLOATS;
+        for (size_t axis = 0; axis < 3; axis++)
+        {
+            outMin[axis] = std::min(outMin[axis], position[axis]);
+            max_bound[axis] = std::max(max_bound[axis], position[axis]);
+        }
+    }
+    for (size_t axis = 0; axis < 3; axis++)
+    {
+        outScale[axis] = max_bound[axis] - outMin[axis];
+    }
+}
+
+bool omp::VertexPacking::hasVertexColors(const float* inVertices, size_t inVertexCount)
+{
+    for (size_t vertex = 0; vertex < inVertexCount; vertex++)
+    {
+        const float* color = inVertices + vertex * VERTEX_FLOATS + COLOR_OFFSET;
+        if (color[0] != 1.0f || color[1] != 1.0f || color[2] != 1.0f)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<uint8_t> omp::VertexPacking::packVertices(const float* inVertices, size_t inVertexCount, EVertexLayout inLayout,
+                                                      const std::array<float, 3>& inMin, const std::array<float, 3>& inScale)
+{
+    std::array<float, 3> inverse_scale{};
+    for (size_t axis = 0; axis < 3; axis++)
+    {
+        inverse_scale[axis] = inScale[axis] > 0.0f ? 1.0f / inScale[axis] : 0.0f;
+    }
+
+    const size_t vertex_size = getVertexSize(inLayout);
+    std::vector<uint8_t> data(inVertexCount * vertex_size);
+    for (size_t vertex = 0; vertex < inVertexCount; vertex++)
+    {
+        const float* source = inVertices + vertex * VERTEX_FLOATS;
+        uint8_t* destination = data.data() + vertex * vertex_size;
+        if (inLayout == EVertexLayout::PackedColor)
+        {
+            PackedColorVertex packed{};
+            packVertex(source, inMin, inverse_scale, packed);
+            const float* color = source + COLOR_OFFSET;
+            packed.color = {quantizeUnorm8(color[0]), quantizeUnorm8(color[1]), quantizeUnorm8(color[2]), UINT8_MAX};
+            std::memcpy(destination, &packed, sizeof(packed));
+        }
+        else
+        {
+            PackedVertex packed{};
+            packVertex(source, inMin, inverse_scale, packed);
+            std::memcpy(destination, &packed, sizeof(packed));
+        }
+    }
+    return data;
+}
+
+std::vector<uint16_t> omp::VertexPacking::packIndices(const std::vector<uint32_t>& inIndices)
+{
+    std::vector<uint16_t> indices(inIndices.size());
+    for (size_t index = 0; index < inIndices.size(); index++)
+    {
+        indices[index] = static_cast<uint16_t>(inIndices[index]);
+    }
+    return indices;
+}
+
+uint16_t omp::VertexPacking::floatToHalf(float inValue)
+{
+    uint32_t bits = 0;
+    std::memcpy(&bits, &inValue, sizeof(bits));
+    const uint32_t sign = (bits >> 16) & 0x8000U;
+    const uint32_t magnitude = bits & 0x7fffffffU;
+
+    // Infinity and NaN, NaN stays quiet
+    if (magnitude >= 0x7f800000U)
+    {
+        return static_cast<uint16_t>(sign | 0x7c00U | (magnitude > 0x7f800000U ? 0x200U : 0U));
+    }
+    // 65520 and above round to infinity
+    if (magnitude >= 0x477ff000U)
+    {
+        return static_cast<uint16_t>(sign | 0x7c00U);
+    }
+    // Below 2^-14 result is subnormal, counted in steps of 2^-24
+    if (magnitude < 0x38800000U)
+    {
+        float value = 0.0f;
+        std::memcpy(&value, &magnitude, sizeof(value));
+        return static_cast<uint16_t>(sign | static_cast<uint32_t>(std::nearbyint(value * 16777216.0f)));
+    }
+
+    // Rebias exponent from 127 to 15, round mantissa to nearest even
+    uint32_t half = magnitude - 0x38000000U;
+    half += 0xfffU + ((half >> 13) & 1U);
+    return static_cast<uint16_t>(sign | (half >> 13));
+}
+
+float omp::VertexPacking::halfToFloat(uint16_t inValue)
+{
+    const uint32_t sign = (uint32_t{inValue} & 0x8000U) << 16;
+    const uint32_t exponent = (uint32_t{inValue} >> 10) & 0x1fU;
+    const uint32_t mantissa = uint32_t{inValue} & 0x3ffU;
+
+    if (exponent == 0)
+    {
+        const float value = static_cast<float>(mantissa) / 16777216.0f;
+        return sign ? -value : value;
+    }
+
+    const uint32_t bits = exponent == 0x1fU ? sign | 0x7f800000U | mantissa << 13 : sign | (exponent + 112U) << 23 | mantissa << 13;
+    float value = 0.0f;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+std::array<float, 2> omp::VertexPacking::encodeOctahedral(float inX, float inY, float inZ)
+{
+    const float length = std::fabs(inX) + std::fabs(inY) + std::fabs(inZ);
+    if (length == 0.0f)
+    {
+        return {0.0f, 0.0f};
+    }
+
+    const float x = inX / length;
+    const float y = inY / length;
+    if (inZ >= 0.0f)
+    {
+        return {x, y};
+    }
+    // Lower hemisphere is folded over the diagonals
+    return {(1.0f - std::fabs(y)) * signNotZero(x), (1.0f - std::fabs(x)) * signNotZero(y)};
+}
+
+std::array<float, 3> omp::VertexPacking::decodeOctahedral(float inX, float inY)
+{
+    std::array<float, 3> normal = {inX, inY, 1.0f - std::fabs(inX) - std::fabs(inY)};
+    const float fold = std::max(-normal[2], 0.0f);
+    normal[0] += normal[0] >= 0.0f ? -fold : fold;
+    normal[1] += normal[1] >= 0.0f ? -fold : fold;
+
+    const float length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+    return {normal[0] / length, normal[1] / length, normal[2] / length};
+}
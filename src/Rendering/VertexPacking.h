@@ -0,0 +1,79 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace omp
+{
+    enum class EVertexLayout : uint8_t
+    {
+        // omp::Vertex as imported, 44 bytes
+        Full = 0,
+        // PackedVertex, 16 bytes
+        Packed,
+        // PackedColorVertex, 20 bytes
+        PackedColor,
+        Max
+    };
+
+    /*
+     * @brief GPU vertex with quantized attributes. Position is unorm16 in the mesh bounds, w is 65535 so it reads as 1.0,
+     * normal is octahedral encoded snorm16, texture coordinates are half floats. Vertex color is dropped
+     */
+    struct PackedVertex
+    {
+        std::array<uint16_t, 4> pos;
+        std::array<int16_t, 2> normal;
+        std::array<uint16_t, 2> tex_coord;
+    };
+
+    // PackedVertex with unorm8 color, for meshes that use vertex colors
+    struct PackedColorVertex
+    {
+        std::array<uint16_t, 4> pos;
+        std::array<int16_t, 2> normal;
+        std::array<uint16_t, 2> tex_coord;
+        std::array<uint8_t, 4> color;
+    };
+
+    /*
+     * @brief Encoding of imported vertices for upload. Vertices are read as VERTEX_FLOATS floats each,
+     * position, color, texture coordinates and normal, the layout of omp::Vertex
+     */
+    class VertexPacking
+    {
+    public:
+        static constexpr size_t VERTEX_FLOATS = 11;
+        static constexpr size_t COLOR_OFFSET = 3;
+        static constexpr size_t TEX_COORD_OFFSET = 6;
+        static constexpr size_t NORMAL_OFFSET = 8;
+        // Highest vertex count drawn with 16 bit indices
+        static constexpr size_t MAX_SHORT_INDEX_VERTICES = 65536;
+
+        static size_t getVertexSize(EVertexLayout inLayout);
+
+        /*
+         * @brief Bounds of positions, outScale is the extent per axis, positions dequantize as outMin + unorm * outScale
+         */
+        static void computeQuantization(const float* inVertices, size_t inVertexCount, std::array<float, 3>& outMin, std::array<float, 3>& outScale);
+
+        // Any vertex color other than white, which importers assign when file has none
+        static bool hasVertexColors(const float* inVertices, size_t inVertexCount);
+
+        /*
+         * @brief Encode vertices into inLayout, Packed or PackedColor, with quantization from computeQuantization
+         */
+        static std::vector<uint8_t> packVertices(const float* inVertices, size_t inVertexCount, EVertexLayout inLayout,
+                                                 const std::array<float, 3>& inMin, const std::array<float, 3>& inScale);
+
+        static std::vector<uint16_t> packIndices(const std::vector<uint32_t>& inIndices);
+
+        static uint16_t floatToHalf(float inValue);
+        static float halfToFloat(uint16_t inValue);
+
+        // Unit normal folded onto the octahedron, both components in [-1, 1]
+        static std::array<float, 2> encodeOctahedral(float inX, float inY, float inZ);
+        static std::array<float, 3> decodeOctahedral(float inX, float inY);
+    };
+}
@@ -8,19 +8,27 @@ omp::VulkanContext::VulkanContext(
         , phys_device(physDevice)
         , command_pools(pool)
         , graphics_queue(graphicsQueue)
+        , memory_allocator(std::make_unique<omp::DeviceMemoryAllocator>(device, physDevice))
 {
 
 }
 
 void omp::VulkanContext::createBuffer(
         VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& buffer,
-        VkDeviceMemory& bufferMemory)
+        omp::MemoryAllocation& bufferMemory, omp::EMemoryStrategy strategy)
 {
     VkBufferCreateInfo buffer_info{};
     buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
     buffer_info.size = size;
     buffer_info.usage = usage;
     buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    // Staging and upload destinations are used by transfer and graphics queues without ownership transfers
+    if ((usage & (VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT)) && queue_families.size() > 1)
+    {
+        buffer_info.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        buffer_info.queueFamilyIndexCount = static_cast<uint32_t>(queue_families.size());
+        buffer_info.pQueueFamilyIndices = queue_families.data();
+    }
 
     if (vkCreateBuffer(logical_device, &buffer_info, nullptr, &buffer) != VK_SUCCESS)
     {
@@ -30,17 +38,17 @@ void omp::VulkanContext::createBuffer(
     VkMemoryRequirements memory_requirements;
     vkGetBufferMemoryRequirements(logical_device, buffer, &memory_requirements);
 
-    VkMemoryAllocateInfo allocate_info{};
-    allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocate_info.allocationSize = memory_requirements.size;
-    allocate_info.memoryTypeIndex = findMemoryType(memory_requirements.memoryTypeBits, properties);
+    bufferMemory = memory_allocator->allocate(memory_requirements, properties, strategy, false);
+    vkBindBufferMemory(logical_device, buffer, bufferMemory.memory, bufferMemory.offset);
+}
 
-    if (vkAllocateMemory(logical_device, &allocate_info, nullptr, &bufferMemory) != VK_SUCCESS)
+void omp::VulkanContext::freeMemory(omp::MemoryAllocation& memory)
+{
+    if (memory_allocator)
     {
-        throw std::runtime_error("failed to allocate vertex buffer memory");
+        memory_allocator->free(memory);
     }
-
-    vkBindBufferMemory(logical_device, buffer, bufferMemory, 0);
+    memory = omp::MemoryAllocation{};
 }
 
 uint32_t omp::VulkanContext::findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties)
@@ -62,7 +70,7 @@ void omp::VulkanContext::createImage(
         uint32_t width, uint32_t height, uint32_t mipLevels,
         VkFormat format, VkImageTiling tiling,
         VkImageUsageFlags usage, VkMemoryPropertyFlags properties,
-        VkImage& image, VkDeviceMemory& imageMemory,
+        VkImage& image, omp::MemoryAllocation& imageMemory,
         VkSampleCountFlagBits numSamples,
         VkImageCreateFlags flags,
         uint32_t arrayLayers)
@@ -83,28 +91,10 @@ void omp::VulkanContext::createImage(
     image_info.samples = numSamples;
     image_info.flags = flags;
 
-    if (vkCreateImage(logical_device, &image_info, nullptr, &image) != VK_SUCCESS)
-    {
-        throw std::runtime_error("Failed to create image!");
-    }
-
-    VkMemoryRequirements mem_req;
-    vkGetImageMemoryRequirements(logical_device, image, &mem_req);
-
-    VkMemoryAllocateInfo allocate_info{};
-    allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocate_info.allocationSize = mem_req.size;
-    allocate_info.memoryTypeIndex = findMemoryType(mem_req.memoryTypeBits, properties);
-
-    if (vkAllocateMemory(logical_device, &allocate_info, nullptr, &imageMemory) != VK_SUCCESS)
-    {
-        throw std::runtime_error("Failed to allocate image memory!");
-    }
-
-    vkBindImageMemory(logical_device, image, imageMemory, 0);
+    createImage(image_info, image, imageMemory, properties);
 }
 
-void omp::VulkanContext::createImage(const VkImageCreateInfo& imageInfo, VkImage& image, VkDeviceMemory& imageMemory,VkMemoryPropertyFlags properties)
+void omp::VulkanContext::createImage(const VkImageCreateInfo& imageInfo, VkImage& image, omp::MemoryAllocation& imageMemory,VkMemoryPropertyFlags properties)
 {
     if (vkCreateImage(logical_device, &imageInfo, nullptr, &image) != VK_SUCCESS)
     {
@@ -114,24 +104,25 @@ void omp::VulkanContext::createImage(const VkImageCreateInfo& imageInfo, VkImage
     VkMemoryRequirements mem_req;
     vkGetImageMemoryRequirements(logical_device, image, &mem_req);
 
-    VkMemoryAllocateInfo allocate_info{};
-    allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocate_info.allocationSize = mem_req.size;
-    allocate_info.memoryTypeIndex = findMemoryType(mem_req.memoryTypeBits, properties);
-
-    if (vkAllocateMemory(logical_device, &allocate_info, nullptr, &imageMemory) != VK_SUCCESS)
-    {
-        throw std::runtime_error("Failed to allocate image memory!");
-    }
-
-    vkBindImageMemory(logical_device, image, imageMemory, 0);
+    // Render targets are recreated with the swapchain, they don't share blocks with long lived images
+    const bool is_attachment = imageInfo.usage & (VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT);
+    imageMemory = memory_allocator->allocate(mem_req, properties,
+                                             is_attachment ? omp::EMemoryStrategy::Dedicated : omp::EMemoryStrategy::General, true);
+    vkBindImageMemory(logical_device, image, imageMemory.memory, imageMemory.offset);
 }
 
 void omp::VulkanContext::transitionImageLayout(
         VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t mipLevels)
 {
     VkCommandBuffer command_buffer = beginSingleTimeCommands();
+    recordImageLayoutTransition(command_buffer, image, format, oldLayout, newLayout, mipLevels);
+    endSingleTimeCommands(command_buffer);
+}
 
+void omp::VulkanContext::recordImageLayoutTransition(
+        VkCommandBuffer commandBuffer, VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout,
+        uint32_t mipLevels, uint32_t layerCount)
+{
     VkImageMemoryBarrier barrier{};
     barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
     barrier.oldLayout = oldLayout;
@@ -143,7 +134,7 @@ void omp::VulkanContext::transitionImageLayout(
     barrier.subresourceRange.baseMipLevel = 0;
     barrier.subresourceRange.levelCount = mipLevels;
     barrier.subresourceRange.baseArrayLayer = 0;
-    barrier.subresourceRange.layerCount = 1;
+    barrier.subresourceRange.layerCount = layerCount;
     barrier.srcAccessMask = 0;
     barrier.dstAccessMask = 0;
 
@@ -195,12 +186,10 @@ void omp::VulkanContext::transitionImageLayout(
         throw std::invalid_argument("Unsupported layout transition!");
     }
 
-    vkCmdPipelineBarrier(command_buffer,
+    vkCmdPipelineBarrier(commandBuffer,
                          source_stage, destination_stage,
                          0, 0, nullptr, 0, nullptr, 1,
                          &barrier);
-
-    endSingleTimeCommands(command_buffer);
 }
 
 void omp::VulkanContext::copyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height)
@@ -236,6 +225,15 @@ void omp::VulkanContext::copyBufferToImage(VkBuffer buffer, VkImage image, const
 
 void omp::VulkanContext::generateMipmaps(
         VkImage image, VkFormat imageFormat, int32_t texWidth, int32_t texHeight, uint32_t mipLevels)
+{
+    VkCommandBuffer command_buffer = beginSingleTimeCommands();
+    recordMipmaps(command_buffer, image, imageFormat, texWidth, texHeight, mipLevels);
+    endSingleTimeCommands(command_buffer);
+}
+
+void omp::VulkanContext::recordMipmaps(
+        VkCommandBuffer commandBuffer, VkImage image, VkFormat imageFormat, int32_t texWidth, int32_t texHeight,
+        uint32_t mipLevels, uint32_t layerCount)
 {
     VkFormatProperties format_properties;
     vkGetPhysicalDeviceFormatProperties(phys_device, imageFormat, &format_properties);
@@ -244,8 +242,6 @@ void omp::VulkanContext::generateMipmaps(
         throw std::runtime_error("Texture image format does not support linear blitting");
     }
 
-    VkCommandBuffer command_buffer = beginSingleTimeCommands();
-
     VkImageMemoryBarrier barrier{};
     barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
     barrier.image = image;
@@ -253,7 +249,7 @@ void omp::VulkanContext::generateMipmaps(
     barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
     barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
     barrier.subresourceRange.baseArrayLayer = 0;
-    barrier.subresourceRange.layerCount = 1;
+    barrier.subresourceRange.layerCount = layerCount;
     barrier.subresourceRange.levelCount = 1;
 
     int32_t mip_width = texWidth;
@@ -267,7 +263,7 @@ void omp::VulkanContext::generateMipmaps(
         barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
         barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
 
-        vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
                              0,
                              0, nullptr,
                              0, nullptr,
@@ -280,16 +276,16 @@ void omp::VulkanContext::generateMipmaps(
         blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
         blit.srcSubresource.mipLevel = i - 1;
         blit.srcSubresource.baseArrayLayer = 0;
-        blit.srcSubresource.layerCount = 1;
+        blit.srcSubresource.layerCount = layerCount;
 
         blit.dstOffsets[0] = {0, 0, 0};
         blit.dstOffsets[1] = {mip_width > 1 ? mip_width / 2 : 1, mip_height > 1 ? mip_height / 2 : 1, 1};
         blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
         blit.dstSubresource.mipLevel = i;
         blit.dstSubresource.baseArrayLayer = 0;
-        blit.dstSubresource.layerCount = 1;
+        blit.dstSubresource.layerCount = layerCount;
 
-        vkCmdBlitImage(command_buffer,
+        vkCmdBlitImage(commandBuffer,
                        image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
                        image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
                        1, &blit, VK_FILTER_LINEAR
@@ -300,7 +296,7 @@ void omp::VulkanContext::generateMipmaps(
         barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
         barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
 
-        vkCmdPipelineBarrier(command_buffer,
+        vkCmdPipelineBarrier(commandBuffer,
                              VK_PIPELINE_STAGE_TRANSFER_BIT,
                              VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
                              0, nullptr,
@@ -320,15 +316,13 @@ void omp::VulkanContext::generateMipmaps(
     barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
     barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
 
-    vkCmdPipelineBarrier(command_buffer,
+    vkCmdPipelineBarrier(commandBuffer,
                          VK_PIPELINE_STAGE_TRANSFER_BIT,
                          VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
                          0, nullptr,
                          0, nullptr,
                          1, &barrier
     );
-
-    endSingleTimeCommands(command_buffer);
 }
 
 VkCommandBuffer omp::VulkanContext::beginSingleTimeCommands()
@@ -427,11 +421,12 @@ void omp::VulkanContext::destroyShaderModule(VkShaderModule inModule)
     vkDestroyShaderModule(logical_device, inModule, nullptr);
 }
 
-void omp::VulkanContext::copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size)
+void omp::VulkanContext::copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size, VkDeviceSize dstOffset)
 {
     VkCommandBuffer command_buffer = beginSingleTimeCommands();
 
     VkBufferCopy copy_region{};
+    copy_region.dstOffset = dstOffset;
     copy_region.size = size;
     vkCmdCopyBuffer(command_buffer, srcBuffer, dstBuffer, 1, &copy_region);
 
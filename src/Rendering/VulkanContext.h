@@ -1,10 +1,16 @@
 #pragma once
 
+#include <memory>
 #include <vector>
 #include "vulkan/vulkan.h"
+#include "Rendering/DeviceMemoryAllocator.h"
+#include "Rendering/DeferredDeletionQueue.h"
 
 namespace omp
 {
+    class GeometryArena;
+    class UploadQueue;
+
 /**
  * Class to help with vulkan routine functions
  */
@@ -15,25 +21,41 @@ namespace omp
         VkPhysicalDevice phys_device;
         VkCommandPool command_pools;
         VkQueue graphics_queue;
+        // Vertex and index ranges of every uploaded model, released before the device
+        std::shared_ptr<omp::GeometryArena> geometry_arena;
+        // Backs every buffer and image made here, released before the device
+        std::unique_ptr<omp::DeviceMemoryAllocator> memory_allocator;
+        // Batches staging copies, released before geometry_arena
+        std::shared_ptr<omp::UploadQueue> upload_queue;
+        // Graphics and transfer families when they differ, buffers used in transfers are shared between them
+        std::vector<uint32_t> queue_families;
+        // Objects released while frames are in flight, Renderer collects them as frame fences signal
+        omp::DeferredDeletionQueue deferred_deletion;
         // TODO replace occurences in Renderer.cpp
         VulkanContext(VkDevice device, VkPhysicalDevice physDevice, VkCommandPool pool, VkQueue graphicsQueue);
 
         void createBuffer(
                 VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& buffer,
-                VkDeviceMemory& bufferMemory);
+                omp::MemoryAllocation& bufferMemory, omp::EMemoryStrategy strategy = omp::EMemoryStrategy::General);
         uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
         void createImage(
                 uint32_t width, uint32_t height, uint32_t mipLevels,
                 VkFormat format, VkImageTiling tiling,
                 VkImageUsageFlags usage, VkMemoryPropertyFlags properties,
-                VkImage& image, VkDeviceMemory& imageMemory,
+                VkImage& image, omp::MemoryAllocation& imageMemory,
                 VkSampleCountFlagBits numSamples,
                 VkImageCreateFlags flags = 0,
                 uint32_t arrayLayers = 1
         );
-        void createImage(const VkImageCreateInfo& imageInfo, VkImage& image, VkDeviceMemory& imageMemory,VkMemoryPropertyFlags properties);
+        void createImage(const VkImageCreateInfo& imageInfo, VkImage& image, omp::MemoryAllocation& imageMemory,VkMemoryPropertyFlags properties);
+        // Safe after memory_allocator is gone, memory went with it
+        void freeMemory(omp::MemoryAllocation& memory);
         void transitionImageLayout(
                 VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t mipLevels);
+        // Records into a command buffer owned by the caller, like UploadQueue batches
+        void recordImageLayoutTransition(
+                VkCommandBuffer commandBuffer, VkImage image, VkFormat format, VkImageLayout oldLayout,
+                VkImageLayout newLayout, uint32_t mipLevels, uint32_t layerCount = 1);
         void copyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height);
         void copyBufferToImage(VkBuffer buffer, VkImage image, const std::vector<VkBufferImageCopy>& regions);
         void generateMipmaps(
@@ -42,6 +64,15 @@ namespace omp
                 int32_t texWidth,
                 int32_t texHeight,
                 uint32_t mipLevels);
+        // Expects every mip level in TRANSFER_DST, leaves them all in SHADER_READ_ONLY
+        void recordMipmaps(
+                VkCommandBuffer commandBuffer,
+                VkImage image,
+                VkFormat imageFormat,
+                int32_t texWidth,
+                int32_t texHeight,
+                uint32_t mipLevels,
+                uint32_t layerCount = 1);
 
         VkCommandBuffer beginSingleTimeCommands();
         void endSingleTimeCommands(VkCommandBuffer commandBuffer);
@@ -54,7 +85,7 @@ namespace omp
 
         void setCommandPool(VkCommandPool pool) { command_pools = pool; }
 
-        void copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size);
+        void copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size, VkDeviceSize dstOffset = 0);
 
         friend class MaterialManager;
     };
@@ -36,10 +36,9 @@ void omp::VulkanImage::destroyAll()
         vkDestroyImage(m_Context->logical_device, m_Image, nullptr);
         m_Image = VK_NULL_HANDLE;
     }
-    if (m_Memory != VK_NULL_HANDLE)
+    if (m_Memory.isValid())
     {
-        vkFreeMemory(m_Context->logical_device, m_Memory, nullptr);
-        m_Memory = VK_NULL_HANDLE;
+        m_Context->freeMemory(m_Memory);
     }
 }
 
@@ -34,7 +34,7 @@ namespace omp
         VkImage m_Image = VK_NULL_HANDLE;
         VkImageView m_ImageView = VK_NULL_HANDLE;
         VkSampler m_Sample = VK_NULL_HANDLE;
-        VkDeviceMemory m_Memory = VK_NULL_HANDLE;
+        omp::MemoryAllocation m_Memory;
         VkDescriptorSet m_ImguiImage = VK_NULL_HANDLE;
     public:
         const VkImage getImage() const { return m_Image; }
@@ -1,6 +1,10 @@
 #include "Scene.h"
 #include "Logs.h"
 #include "SceneEntityFactory.h"
+#include "Async/ThreadPool.h"
+#include "Core/Profiling.h"
+#include "Rendering/UploadQueue.h"
+#include "Rendering/VulkanContext.h"
 
 std::span<std::unique_ptr<omp::SceneEntity>> omp::Scene::getEntities()
 {
@@ -38,6 +42,7 @@ void omp::Scene::addEntityToScene(std::unique_ptr<omp::SceneEntity>&& modelToAdd
 void omp::Scene::loadToGPU(const std::shared_ptr<omp::VulkanContext>& context)
 {
     m_VulkanContext = context;
+    const uint64_t host_waits = context->upload_queue->getHostWaitCount();
 
     for (auto& entity : m_Entities)
     {
@@ -48,14 +53,28 @@ void omp::Scene::loadToGPU(const std::shared_ptr<omp::VulkanContext>& context)
     {
         camera->tryLoadToGpu(context);
     }
+
+    // Model and texture uploads alternate between queues, they should only wait when the staging ring fills up
+    INFO(LogRendering, "Scene uploads recorded, upload queue waited on the GPU {} times",
+         context->upload_queue->getHostWaitCount() - host_waits);
 }
 
 void omp::Scene::serialize(JsonParser<>& parser)
 {
+    parser.writeValue(FORMAT_VERSION_KEY, COLUMNAR_FORMAT_VERSION);
+
+    // Plain entities go to columns, derived classes keep their own records
+    omp::SceneEntityColumns columns;
+    columns.reserve(m_Entities.size());
     std::vector<std::string> names;
-    names.reserve(m_Entities.size());
     for (std::unique_ptr<omp::SceneEntity>& entity : m_Entities)
     {
+        if (entity->getClassName() == PLAIN_ENTITY_CLASS)
+        {
+            entity->onColumnSave(columns, this);
+            continue;
+        }
+
         names.push_back(entity->getName());
 
         JsonParser<> new_parser;
@@ -66,6 +85,10 @@ void omp::Scene::serialize(JsonParser<>& parser)
     }
     parser.writeValue("EntityNames", names);
 
+    JsonParser<> columns_parser;
+    columns.write(columns_parser);
+    parser.writeObject(ENTITY_COLUMNS_KEY, std::move(columns_parser));
+
     names.clear();
     for (std::unique_ptr<omp::Camera>& camera : m_Cameras)
     {
@@ -95,53 +118,105 @@ void omp::Scene::serialize(JsonParser<>& parser)
 
 void omp::Scene::deserialize(JsonParser<>& parser)
 {
-    auto entities_opt = parser.readValue<std::vector<std::string>>("EntityNames");
-    std::vector<std::string> names{};
+    OMP_STAT_SCOPE("SceneDeserialize");
 
-    if (entities_opt.has_value())
+    omp::ThreadPool* thread_pool = getThreadPool();
+
+    uint32_t format_version = parser.readValue<uint32_t>(FORMAT_VERSION_KEY).value_or(0);
+    if (format_version >= COLUMNAR_FORMAT_VERSION && parser.contains(ENTITY_COLUMNS_KEY))
     {
-         names = entities_opt.value();
+        JsonParser<> columns_parser = parser.readObject(ENTITY_COLUMNS_KEY);
+        omp::SceneEntityColumns columns;
+        if (columns.read(columns_parser))
+        {
+            // Entity constructor generates ids with shared state, so storage is created on this thread
+            const size_t first = m_Entities.size();
+            m_Entities.reserve(first + columns.size());
+            for (size_t i = 0; i < columns.size(); i++)
+            {
+                m_Entities.push_back(std::make_unique<omp::SceneEntity>());
+            }
+
+            parallelLoad(thread_pool, columns.size(), [this, &columns, first](size_t begin, size_t end)
+            {
+                for (size_t i = begin; i < end; i++)
+                {
+                    m_Entities[first + i]->onColumnLoad(columns, i, this);
+                }
+            });
+        }
+        else
+        {
+            ERROR(LogAssetManager, "Scene entity columns are corrupted, entities skipped");
+        }
     }
-    size_t entities_num = names.size();
-    for (size_t i = 0; i < entities_num; i++)
+
+    // Old files store every entity as a record
+    loadRecords(parser, "EntityNames", m_Entities);
+    loadRecords(parser, "CameraNames", m_Cameras);
+    loadRecords(parser, "LightNames", m_Lights);
+}
+
+template< typename T >
+void omp::Scene::loadRecords(JsonParser<>& parser, const std::string& inNamesKey, std::vector<std::unique_ptr<T>>& outObjects)
+{
+    std::vector<std::string> names = parser.readValue<std::vector<std::string>>(inNamesKey).value_or(std::vector<std::string>{});
+    if (names.empty())
     {
-        JsonParser<> local_entity = parser.readObject(names[i]);
-        std::string class_name = std::move(local_entity.readValue<std::string>("ClassName").value());
-        std::unique_ptr<SceneEntity> entity = omp::SceneEntityFactory::createSceneEntity(class_name);
-        entity->onSceneLoad(local_entity, this);
-        m_Entities.push_back(std::move(entity));
+        return;
     }
 
-    auto cameras_opt = parser.readValue<std::vector<std::string>>("CameraNames");
-    names.clear();
-    if (cameras_opt.has_value())
+    omp::ThreadPool* thread_pool = getThreadPool();
+
+    // Parsing records is independent, results are stored by index to keep file order
+    std::vector<JsonParser<>> records(names.size());
+    std::vector<std::string> class_names(names.size());
+    parallelLoad(thread_pool, names.size(), [&parser, &names, &records, &class_names](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; i++)
+        {
+            records[i] = parser.readObject(names[i]);
+            class_names[i] = records[i].readValue<std::string>("ClassName").value();
+        }
+    });
+
+    std::vector<std::unique_ptr<T>> objects(names.size());
+    for (size_t i = 0; i < names.size(); i++)
     {
-        names = cameras_opt.value();
+        objects[i] = omp::SceneEntityFactory::createSceneEntity<T>(class_names[i]);
     }
-    size_t camera_num = names.size();
-    for (size_t i = 0; i < camera_num; i++)
+
+    parallelLoad(thread_pool, names.size(), [this, &records, &objects](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; i++)
+        {
+            if (objects[i])
+            {
+                objects[i]->onSceneLoad(records[i], this);
+            }
+        }
+    });
+
+    outObjects.reserve(outObjects.size() + objects.size());
+    for (std::unique_ptr<T>& object : objects)
     {
-        JsonParser<> local_entity = parser.readObject(names[i]);
-        std::string class_name = std::move(local_entity.readValue<std::string>("ClassName").value());
-        std::unique_ptr<Camera> camera = omp::SceneEntityFactory::createSceneEntity<omp::Camera>(class_name);
-        camera->onSceneLoad(local_entity, this);
-        m_Cameras.push_back(std::move(camera));
+        if (object)
+        {
+            outObjects.push_back(std::move(object));
+        }
     }
-    
-    auto light_ops = parser.readValue<std::vector<std::string>>("LightNames");
+}
 
-    if (light_ops.has_value())
+template< typename FunctionType >
+void omp::Scene::parallelLoad(omp::ThreadPool* inThreadPool, size_t inCount, FunctionType&& f)
+{
+    if (inThreadPool)
     {
-        names = light_ops.value();
+        inThreadPool->parallelFor(inCount, LOAD_CHUNK_SIZE, std::forward<FunctionType>(f));
     }
-    size_t light_num = names.size();
-    for (size_t i = 0; i < light_num; i++)
+    else
     {
-        JsonParser<> local_entity = parser.readObject(names[i]);
-        std::string class_name = std::move(local_entity.readValue<std::string>("ClassName").value());
-        std::unique_ptr<LightBase> light = omp::SceneEntityFactory::createSceneEntity<omp::LightBase>(class_name);
-        light->onSceneLoad(local_entity, this);
-        m_Lights.push_back(std::move(light));
+        f(size_t{0}, inCount);
     }
 }
 
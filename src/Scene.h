@@ -62,5 +62,24 @@ namespace omp
         {
             m_StateDirty = true;
         };
+
+    private:
+        /*
+         * @brief Create objects listed under inNamesKey from their records, parsing and loading run on the pool
+         */
+        template< typename T >
+        void loadRecords(JsonParser<>& parser, const std::string& inNamesKey, std::vector<std::unique_ptr<T>>& outObjects);
+
+        template< typename FunctionType >
+        static void parallelLoad(omp::ThreadPool* inThreadPool, size_t inCount, FunctionType&& f);
+
+        // Entities loaded by one pool task
+        static constexpr size_t LOAD_CHUNK_SIZE = 1024;
+
+        // Version 2 stores plain entities in columns, files without version use records only
+        static constexpr uint32_t COLUMNAR_FORMAT_VERSION = 2;
+        inline static const std::string FORMAT_VERSION_KEY = "FormatVersion";
+        inline static const std::string ENTITY_COLUMNS_KEY = "EntityColumns";
+        inline static const std::string PLAIN_ENTITY_CLASS = "SceneEntity";
     };
 } // omp
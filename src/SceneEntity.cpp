@@ -172,20 +172,9 @@ void omp::SceneEntity::onSceneLoad(JsonParser<>& parser, omp::Scene* scene)
         scale.y = parser.readValue<float>("scale_y").value();
         scale.z = parser.readValue<float>("scale_z").value();
         auto model_id_opt = parser.readValue<omp::SerializableObject::SerializationId>("model_id");
-        std::shared_ptr<omp::Model> model_casted;
         if (model_id_opt.has_value())
         {
-            model_casted = std::dynamic_pointer_cast<omp::Model>(scene->getDependency(model_id_opt.value()));
-            if (model_casted)
-            {
-                m_ModelInstance = std::make_shared<omp::ModelInstance>(model_casted);
-                glm::vec3& old_pos = m_ModelInstance->getPosition();
-                old_pos = pos;
-                glm::vec3& old_rot = m_ModelInstance->getRotation();
-                old_rot = rot;
-                glm::vec3& old_scale = m_ModelInstance->getScale();
-                old_scale = scale;
-            }
+            loadModelInstance(model_id_opt.value(), pos, rot, scale, scene);
         }
     }
     auto mat_id_opt = parser.readValue<omp::SerializableObject::SerializationId>("material_id");
@@ -208,16 +197,129 @@ void omp::SceneEntity::onSceneLoad(JsonParser<>& parser, omp::Scene* scene)
         specular.y = parser.readValue<float>("specular_y").value();
         specular.z = parser.readValue<float>("specular_z").value();
         specular.w = parser.readValue<float>("specular_w").value();
-        std::shared_ptr<omp::Material> mat_casted = std::dynamic_pointer_cast<omp::Material>(scene->getDependency(mat_id_opt.value()));
+        loadMaterialInstance(mat_id_opt.value(), ambient, diffusive, specular, scene);
+    }
+}
 
-        if (mat_casted)
+void omp::SceneEntity::onColumnSave(omp::SceneEntityColumns& columns, omp::Scene* scene)
+{
+    columns.names.push_back(m_Name);
+    columns.ids.push_back(m_Id);
+
+    omp::SerializableObject::SerializationId model_id = 0;
+    glm::vec3 pos{0.f}, rot{0.f}, scale{0.f};
+    if (m_ModelInstance)
+    {
+        pos = m_ModelInstance->getPosition();
+        rot = m_ModelInstance->getRotation();
+        scale = m_ModelInstance->getScale();
+        if (!m_ModelInstance->getModel().expired())
         {
-            std::shared_ptr<omp::MaterialInstance> mat_inst = std::make_shared<omp::MaterialInstance>(mat_casted);
-            m_ModelInstance->setMaterialInstance(mat_inst);
-            mat_inst->setAmbient(ambient);
-            mat_inst->setDiffusive(diffusive);
-            mat_inst->setSpecular(specular);
+            model_id = scene->serializeDependency(m_ModelInstance->getModel().lock().get());
         }
     }
+    columns.transforms.insert(columns.transforms.end(), {pos.x, pos.y, pos.z, rot.x, rot.y, rot.z, scale.x, scale.y, scale.z});
+    columns.model_ids.push_back(model_id);
+
+    omp::SerializableObject::SerializationId material_id = 0;
+    glm::vec4 ambient{0.f}, diffusive{0.f}, specular{0.f};
+    bool have_material = m_ModelInstance && m_ModelInstance->getMaterialInstance() && m_ModelInstance->getMaterialInstance()->getStaticMaterial().lock().get();
+    if (have_material)
+    {
+        ambient = m_ModelInstance->getMaterialInstance()->getAmbient();
+        diffusive = m_ModelInstance->getMaterialInstance()->getDiffusive();
+        specular = m_ModelInstance->getMaterialInstance()->getSpecular();
+        material_id = scene->serializeDependency(m_ModelInstance->getMaterialInstance()->getStaticMaterial().lock().get());
+    }
+    columns.colors.insert(columns.colors.end(), {
+            ambient.x, ambient.y, ambient.z, ambient.w,
+            diffusive.x, diffusive.y, diffusive.z, diffusive.w,
+            specular.x, specular.y, specular.z, specular.w});
+    columns.material_ids.push_back(material_id);
+}
+
+void omp::SceneEntity::onColumnLoad(const omp::SceneEntityColumns& columns, size_t row, omp::Scene* scene)
+{
+    m_Name = columns.names[row];
+    m_Id = columns.ids[row];
+
+    if (columns.model_ids[row] != 0)
+    {
+        const float* transform = columns.transforms.data() + row * omp::SceneEntityColumns::TRANSFORM_SIZE;
+        glm::vec3 pos{transform[0], transform[1], transform[2]};
+        glm::vec3 rot{transform[3], transform[4], transform[5]};
+        glm::vec3 scale{transform[6], transform[7], transform[8]};
+        loadModelInstance(columns.model_ids[row], pos, rot, scale, scene);
+    }
+
+    if (columns.material_ids[row] != 0 && m_ModelInstance)
+    {
+        const float* color = columns.colors.data() + row * omp::SceneEntityColumns::COLOR_SIZE;
+        glm::vec4 ambient{color[0], color[1], color[2], color[3]};
+        glm::vec4 diffusive{color[4], color[5], color[6], color[7]};
+        glm::vec4 specular{color[8], color[9], color[10], color[11]};
+        loadMaterialInstance(columns.material_ids[row], ambient, diffusive, specular, scene);
+    }
 }
 
+void omp::SceneEntity::loadModelInstance(omp::SerializableObject::SerializationId modelId, const glm::vec3& pos, const glm::vec3& rot, const glm::vec3& scale, omp::Scene* scene)
+{
+    std::shared_ptr<omp::Model> model_casted = std::dynamic_pointer_cast<omp::Model>(scene->getDependency(modelId));
+    if (model_casted)
+    {
+        m_ModelInstance = std::make_shared<omp::ModelInstance>(model_casted);
+        m_ModelInstance->getPosition() = pos;
+        m_ModelInstance->getRotation() = rot;
+        m_ModelInstance->getScale() = scale;
+    }
+}
+
+void omp::SceneEntity::loadMaterialInstance(omp::SerializableObject::SerializationId materialId, const glm::vec4& ambient, const glm::vec4& diffusive, const glm::vec4& specular, omp::Scene* scene)
+{
+    std::shared_ptr<omp::Material> mat_casted = std::dynamic_pointer_cast<omp::Material>(scene->getDependency(materialId));
+    if (mat_casted)
+    {
+        std::shared_ptr<omp::MaterialInstance> mat_inst = std::make_shared<omp::MaterialInstance>(mat_casted);
+        m_ModelInstance->setMaterialInstance(mat_inst);
+        mat_inst->setAmbient(ambient);
+        mat_inst->setDiffusive(diffusive);
+        mat_inst->setSpecular(specular);
+    }
+}
+
+void omp::SceneEntityColumns::reserve(size_t inCount)
+{
+    names.reserve(inCount);
+    ids.reserve(inCount);
+    transforms.reserve(inCount * TRANSFORM_SIZE);
+    model_ids.reserve(inCount);
+    material_ids.reserve(inCount);
+    colors.reserve(inCount * COLOR_SIZE);
+}
+
+void omp::SceneEntityColumns::write(JsonParser<>& parser) const
+{
+    parser.writeValue("Names", names);
+    parser.writeValue("Ids", ids);
+    parser.writeValue("Transforms", transforms);
+    parser.writeValue("ModelIds", model_ids);
+    parser.writeValue("MaterialIds", material_ids);
+    parser.writeValue("Colors", colors);
+}
+
+bool omp::SceneEntityColumns::read(JsonParser<>& parser)
+{
+    names = parser.readValue<std::vector<std::string>>("Names").value_or(std::vector<std::string>{});
+    ids = parser.readValue<std::vector<uint32_t>>("Ids").value_or(std::vector<uint32_t>{});
+    transforms = parser.readValue<std::vector<float>>("Transforms").value_or(std::vector<float>{});
+    model_ids = parser.readValue<std::vector<omp::SerializableObject::SerializationId>>("ModelIds").value_or(std::vector<omp::SerializableObject::SerializationId>{});
+    material_ids = parser.readValue<std::vector<omp::SerializableObject::SerializationId>>("MaterialIds").value_or(std::vector<omp::SerializableObject::SerializationId>{});
+    colors = parser.readValue<std::vector<float>>("Colors").value_or(std::vector<float>{});
+
+    size_t count = ids.size();
+    return names.size() == count
+            && transforms.size() == count * TRANSFORM_SIZE
+            && model_ids.size() == count
+            && material_ids.size() == count
+            && colors.size() == count * COLOR_SIZE;
+}
@@ -2,12 +2,41 @@
 
 #include <cstdint>
 #include <string>
+#include <vector>
 #include "UI/IDrawable.h"
 #include "Rendering/ModelInstance.h"
 
 namespace omp
 {
     class Scene;
+
+    /*
+     * @brief Scene entities stored column by column, one row per entity.
+     * Each column is one contiguous array in the scene file, so it is read in one pass.
+     */
+    struct SceneEntityColumns
+    {
+        // translation, rotation, scale
+        static constexpr size_t TRANSFORM_SIZE = 9;
+        // ambient, diffusive, specular
+        static constexpr size_t COLOR_SIZE = 12;
+
+        std::vector<std::string> names;
+        std::vector<uint32_t> ids;
+        std::vector<float> transforms;
+        // 0 when entity has no model or material
+        std::vector<omp::SerializableObject::SerializationId> model_ids;
+        std::vector<omp::SerializableObject::SerializationId> material_ids;
+        std::vector<float> colors;
+
+        size_t size() const { return ids.size(); }
+        void reserve(size_t inCount);
+
+        void write(JsonParser<>& parser) const;
+        // False if any column is missing or has wrong size
+        bool read(JsonParser<>& parser);
+    };
+
     class SceneEntity : public IDrawable
     {
     private:
@@ -49,5 +78,15 @@ namespace omp
         virtual void onSceneSave(JsonParser<>& parser, omp::Scene* scene);
         virtual void onSceneLoad(JsonParser<>& parser, omp::Scene* scene);
         virtual std::string getClassName() const { return "SceneEntity"; }
+
+        /*
+         * @brief Columnar saving used by scenes for plain entities, derived classes with own data use onSceneSave
+         */
+        void onColumnSave(omp::SceneEntityColumns& columns, omp::Scene* scene);
+        void onColumnLoad(const omp::SceneEntityColumns& columns, size_t row, omp::Scene* scene);
+
+    private:
+        void loadModelInstance(omp::SerializableObject::SerializationId modelId, const glm::vec3& pos, const glm::vec3& rot, const glm::vec3& scale, omp::Scene* scene);
+        void loadMaterialInstance(omp::SerializableObject::SerializationId materialId, const glm::vec4& ambient, const glm::vec4& diffusive, const glm::vec4& specular, omp::Scene* scene);
     };
 }
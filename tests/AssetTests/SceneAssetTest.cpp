@@ -133,3 +133,88 @@ TEST_F(SceneAssetSuite, SceneAsset__Test__Entities)
     ASSERT_EQ(*scene.getCurrentEntity(), entity);
 }
 
+
+TEST_F(SceneAssetSuite, SceneAsset__Test__ColumnarEntities)
+{
+    omp::Scene scene{};
+    for (int i = 0; i < 50; i++)
+    {
+        scene.addEntityToScene(std::make_unique<omp::SceneEntity>("ent" + std::to_string(i), nullptr));
+    }
+
+    omp::JsonParser<> parser{};
+    EXPECT_NO_THROW(scene.serialize(parser));
+    EXPECT_TRUE(parser.contains("EntityColumns"));
+    EXPECT_FALSE(parser.contains("ent0"));
+
+    omp::Scene second{};
+    EXPECT_NO_THROW(second.deserialize(parser));
+    ASSERT_EQ(second.getEntities().size(), 50);
+    for (int i = 0; i < 50; i++)
+    {
+        EXPECT_EQ(second.getEntities()[static_cast<size_t>(i)]->getName(), "ent" + std::to_string(i));
+        EXPECT_EQ(second.getEntities()[static_cast<size_t>(i)]->getId(), scene.getEntities()[static_cast<size_t>(i)]->getId());
+    }
+}
+
+TEST_F(SceneAssetSuite, SceneAsset__Test__RecordFormatFallback)
+{
+    // Scene saved before columnar format
+    omp::JsonParser<> parser{};
+    omp::JsonParser<> entity_parser{};
+    entity_parser.writeValue("ClassName", std::string("SceneEntity"));
+    entity_parser.writeValue("Id", uint32_t(113246234));
+    entity_parser.writeValue("Name", std::string("0-0"));
+    entity_parser.writeValue("have_model", false);
+    entity_parser.writeValue("have_material", false);
+    parser.writeObject("0-0", std::move(entity_parser));
+    parser.writeValue("EntityNames", std::vector<std::string>{"0-0"});
+    parser.writeValue("CameraNames", std::vector<std::string>{});
+    parser.writeValue("LightNames", std::vector<std::string>{});
+
+    omp::Scene scene{};
+    EXPECT_NO_THROW(scene.deserialize(parser));
+    ASSERT_EQ(scene.getEntities().size(), 1);
+    EXPECT_EQ(scene.getEntities()[0]->getName(), "0-0");
+    ASSERT_EQ(scene.getEntities()[0]->getId(), 113246234u);
+}
+
+TEST_F(SceneAssetSuite, SceneAsset__Test__ParallelDeserialization)
+{
+    omp::ThreadPool pool{4};
+    manager = std::make_unique<omp::AssetManager>(&pool);
+
+    omp::AssetHandle source_handle = manager->createAsset("sourcescene", "invalid", "Scene");
+    std::shared_ptr<omp::Scene> scene = manager->getAsset(source_handle).lock()->getObjectAs<omp::Scene>();
+    for (int i = 0; i < 5000; i++)
+    {
+        scene->addEntityToScene(std::make_unique<omp::SceneEntity>("ent" + std::to_string(i), nullptr));
+    }
+    for (int i = 0; i < 3000; i++)
+    {
+        scene->addLightToScene(std::make_unique<omp::LightObject<omp::PointLight>>("light" + std::to_string(i)));
+    }
+
+    omp::JsonParser<> parser{};
+    EXPECT_NO_THROW(scene->serialize(parser));
+
+    omp::AssetHandle target_handle = manager->createAsset("targetscene", "invalid", "Scene");
+    std::shared_ptr<omp::Scene> second = manager->getAsset(target_handle).lock()->getObjectAs<omp::Scene>();
+    ASSERT_EQ(second->getThreadPool(), &pool);
+    EXPECT_NO_THROW(second->deserialize(parser));
+
+    // Order matches the file no matter which thread loaded the entity
+    ASSERT_EQ(second->getEntities().size(), scene->getEntities().size());
+    for (size_t i = 0; i < scene->getEntities().size(); i++)
+    {
+        EXPECT_EQ(second->getEntities()[i]->getName(), scene->getEntities()[i]->getName());
+        EXPECT_EQ(second->getEntities()[i]->getId(), scene->getEntities()[i]->getId());
+    }
+    ASSERT_EQ(second->getLights().size(), scene->getLights().size());
+    for (size_t i = 0; i < scene->getLights().size(); i++)
+    {
+        EXPECT_EQ(second->getLights()[i]->getName(), scene->getLights()[i]->getName());
+    }
+
+    manager.reset();
+}
@@ -120,3 +120,41 @@ TEST_F(ThreadPoolSuite, ThreadPool_two)
 
     ASSERT_TRUE(true);
 }
+
+TEST_F(ThreadPoolSuite, ThreadPool_parallelFor)
+{
+    omp::ThreadPool pool{4};
+
+    std::vector<int> visits(10000, 0);
+    pool.parallelFor(visits.size(), 64, [&visits](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; i++)
+        {
+            visits[i]++;
+        }
+    });
+    for (int visit : visits)
+    {
+        EXPECT_EQ(visit, 1);
+    }
+
+    // Nested call from a worker must not wait forever on its own queue
+    std::future<size_t> nested = pool.submit([&pool]() -> size_t
+    {
+        std::atomic<size_t> sum{0};
+        pool.parallelFor(1000, 10, [&sum](size_t begin, size_t end)
+        {
+            sum += end - begin;
+        });
+        return sum.load();
+    });
+    EXPECT_EQ(nested.get(), 1000);
+
+    EXPECT_THROW(pool.parallelFor(100, 10, [](size_t begin, size_t)
+    {
+        if (begin == 50)
+        {
+            throw std::runtime_error("chunk failed");
+        }
+    }), std::runtime_error);
+}
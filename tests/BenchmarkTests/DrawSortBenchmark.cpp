@@ -0,0 +1,140 @@
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+#include "Logs.h"
+#include "Async/ThreadPool.h"
+#include "Rendering/DrawSort.h"
+
+namespace
+{
+    constexpr size_t s_DrawCount = 1000000;
+
+    double elapsedMs(std::chrono::steady_clock::time_point inStart)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - inStart).count();
+    }
+
+    // Stand in for material lookups of the old comparator, reached through weak pointers on every comparison
+    struct BenchmarkMaterial
+    {
+        bool blending = false;
+    };
+
+    struct BenchmarkDraw
+    {
+        std::weak_ptr<BenchmarkMaterial> material;
+        std::array<float, 3> position{};
+    };
+
+    bool isBlending(const BenchmarkDraw* inDraw)
+    {
+        const std::shared_ptr<BenchmarkMaterial> material = inDraw->material.lock();
+        return material && material->blending;
+    }
+
+    float distance(const std::array<float, 3>& inLeft, const std::array<float, 3>& inRight)
+    {
+        const float x = inLeft[0] - inRight[0];
+        const float y = inLeft[1] - inRight[1];
+        const float z = inLeft[2] - inRight[2];
+        return std::sqrt(x * x + y * y + z * z);
+    }
+}
+
+class DrawSortBenchmark : public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        omp::InitializeTestLogs();
+    }
+};
+
+// Draw list of a large scene sorted the way the renderer did it per comparison and with keys built once
+TEST_F(DrawSortBenchmark, MillionDraws)
+{
+    std::mt19937 random(5);
+    std::uniform_real_distribution<float> position(-1000.0f, 1000.0f);
+    std::uniform_int_distribution<size_t> material_index(0, 511);
+    std::uniform_int_distribution<uint32_t> pipeline_id(0, 7);
+
+    std::vector<std::shared_ptr<BenchmarkMaterial>> materials(512);
+    for (size_t index = 0; index < materials.size(); index++)
+    {
+        materials[index] = std::make_shared<BenchmarkMaterial>();
+        materials[index]->blending = index % 16 == 0;
+    }
+
+    std::vector<BenchmarkDraw> draws(s_DrawCount);
+    std::vector<uint32_t> draw_materials(s_DrawCount);
+    std::vector<uint32_t> draw_pipelines(s_DrawCount);
+    for (size_t index = 0; index < s_DrawCount; index++)
+    {
+        draw_materials[index] = static_cast<uint32_t>(material_index(random));
+        draw_pipelines[index] = pipeline_id(random);
+        draws[index].material = materials[draw_materials[index]];
+        draws[index].position = {position(random), position(random), position(random)};
+    }
+    const std::array<float, 3> camera = {0.0f, 0.0f, 0.0f};
+
+    std::vector<const BenchmarkDraw*> pointers(s_DrawCount);
+    for (size_t index = 0; index < s_DrawCount; index++)
+    {
+        pointers[index] = &draws[index];
+    }
+    auto start = std::chrono::steady_clock::now();
+    std::sort(pointers.begin(), pointers.end(), [&camera](const BenchmarkDraw* inLeft, const BenchmarkDraw* inRight)
+    {
+        const bool left_blending = isBlending(inLeft);
+        const bool right_blending = isBlending(inRight);
+        if (left_blending != right_blending)
+        {
+            return right_blending;
+        }
+        return distance(camera, inLeft->position) > distance(camera, inRight->position);
+    });
+    const double comparator_ms = elapsedMs(start);
+
+    const auto build_keys = [&](std::vector<omp::DrawSortEntry>& outEntries)
+    {
+        outEntries.resize(s_DrawCount);
+        for (size_t index = 0; index < s_DrawCount; index++)
+        {
+            const std::array<float, 3>& draw_position = draws[index].position;
+            const float depth = draw_position[0] * draw_position[0] + draw_position[1] * draw_position[1]
+                                + draw_position[2] * draw_position[2];
+            outEntries[index] = {omp::DrawSort::makeKey(materials[draw_materials[index]]->blending, draw_pipelines[index],
+                                                        draw_materials[index], depth),
+                                 static_cast<uint32_t>(index)};
+        }
+    };
+
+    std::vector<omp::DrawSortEntry> entries;
+    std::vector<omp::DrawSortEntry> scratch;
+    start = std::chrono::steady_clock::now();
+    build_keys(entries);
+    omp::DrawSort::sort(entries, scratch, nullptr);
+    const double serial_ms = elapsedMs(start);
+    const std::vector<omp::DrawSortEntry> serial_entries = entries;
+
+    omp::ThreadPool pool;
+    start = std::chrono::steady_clock::now();
+    build_keys(entries);
+    omp::DrawSort::sort(entries, scratch, &pool);
+    const double parallel_ms = elapsedMs(start);
+
+    INFO(LogTesting, "{} draws: comparator sort {:.2f} ms, keys and radix sort {:.2f} ms, on {} threads {:.2f} ms",
+         s_DrawCount, comparator_ms, serial_ms, std::thread::hardware_concurrency(), parallel_ms);
+
+    ASSERT_EQ(entries.size(), serial_entries.size());
+    for (size_t index = 1; index < entries.size(); index++)
+    {
+        ASSERT_LE(entries[index - 1].key, entries[index].key);
+        ASSERT_EQ(entries[index].index, serial_entries[index].index);
+    }
+}
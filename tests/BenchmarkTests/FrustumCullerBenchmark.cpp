@@ -0,0 +1,119 @@
+#include "gtest/gtest.h"
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "Logs.h"
+#include "Async/ThreadPool.h"
+#include "Rendering/FrustumCuller.h"
+
+namespace
+{
+    constexpr size_t s_EntityCount = 1000000;
+
+    double elapsedMs(std::chrono::steady_clock::time_point inStart)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - inStart).count();
+    }
+
+    /*
+     * @brief Column major view projection of a camera at the origin looking down -z,
+     * 60 degree vertical field of view, 16:9 viewport, depth in [0, 1]
+     */
+    std::array<float, 16> makeViewProjection()
+    {
+        const float focal = 1.0f / std::tan(0.5f * 1.047198f);
+        const float aspect = 16.0f / 9.0f;
+        const float near_plane = 0.1f;
+        const float far_plane = 1000.0f;
+        const float depth_scale = far_plane / (near_plane - far_plane);
+        const float depth_offset = -far_plane * near_plane / (far_plane - near_plane);
+        return {focal / aspect, 0.0f, 0.0f, 0.0f,
+                0.0f, focal, 0.0f, 0.0f,
+                0.0f, 0.0f, depth_scale, -1.0f,
+                0.0f, 0.0f, depth_offset, 0.0f};
+    }
+}
+
+class FrustumCullerBenchmark : public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        omp::InitializeTestLogs();
+    }
+};
+
+// Entities scattered around the camera as a large open scene would have them, culled without a window or device
+TEST_F(FrustumCullerBenchmark, MillionEntities)
+{
+    std::mt19937 random(3);
+    std::uniform_real_distribution<float> position(-1000.0f, 1000.0f);
+    std::uniform_real_distribution<float> extent(0.5f, 5.0f);
+
+    omp::BoundingBoxArray boxes;
+    boxes.resize(s_EntityCount);
+    for (size_t index = 0; index < s_EntityCount; index++)
+    {
+        omp::BoundingBox box;
+        for (size_t axis = 0; axis < 3; axis++)
+        {
+            box.min[axis] = position(random);
+            box.max[axis] = box.min[axis] + extent(random);
+        }
+        boxes.set(index, box);
+    }
+
+    const std::array<float, 16> view_projection = makeViewProjection();
+    const omp::Frustum frustum = omp::BoundsLib::extractFrustum(view_projection.data());
+
+    // Scalar sphere test as entities were culled one by one before
+    constexpr size_t iterations = 20;
+    size_t sphere_visible = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t iteration = 0; iteration < iterations; iteration++)
+    {
+        sphere_visible = 0;
+        for (size_t index = 0; index < s_EntityCount; index++)
+        {
+            omp::BoundingSphere sphere;
+            float radius = 0.0f;
+            for (size_t axis = 0; axis < 3; axis++)
+            {
+                const float half = (boxes.max[axis][index] - boxes.min[axis][index]) * 0.5f;
+                sphere.center[axis] = boxes.min[axis][index] + half;
+                radius += half * half;
+            }
+            sphere.radius = std::sqrt(radius);
+            sphere_visible += omp::BoundsLib::isVisible(frustum, sphere) ? 1U : 0U;
+        }
+    }
+    const double sphere_ms = elapsedMs(start) / iterations;
+
+    std::vector<uint32_t> visible;
+    start = std::chrono::steady_clock::now();
+    for (size_t iteration = 0; iteration < iterations; iteration++)
+    {
+        omp::FrustumCuller::cull(frustum, boxes, nullptr, visible);
+    }
+    const double serial_ms = elapsedMs(start) / iterations;
+    const size_t serial_visible = visible.size();
+
+    omp::ThreadPool pool;
+    start = std::chrono::steady_clock::now();
+    for (size_t iteration = 0; iteration < iterations; iteration++)
+    {
+        omp::FrustumCuller::cull(frustum, boxes, &pool, visible);
+    }
+    const double parallel_ms = elapsedMs(start) / iterations;
+
+    INFO(LogTesting, "{} entities, {} visible: scalar spheres {:.2f} ms, SIMD boxes {:.2f} ms, SIMD boxes on {} threads {:.2f} ms",
+         s_EntityCount, serial_visible, sphere_ms, serial_ms, std::thread::hardware_concurrency(), parallel_ms);
+
+    EXPECT_EQ(visible.size(), serial_visible);
+    // Boxes are never looser than spheres around them
+    EXPECT_LE(serial_visible, sphere_visible);
+    EXPECT_GT(serial_visible, 0u);
+    EXPECT_LT(serial_visible, s_EntityCount / 2);
+}
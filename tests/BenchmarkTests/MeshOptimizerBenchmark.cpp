@@ -0,0 +1,146 @@
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "Logs.h"
+#include "Rendering/MeshOptimizer.h"
+#include "Rendering/MeshSimplifier.h"
+
+namespace
+{
+    constexpr uint32_t s_Rings = 512;
+    constexpr uint32_t s_Segments = 1024;
+
+    double elapsedMs(std::chrono::steady_clock::time_point inStart)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - inStart).count();
+    }
+
+    // UV sphere of about 1M triangles in scanline order
+    void makeSphere(std::vector<std::array<float, 3>>& outPositions, std::vector<uint32_t>& outIndices)
+    {
+        for (uint32_t ring = 0; ring <= s_Rings; ring++)
+        {
+            const float theta = 3.14159265f * static_cast<float>(ring) / static_cast<float>(s_Rings);
+            for (uint32_t segment = 0; segment < s_Segments; segment++)
+            {
+                const float phi = 6.2831853f * static_cast<float>(segment) / static_cast<float>(s_Segments);
+                outPositions.push_back({std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)});
+            }
+        }
+
+        for (uint32_t ring = 0; ring < s_Rings; ring++)
+        {
+            for (uint32_t segment = 0; segment < s_Segments; segment++)
+            {
+                const uint32_t a = ring * s_Segments + segment;
+                const uint32_t b = ring * s_Segments + (segment + 1) % s_Segments;
+                outIndices.insert(outIndices.end(), {a, a + s_Segments, b, b, a + s_Segments, b + s_Segments});
+            }
+        }
+    }
+
+    void report(const char* inStage, const omp::VertexCacheStatistics& inStatistics, double inMs)
+    {
+        INFO(LogTesting, "{}: ACMR {:.3f}, ATVR {:.3f}, {:.0f} ms", inStage, inStatistics.acmr, inStatistics.atvr, inMs);
+    }
+}
+
+class MeshOptimizerBenchmark : public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        omp::InitializeTestLogs();
+    }
+};
+
+// About 1M triangles in scanline order, as exporters write grids, and shuffled, as some write soups
+TEST_F(MeshOptimizerBenchmark, SphereStages)
+{
+    std::vector<std::array<float, 3>> positions;
+    std::vector<uint32_t> scanline;
+    makeSphere(positions, scanline);
+
+    std::vector<std::array<uint32_t, 3>> triangles(scanline.size() / 3);
+    std::memcpy(triangles.data(), scanline.data(), scanline.size() * sizeof(uint32_t));
+    std::shuffle(triangles.begin(), triangles.end(), std::mt19937(7));
+    std::vector<uint32_t> shuffled(scanline.size());
+    std::memcpy(shuffled.data(), triangles.data(), shuffled.size() * sizeof(uint32_t));
+
+    for (std::vector<uint32_t>* indices : {&scanline, &shuffled})
+    {
+        INFO(LogTesting, "{} input, {} triangles", indices == &scanline ? "Scanline" : "Shuffled", indices->size() / 3);
+        const omp::VertexCacheStatistics before = omp::MeshOptimizer::analyzeVertexCache(*indices, positions.size());
+        report("Input", before, 0.0);
+
+        auto start = std::chrono::steady_clock::now();
+        omp::MeshOptimizer::optimizeVertexCache(*indices, positions.size());
+        const double cache_ms = elapsedMs(start);
+        const omp::VertexCacheStatistics cache = omp::MeshOptimizer::analyzeVertexCache(*indices, positions.size());
+        report("Vertex cache", cache, cache_ms);
+
+        start = std::chrono::steady_clock::now();
+        omp::MeshOptimizer::optimizeOverdraw(*indices, positions.front().data(), sizeof(positions.front()), positions.size());
+        const double overdraw_ms = elapsedMs(start);
+        report("Overdraw", omp::MeshOptimizer::analyzeVertexCache(*indices, positions.size()), overdraw_ms);
+
+        std::vector<std::array<float, 3>> vertices = positions;
+        start = std::chrono::steady_clock::now();
+        omp::MeshOptimizer::optimizeVertexFetch(vertices, *indices);
+        const double fetch_ms = elapsedMs(start);
+        report("Vertex fetch", omp::MeshOptimizer::analyzeVertexCache(*indices, vertices.size()), fetch_ms);
+
+        EXPECT_LT(cache.acmr, before.acmr);
+    }
+}
+
+// LOD chain as ModelImporter builds it, and triangles drawn for a field of spheres picked by projected size
+TEST_F(MeshOptimizerBenchmark, SphereLodChain)
+{
+    std::vector<std::array<float, 3>> positions;
+    std::vector<std::vector<uint32_t>> lods(1);
+    makeSphere(positions, lods.front());
+    std::vector<float> errors = {0.0f};
+
+    while (lods.size() < 5)
+    {
+        const std::vector<uint32_t>& previous = lods.back();
+        float error = 0.0f;
+        auto start = std::chrono::steady_clock::now();
+        std::vector<uint32_t> lod = omp::MeshSimplifier::simplify(previous, positions.front().data(), sizeof(positions.front()),
+                                                                  positions.size(), previous.size() / 6 * 3, 0.05f, &error);
+        const double simplify_ms = elapsedMs(start);
+        errors.push_back(errors.back() + error * 2.0f);
+        INFO(LogTesting, "LOD {}: {} triangles, error {:.5f}, {:.0f} ms", lods.size(), lod.size() / 3, errors.back(), simplify_ms);
+        ASSERT_LT(lod.size(), previous.size());
+        lods.push_back(std::move(lod));
+    }
+
+    // 100 x 100 spheres one unit apart, seen from the edge of the field by a 1080p 45 degree camera
+    const float pixels_per_unit = 1080.0f / (2.0f * std::tan(0.5f * 0.785398f));
+    size_t full_triangles = 0;
+    size_t lod_triangles = 0;
+    for (size_t row = 0; row < 100; row++)
+    {
+        for (size_t column = 0; column < 100; column++)
+        {
+            const float x = static_cast<float>(column) - 50.0f;
+            const float z = static_cast<float>(row) + 2.0f;
+            const float max_error = 1.0f * std::sqrt(x * x + z * z) / pixels_per_unit;
+            size_t level = 0;
+            while (level + 1 < lods.size() && errors[level + 1] <= max_error)
+            {
+                level++;
+            }
+            full_triangles += lods.front().size() / 3;
+            lod_triangles += lods[level].size() / 3;
+        }
+    }
+    INFO(LogTesting, "10000 spheres: {} triangles without LODs, {} with LODs", full_triangles, lod_triangles);
+    EXPECT_LT(lod_triangles * 4, full_triangles);
+}
@@ -0,0 +1,127 @@
+#include "gtest/gtest.h"
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <vector>
+#include "Logs.h"
+#include "Rendering/MeshOptimizer.h"
+#include "Rendering/MeshletBuilder.h"
+
+namespace
+{
+    constexpr uint32_t s_Rings = 512;
+    constexpr uint32_t s_Segments = 1024;
+
+    double elapsedMs(std::chrono::steady_clock::time_point inStart)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - inStart).count();
+    }
+
+    // UV sphere of about 1M triangles with radius one, counter clockwise seen from outside
+    void makeSphere(std::vector<std::array<float, 3>>& outPositions, std::vector<uint32_t>& outIndices)
+    {
+        for (uint32_t ring = 0; ring <= s_Rings; ring++)
+        {
+            const float theta = 3.14159265f * static_cast<float>(ring) / static_cast<float>(s_Rings);
+            for (uint32_t segment = 0; segment < s_Segments; segment++)
+            {
+                const float phi = 6.2831853f * static_cast<float>(segment) / static_cast<float>(s_Segments);
+                outPositions.push_back({std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)});
+            }
+        }
+
+        for (uint32_t ring = 0; ring < s_Rings; ring++)
+        {
+            for (uint32_t segment = 0; segment < s_Segments; segment++)
+            {
+                const uint32_t a = ring * s_Segments + segment;
+                const uint32_t b = ring * s_Segments + (segment + 1) % s_Segments;
+                outIndices.insert(outIndices.end(), {a, b, a + s_Segments, b, b + s_Segments, a + s_Segments});
+            }
+        }
+    }
+
+    /*
+     * @brief Column major view projection of a camera at inDistance on +z looking at the origin,
+     * 45 degree vertical field of view, square viewport, depth in [0, 1]
+     */
+    std::array<float, 16> makeViewProjection(float inDistance)
+    {
+        const float focal = 1.0f / std::tan(0.5f * 0.785398f);
+        const float near_plane = 0.1f;
+        const float far_plane = 100.0f;
+        const float depth_scale = far_plane / (near_plane - far_plane);
+        const float depth_offset = -far_plane * near_plane / (far_plane - near_plane);
+        return {focal, 0.0f, 0.0f, 0.0f,
+                0.0f, focal, 0.0f, 0.0f,
+                0.0f, 0.0f, depth_scale, -1.0f,
+                0.0f, 0.0f, -inDistance * depth_scale + depth_offset, inDistance};
+    }
+}
+
+class MeshletBenchmark : public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        omp::InitializeTestLogs();
+    }
+};
+
+// Cluster build of a cache optimized 1M triangle mesh as ModelImporter runs it, then culling from a close and a far camera
+TEST_F(MeshletBenchmark, SphereBuildAndCull)
+{
+    std::vector<std::array<float, 3>> positions;
+    std::vector<uint32_t> indices;
+    makeSphere(positions, indices);
+    omp::MeshOptimizer::optimizeVertexCache(indices, positions.size());
+    const omp::VertexCacheStatistics before = omp::MeshOptimizer::analyzeVertexCache(indices, positions.size());
+
+    auto start = std::chrono::steady_clock::now();
+    const std::vector<omp::Meshlet> meshlets = omp::MeshletBuilder::build(indices, 0, indices.size(), positions.front().data(),
+                                                                          sizeof(positions.front()), positions.size());
+    const double build_ms = elapsedMs(start);
+    const omp::VertexCacheStatistics after = omp::MeshOptimizer::analyzeVertexCache(indices, positions.size());
+
+    size_t vertices = 0;
+    size_t coned = 0;
+    for (const omp::Meshlet& meshlet : meshlets)
+    {
+        vertices += meshlet.vertex_count;
+        coned += meshlet.cone_cutoff < 1.0f ? 1 : 0;
+    }
+    INFO(LogTesting, "{} triangles into {} meshlets in {:.0f} ms, {:.1f} vertices and {:.1f} triangles each, {} with cones, ACMR {:.3f} -> {:.3f}",
+         indices.size() / 3, meshlets.size(), build_ms, static_cast<double>(vertices) / static_cast<double>(meshlets.size()),
+         static_cast<double>(indices.size() / 3) / static_cast<double>(meshlets.size()), coned, before.acmr, after.acmr);
+
+    const std::array<float, 16> model = {1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f};
+    for (float distance : {1.5f, 4.0f})
+    {
+        const std::array<float, 16> view_projection = makeViewProjection(distance);
+        const omp::Frustum frustum = omp::BoundsLib::extractFrustum(view_projection.data());
+
+        std::vector<omp::IndexRange> ranges;
+        constexpr size_t iterations = 100;
+        omp::MeshletCullStatistics statistics;
+        start = std::chrono::steady_clock::now();
+        for (size_t iteration = 0; iteration < iterations; iteration++)
+        {
+            ranges.clear();
+            statistics = omp::MeshletBuilder::cull(meshlets, model.data(), frustum, {0.0f, 0.0f, distance}, ranges);
+        }
+        const double cull_ms = elapsedMs(start) / iterations;
+
+        size_t drawn_triangles = 0;
+        for (const omp::IndexRange& range : ranges)
+        {
+            drawn_triangles += range.index_count / 3;
+        }
+        const double meshlet_count = static_cast<double>(meshlets.size());
+        INFO(LogTesting, "Camera at {:.1f}: {:.1f}% frustum culled, {:.1f}% backface culled, {} of {} triangles in {} ranges, {:.3f} ms",
+             distance, 100.0 * static_cast<double>(statistics.frustum_culled) / meshlet_count,
+             100.0 * static_cast<double>(statistics.backface_culled) / meshlet_count, drawn_triangles, indices.size() / 3, ranges.size(), cull_ms);
+
+        // At least the far hemisphere faces away
+        EXPECT_LT(drawn_triangles * 3, indices.size() / 3 * 2);
+    }
+}
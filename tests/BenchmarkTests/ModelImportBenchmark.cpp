@@ -0,0 +1,263 @@
+#include "gtest/gtest.h"
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include "Logs.h"
+#include "Async/ThreadPool.h"
+#include "IO/MappedFile.h"
+#include "Math/DedupTable.h"
+#include "Rendering/ModelStatics.h"
+
+namespace
+{
+    // Cells per side, two triangles per cell, a bit over 10M triangles
+    constexpr size_t s_GridSize = 2237;
+
+    double elapsedMs(std::chrono::steady_clock::time_point inStart)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - inStart).count();
+    }
+
+    void appendNumber(std::string& outData, float inValue)
+    {
+        char buffer[32];
+        std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), inValue, std::chars_format::fixed, 6);
+        outData.append(buffer, result.ptr);
+    }
+
+    void appendNumber(std::string& outData, size_t inValue)
+    {
+        char buffer[32];
+        std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), inValue);
+        outData.append(buffer, result.ptr);
+    }
+
+    void appendCorner(std::string& outData, size_t inIndex)
+    {
+        outData += ' ';
+        appendNumber(outData, inIndex);
+        outData += '/';
+        appendNumber(outData, inIndex);
+        outData += '/';
+        appendNumber(outData, inIndex);
+    }
+
+    // Height field with per vertex uv and normal, written as triangles
+    void writeGrid(const std::string& inPath)
+    {
+        std::ofstream file(inPath, std::ios::binary);
+        std::string data;
+        const float scale = 1.0f / static_cast<float>(s_GridSize);
+        for (size_t y = 0; y <= s_GridSize; y++)
+        {
+            for (size_t x = 0; x <= s_GridSize; x++)
+            {
+                const float u = static_cast<float>(x) * scale;
+                const float v = static_cast<float>(y) * scale;
+                const float height = static_cast<float>((x * 7 + y * 13) % 101) * 0.01f;
+                data += "v ";
+                appendNumber(data, u * 100.0f);
+                data += ' ';
+                appendNumber(data, height);
+                data += ' ';
+                appendNumber(data, v * 100.0f);
+                data += "\nvt ";
+                appendNumber(data, u);
+                data += ' ';
+                appendNumber(data, v);
+                data += "\nvn ";
+                appendNumber(data, height - 0.5f);
+                data += " 1.0 ";
+                appendNumber(data, 0.5f - height);
+                data += '\n';
+            }
+            file.write(data.data(), static_cast<std::streamsize>(data.size()));
+            data.clear();
+        }
+
+        for (size_t y = 0; y < s_GridSize; y++)
+        {
+            for (size_t x = 0; x < s_GridSize; x++)
+            {
+                const size_t first = y * (s_GridSize + 1) + x + 1;
+                const size_t next_row = first + s_GridSize + 1;
+                data += 'f';
+                appendCorner(data, first);
+                appendCorner(data, first + 1);
+                appendCorner(data, next_row + 1);
+                data += "\nf";
+                appendCorner(data, first);
+                appendCorner(data, next_row + 1);
+                appendCorner(data, next_row);
+                data += '\n';
+            }
+            file.write(data.data(), static_cast<std::streamsize>(data.size()));
+            data.clear();
+        }
+    }
+
+    // Vertex hash before HashLib::hashFloats, ignores normals
+    struct LegacyVertexHash
+    {
+        size_t operator()(const omp::Vertex& vertex) const
+        {
+            auto hash3 = [](const glm::vec3& inValue)
+            {
+                std::hash<float> hash;
+                return ((hash(inValue.x) ^ (hash(inValue.y) << 1)) >> 1) ^ (hash(inValue.z) << 1);
+            };
+            std::hash<float> hash;
+            const size_t tex_coord = (hash(vertex.tex_coord.x) ^ (hash(vertex.tex_coord.y) << 1)) >> 1;
+            return ((hash3(vertex.pos) ^ (hash3(vertex.color) << 1)) >> 1) ^ (tex_coord << 1);
+        }
+    };
+
+    // Flat shaded terrain, every position is shared by corners with different normals
+    std::vector<omp::Vertex> makeFlatShadedCorners(size_t inGridSize)
+    {
+        static constexpr std::array<std::array<size_t, 2>, 6> offsets = {{{0, 0}, {1, 0}, {1, 1}, {0, 0}, {1, 1}, {0, 1}}};
+        std::vector<omp::Vertex> corners;
+        corners.reserve(inGridSize * inGridSize * offsets.size());
+        const float scale = 1.0f / static_cast<float>(inGridSize);
+        for (size_t y = 0; y < inGridSize; y++)
+        {
+            for (size_t x = 0; x < inGridSize; x++)
+            {
+                const glm::vec3 normal = glm::normalize(glm::vec3(static_cast<float>((x * 7 + y * 3) % 5), 4.0f, static_cast<float>((x + y) % 3)));
+                for (size_t corner = 0; corner < offsets.size(); corner++)
+                {
+                    const float u = static_cast<float>(x + offsets[corner][0]) * scale;
+                    const float v = static_cast<float>(y + offsets[corner][1]) * scale;
+                    omp::Vertex vertex{};
+                    vertex.pos = {u * 100.0f, 0.0f, v * 100.0f};
+                    vertex.color = {1.0f, 1.0f, 1.0f};
+                    vertex.tex_coord = {u, v};
+                    vertex.normal = corner < 3 ? normal : -normal;
+                    corners.push_back(vertex);
+                }
+            }
+        }
+        return corners;
+    }
+
+    void expectSameMesh(const omp::MeshData& inExpected, const omp::MeshData& inActual)
+    {
+        ASSERT_EQ(inExpected.vertices.size(), inActual.vertices.size());
+        ASSERT_EQ(inExpected.indices, inActual.indices);
+        for (size_t index = 0; index < inExpected.vertices.size(); index++)
+        {
+            ASSERT_TRUE(inExpected.vertices[index] == inActual.vertices[index]) << "vertex " << index;
+        }
+    }
+}
+
+class ModelImportBenchmark : public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        omp::InitializeTestLogs();
+    }
+
+    std::string m_Path = (std::filesystem::temp_directory_path() / "stomp_model_import_benchmark.obj").string();
+
+    virtual void TearDown() override
+    {
+        std::filesystem::remove(m_Path);
+    }
+};
+
+TEST_F(ModelImportBenchmark, RepositoryModelsMatchTinyobj)
+{
+    for (const auto& entry : std::filesystem::directory_iterator("../../../models"))
+    {
+        if (entry.path().extension() != ".obj")
+        {
+            continue;
+        }
+
+        omp::MappedFile file;
+        ASSERT_TRUE(file.open(entry.path().string()));
+        omp::ThreadPool pool;
+        std::shared_ptr<omp::MeshData> expected = omp::ModelImporter::parseObjTinyobj(file.view(), entry.path().string());
+        std::shared_ptr<omp::MeshData> actual = omp::ModelImporter::parseObj(file.view(), entry.path().string(), &pool);
+        ASSERT_TRUE(expected && actual);
+        expectSameMesh(*expected, *actual);
+    }
+}
+
+TEST_F(ModelImportBenchmark, TenMillionTriangles)
+{
+    auto start = std::chrono::steady_clock::now();
+    writeGrid(m_Path);
+    INFO(LogTesting, "Generated {} triangles, {:.1f} MB in {:.0f} ms", s_GridSize * s_GridSize * 2,
+         static_cast<double>(std::filesystem::file_size(m_Path)) / (1024.0 * 1024.0), elapsedMs(start));
+
+    omp::MappedFile file;
+    ASSERT_TRUE(file.open(m_Path));
+
+    start = std::chrono::steady_clock::now();
+    std::shared_ptr<omp::MeshData> tinyobj_mesh = omp::ModelImporter::parseObjTinyobj(file.view(), m_Path);
+    const double tinyobj_ms = elapsedMs(start);
+    ASSERT_TRUE(tinyobj_mesh);
+
+    start = std::chrono::steady_clock::now();
+    std::shared_ptr<omp::MeshData> serial_mesh = omp::ModelImporter::parseObj(file.view(), m_Path, nullptr);
+    const double serial_ms = elapsedMs(start);
+    ASSERT_TRUE(serial_mesh);
+
+    omp::ThreadPool pool;
+    start = std::chrono::steady_clock::now();
+    std::shared_ptr<omp::MeshData> parallel_mesh = omp::ModelImporter::parseObj(file.view(), m_Path, &pool);
+    const double parallel_ms = elapsedMs(start);
+    ASSERT_TRUE(parallel_mesh);
+
+    INFO(LogTesting, "tinyobj {:.0f} ms, ObjParser single thread {:.0f} ms, ObjParser on {} threads {:.0f} ms",
+         tinyobj_ms, serial_ms, std::thread::hardware_concurrency(), parallel_ms);
+    INFO(LogTesting, "{} vertices, {} indices", parallel_mesh->vertices.size(), parallel_mesh->indices.size());
+
+    expectSameMesh(*tinyobj_mesh, *serial_mesh);
+    expectSameMesh(*tinyobj_mesh, *parallel_mesh);
+}
+
+TEST_F(ModelImportBenchmark, VertexDeduplication)
+{
+    const std::vector<omp::Vertex> corners = makeFlatShadedCorners(1000);
+
+    auto start = std::chrono::steady_clock::now();
+    omp::MeshData legacy;
+    {
+        std::unordered_map<omp::Vertex, uint32_t, LegacyVertexHash> unique_vertices;
+        for (const omp::Vertex& vertex : corners)
+        {
+            if (unique_vertices.count(vertex) == 0)
+            {
+                unique_vertices[vertex] = static_cast<uint32_t>(legacy.vertices.size());
+                legacy.vertices.push_back(vertex);
+            }
+            legacy.indices.push_back(unique_vertices[vertex]);
+        }
+    }
+    const double legacy_ms = elapsedMs(start);
+
+    start = std::chrono::steady_clock::now();
+    omp::MeshData table;
+    {
+        table.indices.reserve(corners.size());
+        omp::DedupTable<omp::Vertex> unique_vertices(table.vertices, corners.size());
+        for (const omp::Vertex& vertex : corners)
+        {
+            table.indices.push_back(unique_vertices.insert(vertex));
+        }
+    }
+    const double table_ms = elapsedMs(start);
+
+    INFO(LogTesting, "{} corners, {} vertices: unordered_map {:.0f} ms, DedupTable {:.0f} ms",
+         corners.size(), table.vertices.size(), legacy_ms, table_ms);
+    expectSameMesh(legacy, table);
+    EXPECT_LT(table_ms, legacy_ms);
+}
@@ -0,0 +1,217 @@
+#include "gtest/gtest.h"
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include "Logs.h"
+#include "IO/JsonParser.h"
+
+namespace
+{
+    // main_scene.json entity layout scaled up
+    constexpr size_t s_EntityCount = 100000;
+
+    const std::vector<std::string> s_FloatKeys = {
+        "translation_x", "translation_y", "translation_z",
+        "rotation_x", "rotation_y", "rotation_z",
+        "scale_x", "scale_y", "scale_z",
+        "ambient_x", "ambient_y", "ambient_z", "ambient_w",
+        "diffusive_x", "diffusive_y", "diffusive_z", "diffusive_w",
+        "specular_x", "specular_y", "specular_z", "specular_w"
+    };
+
+    struct BenchmarkResult
+    {
+        double write_ms = 0;
+        double parse_ms = 0;
+        size_t file_size = 0;
+        double checksum = 0;
+    };
+
+    double elapsedMs(std::chrono::steady_clock::time_point inStart)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - inStart).count();
+    }
+
+    template<typename ParserType>
+    BenchmarkResult runBenchmark(const std::string& inPath, omp::EJsonFormat inFormat)
+    {
+        BenchmarkResult result;
+
+        auto start = std::chrono::steady_clock::now();
+        {
+            omp::JsonParser<ParserType> scene;
+            std::vector<std::string> names;
+            names.reserve(s_EntityCount);
+            for (size_t i = 0; i < s_EntityCount; i++)
+            {
+                std::string name = std::to_string(i / 100) + "-" + std::to_string(i % 100);
+                omp::JsonParser<ParserType> entity;
+                entity.writeValue("ClassName", "SceneEntity");
+                entity.writeValue("Id", static_cast<uint32_t>(i));
+                entity.writeValue("Name", name);
+                entity.writeValue("have_model", true);
+                entity.writeValue("have_material", true);
+                entity.writeValue("model_id", uint64_t(6474591899397657ULL));
+                entity.writeValue("material_id", uint64_t(10133762301734425ULL));
+                for (size_t key = 0; key < s_FloatKeys.size(); key++)
+                {
+                    entity.writeValue(s_FloatKeys[key], static_cast<float>(i % 1000) * 0.25f + static_cast<float>(key));
+                }
+                scene.writeObject(name, std::move(entity));
+                names.push_back(std::move(name));
+            }
+            scene.writeValue("EntityNames", names);
+            EXPECT_TRUE(scene.writeToFile(inPath, inFormat));
+        }
+        result.write_ms = elapsedMs(start);
+        result.file_size = std::filesystem::file_size(inPath);
+
+        start = std::chrono::steady_clock::now();
+        {
+            omp::JsonParser<ParserType> scene;
+            EXPECT_TRUE(scene.populateFromFile(inPath));
+            std::vector<std::string> names = scene.template readValue<std::vector<std::string>>("EntityNames").value_or(std::vector<std::string>{});
+            EXPECT_EQ(names.size(), s_EntityCount);
+            for (const std::string& name : names)
+            {
+                omp::JsonParser<ParserType> entity = scene.readObject(name);
+                result.checksum += entity.template readValue<uint32_t>("Id").value_or(0);
+                for (const std::string& key : s_FloatKeys)
+                {
+                    result.checksum += static_cast<double>(entity.template readValue<float>(key).value_or(0.f));
+                }
+            }
+        }
+        result.parse_ms = elapsedMs(start);
+
+        return result;
+    }
+
+    // Scene::serialize layout with entities stored in columns
+    template<typename ParserType>
+    BenchmarkResult runColumnarBenchmark(const std::string& inPath, omp::EJsonFormat inFormat)
+    {
+        BenchmarkResult result;
+
+        auto start = std::chrono::steady_clock::now();
+        {
+            std::vector<std::string> names;
+            std::vector<uint32_t> ids;
+            std::vector<float> transforms;
+            std::vector<float> colors;
+            std::vector<uint64_t> model_ids(s_EntityCount, 6474591899397657ULL);
+            std::vector<uint64_t> material_ids(s_EntityCount, 10133762301734425ULL);
+            for (size_t i = 0; i < s_EntityCount; i++)
+            {
+                names.push_back(std::to_string(i / 100) + "-" + std::to_string(i % 100));
+                ids.push_back(static_cast<uint32_t>(i));
+                for (size_t key = 0; key < s_FloatKeys.size(); key++)
+                {
+                    float value = static_cast<float>(i % 1000) * 0.25f + static_cast<float>(key);
+                    (key < 9 ? transforms : colors).push_back(value);
+                }
+            }
+
+            omp::JsonParser<ParserType> scene;
+            omp::JsonParser<ParserType> columns;
+            columns.writeValue("Names", names);
+            columns.writeValue("Ids", ids);
+            columns.writeValue("Transforms", transforms);
+            columns.writeValue("ModelIds", model_ids);
+            columns.writeValue("MaterialIds", material_ids);
+            columns.writeValue("Colors", colors);
+            scene.writeValue("FormatVersion", 2u);
+            scene.writeObject("EntityColumns", std::move(columns));
+            EXPECT_TRUE(scene.writeToFile(inPath, inFormat));
+        }
+        result.write_ms = elapsedMs(start);
+        result.file_size = std::filesystem::file_size(inPath);
+
+        start = std::chrono::steady_clock::now();
+        {
+            omp::JsonParser<ParserType> scene;
+            EXPECT_TRUE(scene.populateFromFile(inPath));
+            omp::JsonParser<ParserType> columns = scene.readObject("EntityColumns");
+            std::vector<uint32_t> ids = columns.template readValue<std::vector<uint32_t>>("Ids").value_or(std::vector<uint32_t>{});
+            std::vector<float> transforms = columns.template readValue<std::vector<float>>("Transforms").value_or(std::vector<float>{});
+            std::vector<float> colors = columns.template readValue<std::vector<float>>("Colors").value_or(std::vector<float>{});
+            EXPECT_EQ(ids.size(), s_EntityCount);
+            for (uint32_t id : ids)
+            {
+                result.checksum += id;
+            }
+            for (float value : transforms)
+            {
+                result.checksum += static_cast<double>(value);
+            }
+            for (float value : colors)
+            {
+                result.checksum += static_cast<double>(value);
+            }
+        }
+        result.parse_ms = elapsedMs(start);
+
+        return result;
+    }
+
+    void report(const std::string& inName, const BenchmarkResult& inResult)
+    {
+        double megabytes = static_cast<double>(inResult.file_size) / (1024.0 * 1024.0);
+        INFO(LogTesting, "{}: {} entities, {:.1f} MB, write {:.0f} ms ({:.1f} MB/s), parse {:.0f} ms ({:.1f} MB/s)",
+             inName, s_EntityCount, megabytes,
+             inResult.write_ms, megabytes / (inResult.write_ms / 1000.0),
+             inResult.parse_ms, megabytes / (inResult.parse_ms / 1000.0));
+    }
+}
+
+class SerializationBenchmark : public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        omp::InitializeTestLogs();
+    }
+
+    std::string m_Path = (std::filesystem::temp_directory_path() / "stomp_serialization_benchmark.json").string();
+};
+
+TEST_F(SerializationBenchmark, SceneBackends)
+{
+    BenchmarkResult nlohmann_text = runBenchmark<omp::nlohmannjson>(m_Path, omp::EJsonFormat::Text);
+    report("nlohmannjson text", nlohmann_text);
+
+    BenchmarkResult nlohmann_binary = runBenchmark<omp::nlohmannjson>(m_Path, omp::EJsonFormat::Binary);
+    report("nlohmannjson binary", nlohmann_binary);
+
+    BenchmarkResult stream_text = runBenchmark<omp::streamjson>(m_Path, omp::EJsonFormat::Text);
+    report("streamjson text", stream_text);
+
+    BenchmarkResult binary = runBenchmark<omp::binaryjson>(m_Path, omp::EJsonFormat::Binary);
+    report("binaryjson binary", binary);
+
+    // Every backend must read back the same scene
+    EXPECT_EQ(nlohmann_text.checksum, nlohmann_binary.checksum);
+    EXPECT_EQ(nlohmann_text.checksum, stream_text.checksum);
+    EXPECT_EQ(nlohmann_text.checksum, binary.checksum);
+    ASSERT_LT(binary.file_size, nlohmann_text.file_size);
+}
+
+TEST_F(SerializationBenchmark, ColumnarSceneBackends)
+{
+    BenchmarkResult records = runBenchmark<omp::binaryjson>(m_Path, omp::EJsonFormat::Binary);
+    report("binaryjson records", records);
+
+    BenchmarkResult nlohmann_text = runColumnarBenchmark<omp::nlohmannjson>(m_Path, omp::EJsonFormat::Text);
+    report("nlohmannjson columns text", nlohmann_text);
+
+    BenchmarkResult stream_text = runColumnarBenchmark<omp::streamjson>(m_Path, omp::EJsonFormat::Text);
+    report("streamjson columns text", stream_text);
+
+    BenchmarkResult binary = runColumnarBenchmark<omp::binaryjson>(m_Path, omp::EJsonFormat::Binary);
+    report("binaryjson columns binary", binary);
+
+    EXPECT_EQ(nlohmann_text.checksum, stream_text.checksum);
+    EXPECT_EQ(nlohmann_text.checksum, binary.checksum);
+    ASSERT_LT(binary.file_size, records.file_size);
+}
@@ -0,0 +1,89 @@
+#include "gtest/gtest.h"
+#include <filesystem>
+#include <fstream>
+#include "IO/AsyncFileReader.h"
+#include "Async/ThreadPool.h"
+#include "Logs.h"
+
+class AsyncFileReaderSuite : public ::testing::Test
+{
+protected:
+    std::vector<std::string> m_Paths;
+
+    static void SetUpTestSuite()
+    {
+        omp::InitializeTestLogs();
+    }
+
+    virtual void SetUp() override
+    {
+        std::filesystem::path directory = std::filesystem::temp_directory_path() / "omp_async_reader";
+        std::filesystem::create_directories(directory);
+        for (size_t i = 0; i < 200; i++)
+        {
+            std::string path = (directory / ("file" + std::to_string(i) + ".txt")).string();
+            std::ofstream file(path, std::ios::binary);
+            file << std::string(i * 997, static_cast<char>('a' + i % 26));
+            m_Paths.push_back(path);
+        }
+    }
+
+    virtual void TearDown() override
+    {
+        std::filesystem::remove_all(std::filesystem::temp_directory_path() / "omp_async_reader");
+    }
+
+    void readAll(omp::AsyncFileReader& reader, omp::ThreadPool* pool)
+    {
+        std::vector<std::string> contents(m_Paths.size());
+        std::vector<int> results(m_Paths.size(), -1);
+        std::vector<std::string> paths = m_Paths;
+        paths.push_back("missing_file.txt");
+        contents.emplace_back();
+        results.push_back(-1);
+
+        std::future<void> done = reader.readFiles(paths, [&contents, &results](size_t inIndex, std::string&& inData, bool inSuccess)
+        {
+            contents[inIndex] = std::move(inData);
+            results[inIndex] = inSuccess ? 1 : 0;
+        });
+        if (pool)
+        {
+            pool->wait(done);
+        }
+        EXPECT_NO_THROW(done.get());
+
+        for (size_t i = 0; i < m_Paths.size(); i++)
+        {
+            EXPECT_EQ(results[i], 1);
+            ASSERT_EQ(contents[i].size(), i * 997);
+            if (i > 0)
+            {
+                EXPECT_EQ(contents[i].front(), static_cast<char>('a' + i % 26));
+                EXPECT_EQ(contents[i].back(), static_cast<char>('a' + i % 26));
+            }
+        }
+        EXPECT_EQ(results.back(), 0);
+    }
+};
+
+TEST_F(AsyncFileReaderSuite, AsyncFileReader__Test__Inline)
+{
+    omp::AsyncFileReader reader(nullptr, 8);
+    readAll(reader, nullptr);
+}
+
+TEST_F(AsyncFileReaderSuite, AsyncFileReader__Test__ThreadPool)
+{
+    omp::ThreadPool pool{4};
+    omp::AsyncFileReader reader(&pool);
+    readAll(reader, &pool);
+    readAll(reader, &pool);
+}
+
+TEST_F(AsyncFileReaderSuite, AsyncFileReader__Test__EmptyBatch)
+{
+    omp::AsyncFileReader reader(nullptr);
+    std::future<void> done = reader.readFiles({}, [](size_t, std::string&&, bool) {});
+    ASSERT_EQ(done.wait_for(std::chrono::seconds(0)), std::future_status::ready);
+}
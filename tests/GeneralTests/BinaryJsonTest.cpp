@@ -0,0 +1,109 @@
+#include "gtest/gtest.h"
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <unordered_set>
+#include "Logs.h"
+#include "IO/JsonParser.h"
+#include "IO/JsonConverter.h"
+
+class BinaryJsonSuite : public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        omp::InitializeTestLogs();
+    }
+
+    std::string m_Path = (std::filesystem::temp_directory_path() / "stomp_binary_json_test.json").string();
+    std::string m_ConvertedPath = (std::filesystem::temp_directory_path() / "stomp_binary_json_converted.json").string();
+};
+
+TEST_F(BinaryJsonSuite, WriteAndReadValues)
+{
+    omp::JsonParser<omp::binaryjson> parser;
+    parser.writeValue("name", "binary name");
+    parser.writeValue("negative", -70000);
+    parser.writeValue("scale", 0.1f);
+    parser.writeValue("visible", false);
+    parser.writeValue("id", uint64_t(10844950053709983257ULL));
+    parser.writeValue("ids", std::unordered_set<uint64_t>{6474591899397657ULL, 7ULL});
+    ASSERT_TRUE(parser.writeToFile(m_Path, omp::EJsonFormat::Binary));
+
+    std::string data;
+    ASSERT_TRUE(omp::JsonConverter::readFile(m_Path, data));
+    EXPECT_EQ(omp::JsonConverter::detectFormat(data), omp::EJsonFormat::Binary);
+
+    omp::JsonParser<omp::binaryjson> result;
+    ASSERT_TRUE(result.populateFromFile(m_Path));
+    EXPECT_EQ(result.readValue<std::string>("name").value(), "binary name");
+    EXPECT_EQ(result.readValue<int>("negative").value(), -70000);
+    EXPECT_EQ(result.readValue<float>("scale").value(), 0.1f);
+    EXPECT_FALSE(result.readValue<bool>("visible").value());
+    EXPECT_EQ(result.readValue<uint64_t>("id").value(), 10844950053709983257ULL);
+    EXPECT_EQ(result.readValue<std::unordered_set<uint64_t>>("ids").value().count(7ULL), 1u);
+    ASSERT_FALSE(result.contains("missing"));
+}
+
+TEST_F(BinaryJsonSuite, NestedObjects)
+{
+    omp::JsonParser<omp::binaryjson> parser;
+    for (int i = 0; i < 40; i++)
+    {
+        omp::JsonParser<omp::binaryjson> entity;
+        entity.writeValue("Name", "Entity" + std::to_string(i));
+        entity.writeValue("translation_x", float(i));
+        parser.writeObject("Entity" + std::to_string(i), std::move(entity));
+    }
+    ASSERT_TRUE(parser.writeToFile(m_Path, omp::EJsonFormat::Binary));
+
+    omp::JsonParser<omp::binaryjson> result;
+    ASSERT_TRUE(result.populateFromFile(m_Path));
+    for (int i = 0; i < 40; i++)
+    {
+        omp::JsonParser<omp::binaryjson> entity = result.readObject("Entity" + std::to_string(i));
+        EXPECT_EQ(entity.readValue<std::string>("Name").value(), "Entity" + std::to_string(i));
+        EXPECT_EQ(entity.readValue<float>("translation_x").value(), float(i));
+    }
+}
+
+TEST_F(BinaryJsonSuite, ConvertBothWays)
+{
+    omp::JsonParser<omp::nlohmannjson> parser;
+    omp::JsonParser<omp::nlohmannjson> metadata;
+    metadata.writeValue("AssetName", "main_scene");
+    metadata.writeValue("ObjectID", uint64_t(10844950053709983257ULL));
+    metadata.writeValue("Dependencies", std::vector<uint64_t>{6474591899397657ULL, 7881936717852185ULL});
+    parser.writeObject("Metadata", std::move(metadata));
+    parser.writeValue("translation_x", 20.5f);
+    parser.writeValue("precise", 0.123456789);
+    parser.writeValue("offset", -3);
+    ASSERT_TRUE(parser.writeToFile(m_Path));
+
+    ASSERT_TRUE(omp::JsonConverter::convertFile(m_Path, m_ConvertedPath, omp::EJsonFormat::Binary));
+    omp::JsonParser<omp::nlohmannjson> binary;
+    ASSERT_TRUE(binary.populateFromFile(m_ConvertedPath));
+    EXPECT_EQ(binary.to_string(), parser.to_string());
+
+    ASSERT_TRUE(omp::JsonConverter::convertFile(m_ConvertedPath, m_ConvertedPath, omp::EJsonFormat::Text));
+    std::string data;
+    ASSERT_TRUE(omp::JsonConverter::readFile(m_ConvertedPath, data));
+    EXPECT_EQ(omp::JsonConverter::detectFormat(data), omp::EJsonFormat::Text);
+
+    omp::JsonParser<omp::nlohmannjson> text;
+    ASSERT_TRUE(text.populateFromFile(m_ConvertedPath));
+    ASSERT_EQ(text.to_string(), parser.to_string());
+}
+
+TEST_F(BinaryJsonSuite, NlohmannBinaryCompatible)
+{
+    omp::JsonParser<omp::nlohmannjson> parser;
+    parser.writeValue("scale", 1.5f);
+    parser.writeValue("names", std::vector<std::string>{"one", "two"});
+    ASSERT_TRUE(parser.writeToFile(m_Path, omp::EJsonFormat::Binary));
+
+    omp::JsonParser<omp::binaryjson> result;
+    ASSERT_TRUE(result.populateFromFile(m_Path));
+    EXPECT_EQ(result.readValue<float>("scale").value(), 1.5f);
+    ASSERT_EQ(result.readValue<std::vector<std::string>>("names").value()[1], "two");
+}
@@ -0,0 +1,81 @@
+#include "gtest/gtest.h"
+#include <array>
+#include <cstdint>
+#include "Logs.h"
+#include "Rendering/BindStateCache.h"
+
+namespace
+{
+    // Handles are only compared, never used with a device
+    template<typename T>
+    T fakeHandle(uintptr_t inValue)
+    {
+        return reinterpret_cast<T>(inValue);
+    }
+}
+
+class BindStateCacheSuite : public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        omp::InitializeTestLogs();
+    }
+};
+
+TEST_F(BindStateCacheSuite, SkipsRepeatedBinds)
+{
+    omp::BindStateCache cache;
+    const VkPipeline pipeline = fakeHandle<VkPipeline>(1);
+    const VkBuffer vertex_buffer = fakeHandle<VkBuffer>(2);
+    const VkBuffer index_buffer = fakeHandle<VkBuffer>(3);
+
+    EXPECT_TRUE(cache.bindPipeline(pipeline));
+    EXPECT_FALSE(cache.bindPipeline(pipeline));
+    EXPECT_TRUE(cache.bindPipeline(fakeHandle<VkPipeline>(4)));
+
+    EXPECT_TRUE(cache.bindVertexBuffer(vertex_buffer));
+    EXPECT_FALSE(cache.bindVertexBuffer(vertex_buffer));
+
+    EXPECT_TRUE(cache.bindIndexBuffer(index_buffer, VK_INDEX_TYPE_UINT16));
+    EXPECT_FALSE(cache.bindIndexBuffer(index_buffer, VK_INDEX_TYPE_UINT16));
+    EXPECT_TRUE(cache.bindIndexBuffer(index_buffer, VK_INDEX_TYPE_UINT32));
+
+    EXPECT_EQ(cache.getSavedBinds(), 3u);
+
+    cache.reset();
+    EXPECT_TRUE(cache.bindPipeline(pipeline));
+    EXPECT_TRUE(cache.bindVertexBuffer(vertex_buffer));
+}
+
+TEST_F(BindStateCacheSuite, TracksDescriptorSetsPerLayout)
+{
+    omp::BindStateCache cache;
+    const VkDescriptorSet ubo_set = fakeHandle<VkDescriptorSet>(10);
+    const VkDescriptorSet material_set = fakeHandle<VkDescriptorSet>(11);
+    const std::array<uint32_t, 2> offsets = {0, 256};
+    const std::array<uint32_t, 2> next_offsets = {512, 768};
+
+    EXPECT_TRUE(cache.bindDescriptorSet(7, 0, ubo_set, 2, offsets.data()));
+    EXPECT_TRUE(cache.bindDescriptorSet(7, 1, material_set, 0, nullptr));
+    EXPECT_FALSE(cache.bindDescriptorSet(7, 0, ubo_set, 2, offsets.data()));
+    EXPECT_FALSE(cache.bindDescriptorSet(7, 1, material_set, 0, nullptr));
+
+    // Other dynamic offsets are other state
+    EXPECT_TRUE(cache.bindDescriptorSet(7, 0, ubo_set, 2, next_offsets.data()));
+
+    // Pipelines don't disturb sets, layouts of another signature do
+    EXPECT_TRUE(cache.bindPipeline(fakeHandle<VkPipeline>(1)));
+    EXPECT_FALSE(cache.bindDescriptorSet(7, 1, material_set, 0, nullptr));
+    EXPECT_TRUE(cache.bindDescriptorSet(8, 1, material_set, 0, nullptr));
+    EXPECT_TRUE(cache.bindDescriptorSet(8, 0, ubo_set, 2, next_offsets.data()));
+
+    // Sets the cache can't hold are always bound and forget what was there
+    const std::array<uint32_t, omp::BindStateCache::MAX_DYNAMIC_OFFSETS + 1> many_offsets{};
+    EXPECT_TRUE(cache.bindDescriptorSet(8, 1, material_set, static_cast<uint32_t>(many_offsets.size()), many_offsets.data()));
+    EXPECT_TRUE(cache.bindDescriptorSet(8, 1, material_set, 0, nullptr));
+    EXPECT_TRUE(cache.bindDescriptorSet(8, omp::BindStateCache::MAX_SETS, material_set, 0, nullptr));
+    EXPECT_TRUE(cache.bindDescriptorSet(8, omp::BindStateCache::MAX_SETS, material_set, 0, nullptr));
+
+    EXPECT_EQ(cache.getSavedBinds(), 3u);
+}
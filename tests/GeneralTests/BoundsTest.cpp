@@ -0,0 +1,113 @@
+#include "gtest/gtest.h"
+#include <array>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "Logs.h"
+#include "Math/Bounds.h"
+
+namespace
+{
+    // Position followed by padding, like position inside a vertex
+    using TestVertex = std::array<float, 5>;
+}
+
+class BoundsSuite : public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        omp::InitializeTestLogs();
+    }
+};
+
+TEST_F(BoundsSuite, BoxMatchesScalarReduction)
+{
+    std::mt19937 random(5);
+    std::uniform_real_distribution<float> distribution(-100.0f, 100.0f);
+
+    // Odd and tiny counts cover every tail of the vector loop
+    for (size_t count : {size_t{1}, size_t{2}, size_t{3}, size_t{4}, size_t{5}, size_t{1001}})
+    {
+        std::vector<TestVertex> vertices(count);
+        omp::BoundingBox expected{{1e30f, 1e30f, 1e30f}, {-1e30f, -1e30f, -1e30f}};
+        for (TestVertex& vertex : vertices)
+        {
+            for (size_t axis = 0; axis < 5; axis++)
+            {
+                vertex[axis] = distribution(random);
+            }
+            for (size_t axis = 0; axis < 3; axis++)
+            {
+                expected.min[axis] = std::min(expected.min[axis], vertex[axis]);
+                expected.max[axis] = std::max(expected.max[axis], vertex[axis]);
+            }
+        }
+
+        EXPECT_EQ(omp::BoundsLib::computeBox(vertices.front().data(), sizeof(TestVertex), count), expected) << count;
+    }
+
+    // Tightly packed positions, last one ends the buffer
+    const std::vector<std::array<float, 3>> positions = {{1.0f, -2.0f, 3.0f}, {-4.0f, 5.0f, 0.5f}, {2.0f, 2.0f, 9.0f}};
+    const omp::BoundingBox box = omp::BoundsLib::computeBox(positions.front().data(), sizeof(positions.front()), positions.size());
+    EXPECT_EQ(box.min, (std::array<float, 3>{-4.0f, -2.0f, 0.5f}));
+    EXPECT_EQ(box.max, (std::array<float, 3>{2.0f, 5.0f, 9.0f}));
+
+    EXPECT_FALSE(omp::BoundsLib::computeBox(nullptr, sizeof(TestVertex), 0).isValid());
+}
+
+TEST_F(BoundsSuite, SphereContainsPoints)
+{
+    std::mt19937 random(7);
+    std::normal_distribution<float> distribution(3.0f, 10.0f);
+    std::vector<std::array<float, 3>> positions(500);
+    for (auto& position : positions)
+    {
+        position = {distribution(random), distribution(random), distribution(random)};
+    }
+
+    const omp::Bounds bounds = omp::BoundsLib::compute(positions.front().data(), sizeof(positions.front()), positions.size());
+    float diagonal = 0.0f;
+    for (size_t axis = 0; axis < 3; axis++)
+    {
+        EXPECT_FLOAT_EQ(bounds.sphere.center[axis], (bounds.box.min[axis] + bounds.box.max[axis]) * 0.5f);
+        diagonal += (bounds.box.max[axis] - bounds.box.min[axis]) * (bounds.box.max[axis] - bounds.box.min[axis]);
+    }
+    EXPECT_LE(bounds.sphere.radius, std::sqrt(diagonal) * 0.5f * 1.0001f);
+
+    float farthest = 0.0f;
+    for (const auto& position : positions)
+    {
+        const float x = position[0] - bounds.sphere.center[0];
+        const float y = position[1] - bounds.sphere.center[1];
+        const float z = position[2] - bounds.sphere.center[2];
+        farthest = std::max(farthest, std::sqrt(x * x + y * y + z * z));
+    }
+    EXPECT_FLOAT_EQ(bounds.sphere.radius, farthest);
+}
+
+TEST_F(BoundsSuite, TransformedBounds)
+{
+    const std::vector<std::array<float, 3>> positions = {{-1.0f, -1.0f, -1.0f}, {1.0f, 1.0f, 1.0f}, {1.0f, -1.0f, 1.0f}};
+    const omp::Bounds bounds = omp::BoundsLib::compute(positions.front().data(), sizeof(positions.front()), positions.size());
+
+    // Scale 2 on x, 90 degrees around z, then move by (10, 20, 30). Column major
+    const std::array<float, 16> matrix = {
+            0.0f, 2.0f, 0.0f, 0.0f,
+            -1.0f, 0.0f, 0.0f, 0.0f,
+            0.0f, 0.0f, 1.0f, 0.0f,
+            10.0f, 20.0f, 30.0f, 1.0f};
+    const omp::Bounds world = omp::BoundsLib::transform(bounds, matrix.data());
+
+    const std::array<float, 3> expected_min = {9.0f, 18.0f, 29.0f};
+    const std::array<float, 3> expected_max = {11.0f, 22.0f, 31.0f};
+    for (size_t axis = 0; axis < 3; axis++)
+    {
+        EXPECT_FLOAT_EQ(world.box.min[axis], expected_min[axis]) << axis;
+        EXPECT_FLOAT_EQ(world.box.max[axis], expected_max[axis]) << axis;
+    }
+    EXPECT_FLOAT_EQ(world.sphere.center[0], 10.0f);
+    EXPECT_FLOAT_EQ(world.sphere.center[1], 20.0f);
+    EXPECT_FLOAT_EQ(world.sphere.center[2], 30.0f);
+    EXPECT_FLOAT_EQ(world.sphere.radius, bounds.sphere.radius * 2.0f);
+}
@@ -0,0 +1,145 @@
+#include "gtest/gtest.h"
+#include <cstring>
+#include <memory>
+#include <string>
+#include "Logs.h"
+#include "Math/Hash.h"
+#include "AssetSystem/ContentCache.h"
+
+class ContentCacheSuite : public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        omp::InitializeTestLogs();
+    }
+
+    virtual void SetUp() override
+    {
+        omp::ContentCache::resetStatistics();
+    }
+};
+
+struct TestContent
+{
+    size_t size = 0;
+    size_t getByteSize() const { return size; }
+};
+
+TEST_F(ContentCacheSuite, Hash128KnownValue)
+{
+    const std::string text = "The quick brown fox jumps over the lazy dog";
+    omp::Hash128 hash = omp::HashLib::hash128(text.data(), text.size());
+    EXPECT_EQ(hash.low, 0xe34bbc7bbc071b6cULL);
+    ASSERT_EQ(hash.high, 0x7a433ca9c49a9347ULL);
+}
+
+TEST_F(ContentCacheSuite, Hash128DifferentContent)
+{
+    const std::string first = "first content";
+    const std::string second = "first_content";
+    omp::Hash128 one = omp::HashLib::hash128(first.data(), first.size());
+    omp::Hash128 two = omp::HashLib::hash128(second.data(), second.size());
+    EXPECT_TRUE(one.isValid());
+    ASSERT_NE(one, two);
+}
+
+TEST_F(ContentCacheSuite, SameContentReused)
+{
+    const std::string bytes = "same bytes under different names";
+    omp::Hash128 hash = omp::HashLib::hash128(bytes.data(), bytes.size());
+
+    int created = 0;
+    auto creator = [&created]()
+    {
+        created++;
+        auto content = std::make_shared<TestContent>();
+        content->size = 128;
+        return content;
+    };
+
+    std::shared_ptr<TestContent> first = omp::ContentCache::acquireCpu<TestContent>(omp::EContentType::Mesh, hash, creator);
+    std::shared_ptr<TestContent> second = omp::ContentCache::acquireCpu<TestContent>(omp::EContentType::Mesh, hash, creator);
+    EXPECT_EQ(created, 1);
+    EXPECT_EQ(first.get(), second.get());
+    EXPECT_EQ(first.use_count(), 2);
+
+    omp::ContentCacheStatistics stats = omp::ContentCache::getStatistics();
+    EXPECT_EQ(stats.cpu_hits, 1u);
+    ASSERT_EQ(stats.cpu_bytes_saved, 128u);
+}
+
+TEST_F(ContentCacheSuite, ReleasedContentRecreated)
+{
+    const std::string bytes = "content released by every user";
+    omp::Hash128 hash = omp::HashLib::hash128(bytes.data(), bytes.size());
+
+    int created = 0;
+    auto creator = [&created]()
+    {
+        created++;
+        return std::make_shared<TestContent>();
+    };
+
+    {
+        auto content = omp::ContentCache::acquireGpu<TestContent>(omp::EContentType::Texture, hash, creator);
+        EXPECT_TRUE(content);
+    }
+    auto content = omp::ContentCache::acquireGpu<TestContent>(omp::EContentType::Texture, hash, creator);
+    EXPECT_TRUE(content);
+    ASSERT_EQ(created, 2);
+}
+
+TEST_F(ContentCacheSuite, ExpiredEntriesErased)
+{
+    auto creator = []()
+    {
+        return std::make_shared<TestContent>();
+    };
+
+    // Every distinct file of a session is released again, none of them may stay in the tables
+    for (size_t index = 0; index < 1000; index++)
+    {
+        const std::string bytes = "released content " + std::to_string(index);
+        omp::Hash128 hash = omp::HashLib::hash128(bytes.data(), bytes.size());
+        EXPECT_TRUE(omp::ContentCache::acquireCpu<TestContent>(omp::EContentType::Mesh, hash, creator));
+    }
+    EXPECT_LT(omp::ContentCache::getEntryCount(), 1000u);
+
+    const std::string kept_bytes = "content still in use";
+    omp::Hash128 kept_hash = omp::HashLib::hash128(kept_bytes.data(), kept_bytes.size());
+    auto kept = omp::ContentCache::acquireGpu<TestContent>(omp::EContentType::Texture, kept_hash, creator);
+
+    omp::ContentCache::resetStatistics();
+    ASSERT_EQ(omp::ContentCache::getEntryCount(), 1u);
+}
+
+TEST_F(ContentCacheSuite, InvalidHashNotCached)
+{
+    int created = 0;
+    auto creator = [&created]()
+    {
+        created++;
+        return std::make_shared<TestContent>();
+    };
+
+    auto first = omp::ContentCache::acquireCpu<TestContent>(omp::EContentType::Texture, omp::Hash128{}, creator);
+    auto second = omp::ContentCache::acquireCpu<TestContent>(omp::EContentType::Texture, omp::Hash128{}, creator);
+    EXPECT_NE(first.get(), second.get());
+    ASSERT_EQ(created, 2);
+}
+
+TEST_F(ContentCacheSuite, PrefetchedFileConsumedOnce)
+{
+    const std::string path = "not_on_disk.obj";
+    omp::ContentCache::prefetchFile(path, std::string("v 0 0 0"));
+
+    std::string data;
+    omp::Hash128 hash = omp::ContentCache::hashFile(path, data);
+    EXPECT_TRUE(hash.isValid());
+    EXPECT_EQ(data, "v 0 0 0");
+
+    // Second request goes to disk
+    hash = omp::ContentCache::hashFile(path, data);
+    ASSERT_FALSE(hash.isValid());
+}
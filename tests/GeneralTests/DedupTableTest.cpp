@@ -0,0 +1,128 @@
+#include "gtest/gtest.h"
+#include <array>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "Logs.h"
+#include "Math/DedupTable.h"
+#include "Math/Hash.h"
+
+namespace
+{
+    // Vertex layout without glm
+    using TestVertex = std::array<float, 11>;
+
+    struct TestVertexHash
+    {
+        size_t operator()(const TestVertex& inVertex) const
+        {
+            return omp::HashLib::hashFloats(inVertex.data(), inVertex.size());
+        }
+    };
+
+    // Every value lands in the same slot, only probing separates them
+    struct CollidingHash
+    {
+        size_t operator()(int) const
+        {
+            return 7;
+        }
+    };
+}
+
+class DedupTableSuite : public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        omp::InitializeTestLogs();
+    }
+};
+
+TEST_F(DedupTableSuite, Hash64Deterministic)
+{
+    const std::string data = "Hash64 covers short, medium and long inputs, with more than 48 bytes here";
+    std::unordered_set<uint64_t> hashes;
+    for (size_t size = 0; size <= data.size(); size++)
+    {
+        const uint64_t hash = omp::HashLib::hash64(data.data(), size);
+        EXPECT_EQ(hash, omp::HashLib::hash64(data.data(), size));
+        hashes.insert(hash);
+    }
+    // Every prefix length gives a different hash
+    EXPECT_EQ(hashes.size(), data.size() + 1);
+    EXPECT_NE(omp::HashLib::hash64(data.data(), data.size(), 1), omp::HashLib::hash64(data.data(), data.size(), 2));
+}
+
+TEST_F(DedupTableSuite, HashFloatsZeroSign)
+{
+    const std::array<float, 3> positive = {0.0f, 1.0f, 0.0f};
+    const std::array<float, 3> negative = {-0.0f, 1.0f, -0.0f};
+    EXPECT_EQ(omp::HashLib::hashFloats(positive.data(), positive.size()), omp::HashLib::hashFloats(negative.data(), negative.size()));
+
+    std::vector<float> values(40, 1.0f);
+    const uint64_t hash = omp::HashLib::hashFloats(values.data(), values.size());
+    values[39] = 2.0f;
+    EXPECT_NE(hash, omp::HashLib::hashFloats(values.data(), values.size()));
+}
+
+TEST_F(DedupTableSuite, NormalsChangeVertexHash)
+{
+    TestVertex first{};
+    TestVertex second{};
+    second[10] = 1.0f;
+    EXPECT_NE(TestVertexHash()(first), TestVertexHash()(second));
+}
+
+TEST_F(DedupTableSuite, FirstOccurrenceOrder)
+{
+    std::vector<TestVertex> vertices;
+    omp::DedupTable<TestVertex, TestVertexHash> table(vertices, 8);
+
+    TestVertex first{};
+    TestVertex second{};
+    second[8] = 1.0f;
+    TestVertex negative_zero{};
+    negative_zero[0] = -0.0f;
+
+    EXPECT_EQ(table.insert(first), 0u);
+    EXPECT_EQ(table.insert(second), 1u);
+    EXPECT_EQ(table.insert(first), 0u);
+    EXPECT_EQ(table.insert(negative_zero), 0u);
+    EXPECT_EQ(table.insert(second), 1u);
+    EXPECT_EQ(vertices.size(), 2u);
+    EXPECT_EQ(vertices[1], second);
+}
+
+TEST_F(DedupTableSuite, GrowsPastExpectedCount)
+{
+    std::vector<int> values;
+    omp::DedupTable<int> table(values, 4);
+    const size_t initial_capacity = table.capacity();
+
+    for (int round = 0; round < 2; round++)
+    {
+        for (int value = 0; value < 1000; value++)
+        {
+            EXPECT_EQ(table.insert(value * 3), static_cast<uint32_t>(value));
+        }
+    }
+    EXPECT_EQ(table.size(), 1000u);
+    EXPECT_GT(table.capacity(), initial_capacity);
+    EXPECT_LE(table.size() * 2, table.capacity());
+}
+
+TEST_F(DedupTableSuite, CollidingHashes)
+{
+    std::vector<int> values;
+    omp::DedupTable<int, CollidingHash> table(values, 64);
+    for (int value = 0; value < 40; value++)
+    {
+        EXPECT_EQ(table.insert(value), static_cast<uint32_t>(value));
+    }
+    for (int value = 0; value < 40; value++)
+    {
+        EXPECT_EQ(table.insert(value), static_cast<uint32_t>(value));
+    }
+    EXPECT_EQ(values.size(), 40u);
+}
@@ -0,0 +1,55 @@
+#include "gtest/gtest.h"
+#include <vector>
+#include "Logs.h"
+#include "Rendering/DeferredDeletionQueue.h"
+
+class DeferredDeletionQueueSuite : public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        omp::InitializeTestLogs();
+    }
+};
+
+TEST_F(DeferredDeletionQueueSuite, WaitsForRecordingFrame)
+{
+    omp::DeferredDeletionQueue queue;
+    std::vector<int> destroyed;
+
+    queue.push([&destroyed]() { destroyed.push_back(0); });
+    queue.endFrame();
+    queue.push([&destroyed]() { destroyed.push_back(1); });
+    queue.endFrame();
+
+    // Frame 0 may still be on the GPU
+    queue.collect(0);
+    EXPECT_TRUE(destroyed.empty());
+
+    queue.collect(1);
+    EXPECT_EQ(destroyed, std::vector<int>{0});
+    EXPECT_EQ(queue.getPendingCount(), 1u);
+
+    queue.collect(2);
+    EXPECT_EQ(destroyed, (std::vector<int>{0, 1}));
+    EXPECT_EQ(queue.getFrame(), 2u);
+}
+
+TEST_F(DeferredDeletionQueueSuite, DeletionCanPushAgain)
+{
+    omp::DeferredDeletionQueue queue;
+    int destroyed = 0;
+
+    queue.push([&queue, &destroyed]()
+    {
+        destroyed++;
+        queue.push([&destroyed]() { destroyed++; });
+    });
+    queue.collect(1);
+    EXPECT_EQ(destroyed, 1);
+    EXPECT_EQ(queue.getPendingCount(), 1u);
+
+    queue.flush();
+    EXPECT_EQ(destroyed, 2);
+    EXPECT_EQ(queue.getPendingCount(), 0u);
+}
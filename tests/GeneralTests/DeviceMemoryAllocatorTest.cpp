@@ -0,0 +1,172 @@
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include "Logs.h"
+#include "Rendering/DeviceMemoryAllocator.h"
+
+// Runs on any Vulkan driver, lavapipe included, and skips when there is none
+class DeviceMemoryAllocatorSuite : public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        omp::InitializeTestLogs();
+    }
+
+    void SetUp() override
+    {
+        VkApplicationInfo app_info{};
+        app_info.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+        app_info.pApplicationName = "DeviceMemoryAllocatorTest";
+        app_info.apiVersion = VK_API_VERSION_1_1;
+
+        VkInstanceCreateInfo instance_info{};
+        instance_info.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+        instance_info.pApplicationInfo = &app_info;
+        if (vkCreateInstance(&instance_info, nullptr, &m_Instance) != VK_SUCCESS)
+        {
+            m_Instance = VK_NULL_HANDLE;
+            GTEST_SKIP() << "No Vulkan driver";
+        }
+
+        uint32_t device_count = 1;
+        if (vkEnumeratePhysicalDevices(m_Instance, &device_count, &m_PhysDevice) < 0 || device_count == 0)
+        {
+            GTEST_SKIP() << "No Vulkan device";
+        }
+
+        const float priority = 1.0f;
+        VkDeviceQueueCreateInfo queue_info{};
+        queue_info.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+        queue_info.queueFamilyIndex = 0;
+        queue_info.queueCount = 1;
+        queue_info.pQueuePriorities = &priority;
+
+        VkDeviceCreateInfo device_info{};
+        device_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+        device_info.queueCreateInfoCount = 1;
+        device_info.pQueueCreateInfos = &queue_info;
+        ASSERT_EQ(vkCreateDevice(m_PhysDevice, &device_info, nullptr, &m_Device), VK_SUCCESS);
+    }
+
+    void TearDown() override
+    {
+        if (m_Device != VK_NULL_HANDLE)
+        {
+            vkDestroyDevice(m_Device, nullptr);
+        }
+        if (m_Instance != VK_NULL_HANDLE)
+        {
+            vkDestroyInstance(m_Instance, nullptr);
+        }
+    }
+
+    VkBuffer createBuffer(VkDeviceSize inSize, VkBufferUsageFlags inUsage, VkMemoryRequirements& outRequirements) const
+    {
+        VkBufferCreateInfo buffer_info{};
+        buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        buffer_info.size = inSize;
+        buffer_info.usage = inUsage;
+        buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        VkBuffer buffer = VK_NULL_HANDLE;
+        EXPECT_EQ(vkCreateBuffer(m_Device, &buffer_info, nullptr, &buffer), VK_SUCCESS);
+        vkGetBufferMemoryRequirements(m_Device, buffer, &outRequirements);
+        return buffer;
+    }
+
+    VkInstance m_Instance = VK_NULL_HANDLE;
+    VkPhysicalDevice m_PhysDevice = VK_NULL_HANDLE;
+    VkDevice m_Device = VK_NULL_HANDLE;
+};
+
+TEST_F(DeviceMemoryAllocatorSuite, BuffersShareOneBlock)
+{
+    omp::DeviceMemoryAllocator allocator(m_Device, m_PhysDevice);
+
+    std::vector<VkBuffer> buffers;
+    std::vector<omp::MemoryAllocation> allocations;
+    for (size_t index = 0; index < 100; index++)
+    {
+        VkMemoryRequirements requirements;
+        buffers.push_back(createBuffer(4096 + index * 16, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, requirements));
+        allocations.push_back(allocator.allocate(requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, omp::EMemoryStrategy::General, false));
+        EXPECT_EQ(allocations.back().offset % requirements.alignment, 0u);
+        EXPECT_EQ(vkBindBufferMemory(m_Device, buffers.back(), allocations.back().memory, allocations.back().offset), VK_SUCCESS);
+    }
+
+    omp::DeviceMemoryStatistics statistics = allocator.getStatistics();
+    EXPECT_EQ(statistics.vulkan_allocations_made, 1u);
+    EXPECT_EQ(statistics.allocation_count, 100u);
+
+    // Ranges in the block never overlap
+    std::sort(allocations.begin(), allocations.end(),
+              [](const omp::MemoryAllocation& inFirst, const omp::MemoryAllocation& inSecond) { return inFirst.offset < inSecond.offset; });
+    for (size_t index = 1; index < allocations.size(); index++)
+    {
+        EXPECT_EQ(allocations[index].memory, allocations[0].memory);
+        EXPECT_GE(allocations[index].offset, allocations[index - 1].offset + allocations[index - 1].size);
+    }
+
+    for (size_t index = 0; index < buffers.size(); index++)
+    {
+        vkDestroyBuffer(m_Device, buffers[index], nullptr);
+        allocator.free(allocations[index]);
+        EXPECT_FALSE(allocations[index].isValid());
+    }
+
+    // Last empty block is kept
+    statistics = allocator.getStatistics();
+    EXPECT_EQ(statistics.allocation_count, 0u);
+    EXPECT_EQ(statistics.used_bytes, 0u);
+    EXPECT_EQ(statistics.block_count, 1u);
+}
+
+TEST_F(DeviceMemoryAllocatorSuite, LinearBlockIsReused)
+{
+    omp::DeviceMemoryAllocator allocator(m_Device, m_PhysDevice);
+    const VkMemoryPropertyFlags host_memory = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+    VkMemoryRequirements requirements{};
+    requirements.size = 1024;
+    requirements.alignment = 256;
+    requirements.memoryTypeBits = ~0U;
+
+    std::vector<omp::MemoryAllocation> staging;
+    for (size_t index = 0; index < 3; index++)
+    {
+        staging.push_back(allocator.allocate(requirements, host_memory, omp::EMemoryStrategy::Linear, false));
+        ASSERT_NE(staging.back().mapped, nullptr);
+        std::memset(staging.back().mapped, static_cast<int>(index), 1024);
+        EXPECT_EQ(staging.back().offset, index * 1024);
+    }
+
+    // Head goes back to the start once every staging range is freed
+    for (omp::MemoryAllocation& allocation : staging)
+    {
+        allocator.free(allocation);
+    }
+    const omp::MemoryAllocation reused = allocator.allocate(requirements, host_memory, omp::EMemoryStrategy::Linear, false);
+    EXPECT_EQ(reused.offset, 0u);
+    EXPECT_EQ(allocator.getStatistics().vulkan_allocations_made, 1u);
+}
+
+TEST_F(DeviceMemoryAllocatorSuite, LargeRequestsAreDedicated)
+{
+    omp::DeviceMemoryAllocator allocator(m_Device, m_PhysDevice);
+
+    VkMemoryRequirements requirements{};
+    requirements.size = omp::DeviceMemoryAllocator::GENERAL_BLOCK_SIZE;
+    requirements.alignment = 256;
+    requirements.memoryTypeBits = ~0U;
+
+    omp::MemoryAllocation allocation = allocator.allocate(requirements, 0, omp::EMemoryStrategy::General, false);
+    EXPECT_EQ(allocation.strategy, omp::EMemoryStrategy::Dedicated);
+    EXPECT_EQ(allocation.offset, 0u);
+    EXPECT_EQ(allocator.getStatistics().dedicated_count, 1u);
+    EXPECT_EQ(allocator.getStatistics().block_count, 0u);
+
+    allocator.free(allocation);
+    EXPECT_EQ(allocator.getStatistics().dedicated_count, 0u);
+    EXPECT_EQ(allocator.getStatistics().reserved_bytes, 0u);
+}
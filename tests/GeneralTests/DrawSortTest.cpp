@@ -0,0 +1,109 @@
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "Logs.h"
+#include "Async/ThreadPool.h"
+#include "Rendering/DrawSort.h"
+
+namespace
+{
+    std::vector<omp::DrawSortEntry> makeRandomEntries(size_t inCount, uint32_t inSeed)
+    {
+        std::mt19937 random(inSeed);
+        std::uniform_int_distribution<uint32_t> pipeline(0, 7);
+        std::uniform_int_distribution<uint32_t> material(0, 300);
+        std::uniform_real_distribution<float> depth(0.0f, 10000.0f);
+        std::bernoulli_distribution translucent(0.1);
+
+        std::vector<omp::DrawSortEntry> entries(inCount);
+        for (size_t index = 0; index < inCount; index++)
+        {
+            entries[index].key = omp::DrawSort::makeKey(translucent(random), pipeline(random), material(random), depth(random));
+            entries[index].index = static_cast<uint32_t>(index);
+        }
+        return entries;
+    }
+
+    std::vector<omp::DrawSortEntry> sortedExpected(std::vector<omp::DrawSortEntry> inEntries)
+    {
+        std::stable_sort(inEntries.begin(), inEntries.end(), [](const omp::DrawSortEntry& inLeft, const omp::DrawSortEntry& inRight)
+        {
+            return inLeft.key < inRight.key;
+        });
+        return inEntries;
+    }
+
+    void expectSameOrder(const std::vector<omp::DrawSortEntry>& inActual, const std::vector<omp::DrawSortEntry>& inExpected)
+    {
+        ASSERT_EQ(inActual.size(), inExpected.size());
+        for (size_t index = 0; index < inActual.size(); index++)
+        {
+            ASSERT_EQ(inActual[index].key, inExpected[index].key) << index;
+            ASSERT_EQ(inActual[index].index, inExpected[index].index) << index;
+        }
+    }
+}
+
+class DrawSortSuite : public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        omp::InitializeTestLogs();
+    }
+};
+
+TEST_F(DrawSortSuite, KeysOrderDraws)
+{
+    // Opaque before translucent whatever the state and depth
+    EXPECT_LT(omp::DrawSort::makeKey(false, 100, 100, 1000.0f), omp::DrawSort::makeKey(true, 0, 0, 0.0f));
+
+    // Opaque by pipeline, then material, then front to back
+    EXPECT_LT(omp::DrawSort::makeKey(false, 1, 50, 900.0f), omp::DrawSort::makeKey(false, 2, 0, 1.0f));
+    EXPECT_LT(omp::DrawSort::makeKey(false, 1, 1, 900.0f), omp::DrawSort::makeKey(false, 1, 2, 1.0f));
+    EXPECT_LT(omp::DrawSort::makeKey(false, 1, 1, 0.5f), omp::DrawSort::makeKey(false, 1, 1, 2.0f));
+
+    // Translucent back to front first, state only breaks ties
+    EXPECT_LT(omp::DrawSort::makeKey(true, 5, 5, 20.0f), omp::DrawSort::makeKey(true, 0, 0, 10.0f));
+    EXPECT_LT(omp::DrawSort::makeKey(true, 0, 9, 10.0f), omp::DrawSort::makeKey(true, 1, 0, 10.0f));
+
+    EXPECT_EQ(omp::DrawSort::quantizeDepth(-1.0f), 0u);
+    EXPECT_LT(omp::DrawSort::quantizeDepth(0.001f), omp::DrawSort::quantizeDepth(0.002f));
+    EXPECT_LT(omp::DrawSort::quantizeDepth(1.0e6f), omp::DrawSort::quantizeDepth(1.0e7f));
+}
+
+TEST_F(DrawSortSuite, MatchesStableSort)
+{
+    std::vector<omp::DrawSortEntry> scratch;
+    for (const size_t count : {size_t{0}, size_t{1}, size_t{2}, size_t{17}, size_t{5000}})
+    {
+        std::vector<omp::DrawSortEntry> entries = makeRandomEntries(count, static_cast<uint32_t>(count));
+        const std::vector<omp::DrawSortEntry> expected = sortedExpected(entries);
+        omp::DrawSort::sort(entries, scratch, nullptr);
+        expectSameOrder(entries, expected);
+    }
+
+    // Equal keys skip every pass and keep their order
+    std::vector<omp::DrawSortEntry> same(100, omp::DrawSortEntry{omp::DrawSort::makeKey(false, 3, 4, 5.0f), 0});
+    for (size_t index = 0; index < same.size(); index++)
+    {
+        same[index].index = static_cast<uint32_t>(index);
+    }
+    const std::vector<omp::DrawSortEntry> expected_same = same;
+    omp::DrawSort::sort(same, scratch, nullptr);
+    expectSameOrder(same, expected_same);
+}
+
+TEST_F(DrawSortSuite, ParallelMatchesSerial)
+{
+    // Odd count leaves a short last chunk
+    const size_t count = omp::DrawSort::PARALLEL_THRESHOLD * 4 + 13;
+    std::vector<omp::DrawSortEntry> entries = makeRandomEntries(count, 7);
+    const std::vector<omp::DrawSortEntry> expected = sortedExpected(entries);
+
+    omp::ThreadPool pool{4};
+    std::vector<omp::DrawSortEntry> scratch;
+    omp::DrawSort::sort(entries, scratch, &pool);
+    expectSameOrder(entries, expected);
+}
@@ -0,0 +1,118 @@
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+#include "Logs.h"
+#include "Async/ThreadPool.h"
+#include "Rendering/FrustumCuller.h"
+
+namespace
+{
+    // Axis aligned box x, y in [-1, 1] and z in [-10, -1], planes facing inside
+    omp::Frustum makeBoxFrustum()
+    {
+        omp::Frustum frustum;
+        frustum.planes[0] = {1.0f, 0.0f, 0.0f, 1.0f};
+        frustum.planes[1] = {-1.0f, 0.0f, 0.0f, 1.0f};
+        frustum.planes[2] = {0.0f, 1.0f, 0.0f, 1.0f};
+        frustum.planes[3] = {0.0f, -1.0f, 0.0f, 1.0f};
+        frustum.planes[4] = {0.0f, 0.0f, -1.0f, -1.0f};
+        frustum.planes[5] = {0.0f, 0.0f, 1.0f, 10.0f};
+        return frustum;
+    }
+
+    bool isBoxVisible(const omp::Frustum& inFrustum, const omp::BoundingBox& inBox)
+    {
+        for (const std::array<float, 4>& plane : inFrustum.planes)
+        {
+            float distance = plane[3];
+            for (size_t axis = 0; axis < 3; axis++)
+            {
+                distance += plane[axis] * (plane[axis] >= 0.0f ? inBox.max[axis] : inBox.min[axis]);
+            }
+            if (distance < 0.0f)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+class FrustumCullerSuite : public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        omp::InitializeTestLogs();
+    }
+};
+
+TEST_F(FrustumCullerSuite, KeepsBoxesTouchingFrustum)
+{
+    const omp::Frustum frustum = makeBoxFrustum();
+    omp::BoundingBoxArray boxes;
+    boxes.push({{-0.5f, -0.5f, -5.0f}, {0.5f, 0.5f, -4.0f}});
+    // Crosses the right plane
+    boxes.push({{0.5f, 0.0f, -5.0f}, {3.0f, 0.5f, -4.0f}});
+    // Behind the camera
+    boxes.push({{-0.5f, -0.5f, 1.0f}, {0.5f, 0.5f, 2.0f}});
+    // Past the far plane
+    boxes.push({{-0.5f, -0.5f, -20.0f}, {0.5f, 0.5f, -11.0f}});
+    // Outside left and bottom at once
+    boxes.push({{-5.0f, -5.0f, -5.0f}, {-2.0f, -2.0f, -4.0f}});
+    boxes.resize(6);
+    boxes.setUnbounded(5);
+
+    std::vector<uint32_t> visible;
+    omp::FrustumCuller::cull(frustum, boxes, nullptr, visible);
+    EXPECT_EQ(visible, (std::vector<uint32_t>{0, 1, 5}));
+}
+
+TEST_F(FrustumCullerSuite, MatchesScalarAndParallel)
+{
+    const omp::Frustum frustum = makeBoxFrustum();
+    std::mt19937 random(11);
+    std::uniform_real_distribution<float> position(-15.0f, 5.0f);
+    std::uniform_real_distribution<float> extent(0.0f, 1.5f);
+
+    // Odd count leaves a tail after every vector width
+    const size_t count = omp::FrustumCuller::CHUNK_SIZE * 3 + 7;
+    omp::BoundingBoxArray boxes;
+    boxes.resize(count);
+    std::vector<uint32_t> expected;
+    for (size_t index = 0; index < count; index++)
+    {
+        omp::BoundingBox box;
+        for (size_t axis = 0; axis < 3; axis++)
+        {
+            box.min[axis] = position(random);
+            box.max[axis] = box.min[axis] + extent(random);
+        }
+        boxes.set(index, box);
+        if (isBoxVisible(frustum, box))
+        {
+            expected.push_back(static_cast<uint32_t>(index));
+        }
+    }
+    ASSERT_FALSE(expected.empty());
+    ASSERT_LT(expected.size(), count);
+
+    std::vector<uint32_t> visible;
+    omp::FrustumCuller::cull(frustum, boxes, nullptr, visible);
+    EXPECT_EQ(visible, expected);
+
+    // Small ranges fall entirely into the scalar tail
+    for (size_t end = 1; end < 10; end++)
+    {
+        visible.clear();
+        omp::FrustumCuller::cull(frustum, boxes, 0, end, visible);
+        const std::vector<uint32_t> expected_part(expected.begin(), std::lower_bound(expected.begin(), expected.end(), end));
+        EXPECT_EQ(visible, expected_part) << end;
+    }
+
+    omp::ThreadPool pool{4};
+    omp::FrustumCuller::cull(frustum, boxes, &pool, visible);
+    EXPECT_EQ(visible, expected);
+}
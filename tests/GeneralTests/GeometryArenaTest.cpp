@@ -0,0 +1,65 @@
+#include "gtest/gtest.h"
+#include <cstdint>
+#include <vector>
+#include "Logs.h"
+#include "Rendering/GeometryArena.h"
+
+namespace
+{
+    // Handles are only compared, never used with a device
+    VkBuffer fakeBuffer(uintptr_t inValue)
+    {
+        return reinterpret_cast<VkBuffer>(inValue);
+    }
+}
+
+class GeometryArenaSuite : public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        omp::InitializeTestLogs();
+    }
+};
+
+// Copy ticket completes after the frame's update and before its draw list is built
+TEST_F(GeometryArenaSuite, DrawBufferFollowsCopyCompletion)
+{
+    const VkBuffer old_buffer = fakeBuffer(1);
+    const VkBuffer grown_buffer = fakeBuffer(2);
+    const std::vector<omp::GeometryArena::RetiredBuffer> retired = {{old_buffer, {}, 4}};
+
+    omp::UploadTicket completed = 2;
+    const auto is_complete = [&completed](omp::UploadTicket inTicket)
+    {
+        return inTicket <= completed;
+    };
+    EXPECT_EQ(omp::GeometryArena::selectDrawBuffer(grown_buffer, retired, is_complete), old_buffer);
+
+    // Models allocated past the old capacity now report uploaded, so must the grown buffer
+    completed = 4;
+    ASSERT_EQ(omp::GeometryArena::selectDrawBuffer(grown_buffer, retired, is_complete), grown_buffer);
+}
+
+TEST_F(GeometryArenaSuite, DrawBufferAcrossSeveralGrowths)
+{
+    const VkBuffer first = fakeBuffer(1);
+    const VkBuffer second = fakeBuffer(2);
+    const VkBuffer current = fakeBuffer(3);
+    const std::vector<omp::GeometryArena::RetiredBuffer> retired = {{first, {}, 2}, {second, {}, 6}};
+
+    omp::UploadTicket completed = 0;
+    const auto is_complete = [&completed](omp::UploadTicket inTicket)
+    {
+        return inTicket <= completed;
+    };
+    EXPECT_EQ(omp::GeometryArena::selectDrawBuffer(current, retired, is_complete), first);
+
+    // Ranges uploaded between the two growths live in the second buffer until its own copy is done
+    completed = 4;
+    EXPECT_EQ(omp::GeometryArena::selectDrawBuffer(current, retired, is_complete), second);
+
+    completed = 6;
+    EXPECT_EQ(omp::GeometryArena::selectDrawBuffer(current, retired, is_complete), current);
+    ASSERT_EQ(omp::GeometryArena::selectDrawBuffer(current, {}, is_complete), current);
+}
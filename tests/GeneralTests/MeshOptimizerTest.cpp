@@ -0,0 +1,128 @@
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "Logs.h"
+#include "Rendering/MeshOptimizer.h"
+
+namespace
+{
+    struct TestMesh
+    {
+        std::vector<std::array<float, 3>> positions;
+        std::vector<uint32_t> indices;
+    };
+
+    // Closed UV sphere, triangles shuffled so input order is cache hostile
+    TestMesh makeShuffledSphere(uint32_t inRings, uint32_t inSegments)
+    {
+        TestMesh mesh;
+        for (uint32_t ring = 0; ring <= inRings; ring++)
+        {
+            const float theta = 3.14159265f * static_cast<float>(ring) / static_cast<float>(inRings);
+            for (uint32_t segment = 0; segment < inSegments; segment++)
+            {
+                const float phi = 6.2831853f * static_cast<float>(segment) / static_cast<float>(inSegments);
+                mesh.positions.push_back({std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)});
+            }
+        }
+
+        std::vector<std::array<uint32_t, 3>> triangles;
+        for (uint32_t ring = 0; ring < inRings; ring++)
+        {
+            for (uint32_t segment = 0; segment < inSegments; segment++)
+            {
+                const uint32_t a = ring * inSegments + segment;
+                const uint32_t b = ring * inSegments + (segment + 1) % inSegments;
+                const uint32_t c = a + inSegments;
+                const uint32_t d = b + inSegments;
+                triangles.push_back({a, c, b});
+                triangles.push_back({b, c, d});
+            }
+        }
+        std::shuffle(triangles.begin(), triangles.end(), std::mt19937(7));
+        for (const auto& triangle : triangles)
+        {
+            mesh.indices.insert(mesh.indices.end(), triangle.begin(), triangle.end());
+        }
+        return mesh;
+    }
+
+    std::vector<std::array<uint32_t, 3>> sortedTriangles(const std::vector<uint32_t>& inIndices)
+    {
+        std::vector<std::array<uint32_t, 3>> triangles;
+        for (size_t index = 0; index + 2 < inIndices.size(); index += 3)
+        {
+            triangles.push_back({inIndices[index], inIndices[index + 1], inIndices[index + 2]});
+        }
+        std::sort(triangles.begin(), triangles.end());
+        return triangles;
+    }
+}
+
+class MeshOptimizerSuite : public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        omp::InitializeTestLogs();
+    }
+};
+
+TEST_F(MeshOptimizerSuite, AnalyzeKnownOrder)
+{
+    // Strip of two triangles sharing an edge, 4 vertices transformed
+    const std::vector<uint32_t> indices = {0, 1, 2, 2, 1, 3};
+    omp::VertexCacheStatistics statistics = omp::MeshOptimizer::analyzeVertexCache(indices, 4);
+    EXPECT_EQ(statistics.vertices_transformed, 4u);
+    EXPECT_FLOAT_EQ(statistics.acmr, 2.0f);
+    EXPECT_FLOAT_EQ(statistics.atvr, 1.0f);
+
+    // FIFO cache of 3 vertices, loading vertex 0 again pushes out 1 and then 2
+    const std::vector<uint32_t> evicting = {0, 1, 2, 3, 1, 2, 0, 1, 2};
+    EXPECT_EQ(omp::MeshOptimizer::analyzeVertexCache(evicting, 4, 3).vertices_transformed, 7u);
+}
+
+TEST_F(MeshOptimizerSuite, VertexCacheKeepsTriangles)
+{
+    TestMesh mesh = makeShuffledSphere(64, 64);
+    const size_t vertex_count = mesh.positions.size();
+    const auto expected_triangles = sortedTriangles(mesh.indices);
+    const omp::VertexCacheStatistics before = omp::MeshOptimizer::analyzeVertexCache(mesh.indices, vertex_count);
+
+    omp::MeshOptimizer::optimizeVertexCache(mesh.indices, vertex_count);
+    const omp::VertexCacheStatistics after = omp::MeshOptimizer::analyzeVertexCache(mesh.indices, vertex_count);
+
+    EXPECT_EQ(sortedTriangles(mesh.indices), expected_triangles);
+    INFO(LogTesting, "ACMR {} -> {}, ATVR {} -> {}", before.acmr, after.acmr, before.atvr, after.atvr);
+    EXPECT_LT(after.acmr, 0.8f);
+    EXPECT_LT(after.acmr * 2.0f, before.acmr);
+}
+
+TEST_F(MeshOptimizerSuite, OverdrawKeepsTrianglesAndCache)
+{
+    TestMesh mesh = makeShuffledSphere(64, 64);
+    const size_t vertex_count = mesh.positions.size();
+    const auto expected_triangles = sortedTriangles(mesh.indices);
+
+    omp::MeshOptimizer::optimizeVertexCache(mesh.indices, vertex_count);
+    const float cache_acmr = omp::MeshOptimizer::analyzeVertexCache(mesh.indices, vertex_count).acmr;
+    omp::MeshOptimizer::optimizeOverdraw(mesh.indices, mesh.positions.front().data(), sizeof(mesh.positions.front()), vertex_count);
+
+    EXPECT_EQ(sortedTriangles(mesh.indices), expected_triangles);
+    // Clusters restart the cache, but only a little worse than the threshold allows
+    EXPECT_LT(omp::MeshOptimizer::analyzeVertexCache(mesh.indices, vertex_count).acmr, cache_acmr * 1.25f);
+}
+
+TEST_F(MeshOptimizerSuite, VertexFetchFirstUseOrder)
+{
+    std::vector<uint32_t> indices = {4, 2, 0, 0, 2, 5};
+    std::vector<char> vertices = {'a', 'b', 'c', 'd', 'e', 'f'};
+
+    omp::MeshOptimizer::optimizeVertexFetch(vertices, indices);
+
+    EXPECT_EQ(indices, (std::vector<uint32_t>{0, 1, 2, 2, 1, 3}));
+    EXPECT_EQ(vertices, (std::vector<char>{'e', 'c', 'a', 'f'}));
+}
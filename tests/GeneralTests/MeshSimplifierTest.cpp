@@ -0,0 +1,164 @@
+#include "gtest/gtest.h"
+#include <array>
+#include <cmath>
+#include <vector>
+#include "Logs.h"
+#include "Rendering/MeshSimplifier.h"
+
+namespace
+{
+    struct TestMesh
+    {
+        std::vector<std::array<float, 3>> positions;
+        std::vector<uint32_t> indices;
+    };
+
+    // Closed UV sphere of radius one around the origin, poles have a vertex per segment
+    TestMesh makeSphere(uint32_t inRings, uint32_t inSegments)
+    {
+        TestMesh mesh;
+        for (uint32_t ring = 0; ring <= inRings; ring++)
+        {
+            const float theta = 3.14159265f * static_cast<float>(ring) / static_cast<float>(inRings);
+            for (uint32_t segment = 0; segment < inSegments; segment++)
+            {
+                const float phi = 6.2831853f * static_cast<float>(segment) / static_cast<float>(inSegments);
+                mesh.positions.push_back({std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)});
+            }
+        }
+        for (uint32_t ring = 0; ring < inRings; ring++)
+        {
+            for (uint32_t segment = 0; segment < inSegments; segment++)
+            {
+                const uint32_t a = ring * inSegments + segment;
+                const uint32_t b = ring * inSegments + (segment + 1) % inSegments;
+                mesh.indices.insert(mesh.indices.end(), {a, b, a + inSegments, b, b + inSegments, a + inSegments});
+            }
+        }
+        return mesh;
+    }
+
+    // Flat grid in the XZ plane, inSeamColumn gets a second vertex per row, as a texture seam would
+    TestMesh makeGrid(uint32_t inSize, uint32_t inSeamColumn)
+    {
+        TestMesh mesh;
+        for (uint32_t y = 0; y <= inSize; y++)
+        {
+            for (uint32_t x = 0; x <= inSize; x++)
+            {
+                mesh.positions.push_back({static_cast<float>(x), 0.0f, static_cast<float>(y)});
+            }
+        }
+        const uint32_t row = inSize + 1;
+        const uint32_t seam_first = static_cast<uint32_t>(mesh.positions.size());
+        for (uint32_t y = 0; y <= inSize; y++)
+        {
+            mesh.positions.push_back({static_cast<float>(inSeamColumn), 0.0f, static_cast<float>(y)});
+        }
+
+        for (uint32_t y = 0; y < inSize; y++)
+        {
+            for (uint32_t x = 0; x < inSize; x++)
+            {
+                // Cells right of the seam use the duplicated column
+                const uint32_t left = x == inSeamColumn ? seam_first + y : y * row + x;
+                const uint32_t left_next = x == inSeamColumn ? seam_first + y + 1 : (y + 1) * row + x;
+                const uint32_t right = y * row + x + 1;
+                const uint32_t right_next = (y + 1) * row + x + 1;
+                mesh.indices.insert(mesh.indices.end(), {left, left_next, right, right, left_next, right_next});
+            }
+        }
+        return mesh;
+    }
+
+    float signedVolume(const TestMesh& inMesh, const std::vector<uint32_t>& inIndices, size_t inTriangle)
+    {
+        const auto& a = inMesh.positions[inIndices[inTriangle]];
+        const auto& b = inMesh.positions[inIndices[inTriangle + 1]];
+        const auto& c = inMesh.positions[inIndices[inTriangle + 2]];
+        return a[0] * (b[1] * c[2] - b[2] * c[1]) - a[1] * (b[0] * c[2] - b[2] * c[0]) + a[2] * (b[0] * c[1] - b[1] * c[0]);
+    }
+
+    std::vector<uint32_t> simplify(const TestMesh& inMesh, size_t inTargetIndexCount, float inTargetError, float* outError)
+    {
+        return omp::MeshSimplifier::simplify(inMesh.indices, inMesh.positions.front().data(), sizeof(inMesh.positions.front()),
+                                             inMesh.positions.size(), inTargetIndexCount, inTargetError, outError);
+    }
+}
+
+class MeshSimplifierSuite : public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        omp::InitializeTestLogs();
+    }
+};
+
+TEST_F(MeshSimplifierSuite, SphereKeepsShape)
+{
+    const TestMesh sphere = makeSphere(64, 128);
+    float error = 0.0f;
+    const std::vector<uint32_t> indices = simplify(sphere, sphere.indices.size() / 10, 1.0f, &error);
+
+    EXPECT_LE(indices.size(), sphere.indices.size() / 10);
+    EXPECT_GT(indices.size(), 0u);
+    EXPECT_GT(error, 0.0f);
+    EXPECT_LT(error, 0.02f);
+
+    // Every triangle of the source sphere has the same winding, simplified ones must keep it.
+    // Degenerate triangles at the poles are locked and stay as they are
+    const float winding = signedVolume(sphere, sphere.indices, sphere.indices.size() / 2);
+    for (size_t triangle = 0; triangle < indices.size(); triangle += 3)
+    {
+        EXPECT_GT(signedVolume(sphere, indices, triangle) * winding, -1e-9f) << "triangle " << triangle / 3;
+    }
+}
+
+TEST_F(MeshSimplifierSuite, ErrorLimitStopsEarly)
+{
+    const TestMesh sphere = makeSphere(32, 64);
+    float error = 0.0f;
+    const std::vector<uint32_t> indices = simplify(sphere, 0, 1e-3f, &error);
+
+    EXPECT_LT(indices.size(), sphere.indices.size());
+    EXPECT_GT(indices.size(), sphere.indices.size() / 20);
+    EXPECT_LE(error, 1e-3f);
+}
+
+TEST_F(MeshSimplifierSuite, FlatGridBordersAndSeamsLocked)
+{
+    const uint32_t size = 16;
+    const TestMesh grid = makeGrid(size, 8);
+    float error = 1.0f;
+    const std::vector<uint32_t> indices = simplify(grid, 0, 1e-4f, &error);
+
+    // Interior of a plane collapses for free, everything left is pinned by the border or the seam
+    EXPECT_LT(indices.size(), grid.indices.size() / 4);
+    EXPECT_FLOAT_EQ(error, 0.0f);
+
+    std::vector<bool> used(grid.positions.size(), false);
+    for (uint32_t vertex : indices)
+    {
+        used[vertex] = true;
+    }
+    const uint32_t row = size + 1;
+    for (uint32_t index = 0; index <= size; index++)
+    {
+        EXPECT_TRUE(used[index]) << "bottom border " << index;
+        EXPECT_TRUE(used[size * row + index]) << "top border " << index;
+        EXPECT_TRUE(used[index * row]) << "left border " << index;
+        EXPECT_TRUE(used[index * row + size]) << "right border " << index;
+        EXPECT_TRUE(used[index * row + 8]) << "seam " << index;
+        EXPECT_TRUE(used[row * row + index]) << "seam copy " << index;
+    }
+}
+
+TEST_F(MeshSimplifierSuite, TargetAboveInputKeepsMesh)
+{
+    const TestMesh grid = makeGrid(4, 2);
+    float error = 1.0f;
+    EXPECT_EQ(simplify(grid, grid.indices.size(), 1.0f, &error), grid.indices);
+    EXPECT_EQ(error, 0.0f);
+    EXPECT_FLOAT_EQ(omp::MeshSimplifier::getScale(grid.indices, grid.positions.front().data(), sizeof(grid.positions.front())), 4.0f);
+}
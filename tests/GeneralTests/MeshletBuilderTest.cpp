@@ -0,0 +1,188 @@
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <set>
+#include <vector>
+#include "Logs.h"
+#include "Rendering/MeshletBuilder.h"
+
+namespace
+{
+    struct TestMesh
+    {
+        std::vector<std::array<float, 3>> positions;
+        std::vector<uint32_t> indices;
+    };
+
+    // Closed UV sphere of radius one around the origin
+    TestMesh makeSphere(uint32_t inRings, uint32_t inSegments)
+    {
+        TestMesh mesh;
+        for (uint32_t ring = 0; ring <= inRings; ring++)
+        {
+            const float theta = 3.14159265f * static_cast<float>(ring) / static_cast<float>(inRings);
+            for (uint32_t segment = 0; segment < inSegments; segment++)
+            {
+                const float phi = 6.2831853f * static_cast<float>(segment) / static_cast<float>(inSegments);
+                mesh.positions.push_back({std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)});
+            }
+        }
+        for (uint32_t ring = 0; ring < inRings; ring++)
+        {
+            for (uint32_t segment = 0; segment < inSegments; segment++)
+            {
+                const uint32_t a = ring * inSegments + segment;
+                const uint32_t b = ring * inSegments + (segment + 1) % inSegments;
+                mesh.indices.insert(mesh.indices.end(), {a, a + inSegments, b, b, a + inSegments, b + inSegments});
+            }
+        }
+        return mesh;
+    }
+
+    // Unit grid in the XZ plane facing up
+    TestMesh makeGrid(uint32_t inSize)
+    {
+        TestMesh mesh;
+        const float step = 1.0f / static_cast<float>(inSize);
+        for (uint32_t y = 0; y <= inSize; y++)
+        {
+            for (uint32_t x = 0; x <= inSize; x++)
+            {
+                mesh.positions.push_back({static_cast<float>(x) * step, 0.0f, static_cast<float>(y) * step});
+            }
+        }
+        const uint32_t row = inSize + 1;
+        for (uint32_t y = 0; y < inSize; y++)
+        {
+            for (uint32_t x = 0; x < inSize; x++)
+            {
+                const uint32_t a = y * row + x;
+                mesh.indices.insert(mesh.indices.end(), {a, a + row, a + 1, a + 1, a + row, a + row + 1});
+            }
+        }
+        return mesh;
+    }
+
+    std::vector<omp::Meshlet> build(TestMesh& ioMesh)
+    {
+        return omp::MeshletBuilder::build(ioMesh.indices, 0, ioMesh.indices.size(), ioMesh.positions.front().data(),
+                                          sizeof(ioMesh.positions.front()), ioMesh.positions.size());
+    }
+
+    std::multiset<std::array<uint32_t, 3>> triangleSet(const std::vector<uint32_t>& inIndices)
+    {
+        std::multiset<std::array<uint32_t, 3>> triangles;
+        for (size_t index = 0; index < inIndices.size(); index += 3)
+        {
+            triangles.insert({inIndices[index], inIndices[index + 1], inIndices[index + 2]});
+        }
+        return triangles;
+    }
+
+    constexpr std::array<float, 16> s_Identity = {1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f};
+}
+
+class MeshletBuilderSuite : public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        omp::InitializeTestLogs();
+    }
+};
+
+TEST_F(MeshletBuilderSuite, MeshletsCoverMeshWithinLimits)
+{
+    TestMesh sphere = makeSphere(32, 64);
+    const std::multiset<std::array<uint32_t, 3>> source_triangles = triangleSet(sphere.indices);
+    const std::vector<omp::Meshlet> meshlets = build(sphere);
+
+    EXPECT_EQ(triangleSet(sphere.indices), source_triangles);
+    ASSERT_FALSE(meshlets.empty());
+    EXPECT_LT(meshlets.size(), sphere.indices.size() / 3 / 60);
+
+    uint32_t next_index = 0;
+    for (const omp::Meshlet& meshlet : meshlets)
+    {
+        EXPECT_EQ(meshlet.first_index, next_index);
+        EXPECT_LE(meshlet.index_count / 3, omp::MeshletBuilder::MAX_TRIANGLES);
+        next_index += meshlet.index_count;
+
+        const std::set<uint32_t> vertices(sphere.indices.begin() + meshlet.first_index,
+                                          sphere.indices.begin() + meshlet.first_index + meshlet.index_count);
+        EXPECT_EQ(vertices.size(), meshlet.vertex_count);
+        EXPECT_LE(vertices.size(), omp::MeshletBuilder::MAX_VERTICES);
+        for (uint32_t vertex : vertices)
+        {
+            const auto& position = sphere.positions[vertex];
+            const float x = position[0] - meshlet.sphere.center[0];
+            const float y = position[1] - meshlet.sphere.center[1];
+            const float z = position[2] - meshlet.sphere.center[2];
+            EXPECT_LE(std::sqrt(x * x + y * y + z * z), meshlet.sphere.radius * 1.0001f);
+        }
+    }
+    EXPECT_EQ(next_index, sphere.indices.size());
+}
+
+TEST_F(MeshletBuilderSuite, BackfaceConeCulling)
+{
+    TestMesh grid = makeGrid(16);
+    const std::vector<omp::Meshlet> meshlets = build(grid);
+    ASSERT_FALSE(meshlets.empty());
+    for (const omp::Meshlet& meshlet : meshlets)
+    {
+        EXPECT_NEAR(meshlet.cone_axis[1], 1.0f, 1e-5f);
+        EXPECT_NEAR(meshlet.cone_cutoff, 0.0f, 1e-3f);
+    }
+
+    // Identity view projection clips to x and y in [-1, 1] and z in [0, 1], the grid is inside
+    const omp::Frustum frustum = omp::BoundsLib::extractFrustum(s_Identity.data());
+
+    std::vector<omp::IndexRange> ranges;
+    omp::MeshletCullStatistics statistics = omp::MeshletBuilder::cull(meshlets, s_Identity.data(), frustum, {0.5f, 5.0f, 0.5f}, ranges);
+    EXPECT_EQ(statistics.frustum_culled + statistics.backface_culled, 0u);
+    ASSERT_EQ(ranges.size(), 1u);
+    EXPECT_EQ(ranges.front().first_index, 0u);
+    EXPECT_EQ(ranges.front().index_count, grid.indices.size());
+
+    ranges.clear();
+    statistics = omp::MeshletBuilder::cull(meshlets, s_Identity.data(), frustum, {0.5f, -5.0f, 0.5f}, ranges);
+    EXPECT_EQ(statistics.backface_culled, meshlets.size());
+    EXPECT_TRUE(ranges.empty());
+
+    // Non uniform scale bends cones, they are not tested
+    std::array<float, 16> stretched = s_Identity;
+    stretched[0] = 0.5f;
+    ranges.clear();
+    statistics = omp::MeshletBuilder::cull(meshlets, stretched.data(), frustum, {0.5f, -5.0f, 0.5f}, ranges);
+    EXPECT_EQ(statistics.backface_culled, 0u);
+    EXPECT_EQ(ranges.size(), 1u);
+}
+
+TEST_F(MeshletBuilderSuite, FrustumCulling)
+{
+    TestMesh grid = makeGrid(32);
+    const std::vector<omp::Meshlet> meshlets = build(grid);
+    const omp::Frustum frustum = omp::BoundsLib::extractFrustum(s_Identity.data());
+
+    // Moved right by 0.9, only meshlets reaching back into the frustum are left
+    std::array<float, 16> moved = s_Identity;
+    moved[12] = 0.9f;
+    std::vector<omp::IndexRange> ranges;
+    const omp::MeshletCullStatistics statistics = omp::MeshletBuilder::cull(meshlets, moved.data(), frustum, {0.9f, 5.0f, 0.5f}, ranges);
+    EXPECT_GT(statistics.frustum_culled, 0u);
+    EXPECT_LT(statistics.frustum_culled, meshlets.size());
+    for (const omp::Meshlet& meshlet : meshlets)
+    {
+        const bool drawn = std::any_of(ranges.begin(), ranges.end(), [&meshlet](const omp::IndexRange& inRange)
+        {
+            return meshlet.first_index >= inRange.first_index && meshlet.first_index < inRange.first_index + inRange.index_count;
+        });
+        EXPECT_EQ(drawn, meshlet.sphere.center[0] + 0.9f - meshlet.sphere.radius <= 1.0f);
+    }
+
+    moved[12] = 5.0f;
+    ranges.clear();
+    EXPECT_EQ(omp::MeshletBuilder::cull(meshlets, moved.data(), frustum, {5.0f, 5.0f, 0.5f}, ranges).frustum_culled, meshlets.size());
+}
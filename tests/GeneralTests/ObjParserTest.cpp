@@ -0,0 +1,147 @@
+#include "gtest/gtest.h"
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "Async/ThreadPool.h"
+#include "IO/MappedFile.h"
+#include "IO/ObjParser.h"
+#include "Logs.h"
+
+class ObjParserSuite : public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        omp::InitializeTestLogs();
+    }
+
+    std::vector<float> m_Vertices;
+    std::vector<uint32_t> m_Indices;
+
+    bool parse(const std::string& inData, omp::ThreadPool* inPool = nullptr)
+    {
+        return omp::ObjParser::parse(inData, inPool, m_Vertices, m_Indices);
+    }
+
+    float vertexValue(size_t inVertex, size_t inFloat) const
+    {
+        return m_Vertices[inVertex * omp::ObjParser::VERTEX_FLOATS + inFloat];
+    }
+
+    // Grid of quads, a few chunks big
+    static std::string makeGrid(size_t inSize)
+    {
+        std::string data = "# grid\no grid\n";
+        for (size_t y = 0; y <= inSize; y++)
+        {
+            for (size_t x = 0; x <= inSize; x++)
+            {
+                data += "v " + std::to_string(x) + ".25 " + std::to_string(y) + ".5 -0.125\n";
+                data += "vt 0." + std::to_string(x) + " 0." + std::to_string(y) + "\n";
+            }
+        }
+        data += "vn 0 0 1\nvn 0.0 -0.0 1.0\n";
+        for (size_t y = 0; y < inSize; y++)
+        {
+            for (size_t x = 0; x < inSize; x++)
+            {
+                const size_t first = y * (inSize + 1) + x + 1;
+                const size_t third = first + inSize + 1;
+                const std::string normal = std::to_string(1 + (x + y) % 2);
+                auto corner = [&normal](size_t inIndex)
+                {
+                    return std::to_string(inIndex) + "/" + std::to_string(inIndex) + "/" + normal;
+                };
+                data += "f " + corner(first) + " " + corner(first + 1) + " " + corner(third + 1) + " " + corner(third) + "\r\n";
+            }
+        }
+        return data;
+    }
+};
+
+TEST_F(ObjParserSuite, TriangleVertices)
+{
+    ASSERT_TRUE(parse("v 1 2 3\nv 4 5 6 0.5 0.25 0\nv 7 8 9\nvt 0.25 0.75\nvn 0 1 0\n"
+                      "f 1/1/1 2/1/1 3/1/1\nf 3/1/1 2/1/1 1/1/1\n"));
+
+    ASSERT_EQ(m_Vertices.size(), 3 * omp::ObjParser::VERTEX_FLOATS);
+    EXPECT_EQ(m_Indices, (std::vector<uint32_t>{0, 1, 2, 2, 1, 0}));
+
+    EXPECT_FLOAT_EQ(vertexValue(1, 0), 4.0f);
+    EXPECT_FLOAT_EQ(vertexValue(0, 3), 1.0f);
+    EXPECT_FLOAT_EQ(vertexValue(1, 3), 0.5f);
+    EXPECT_FLOAT_EQ(vertexValue(1, 4), 0.25f);
+    EXPECT_FLOAT_EQ(vertexValue(2, 6), 0.25f);
+    EXPECT_FLOAT_EQ(vertexValue(2, 7), 0.25f);
+    EXPECT_FLOAT_EQ(vertexValue(2, 9), 1.0f);
+}
+
+TEST_F(ObjParserSuite, EqualValuesMerged)
+{
+    ASSERT_TRUE(parse("v 0 0 0\nv 1 0 0\nv 0 1 0\nv 0.0 -0.0 0e5\nvt 0 0\nvn 0 0 1\n"
+                      "f 1/1/1 2/1/1 3/1/1\nf 4/1/1 2/1/1 3/1/1\n"));
+
+    EXPECT_EQ(m_Vertices.size(), 3 * omp::ObjParser::VERTEX_FLOATS);
+    EXPECT_EQ(m_Indices, (std::vector<uint32_t>{0, 1, 2, 0, 1, 2}));
+}
+
+TEST_F(ObjParserSuite, QuadSplitOnShorterDiagonal)
+{
+    const std::string header = "v 0 0 0\nv 1 0 0\nv 1 1 0\nv -1 2 0\nvt 0 0\nvn 0 0 1\n";
+    ASSERT_TRUE(parse(header + "f 1/1/1 2/1/1 3/1/1 4/1/1\n"));
+    EXPECT_EQ(m_Indices, (std::vector<uint32_t>{0, 1, 2, 0, 2, 3}));
+
+    ASSERT_TRUE(parse(header + "f 2/1/1 3/1/1 4/1/1 1/1/1\n"));
+    EXPECT_EQ(m_Indices, (std::vector<uint32_t>{0, 1, 2, 1, 3, 2}));
+}
+
+TEST_F(ObjParserSuite, UnsupportedFilesRejected)
+{
+    const std::string header = "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nv 0 0 1\nvt 0 0\nvn 0 0 1\n";
+    EXPECT_FALSE(parse(header + "f -1/1/1 2/1/1 3/1/1\n"));
+    EXPECT_FALSE(parse(header + "f 1//1 2//1 3//1\n"));
+    EXPECT_FALSE(parse(header + "f 1/1/1 2/1/1 3/1/1 4/1/1 5/1/1\n"));
+    EXPECT_FALSE(parse(header + "f 1/1/1 2/1/1 9/1/1\n"));
+    EXPECT_FALSE(parse(header + "f 0/1/1 2/1/1 3/1/1\n"));
+    EXPECT_FALSE(parse("v 1 2\n"));
+    EXPECT_FALSE(parse("v 1 2 3 1\n"));
+    EXPECT_FALSE(parse("v 0 0 0\rv 1 1 1\n"));
+    EXPECT_FALSE(parse("v 0e999999 0 0\n"));
+
+    EXPECT_TRUE(parse(header + "g group\nusemtl material\ns 1\nf 1/1/1 2/1/1 3/1/1\n"));
+    EXPECT_EQ(m_Indices.size(), 3u);
+}
+
+TEST_F(ObjParserSuite, ParallelMatchesSerial)
+{
+    const std::string data = makeGrid(400);
+    ASSERT_TRUE(parse(data));
+    const std::vector<float> vertices = m_Vertices;
+    const std::vector<uint32_t> indices = m_Indices;
+    EXPECT_EQ(indices.size(), 400u * 400u * 6u);
+    EXPECT_EQ(vertices.size(), 401u * 401u * omp::ObjParser::VERTEX_FLOATS);
+
+    omp::ThreadPool pool(4);
+    ASSERT_TRUE(parse(data, &pool));
+    EXPECT_EQ(vertices, m_Vertices);
+    EXPECT_EQ(indices, m_Indices);
+}
+
+TEST_F(ObjParserSuite, MappedFileView)
+{
+    const std::string path = (std::filesystem::temp_directory_path() / "omp_mapped_file.obj").string();
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << "v 1 2 3\n";
+    }
+
+    omp::MappedFile mapped;
+    ASSERT_TRUE(mapped.open(path));
+    EXPECT_EQ(mapped.view(), "v 1 2 3\n");
+    mapped.close();
+    EXPECT_FALSE(mapped.isOpen());
+    EXPECT_FALSE(mapped.open("missing_file.obj"));
+
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,84 @@
+#include "gtest/gtest.h"
+#include <cstring>
+#include <vector>
+#include "Logs.h"
+#include "Rendering/PipelineCache.h"
+
+namespace
+{
+    VkPhysicalDeviceProperties makeProperties()
+    {
+        VkPhysicalDeviceProperties properties{};
+        properties.vendorID = 0x10005;
+        properties.deviceID = 42;
+        for (uint8_t index = 0; index < VK_UUID_SIZE; index++)
+        {
+            properties.pipelineCacheUUID[index] = static_cast<uint8_t>(index * 17);
+        }
+        return properties;
+    }
+
+    // Header as a driver writes it, followed by some opaque payload
+    std::vector<char> makeCacheData(const VkPhysicalDeviceProperties& inProperties)
+    {
+        VkPipelineCacheHeaderVersionOne header{};
+        header.headerSize = sizeof(header);
+        header.headerVersion = VK_PIPELINE_CACHE_HEADER_VERSION_ONE;
+        header.vendorID = inProperties.vendorID;
+        header.deviceID = inProperties.deviceID;
+        std::memcpy(header.pipelineCacheUUID, inProperties.pipelineCacheUUID, VK_UUID_SIZE);
+
+        std::vector<char> data(sizeof(header) + 64, 'x');
+        std::memcpy(data.data(), &header, sizeof(header));
+        return data;
+    }
+}
+
+class PipelineCacheSuite : public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        omp::InitializeTestLogs();
+    }
+};
+
+TEST_F(PipelineCacheSuite, FileNamedByCacheUuid)
+{
+    const VkPhysicalDeviceProperties properties = makeProperties();
+    EXPECT_EQ(omp::PipelineCache::getCacheFileName(properties.pipelineCacheUUID),
+              "pipeline_cache_00112233445566778899aabbccddeeff.bin");
+}
+
+TEST_F(PipelineCacheSuite, ValidatesHeader)
+{
+    const VkPhysicalDeviceProperties properties = makeProperties();
+    const std::vector<char> data = makeCacheData(properties);
+    EXPECT_TRUE(omp::PipelineCache::isCompatible(data, properties));
+
+    EXPECT_FALSE(omp::PipelineCache::isCompatible({}, properties));
+    EXPECT_FALSE(omp::PipelineCache::isCompatible(std::vector<char>(data.begin(), data.begin() + 16), properties));
+
+    VkPhysicalDeviceProperties other_device = properties;
+    other_device.deviceID++;
+    EXPECT_FALSE(omp::PipelineCache::isCompatible(data, other_device));
+
+    VkPhysicalDeviceProperties other_vendor = properties;
+    other_vendor.vendorID++;
+    EXPECT_FALSE(omp::PipelineCache::isCompatible(data, other_vendor));
+
+    // Driver update changes the cache UUID
+    VkPhysicalDeviceProperties other_driver = properties;
+    other_driver.pipelineCacheUUID[VK_UUID_SIZE - 1]++;
+    EXPECT_FALSE(omp::PipelineCache::isCompatible(data, other_driver));
+
+    std::vector<char> bad_size = data;
+    const uint32_t too_large = static_cast<uint32_t>(data.size() + 1);
+    std::memcpy(bad_size.data(), &too_large, sizeof(too_large));
+    EXPECT_FALSE(omp::PipelineCache::isCompatible(bad_size, properties));
+
+    std::vector<char> bad_version = data;
+    const uint32_t version = 2;
+    std::memcpy(bad_version.data() + sizeof(uint32_t), &version, sizeof(version));
+    EXPECT_FALSE(omp::PipelineCache::isCompatible(bad_version, properties));
+}
@@ -0,0 +1,83 @@
+#include "gtest/gtest.h"
+#include <vector>
+#include "Logs.h"
+#include "Core/RangeAllocator.h"
+
+class RangeAllocatorSuite : public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        omp::InitializeTestLogs();
+    }
+};
+
+TEST_F(RangeAllocatorSuite, AlignedToStride)
+{
+    omp::RangeAllocator allocator(1000);
+
+    const size_t first = allocator.allocate(10);
+    // 44 byte vertices after 10 bytes of something else start at 44, padding stays free
+    const size_t second = allocator.allocate(88, 44);
+    EXPECT_EQ(first, 0u);
+    EXPECT_EQ(second, 44u);
+    EXPECT_EQ(allocator.getUsedSize(), 98u);
+
+    const size_t padding = allocator.allocate(34);
+    EXPECT_EQ(padding, 10u);
+
+    EXPECT_EQ(allocator.allocate(2000), omp::RangeAllocator::INVALID_OFFSET);
+    EXPECT_EQ(allocator.allocate(0), omp::RangeAllocator::INVALID_OFFSET);
+}
+
+TEST_F(RangeAllocatorSuite, BestFitAndCoalescing)
+{
+    omp::RangeAllocator allocator(100);
+    std::vector<size_t> offsets;
+    for (size_t index = 0; index < 10; index++)
+    {
+        offsets.push_back(allocator.allocate(10));
+    }
+    EXPECT_EQ(allocator.getLargestFreeBlock(), 0u);
+
+    // Holes of 20 and 10 bytes, a 10 byte range takes the exact one
+    allocator.free(offsets[1]);
+    allocator.free(offsets[2]);
+    allocator.free(offsets[6]);
+    EXPECT_EQ(allocator.getFreeBlockCount(), 2u);
+    EXPECT_EQ(allocator.allocate(10), offsets[6]);
+
+    // Freeing everything leaves one block
+    allocator.free(offsets[6]);
+    for (size_t index : {0U, 3U, 4U, 5U, 7U, 8U, 9U})
+    {
+        allocator.free(offsets[index]);
+    }
+    EXPECT_EQ(allocator.getFreeBlockCount(), 1u);
+    EXPECT_EQ(allocator.getLargestFreeBlock(), 100u);
+    EXPECT_EQ(allocator.getUsedSize(), 0u);
+    EXPECT_EQ(allocator.getAllocationCount(), 0u);
+
+    // Unknown offsets are ignored
+    allocator.free(55);
+    EXPECT_EQ(allocator.getFreeBlockCount(), 1u);
+}
+
+TEST_F(RangeAllocatorSuite, GrowKeepsOffsets)
+{
+    omp::RangeAllocator allocator(64);
+    const size_t first = allocator.allocate(40);
+    const size_t second = allocator.allocate(20);
+    EXPECT_EQ(allocator.allocate(40), omp::RangeAllocator::INVALID_OFFSET);
+
+    allocator.grow(128);
+    EXPECT_EQ(allocator.getCapacity(), 128u);
+    // Tail of the old capacity joins the new space
+    EXPECT_EQ(allocator.getFreeBlockCount(), 1u);
+    EXPECT_EQ(allocator.allocate(40), 60u);
+
+    allocator.free(first);
+    allocator.free(second);
+    EXPECT_EQ(allocator.getUsedSize(), 40u);
+    EXPECT_EQ(allocator.getLargestFreeBlock(), 60u);
+}
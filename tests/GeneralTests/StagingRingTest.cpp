@@ -0,0 +1,64 @@
+#include "gtest/gtest.h"
+#include <cstdint>
+#include <set>
+#include "Logs.h"
+#include "Rendering/StagingRing.h"
+
+class StagingRingSuite : public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        omp::InitializeTestLogs();
+    }
+};
+
+TEST_F(StagingRingSuite, AlignsAndWraps)
+{
+    omp::StagingRing ring(256, 16);
+    uint64_t offset = 0;
+    ASSERT_TRUE(ring.allocate(100, 1, offset));
+    EXPECT_EQ(offset, 0u);
+    ASSERT_TRUE(ring.allocate(100, 1, offset));
+    EXPECT_EQ(offset, 112u);
+    EXPECT_FALSE(ring.allocate(100, 2, offset));
+
+    ring.release([](uint64_t inTicket)
+    {
+        return inTicket == 1;
+    });
+    EXPECT_EQ(ring.getUsedSize(), 0u);
+
+    // Empty ring starts over instead of wrapping
+    ASSERT_TRUE(ring.allocate(200, 2, offset));
+    ASSERT_EQ(offset, 0u);
+}
+
+// Batches of two queues interleave in the ring and may complete in any order
+TEST_F(StagingRingSuite, OutOfOrderCompletionKeepsOlderSpans)
+{
+    constexpr uint64_t transfer_ticket = 3;
+    constexpr uint64_t graphics_ticket = 2;
+    omp::StagingRing ring(256, 16);
+    uint64_t offset = 0;
+    ASSERT_TRUE(ring.allocate(64, transfer_ticket, offset));
+    ASSERT_TRUE(ring.allocate(64, graphics_ticket, offset));
+    ASSERT_TRUE(ring.allocate(64, transfer_ticket, offset));
+    EXPECT_EQ(ring.getOldestTicket(), transfer_ticket);
+
+    std::set<uint64_t> complete = {graphics_ticket};
+    const auto is_complete = [&complete](uint64_t inTicket)
+    {
+        return complete.contains(inTicket);
+    };
+
+    // Graphics batch finished first, its bytes sit behind transfer bytes still being read
+    ring.release(is_complete);
+    EXPECT_EQ(ring.getUsedSize(), 192u);
+    EXPECT_FALSE(ring.allocate(128, 4, offset));
+
+    complete.insert(transfer_ticket);
+    ring.release(is_complete);
+    EXPECT_EQ(ring.getUsedSize(), 0u);
+    ASSERT_EQ(ring.getOldestTicket(), 0u);
+}
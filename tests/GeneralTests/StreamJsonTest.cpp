@@ -0,0 +1,122 @@
+#include "gtest/gtest.h"
+#include <filesystem>
+#include <limits>
+#include <string>
+#include <vector>
+#include "Logs.h"
+#include "IO/JsonParser.h"
+
+class StreamJsonSuite : public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        omp::InitializeTestLogs();
+    }
+
+    std::string m_Path = (std::filesystem::temp_directory_path() / "stomp_stream_json_test.json").string();
+};
+
+TEST_F(StreamJsonSuite, WriteAndReadValues)
+{
+    omp::JsonParser<omp::streamjson> parser;
+    parser.writeValue("name", "first \"name\"\n");
+    parser.writeValue("age", 5);
+    parser.writeValue("scale", 0.1f);
+    parser.writeValue("visible", true);
+    parser.writeValue("id", uint64_t(18446744073709551615ULL));
+    parser.writeValue("names", std::vector<std::string>{"one", "two"});
+    parser.writeValue("age", 6);
+    ASSERT_TRUE(parser.writeToFile(m_Path));
+
+    omp::JsonParser<omp::streamjson> result;
+    ASSERT_TRUE(result.populateFromFile(m_Path));
+    EXPECT_EQ(result.readValue<std::string>("name").value(), "first \"name\"\n");
+    EXPECT_EQ(result.readValue<int>("age").value(), 6);
+    EXPECT_EQ(result.readValue<float>("scale").value(), 0.1f);
+    EXPECT_TRUE(result.readValue<bool>("visible").value());
+    EXPECT_EQ(result.readValue<uint64_t>("id").value(), 18446744073709551615ULL);
+    EXPECT_EQ(result.readValue<std::vector<std::string>>("names").value().size(), 2u);
+    ASSERT_FALSE(result.readValue<float>("missing").has_value());
+}
+
+TEST_F(StreamJsonSuite, NestedObjectViews)
+{
+    omp::JsonParser<omp::streamjson> parser;
+    for (int i = 0; i < 100; i++)
+    {
+        omp::JsonParser<omp::streamjson> entity;
+        entity.writeValue("Index", i);
+        entity.writeValue("Position", float(i) * 0.5f);
+        parser.writeObject("Entity" + std::to_string(i), std::move(entity));
+    }
+    ASSERT_TRUE(parser.writeToFile(m_Path));
+
+    omp::JsonParser<omp::streamjson> result;
+    ASSERT_TRUE(result.populateFromFile(m_Path));
+    for (int i = 0; i < 100; i++)
+    {
+        omp::JsonParser<omp::streamjson> entity = result.readObject("Entity" + std::to_string(i));
+        EXPECT_EQ(entity.readValue<int>("Index").value(), i);
+        EXPECT_EQ(entity.readValue<float>("Position").value(), float(i) * 0.5f);
+    }
+    ASSERT_THROW(result.readObject("Entity100"), std::out_of_range);
+}
+
+TEST_F(StreamJsonSuite, ReadBackFromNlohmann)
+{
+    omp::JsonParser<omp::nlohmannjson> parser;
+    omp::JsonParser<omp::nlohmannjson> metadata;
+    metadata.writeValue("AssetName", "Scene");
+    metadata.writeValue("Dependencies", std::vector<uint64_t>{1, 2, 3});
+    parser.writeObject("Metadata", std::move(metadata));
+    parser.writeValue("Scale", 2.5f);
+    ASSERT_TRUE(parser.writeToFile(m_Path));
+
+    omp::JsonParser<omp::streamjson> result;
+    ASSERT_TRUE(result.populateFromFile(m_Path));
+    omp::JsonParser<omp::streamjson> result_metadata = result.readObject("Metadata");
+    EXPECT_EQ(result_metadata.readValue<std::string>("AssetName").value(), "Scene");
+    EXPECT_EQ(result_metadata.readValue<std::vector<uint64_t>>("Dependencies").value()[2], 3u);
+    ASSERT_EQ(result.readValue<float>("Scale").value(), 2.5f);
+}
+
+TEST_F(StreamJsonSuite, OverwriteKeepsUntouchedMembers)
+{
+    omp::JsonParser<omp::streamjson> parser;
+    parser.writeValue("Kept", 1);
+    parser.writeValue("Replaced", 2);
+    ASSERT_TRUE(parser.writeToFile(m_Path));
+
+    omp::JsonParser<omp::streamjson> loaded;
+    ASSERT_TRUE(loaded.populateFromFile(m_Path));
+    loaded.writeValue("Replaced", 3);
+    ASSERT_TRUE(loaded.writeToFile(m_Path));
+
+    omp::JsonParser<omp::streamjson> result;
+    ASSERT_TRUE(result.populateFromFile(m_Path));
+    EXPECT_EQ(result.readValue<int>("Kept").value(), 1);
+    ASSERT_EQ(result.readValue<int>("Replaced").value(), 3);
+}
+
+TEST_F(StreamJsonSuite, NonFiniteNumbersWrittenAsNull)
+{
+    omp::JsonParser<omp::streamjson> parser;
+    parser.writeValue("NaN", std::numeric_limits<float>::quiet_NaN());
+    parser.writeValue("Infinity", std::numeric_limits<double>::infinity());
+    parser.writeValue("Values", std::vector<float>{1.0f, -std::numeric_limits<float>::infinity()});
+    parser.writeValue("Kept", 1.5f);
+    ASSERT_TRUE(parser.writeToFile(m_Path));
+
+    // File stays valid JSON for both parsers
+    omp::JsonParser<omp::nlohmannjson> nlohmann_result;
+    ASSERT_TRUE(nlohmann_result.populateFromFile(m_Path));
+    EXPECT_EQ(nlohmann_result.readValue<float>("Kept").value(), 1.5f);
+
+    omp::JsonParser<omp::streamjson> result;
+    ASSERT_TRUE(result.populateFromFile(m_Path));
+    EXPECT_FALSE(result.readValue<float>("NaN").has_value());
+    EXPECT_FALSE(result.readValue<double>("Infinity").has_value());
+    EXPECT_FALSE(result.readValue<std::vector<float>>("Values").has_value());
+    ASSERT_EQ(result.readValue<float>("Kept").value(), 1.5f);
+}
@@ -0,0 +1,125 @@
+#include "gtest/gtest.h"
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+#include "Logs.h"
+#include "Rendering/VertexPacking.h"
+
+namespace
+{
+    using TestVertex = std::array<float, omp::VertexPacking::VERTEX_FLOATS>;
+
+    TestVertex makeVertex(const std::array<float, 3>& inPosition, const std::array<float, 2>& inTexCoord, const std::array<float, 3>& inNormal)
+    {
+        return {inPosition[0], inPosition[1], inPosition[2], 1.0f, 1.0f, 1.0f, inTexCoord[0], inTexCoord[1], inNormal[0], inNormal[1], inNormal[2]};
+    }
+}
+
+class VertexPackingSuite : public ::testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        omp::InitializeTestLogs();
+    }
+};
+
+TEST_F(VertexPackingSuite, HalfFloatRoundTrip)
+{
+    for (float value : {0.0f, 1.0f, -2.5f, 0.333333f, 65504.0f, 6.1035156e-05f, 5.9604645e-08f, 1e-3f})
+    {
+        const float decoded = omp::VertexPacking::halfToFloat(omp::VertexPacking::floatToHalf(value));
+        EXPECT_NEAR(decoded, value, std::fabs(value) / 1024.0f) << value;
+    }
+
+    EXPECT_EQ(omp::VertexPacking::floatToHalf(1.0f), 0x3c00);
+    EXPECT_EQ(omp::VertexPacking::floatToHalf(-0.0f), 0x8000);
+    EXPECT_EQ(omp::VertexPacking::floatToHalf(65520.0f), 0x7c00);
+    EXPECT_EQ(omp::VertexPacking::floatToHalf(std::numeric_limits<float>::infinity()), 0x7c00);
+    EXPECT_TRUE(std::isnan(omp::VertexPacking::halfToFloat(omp::VertexPacking::floatToHalf(std::numeric_limits<float>::quiet_NaN()))));
+
+    // Every half survives the trip through float
+    for (uint32_t half = 0; half < 0x7c00; half++)
+    {
+        const uint16_t value = static_cast<uint16_t>(half);
+        ASSERT_EQ(omp::VertexPacking::floatToHalf(omp::VertexPacking::halfToFloat(value)), value);
+    }
+}
+
+TEST_F(VertexPackingSuite, OctahedralNormals)
+{
+    std::mt19937 random(3);
+    std::normal_distribution<float> distribution;
+    for (size_t sample = 0; sample < 10000; sample++)
+    {
+        std::array<float, 3> normal = {distribution(random), distribution(random), distribution(random)};
+        const float length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+        normal = {normal[0] / length, normal[1] / length, normal[2] / length};
+
+        // Quantized the same way as on upload
+        const std::array<float, 2> encoded = omp::VertexPacking::encodeOctahedral(normal[0], normal[1], normal[2]);
+        const float x = std::round(encoded[0] * 32767.0f) / 32767.0f;
+        const float y = std::round(encoded[1] * 32767.0f) / 32767.0f;
+        const std::array<float, 3> decoded = omp::VertexPacking::decodeOctahedral(x, y);
+        const float cosine = normal[0] * decoded[0] + normal[1] * decoded[1] + normal[2] * decoded[2];
+        ASSERT_GT(cosine, 0.99999f) << sample;
+    }
+}
+
+TEST_F(VertexPackingSuite, PackedLayouts)
+{
+    std::vector<TestVertex> vertices = {
+            makeVertex({-1.0f, 2.0f, 5.0f}, {0.0f, 1.0f}, {0.0f, 0.0f, -1.0f}),
+            makeVertex({3.0f, 2.0f, 6.0f}, {0.5f, 0.25f}, {1.0f, 0.0f, 0.0f}),
+            makeVertex({0.5f, 2.0f, 5.5f}, {2.0f, -1.0f}, {0.0f, 1.0f, 0.0f})};
+
+    std::array<float, 3> min_bound{};
+    std::array<float, 3> scale{};
+    omp::VertexPacking::computeQuantization(vertices.front().data(), vertices.size(), min_bound, scale);
+    EXPECT_EQ(min_bound, (std::array<float, 3>{-1.0f, 2.0f, 5.0f}));
+    EXPECT_EQ(scale, (std::array<float, 3>{4.0f, 0.0f, 1.0f}));
+
+    EXPECT_FALSE(omp::VertexPacking::hasVertexColors(vertices.front().data(), vertices.size()));
+    const std::vector<uint8_t> data = omp::VertexPacking::packVertices(vertices.front().data(), vertices.size(),
+                                                                       omp::EVertexLayout::Packed, min_bound, scale);
+    ASSERT_EQ(data.size(), vertices.size() * sizeof(omp::PackedVertex));
+    EXPECT_LE(sizeof(omp::PackedColorVertex) * 2, sizeof(TestVertex));
+
+    for (size_t index = 0; index < vertices.size(); index++)
+    {
+        omp::PackedVertex packed{};
+        std::memcpy(&packed, data.data() + index * sizeof(packed), sizeof(packed));
+        EXPECT_EQ(packed.pos[3], UINT16_MAX);
+        for (size_t axis = 0; axis < 3; axis++)
+        {
+            const float position = min_bound[axis] + static_cast<float>(packed.pos[axis]) / 65535.0f * scale[axis];
+            EXPECT_NEAR(position, vertices[index][axis], scale[axis] / 65535.0f) << index << " " << axis;
+        }
+        EXPECT_FLOAT_EQ(omp::VertexPacking::halfToFloat(packed.tex_coord[0]), vertices[index][6]);
+        EXPECT_FLOAT_EQ(omp::VertexPacking::halfToFloat(packed.tex_coord[1]), vertices[index][7]);
+        const std::array<float, 3> normal = omp::VertexPacking::decodeOctahedral(static_cast<float>(packed.normal[0]) / 32767.0f,
+                                                                                 static_cast<float>(packed.normal[1]) / 32767.0f);
+        for (size_t axis = 0; axis < 3; axis++)
+        {
+            EXPECT_NEAR(normal[axis], vertices[index][8 + axis], 1e-4f);
+        }
+    }
+
+    vertices[1][4] = 0.5f;
+    EXPECT_TRUE(omp::VertexPacking::hasVertexColors(vertices.front().data(), vertices.size()));
+    const std::vector<uint8_t> color_data = omp::VertexPacking::packVertices(vertices.front().data(), vertices.size(),
+                                                                             omp::EVertexLayout::PackedColor, min_bound, scale);
+    ASSERT_EQ(color_data.size(), vertices.size() * sizeof(omp::PackedColorVertex));
+    omp::PackedColorVertex packed{};
+    std::memcpy(&packed, color_data.data() + sizeof(packed), sizeof(packed));
+    EXPECT_EQ(packed.color, (std::array<uint8_t, 4>{255, 128, 255, 255}));
+}
+
+TEST_F(VertexPackingSuite, ShortIndices)
+{
+    const std::vector<uint32_t> indices = {0, 1, 65535, 7};
+    EXPECT_EQ(omp::VertexPacking::packIndices(indices), (std::vector<uint16_t>{0, 1, 65535, 7}));
+}